@@ -373,43 +373,43 @@ bool Ai::isStableBase() {
 }
 
 bool Ai::findAbleUnit(int *unitIndex, CmdClass ability, bool idleOnly) {
-	vector<int> units;
+	const Faction *faction = aiInterface->getFaction();
+	const Units &able = faction->getUnitsWithCommandClass(ability);
+	vector<const Unit*> units;
 
 	*unitIndex = -1;
-	for (int i = 0; i < aiInterface->getMyUnitCount(); ++i) {
-		const Unit *unit = aiInterface->getMyUnit(i);
-		if (unit->getType()->getActions()->hasCommandClass(ability)) {
-			if ((!idleOnly || !unit->anyCommand() || unit->getCurrCommand()->getType()->getClass() == CmdClass::STOP)) {
-				units.push_back(i);
-			}
+	foreach_const (Units, it, able) {
+		const Unit *unit = *it;
+		if ((!idleOnly || !unit->anyCommand() || unit->getCurrCommand()->getType()->getClass() == CmdClass::STOP)) {
+			units.push_back(unit);
 		}
 	}
 
 	if (units.empty()) {
 		return false;
 	} else {
-		*unitIndex = units[random.randRange(0, units.size() - 1)];
+		*unitIndex = faction->getUnitIndex(units[random.randRange(0, units.size() - 1)]);
 		return true;
 	}
 }
 
 bool Ai::findAbleUnit(int *unitIndex, CmdClass ability, CmdClass currentCommand) {
-	vector<int> units;
+	const Faction *faction = aiInterface->getFaction();
+	const Units &able = faction->getUnitsWithCommandClass(ability);
+	vector<const Unit*> units;
 
 	*unitIndex = -1;
-	for (int i = 0; i < aiInterface->getMyUnitCount(); ++i) {
-		const Unit *unit = aiInterface->getMyUnit(i);
-		if (unit->getType()->getActions()->hasCommandClass(ability)) {
-			if (unit->anyCommand() && unit->getCurrCommand()->getType()->getClass() == currentCommand) {
-				units.push_back(i);
-			}
+	foreach_const (Units, it, able) {
+		const Unit *unit = *it;
+		if (unit->anyCommand() && unit->getCurrCommand()->getType()->getClass() == currentCommand) {
+			units.push_back(unit);
 		}
 	}
 
 	if (units.empty()) {
 		return false;
 	} else {
-		*unitIndex = units[random.randRange(0, units.size() - 1)];
+		*unitIndex = faction->getUnitIndex(units[random.randRange(0, units.size() - 1)]);
 		return true;
 	}
 }
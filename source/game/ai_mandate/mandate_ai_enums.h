@@ -38,6 +38,23 @@ STRINGY_ENUM( Goal,
 	REST
 )
 
+/** what a sim ai unit is doing towards its current Goal */
+STRINGY_ENUM( GoalReason,
+	COMPUTE,
+	LIVE,
+	SHOP,
+	KILL,
+	FOLLOW,
+	HUNT,
+	PATROL,
+	RAID,
+	DEMOLISH,
+	PROCURE,
+	COLLECT,
+	DELIVER,
+	REST
+)
+
 }}
 
 #endif
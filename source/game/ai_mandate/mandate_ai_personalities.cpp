@@ -13,6 +13,13 @@
 #include "unit.h"
 #include "world.h"
 
+#include <set>
+#include <algorithm>
+
+using Glest::Sim::UnitFilter;
+using Glest::Sim::UnitDistList;
+using Glest::Sim::TeamRelation;
+
 namespace Glest { namespace Plan {
 // ===============================
 // 	class Focus
@@ -26,73 +33,24 @@ void Focus::init(Goal newName, int newImportance) {
 // 	class Personality
 // ===============================
 void Personality::load(const XmlNode *node) {
-    GoalList goalList;
-    goalList.push_back("empty");
-    goalList.push_back("live");
-    goalList.push_back("build");
-    goalList.push_back("collect");
-    goalList.push_back("transport");
-    goalList.push_back("trade");
-    goalList.push_back("procure");
-    goalList.push_back("explore");
-    goalList.push_back("shop");
-    goalList.push_back("demolish");
-    goalList.push_back("raid");
-    goalList.push_back("hunt");
-    goalList.push_back("patrol");
-    goalList.push_back("focusfire");
-    goalList.push_back("attack");
-    goalList.push_back("defend");
-    goalList.push_back("follow");
-    goalList.push_back("buff");
-    goalList.push_back("heal");
-    goalList.push_back("spell");
-    goalList.push_back("rest");
     personalityName = node->getAttribute("name")->getRestrictedValue();
     goals.resize(node->getChildCount());
     for (int i = 0; i < node->getChildCount(); ++i) {
         const XmlNode *goalNode = node->getChild("goal", i);
-        string name = goalNode->getAttribute("name")->getRestrictedValue();
-        Goal newGoal = Goal::EMPTY;
-        for (int j = 0; j < goalList.size(); ++j) {
-            if (name == goalList[j]) {
-                break;
-            } else {
-                ++newGoal;
-            }
-        }
+        Goal newGoal = GoalNames.match(goalNode->getAttribute("name")->getRestrictedValue());
         int importance = goalNode->getAttribute("importance")->getIntValue();
         goals[i].init(newGoal, importance);
     }
 }
 
+/** add the goals of a personality of the same name, from another faction type */
+void Personality::addGoals(const Personality &other) {
+    goals.insert(goals.end(), other.goals.begin(), other.goals.end());
+}
+
 // ===============================
 // 	class Goal System
 // ===============================
-void GoalSystem::init() {
-    goalList.push_back("empty");
-    goalList.push_back("live");
-    goalList.push_back("build");
-    goalList.push_back("collect");
-    goalList.push_back("transport");
-    goalList.push_back("trade");
-    goalList.push_back("procure");
-    goalList.push_back("explore");
-    goalList.push_back("shop");
-    goalList.push_back("demolish");
-    goalList.push_back("raid");
-    goalList.push_back("hunt");
-    goalList.push_back("patrol");
-    goalList.push_back("focusfire");
-    goalList.push_back("attack");
-    goalList.push_back("defend");
-    goalList.push_back("follow");
-    goalList.push_back("buff");
-    goalList.push_back("heal");
-    goalList.push_back("spell");
-    goalList.push_back("rest");
-}
-
 void GoalSystem::ownerLoad(Unit *unit) {
     if (unit->owner->getId() != unit->getId() && unit->owner->getType()->getActions()->hasCommandClass(CmdClass::LOAD)) {
         const CommandType *oct = unit->owner->getType()->getActions()->getFirstCtOfClass(CmdClass::LOAD);
@@ -278,25 +236,24 @@ Unit *GoalSystem::buildingList(Unit *unit, vector<Unit*> buildingsList) {
 }
 
 Unit* GoalSystem::findShop(Unit *unit) {
-    Faction *f = unit->getFaction();
-    vector<Unit*> buildingsList;
-    for (int i = 0; i < f->getUnitCount(); ++i) {
-        Unit *building = f->getUnit(i);
-        if (building->getType()->hasTag("shop") || building->getType()->hasTag("enhancer")) {
-            buildingsList.push_back(building);
-        }
-    }
     int distance = 50;
     Vec2i uPos = unit->getCenteredPos();
     if (unit->isCarried()) {
         uPos = unit->owner->getCenteredPos();
     }
+    UnitFilter filter;
+    filter.faction = unit->getFactionIndex();
+    filter.addAnyTag("shop");
+    filter.addAnyTag("enhancer");
+    filter.aliveOnly = false;
+    UnitDistList buildingsList;
+    g_world.getUnitGrid().findInRange(uPos, distance - 1, filter, buildingsList);
     Unit *finalPick = NULL;
     Vec2i tPos = Vec2i(0,0);
     for (int i = 0; i < buildingsList.size(); ++i) {
-        Unit *building = buildingsList[i];
+        Unit *building = buildingsList[i].unit;
         Vec2i bPos = building->getCenteredPos();
-        int newDistance = sqrt(pow(float(abs(uPos.x - bPos.x)), 2) + pow(float(abs(uPos.y - bPos.y)), 2));
+        int newDistance = buildingsList[i].dist.intp();
         if (newDistance < distance) {
             if (building->getStoredItems().size() > 0) {
                 for (int i = 0; i < unit->getEquipmentSize(); ++i) {
@@ -372,21 +329,20 @@ Unit* GoalSystem::findBuilding(Unit* unit) {
     Unit *targetBuilding = NULL;
     Faction *f = unit->getFaction();
     vector<Unit*> buildingsList;
-    for (int i = 0; i < f->getUnitCount(); ++i) {
-        Unit *building = f->getUnit(i);
-        if (building->getType()->hasTag("building")) {
-            if (!building->isBuilt() && !unit->getType()->hasTag("householder")) {
-                if (!unit->owner->getType()->hasTag("house") && building->owner == unit->owner) {
-                    buildingsList.push_back(building);
-                } else if (unit->owner->getType()->hasTag("house")) {
-                    buildingsList.push_back(building);
-                }
-            } else if (building->getHp() < building->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue()) {
-                if (building->getType()->hasTag("house") && unit->getType()->hasTag("householder") && building == unit->owner) {
-                    buildingsList.push_back(building);
-                } else if (!building->getType()->hasTag("house") && !unit->getType()->hasTag("householder")) {
-                    buildingsList.push_back(building);
-                }
+    const Units &buildings = f->getUnitsWithTag(UnitType::getTagId("building"));
+    for (int i = 0; i < buildings.size(); ++i) {
+        Unit *building = buildings[i];
+        if (!building->isBuilt() && !unit->getType()->hasTag("householder")) {
+            if (!unit->owner->getType()->hasTag("house") && building->owner == unit->owner) {
+                buildingsList.push_back(building);
+            } else if (unit->owner->getType()->hasTag("house")) {
+                buildingsList.push_back(building);
+            }
+        } else if (building->getHp() < building->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue()) {
+            if (building->getType()->hasTag("house") && unit->getType()->hasTag("householder") && building == unit->owner) {
+                buildingsList.push_back(building);
+            } else if (!building->getType()->hasTag("house") && !unit->getType()->hasTag("householder")) {
+                buildingsList.push_back(building);
             }
         }
     }
@@ -398,9 +354,10 @@ Unit* GoalSystem::findProducer(Unit* unit) {
     Unit *producer = NULL;
     Faction *f = unit->getFaction();
     vector<Unit*> buildingsList;
-    for (int i = 0; i < f->getUnitCount(); ++i) {
-        Unit *building = f->getUnit(i);
-        if (building->getType()->hasTag("building") && building->getType()->hasTag("producer")) {
+    const Units &producers = f->getUnitsWithTag(UnitType::getTagId("producer"));
+    for (int i = 0; i < producers.size(); ++i) {
+        Unit *building = producers[i];
+        if (building->getType()->hasTag("building")) {
             for (int k = 0; k < building->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++k) {
                 const ResourceType *producedType = building->getType()->getResourceProductionSystem()->getStoredResource(k, building->getFaction()).getType();
                 int amount = building->getSResource(producedType)->getAmount();
@@ -417,15 +374,7 @@ Unit* GoalSystem::findProducer(Unit* unit) {
                             const ResourceType *storedType = unit->owner->getType()->getResourceProductionSystem()->getStoredResource(l, unit->getFaction()).getType();
                             if (transportedType == storedType && storedType == producedType &&
                                 transportedType == producedType) {
-                                bool previousTarget = false;
-                                for (int z = 0; z < unit->getFaction()->getUnitCount(); ++z) {
-                                    if (unit->getFaction()->getUnit(z)->getType()->personality == unit->getType()->personality) {
-                                        if (unit->getFaction()->getUnit(z)->getGoalStructure() == building) {
-                                            previousTarget = true;
-                                        }
-                                    }
-                                }
-                                if (previousTarget == false) {
+                                if (!previousTarget(unit, building)) {
                                     buildingsList.push_back(building);
                                 }
                             }
@@ -459,6 +408,35 @@ bool GoalSystem::tagCheck(Unit *unit, Unit *building) {
     return buy;
 }
 
+/** the buildings tagCheck() accepts for unit, gathered from the faction's tag index */
+void GoalSystem::findTradeBuildings(Unit *unit, vector<Unit*> &buildings) {
+    buildings.clear();
+    const UnitType *ownerType = unit->owner->getType();
+    vector<int> tags;
+    if (ownerType->hasTag("house") || ownerType->hasTag("fort")) {
+        tags.push_back(UnitType::getTagId("shop"));
+    }
+    if (ownerType->hasTag("shop") || ownerType->hasTag("guildhall")) {
+        tags.push_back(UnitType::getTagId("guildhall"));
+    }
+    if (ownerType->hasTag("guildhall")) {
+        tags.push_back(UnitType::getTagId("producer"));
+    }
+    const Faction *f = unit->getFaction();
+    for (int i = 0; i < tags.size(); ++i) {
+        const Units &tagged = f->getUnitsWithTag(tags[i]);
+        for (int j = 0; j < tagged.size(); ++j) {
+            Unit *building = tagged[j];
+            if (i && std::find(buildings.begin(), buildings.end(), building) != buildings.end()) {
+                continue; // has more than one of the tags
+            }
+            if (tagCheck(unit, building)) {
+                buildings.push_back(building);
+            }
+        }
+    }
+}
+
 bool GoalSystem::status(Unit *building, const ResourceType *producedType) {
     bool status = false;
     for (int i = 0; i < building->getType()->getResourceStoreCount(); ++i) {
@@ -490,48 +468,55 @@ int GoalSystem::available(Unit *building, const ResourceType *producedType) {
     return available;
 }
 
+/** is building already the goal of a unit with the same personality, only the units
+  * of the types with that personality are looked at */
 bool GoalSystem::previousTarget(Unit *unit, Unit *building) {
-    bool previousTarget = false;
-    for (int i = 0; i < unit->getFaction()->getUnitCount(); ++i) {
-        if (unit->getFaction()->getUnit(i)->getType()->personality == unit->getType()->personality) {
-            if (unit->getFaction()->getUnit(i)->getGoalStructure() == building) {
-                previousTarget = true;
+    const Faction *f = unit->getFaction();
+    const FactionType *ft = f->getType();
+    for (int i = 0; i < ft->getUnitTypeCount(); ++i) {
+        const UnitType *ut = ft->getUnitType(i);
+        if (ut->personality != unit->getType()->personality) {
+            continue;
+        }
+        const Units &units = f->getUnitsOfType(ut);
+        for (int j = 0; j < units.size(); ++j) {
+            if (units[j]->getGoalStructure() == building) {
+                return true;
             }
         }
     }
-    return previousTarget;
+    return false;
 }
 
 Unit* GoalSystem::findGuild(Unit* unit) {
     Unit *producer = NULL;
-    Faction *f = unit->getFaction();
     vector<Unit*> buildingsList;
-    for (int i = 0; i < f->getUnitCount(); ++i) {
-        Unit *building = f->getUnit(i);
-        if (tagCheck(unit, building)) {
-            for (int j = 0; j < building->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++j) {
-                const ResourceType *producedType = building->getType()->getResourceProductionSystem()->
-                                                   getStoredResource(j, building->getFaction()).getType();
-                if (producedType->getName() != "wealth" && !status(building, producedType)) {
-                    for (int k = 0; k < unit->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++k) {
-                        const ResourceType *transportedType = unit->getType()->getResourceProductionSystem()->
-                                                              getStoredResource(k, unit->getFaction()).getType();
-                        if (producedType == transportedType) {
-                            for (int l = 0; l < unit->owner->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++l) {
-                                const ResourceType *storedType = unit->owner->getType()->getResourceProductionSystem()->
-                                                                 getStoredResource(l, unit->getFaction()).getType();
-                                if (producedType == storedType) {
-                                    for (int m = 0; m < unit->owner->getType()->getResourceStoreCount(); ++m) {
-                                        const ResourceType *resType = unit->owner->getType()->getResourceStore(m)->getType();
-                                        if (producedType == resType) {
-                                            int homeStored = unit->owner->getSResource(producedType)->getAmount();
-                                            int homeStores = unit->owner->getType()->getResourceStore(m)->getAmount();
-                                            if (homeStores - homeStored > 5) {
-                                                int free = available(building, producedType);
-                                                if (free >= 10) {
-                                                    if (!previousTarget(unit, building)) {
-                                                        buildingsList.push_back(building);
-                                                    }
+    vector<Unit*> buildings;
+    findTradeBuildings(unit, buildings);
+    for (int i = 0; i < buildings.size(); ++i) {
+        Unit *building = buildings[i];
+        for (int j = 0; j < building->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++j) {
+            const ResourceType *producedType = building->getType()->getResourceProductionSystem()->
+                                               getStoredResource(j, building->getFaction()).getType();
+            if (producedType->getName() != "wealth" && !status(building, producedType)) {
+                for (int k = 0; k < unit->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++k) {
+                    const ResourceType *transportedType = unit->getType()->getResourceProductionSystem()->
+                                                          getStoredResource(k, unit->getFaction()).getType();
+                    if (producedType == transportedType) {
+                        for (int l = 0; l < unit->owner->getType()->getResourceProductionSystem()->getStoredResourceCount(); ++l) {
+                            const ResourceType *storedType = unit->owner->getType()->getResourceProductionSystem()->
+                                                             getStoredResource(l, unit->getFaction()).getType();
+                            if (producedType == storedType) {
+                                for (int m = 0; m < unit->owner->getType()->getResourceStoreCount(); ++m) {
+                                    const ResourceType *resType = unit->owner->getType()->getResourceStore(m)->getType();
+                                    if (producedType == resType) {
+                                        int homeStored = unit->owner->getSResource(producedType)->getAmount();
+                                        int homeStores = unit->owner->getType()->getResourceStore(m)->getAmount();
+                                        if (homeStores - homeStored > 5) {
+                                            int free = available(building, producedType);
+                                            if (free >= 10) {
+                                                if (!previousTarget(unit, building)) {
+                                                    buildingsList.push_back(building);
                                                 }
                                             }
                                         }
@@ -550,20 +535,19 @@ Unit* GoalSystem::findGuild(Unit* unit) {
 
 Unit* GoalSystem::findGuildItem(Unit* unit) {
     Unit *producer = NULL;
-    Faction *f = unit->getFaction();
     vector<Unit*> buildingsList;
-    for (int i = 0; i < f->getUnitCount(); ++i) {
-        Unit *building = f->getUnit(i);
-        if (tagCheck(unit, building)) {
-            for (int j = 0; j < building->getStorageSize(); ++j) {
-                const ItemType *producedType = building->getStorage(j)->getItemType();
-                for (int l = 0; l < unit->owner->getRequisitionCount(); ++l) {
-                    const ItemType *requisitionedType = unit->owner->getRequisition(l);
-                    if (producedType == requisitionedType) {
-                        if (building->getStorage(j)->getCurrent() > 0) {
-                            if (!previousTarget(unit, building)) {
-                                buildingsList.push_back(building);
-                            }
+    vector<Unit*> buildings;
+    findTradeBuildings(unit, buildings);
+    for (int i = 0; i < buildings.size(); ++i) {
+        Unit *building = buildings[i];
+        for (int j = 0; j < building->getStorageSize(); ++j) {
+            const ItemType *producedType = building->getStorage(j)->getItemType();
+            for (int l = 0; l < unit->owner->getRequisitionCount(); ++l) {
+                const ItemType *requisitionedType = unit->owner->getRequisition(l);
+                if (producedType == requisitionedType) {
+                    if (building->getStorage(j)->getCurrent() > 0) {
+                        if (!previousTarget(unit, building)) {
+                            buildingsList.push_back(building);
                         }
                     }
                 }
@@ -671,23 +655,7 @@ const CommandType* GoalSystem::selectAttackSpell(Unit *unit, Unit *target) {
                     fixed totalDamage = 0 + fDamage;
                     const UnitType *uType = target->getType();
                     const AttackLevel *aLevel = testSkillType->getLevel(testSkillType->getCurrentLevel());
-                    for (int t = 0; t < aLevel->getStatistics()->getDamageTypeCount(); ++t) {
-                        const DamageType *dType = aLevel->getStatistics()->getDamageType(t);
-                        string damageType = dType->getTypeName();
-                        int mDamage = dType->getValue();
-                        for (int i = 0; i < uType->getStatistics()->getResistances()->size(); ++i) {
-                            const DamageType *rType = uType->getStatistics()->getResistance(i);
-                            string resistType = rType->getTypeName();
-                            if (damageType==resistType) {
-                                int resist = rType->getValue();
-                                mDamage -= resist;
-                                if (mDamage < 0) {
-                                    mDamage = 0;
-                                }
-                            }
-                        }
-                        totalDamage += mDamage;
-                    }
+                    totalDamage += aLevel->getStatistics()->getDamageAgainst(uType->getStatistics());
                     if (currentDamage < totalDamage.intp()) {
                         currentDamage = totalDamage.intp();
                         attackCommandType = testingCommandType;
@@ -702,91 +670,47 @@ const CommandType* GoalSystem::selectAttackSpell(Unit *unit, Unit *target) {
     return attackCommandType;
 }
 
-Unit* GoalSystem::findLair(Unit *unit) {
+/** nearest living hostile unit within range of unit that is (or is not) a building,
+  * optionally restricted to tiles the unit's team has explored */
+Unit* GoalSystem::findNearestHostile(Unit *unit, int range, bool building, bool explored) {
     Vec2i uPos = unit->getPos();
     if (unit->isCarried()) {
         uPos = unit->owner->getCenteredPos();
     }
-    Faction *faction;
-    Unit *lair = NULL;
-    for (int i = 0; i < g_world.getFactionCount(); ++i) {
-        if (g_world.getFaction(i)->getTeam() != unit->getFaction()->getTeam()) {
-            faction = g_world.getFaction(i);
-        }
+    int team = unit->getFaction()->getTeam();
+    UnitFilter filter;
+    filter.team = team;
+    filter.relation = TeamRelation::HOSTILE;
+    filter.self = unit;
+    if (building) {
+        filter.addAnyTag("building");
+    } else {
+        filter.addNoTag("building");
     }
-    int distance = 50;
-    for (int i = 0; i < faction->getUnitCount(); ++i) {
-        Unit *possibleLair = faction->getUnit(i);
-        if (possibleLair->getType()->hasTag("building") && possibleLair->isAlive()) {
-            Vec2i bPos = possibleLair->getPos();
-            Tile *tile = g_world.getMap()->getTile(Map::toTileCoords(Vec2i(bPos.x, bPos.y)));
-            if(tile->isExplored(unit->getFaction()->getTeam())) {
-                int newDistance = sqrt(pow(float(abs(uPos.x - bPos.x)), 2) + pow(float(abs(uPos.y - bPos.y)), 2));
-                if (newDistance < distance) {
-                    distance = newDistance;
-                    lair = possibleLair;
-                }
+    UnitDistList candidates;
+    g_world.getUnitGrid().findInRange(uPos, range - 1, filter, candidates);
+    foreach_const (UnitDistList, it, candidates) {
+        if (explored) {
+            Tile *tile = g_world.getMap()->getTile(Map::toTileCoords(it->unit->getPos()));
+            if (!tile->isExplored(team)) {
+                continue;
             }
         }
+        return it->unit;
     }
-    return lair;
+    return NULL;
+}
+
+Unit* GoalSystem::findLair(Unit *unit) {
+    return findNearestHostile(unit, 50, true, true);
 }
 
 Unit* GoalSystem::findCity(Unit *unit) {
-    Vec2i uPos = unit->getPos();
-    if (unit->isCarried()) {
-        uPos = unit->owner->getCenteredPos();
-    }
-    Faction *faction;
-    Unit *city = NULL;
-    for (int i = 0; i < g_world.getFactionCount(); ++i) {
-        if (g_world.getFaction(i)->getTeam() != unit->getFaction()->getTeam()) {
-            faction = g_world.getFaction(i);
-        }
-    }
-    int distance = 50;
-    for (int i = 0; i < faction->getUnitCount(); ++i) {
-        Unit *possibleCity = faction->getUnit(i);
-        if (possibleCity->getType()->hasTag("building") && possibleCity->isAlive()) {
-            Vec2i bPos = possibleCity->getPos();
-            int newDistance = sqrt(pow(float(abs(uPos.x - bPos.x)), 2) + pow(float(abs(uPos.y - bPos.y)), 2));
-            if (newDistance < distance) {
-                distance = newDistance;
-                city = possibleCity;
-            }
-        }
-    }
-    return city;
+    return findNearestHostile(unit, 50, true, false);
 }
 
 Unit* GoalSystem::findCreature(Unit *unit, int range) {
-    Vec2i uPos = unit->getPos();
-    if (unit->isCarried()) {
-        uPos = unit->owner->getCenteredPos();
-    }
-    Faction *faction;
-    Unit *creature = NULL;
-    for (int i = 0; i < g_world.getFactionCount(); ++i) {
-        if (g_world.getFaction(i)->getTeam() != unit->getFaction()->getTeam()) {
-            faction = g_world.getFaction(i);
-        }
-    }
-    int distance = range;
-    for (int i = 0; i < faction->getUnitCount(); ++i) {
-        Unit *possibleCreature = faction->getUnit(i);
-        if (!possibleCreature->getType()->hasTag("building") && possibleCreature->isAlive()) {
-            Vec2i bPos = possibleCreature->getPos();
-            Tile *tile = g_world.getMap()->getTile(Map::toTileCoords(Vec2i(bPos.x, bPos.y)));
-            if(tile->isExplored(unit->getFaction()->getTeam())) {
-                int newDistance = sqrt(pow(float(abs(uPos.x - bPos.x)), 2) + pow(float(abs(uPos.y - bPos.y)), 2));
-                if (newDistance < distance) {
-                    distance = newDistance;
-                    creature = possibleCreature;
-                }
-            }
-        }
-    }
-    return creature;
+    return findNearestHostile(unit, range, false, true);
 }
 
 UnitDirection GoalSystem::newDirection(UnitDirection oldDirection) {
@@ -845,10 +769,10 @@ UnitDirection GoalSystem::newDirection(UnitDirection oldDirection) {
 }
 
 void GoalSystem::clearSimAi(Unit *unit, Goal goal) {
-    if (goalList[goal] != unit->getCurrentFocus()) {
-        unit->setCurrentFocus(goalList[goal]);
+    if (goal != unit->getCurrentFocus()) {
+        unit->setCurrentFocus(goal);
         unit->setGoalStructure(NULL);
-        unit->setGoalReason("compute");
+        unit->setGoalReason(GoalReason::COMPUTE);
         unit->setCurrSkill(SkillClass::STOP);
         unit->finishCommand();
     }
@@ -860,7 +784,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
     if (goal == Goal::LIVE) {
         clearSimAi(unit, goal);
         ownerLoad(unit);
-        unit->setGoalReason("live");
+        unit->setGoalReason(GoalReason::LIVE);
     } else if (goal == Goal::BUILD) {
         clearSimAi(unit, goal);
         if (change(unit)) {
@@ -881,7 +805,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
         }
     } else if (goal == Goal::SHOP) {
         clearSimAi(unit, goal);
-        if (unit->getGoalReason() == "shop") {
+        if (unit->getGoalReason() == GoalReason::SHOP) {
             Vec2i posUnit = unit->getPos();
             if (unit->isCarried()) {
                 posUnit = unit->owner->getCenteredPos();
@@ -890,7 +814,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             int distance = sqrt(pow(float(abs(posUnit.x - posShop.x)), 2) + pow(float(abs(posUnit.y - posShop.y)), 2));
             if (distance < 2) {
                 unit->shop();
-                unit->setGoalReason("");
+                unit->setGoalReason(GoalReason::INVALID);
             }
         }
         if (change(unit)) {
@@ -906,7 +830,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                     } else {
                         unit->setGoalStructure(finalPick);
                         unit->giveCommand(g_world.newCommand(ct, CmdFlags(), tPos));
-                        unit->setGoalReason("shop");
+                        unit->setGoalReason(GoalReason::SHOP);
                     }
             }
         }
@@ -916,7 +840,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             if (unit->getGoalStructure() == NULL) {
                 if (unit->attackers.size() > 0) {
                     unit->setGoalStructure(unit->attackers[0].getUnit());
-                    unit->setGoalReason("kill");
+                    unit->setGoalReason(GoalReason::KILL);
                 }
             }
             if (unit->getGoalStructure() != NULL) {
@@ -944,7 +868,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                             ownerUnload(unit);
                         }
                         unit->setGoalStructure(unit->owner->getGoalStructure());
-                        unit->setGoalReason("kill");
+                        unit->setGoalReason(GoalReason::KILL);
                     }
                 }
                 if (unit->getGoalStructure() != NULL) {
@@ -974,7 +898,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                         }
                         if (distance < 25 + unit->owner->attackers.size() * 5) {
                             unit->setGoalStructure(unit->owner->attackers[0].getUnit());
-                            unit->setGoalReason("kill");
+                            unit->setGoalReason(GoalReason::KILL);
                         }
                     }
                 }
@@ -1005,7 +929,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                         }
                         if (distance > 5) {
                             unit->setGoalStructure(unit->owner);
-                            unit->setGoalReason("follow");
+                            unit->setGoalReason(GoalReason::FOLLOW);
                         }
                     }
                 }
@@ -1018,7 +942,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                 Unit *creature = findCreature(unit, 50);
                 if (creature != NULL) {
                     unit->setGoalStructure(creature);
-                    unit->setGoalReason("hunt");
+                    unit->setGoalReason(GoalReason::HUNT);
                     if (unit->isCarried()) {
                         ownerUnload(unit);
                     }
@@ -1040,7 +964,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                 Unit *creature = findCreature(unit, 8);
                 if (creature != NULL) {
                     unit->setGoalStructure(creature);
-                    unit->setGoalReason("patrol");
+                    unit->setGoalReason(GoalReason::PATROL);
                     if (unit->isCarried()) {
                         ownerUnload(unit);
                     }
@@ -1062,7 +986,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                 Unit *lair = findLair(unit);
                 if (lair != NULL) {
                     unit->setGoalStructure(lair);
-                    unit->setGoalReason("raid");
+                    unit->setGoalReason(GoalReason::RAID);
                     if (unit->isCarried()) {
                         ownerUnload(unit);
                     }
@@ -1084,7 +1008,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                 Unit *city = findCity(unit);
                 if (city != NULL) {
                     unit->setGoalStructure(city);
-                    unit->setGoalReason("demolish");
+                    unit->setGoalReason(GoalReason::DEMOLISH);
                     if (unit->isCarried()) {
                         ownerUnload(unit);
                     }
@@ -1147,7 +1071,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             }
         }
     } else if (goal == Goal::TRANSPORT) {
-        if (goalList[goal] != unit->getCurrentFocus()) {
+        if (goal != unit->getCurrentFocus()) {
             clearSimAi(unit, goal);
             unit->productionRoute.setStoreId(unit->owner->getId());
             unit->productionRoute.setDestination(unit->owner->getPos());
@@ -1168,7 +1092,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             }
         }
     } else if (goal == Goal::TRADE) {
-        if (goalList[goal] != unit->getCurrentFocus()) {
+        if (goal != unit->getCurrentFocus()) {
             clearSimAi(unit, goal);
             unit->productionRoute.setStoreId(unit->owner->getId());
             unit->productionRoute.setDestination(unit->owner->getPos());
@@ -1192,7 +1116,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             }
         }
     } else if (goal == Goal::PROCURE) {
-        if (goalList[goal] != unit->getCurrentFocus()) {
+        if (goal != unit->getCurrentFocus()) {
             clearSimAi(unit, goal);
             unit->productionRoute.setStoreId(unit->owner->getId());
             unit->productionRoute.setDestination(unit->owner->getPos());
@@ -1227,7 +1151,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                     for (int i = 0; i < remainingReqs.size(); ++i) {
                         unit->owner->addRequisition(remainingReqs[i]);
                     }
-                    unit->setGoalReason("procure");
+                    unit->setGoalReason(GoalReason::PROCURE);
                     const CommandType *pct = unit->getType()->getActions()->getFirstCtOfClass(CmdClass::PROCURE);
                     if (pct != 0) {
                         unit->giveCommand(g_world.newCommand(pct, CmdFlags(), unit->getGoalStructure()));
@@ -1236,34 +1160,36 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
             }
         }
     } else if (goal == Goal::COLLECT) {
-        if (goalList[goal] != unit->getCurrentFocus()) {
+        if (goal != unit->getCurrentFocus()) {
             clearSimAi(unit, goal);
             unit->productionRoute.setStoreId(unit->owner->getId());
             unit->productionRoute.setDestination(unit->owner->getPos());
         }
         if (change(unit)) {
-            if (unit->getGoalReason() == "deliver") {
+            if (unit->getGoalReason() == GoalReason::DELIVER) {
                 const CommandType *tct = unit->getType()->getActions()->getFirstCtOfClass(CmdClass::MOVE);
                 unit->giveCommand(g_world.newCommand(tct, CmdFlags(), unit->getGoalStructure()));
             }
             Faction *f = unit->getFaction();
             vector<Unit*> buildingsList;
-            for (int i = 0; i < f->getUnitCount(); ++i) {
-                Unit *building = f->getUnit(i);
-                if (building->getType()->hasTag("building") && !building->getType()->hasTag("fort") && building->getId() != unit->owner->getId()) {
+            // what the owner's other units already head for, ownership isn't indexed so
+            // this is one pass over the faction, not one for every building
+            std::set<const Unit*> targeted;
+            for (int z = 0; z < f->getUnitCount(); ++z) {
+                const Unit *other = f->getUnit(z);
+                if (other->owner && other->owner->getId() == unit->owner->getId()) {
+                    targeted.insert(other->getGoalStructure());
+                }
+            }
+            const Units &buildings = f->getUnitsWithTag(UnitType::getTagId("building"));
+            for (int i = 0; i < buildings.size(); ++i) {
+                Unit *building = buildings[i];
+                if (!building->getType()->hasTag("fort") && building->getId() != unit->owner->getId()) {
                     if (building->sresources.size() > 0) {
                         for (int j = 0; j < building->sresources.size(); ++j) {
                             if (building->getSResource(j)->getType()->getName() == "wealth") {
                                 if (building->getSResource(j)->getAmount() - building->taxedGold >= 500) {
-                                    bool previousTarget = false;
-                                    for (int z = 0; z < unit->getFaction()->getUnitCount(); ++z) {
-                                        if (unit->getFaction()->getUnit(z)->owner->getId() == unit->owner->getId()) {
-                                            if (unit->getFaction()->getUnit(z)->getGoalStructure() == building) {
-                                                previousTarget = true;
-                                            }
-                                        }
-                                    }
-                                    if (previousTarget == false) {
+                                    if (!targeted.count(building)) {
                                         buildingsList.push_back(building);
                                     }
                                 }
@@ -1299,7 +1225,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
                     unit->productionRoute.setDestination(finalPick->getPos());
                 }
                 if (unit->productionRoute.getProducerId() != -1 && unit->productionRoute.getStoreId() != -1) {
-                    unit->setGoalReason("collect");
+                    unit->setGoalReason(GoalReason::COLLECT);
                     unit->setGoalStructure(finalPick);
                     unit->giveCommand(g_world.newCommand(tct, CmdFlags(), finalPick->getPos()));
                 }
@@ -1313,7 +1239,7 @@ void GoalSystem::computeAction(Unit *unit, Focus focus) {
         clearSimAi(unit, goal);
         if (change(unit)) {
             ownerLoad(unit);
-            unit->setGoalReason("rest");
+            unit->setGoalReason(GoalReason::REST);
         }
     }
 }
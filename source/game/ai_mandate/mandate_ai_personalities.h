@@ -43,29 +43,27 @@ private:
     string personalityName;
     Goals goals;
 public:
-    string getPersonalityName() const {return personalityName;}
-    Goals getGoals() const {return goals;}
+    const string &getPersonalityName() const {return personalityName;}
+    const Goals &getGoals() const {return goals;}
     Focus getGoal(int i) const {return goals[i];}
     void load(const XmlNode *node);
+    void addGoals(const Personality &other);
 };
 
 // ===============================
 // 	class Goal System
 // ===============================
-typedef vector<string> GoalList;
-
 class GoalSystem {
 private:
-    GoalList goalList;
     ExploredMap exploredMap;
 
 public:
-    void init();
     void computeAction(Unit *unit, Focus focus);
     void ownerLoad(Unit*unit);
     void ownerUnload(Unit *unit);
     void shop(Unit *unit);
     bool tagCheck(Unit *unit, Unit *building);
+    void findTradeBuildings(Unit *unit, vector<Unit*> &buildings);
     bool status(Unit *building, const ResourceType *producedType);
     int available(Unit *building, const ResourceType *producedType);
     bool previousTarget(Unit *unit, Unit *building);
@@ -78,6 +76,7 @@ public:
     const CommandType *selectHealSpell(Unit *unit, Unit* target);
     const CommandType *selectBuffSpell(Unit *unit, Unit* target);
     const CommandType *selectAttackSpell(Unit *unit, Unit* target);
+    Unit *findNearestHostile(Unit *unit, int range, bool building, bool explored);
     Unit *findCity(Unit *unit);
     Unit *findLair(Unit *unit);
     Unit *findCreature(Unit *unit, int range);
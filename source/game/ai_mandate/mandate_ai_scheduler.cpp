@@ -0,0 +1,52 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "mandate_ai_scheduler.h"
+
+#include <algorithm>
+
+#include "faction.h"
+#include "unit.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Plan {
+
+// ===============================
+// 	class AgentScheduler
+// ===============================
+
+/** have unit looked at next frame */
+void AgentScheduler::wake(const Unit *unit) {
+	m_woken.insert(unit->getId());
+}
+
+/** the units to look at this frame, those woken (any over budget wait for the next
+  * frame) then those taking their turn, enough to get round all the faction's units
+  * every cycleFrames frames */
+void AgentScheduler::schedule(Faction *faction, vector<Unit*> &out) {
+	out.clear();
+	const int count = faction->getUnitCount();
+	const int turns = (count + cycleFrames - 1) / cycleFrames;
+	const int wokenBudget = std::max(minWokenBudget, turns);
+
+	set<int>::iterator it = m_woken.begin();
+	while (it != m_woken.end() && int(out.size()) < wokenBudget) {
+		if (Unit *unit = faction->findUnit(*it)) { // null if undertaken since
+			out.push_back(unit);
+		}
+		m_woken.erase(it++);
+	}
+	for (int i = 0; i < turns; ++i) {
+		if (m_next >= count) {
+			m_next = 0;
+		}
+		out.push_back(faction->getUnit(m_next++));
+	}
+}
+
+}}
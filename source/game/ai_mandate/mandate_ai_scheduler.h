@@ -0,0 +1,48 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_MANDATE_AI_SCHEDULER_H_
+#define _GLEST_MANDATE_AI_SCHEDULER_H_
+
+#include <set>
+#include <vector>
+
+#include "forward_decs.h"
+
+namespace Glest { namespace Plan {
+
+using std::set;
+using std::vector;
+using Glest::Entities::Unit;
+using Glest::Entities::Faction;
+
+// ===============================
+// 	class AgentScheduler
+// ===============================
+/** Spreads the sim ai's look at a faction's units over the frames. Each unit takes
+  * its turn once every cycleFrames frames, and a unit woken by an event (its command
+  * finished, it was attacked, its store filled up) is looked at the next frame, ahead
+  * of its turn. The per frame budgets are numbers of units rather than a time, so the
+  * same units are looked at on every peer. */
+class AgentScheduler {
+public:
+	static const int cycleFrames = 9;	/**< idle units used to rethink their goal every 9 frames */
+	static const int minWokenBudget = 8;
+
+private:
+	set<int>  m_woken;	/**< ids of units woken since the last frame, in id order */
+	int       m_next;	/**< index in the faction's units of the next to take its turn */
+
+public:
+	AgentScheduler() : m_next(0) {}
+
+	void wake(const Unit *unit);
+	void schedule(Faction *faction, vector<Unit*> &out);
+};
+
+}}
+
+#endif
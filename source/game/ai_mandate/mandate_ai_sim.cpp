@@ -25,310 +25,337 @@ namespace Glest { namespace Plan {
 void MandateAISim::init(World *newWorld, Faction *newFaction) {
     faction = newFaction;
     world = newWorld;
-    goalSystem.init();
     for (int i = 0; i < faction->getType()->getPersonalities().size(); ++i) {
-        personalities.push_back(faction->getType()->getPersonalities()[i]);
+        addPersonality(faction->getType()->getPersonalities()[i]);
     }
     if (faction->getType()->getFactionTypeNames().size() > 0) {
         for (int i = 0; i < faction->getType()->getFactionTypeNames().size(); ++i) {
             string name = faction->getType()->getFactionTypeNames()[i];
             const FactionType *ft = world->getTechTree()->getFactionType(name);
             for (int j = 0; j < ft->getPersonalities().size(); ++j) {
-                personalities.push_back(ft->getPersonalities()[j]);
+                addPersonality(ft->getPersonalities()[j]);
             }
         }
     }
 }
 
-Focus MandateAISim::getTopGoal(Unit *unit, string personality) {
+/** add personality, or its goals to the one of the same name already added */
+void MandateAISim::addPersonality(const Personality &personality) {
+    for (int i = 0; i < personalities.size(); ++i) {
+        if (personalities[i].getPersonalityName() == personality.getPersonalityName()) {
+            personalities[i].addGoals(personality);
+            return;
+        }
+    }
+    personalities.push_back(personality);
+}
+
+/** the personality of units of type ut, null if it has none, looked up by name once per type */
+const Personality *MandateAISim::findPersonality(const UnitType *ut) {
+    if (ut->getId() >= int(typePersonalities.size())) {
+        typePersonalities.resize(ut->getId() + 1, -2);
+    }
+    int &ndx = typePersonalities[ut->getId()];
+    if (ndx == -2) {
+        ndx = -1;
+        for (int i = 0; i < personalities.size(); ++i) {
+            if (personalities[i].getPersonalityName() == ut->personality) {
+                ndx = i;
+                break;
+            }
+        }
+    }
+    return ndx == -1 ? NULL : &personalities[ndx];
+}
+
+Focus MandateAISim::getTopGoal(Unit *unit, const Personality *personality) {
     Focus topGoal;
     topGoal.init(Goal::EMPTY, NULL);
-    for (int i = 0; i < getPersonalities()->size(); ++i) {
-        if (personality == getPersonality(i)->getPersonalityName()) {
-            for (int k = 0; k < getPersonality(i)->getGoals().size(); ++k) {
-                Focus goal = getPersonality(i)->getGoal(k);
-                Goal goalName = goal.getName();
-                int goalImportance = goal.getImportance();
-                if (goalName == Goal::LIVE) {
-                    int importanceLive = goal.getImportance();
-                    if (importanceLive > 100) {
-                        importanceLive = 100;
-                    }
-                    int healthModifier = importanceLive;
-                    if (unit->getHp() <= (unit->getStatistics()->getEnhancement()->getResourcePools()->
-                        getHealth()->getMaxStat()->getValue() * (healthModifier / 100))) {
-                        topGoal = goal;
-                        return topGoal;
-                    } else if (unit->getHp() < unit->getStatistics()->getEnhancement()->getResourcePools()->
-                               getHealth()->getMaxStat()->getValue() && unit->isCarried()) {
-                        topGoal = goal;
-                        return topGoal;
-                    }
-                } else if (goalName == Goal::BUILD) {
-                    if (goalSystem.findBuilding(unit) != NULL) {
+    if (!personality) {
+        return topGoal;
+    }
+    for (int k = 0; k < personality->getGoals().size(); ++k) {
+        Focus goal = personality->getGoal(k);
+        Goal goalName = goal.getName();
+        int goalImportance = goal.getImportance();
+        if (goalName == Goal::LIVE) {
+            int importanceLive = goal.getImportance();
+            if (importanceLive > 100) {
+                importanceLive = 100;
+            }
+            int healthModifier = importanceLive;
+            if (unit->getHp() <= (unit->getStatistics()->getEnhancement()->getResourcePools()->
+                getHealth()->getMaxStat()->getValue() * (healthModifier / 100))) {
+                topGoal = goal;
+                return topGoal;
+            } else if (unit->getHp() < unit->getStatistics()->getEnhancement()->getResourcePools()->
+                       getHealth()->getMaxStat()->getValue() && unit->isCarried()) {
+                topGoal = goal;
+                return topGoal;
+            }
+        } else if (goalName == Goal::BUILD) {
+            if (goalSystem.findBuilding(unit) != NULL) {
+                topGoal = goal;
+                return topGoal;
+            }
+        } else if (goalName == Goal::COLLECT) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::TRANSPORT) {
+            Unit *producer = NULL;
+            producer = goalSystem.findProducer(unit);
+            if (producer != NULL) {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::TRADE) {
+            const ResourceType *rt = NULL;
+            int minWealth = 0;
+            for (int j = 0; j < unit->owner->getType()->getResourceStoreCount(); ++j) {
+                if (unit->owner->getType()->getResourceStore(j)->getType() == g_world.getTechTree()->getResourceType("wealth")) {
+                    minWealth = unit->owner->getType()->getResourceStore(j)->getAmount();
+                    rt = unit->owner->getType()->getResourceStore(j)->getType();
+                }
+            }
+            int freeWealth = unit->owner->getSResource(rt)->getAmount() - minWealth;
+            if (unit->owner->getType()->hasTag("fort")) {
+                freeWealth = unit->owner->getFaction()->getSResource(rt)->getAmount() - minWealth;
+            }
+            if (freeWealth > 50) {
+                Unit *producer = NULL;
+                producer = goalSystem.findGuild(unit);
+                if (producer != NULL) {
+                    topGoal = goal;
+                }
+            }
+        } else if (goalName == Goal::PROCURE) {
+            const ResourceType *rt = NULL;
+            int minWealth = 0;
+            for (int j = 0; j < unit->owner->getType()->getResourceStoreCount(); ++j) {
+                if (unit->owner->getType()->getResourceStore(j)->getType() == g_world.getTechTree()->getResourceType("wealth")) {
+                    minWealth = unit->owner->getType()->getResourceStore(j)->getAmount();
+                    rt = unit->owner->getType()->getResourceStore(j)->getType();
+                }
+            }
+            int freeWealth = unit->owner->getSResource(rt)->getAmount() - minWealth;
+            if (unit->owner->getType()->hasTag("fort")) {
+                freeWealth = unit->owner->getFaction()->getSResource(rt)->getAmount() - minWealth;
+            }
+            if (freeWealth > 50 && (unit->owner->getRequisitionCount() > 0 || unit->getRequisitionCount() > 0)) {
+                Unit *producer = NULL;
+                producer = goalSystem.findGuildItem(unit);
+                if (producer != NULL) {
+                    topGoal = goal;
+                }
+            }
+        } else if (goalName == Goal::EXPLORE) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::SHOP) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalSystem.findShop(unit) != NULL) {
+                    int goldOwned = unit->getSResource(g_world.getTechTree()->getResourceType("wealth"))->getAmount();
+                    int importanceShop = goldOwned / 100;
+                    if (goalImportance + importanceShop > topGoal.getImportance()) {
                         topGoal = goal;
-                        return topGoal;
                     }
-                } else if (goalName == Goal::COLLECT) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
-                            topGoal = goal;
-                        }
-                    } else {
-                        topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::DEMOLISH) {
+            if (topGoal.getImportance() != NULL) {
+                int importanceRaid = 0;
+                Vec2i tPos = Vec2i(0,0);
+                Unit *lair = goalSystem.findLair(unit);
+                if (lair != NULL) {
+                    tPos = lair->getPos();
+                }
+                if (tPos != Vec2i(0,0)) {
+                    Vec2i uPos = unit->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    if (distance < 100) {
+                        importanceRaid = 100 - distance;
                     }
-                } else if (goalName == Goal::TRANSPORT) {
-                    Unit *producer = NULL;
-                    producer = goalSystem.findProducer(unit);
-                    if (producer != NULL) {
+                    if (goalImportance + importanceRaid > topGoal.getImportance()) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::TRADE) {
-                    const ResourceType *rt = NULL;
-                    int minWealth = 0;
-                    for (int j = 0; j < unit->owner->getType()->getResourceStoreCount(); ++j) {
-                        if (unit->owner->getType()->getResourceStore(j)->getType() == g_world.getTechTree()->getResourceType("wealth")) {
-                            minWealth = unit->owner->getType()->getResourceStore(j)->getAmount();
-                            rt = unit->owner->getType()->getResourceStore(j)->getType();
-                        }
-                    }
-                    int freeWealth = unit->owner->getSResource(rt)->getAmount() - minWealth;
-                    if (unit->owner->getType()->hasTag("fort")) {
-                        freeWealth = unit->owner->getFaction()->getSResource(rt)->getAmount() - minWealth;
-                    }
-                    if (freeWealth > 50) {
-                        Unit *producer = NULL;
-                        producer = goalSystem.findGuild(unit);
-                        if (producer != NULL) {
-                            topGoal = goal;
-                        }
-                    }
-                } else if (goalName == Goal::PROCURE) {
-                    const ResourceType *rt = NULL;
-                    int minWealth = 0;
-                    for (int j = 0; j < unit->owner->getType()->getResourceStoreCount(); ++j) {
-                        if (unit->owner->getType()->getResourceStore(j)->getType() == g_world.getTechTree()->getResourceType("wealth")) {
-                            minWealth = unit->owner->getType()->getResourceStore(j)->getAmount();
-                            rt = unit->owner->getType()->getResourceStore(j)->getType();
-                        }
-                    }
-                    int freeWealth = unit->owner->getSResource(rt)->getAmount() - minWealth;
-                    if (unit->owner->getType()->hasTag("fort")) {
-                        freeWealth = unit->owner->getFaction()->getSResource(rt)->getAmount() - minWealth;
-                    }
-                    if (freeWealth > 50 && (unit->owner->getRequisitionCount() > 0 || unit->getRequisitionCount() > 0)) {
-                        Unit *producer = NULL;
-                        producer = goalSystem.findGuildItem(unit);
-                        if (producer != NULL) {
-                            topGoal = goal;
-                        }
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::RAID) {
+            if (topGoal.getImportance() != NULL) {
+                int importanceRaid = 0;
+                Vec2i tPos = Vec2i(0,0);
+                Unit *lair = goalSystem.findLair(unit);
+                if (lair != NULL) {
+                    tPos = lair->getPos();
+                }
+                if (tPos != Vec2i(0,0)) {
+                    Vec2i uPos = unit->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    if (distance < 50) {
+                        importanceRaid = 50 - distance;
                     }
-                } else if (goalName == Goal::EXPLORE) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
-                            topGoal = goal;
-                        }
-                    } else {
+                    if (goalImportance + importanceRaid > topGoal.getImportance()) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::SHOP) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalSystem.findShop(unit) != NULL) {
-                            int goldOwned = unit->getSResource(g_world.getTechTree()->getResourceType("wealth"))->getAmount();
-                            int importanceShop = goldOwned / 100;
-                            if (goalImportance + importanceShop > topGoal.getImportance()) {
-                                topGoal = goal;
-                            }
-                        }
-                    } else {
-                        topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::HUNT) {
+            if (topGoal.getImportance() != NULL) {
+                int importanceHunt = 0;
+                Vec2i tPos = Vec2i(0,0);
+                Unit *creature = goalSystem.findCreature(unit, 50);
+                if (creature != NULL) {
+                    tPos = creature->getPos();
+                }
+                if (tPos != Vec2i(0,0)) {
+                    Vec2i uPos = unit->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    if (distance < 50) {
+                        importanceHunt = 50 - distance;
                     }
-                } else if (goalName == Goal::DEMOLISH) {
-                    if (topGoal.getImportance() != NULL) {
-                        int importanceRaid = 0;
-                        Vec2i tPos = Vec2i(0,0);
-                        Unit *lair = goalSystem.findLair(unit);
-                        if (lair != NULL) {
-                            tPos = lair->getPos();
-                        }
-                        if (tPos != Vec2i(0,0)) {
-                            Vec2i uPos = unit->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            if (distance < 100) {
-                                importanceRaid = 100 - distance;
-                            }
-                            if (goalImportance + importanceRaid > topGoal.getImportance()) {
-                                topGoal = goal;
-                            }
-                        }
-                    } else {
+                    if (goalImportance + importanceHunt > topGoal.getImportance()) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::RAID) {
-                    if (topGoal.getImportance() != NULL) {
-                        int importanceRaid = 0;
-                        Vec2i tPos = Vec2i(0,0);
-                        Unit *lair = goalSystem.findLair(unit);
-                        if (lair != NULL) {
-                            tPos = lair->getPos();
-                        }
-                        if (tPos != Vec2i(0,0)) {
-                            Vec2i uPos = unit->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            if (distance < 50) {
-                                importanceRaid = 50 - distance;
-                            }
-                            if (goalImportance + importanceRaid > topGoal.getImportance()) {
-                                topGoal = goal;
-                            }
-                        }
-                    } else {
-                        topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::PATROL) {
+            if (topGoal.getImportance() != NULL) {
+                int importanceHunt = 0;
+                Vec2i tPos = Vec2i(0,0);
+                Unit *creature = goalSystem.findCreature(unit, 8);
+                if (creature != NULL) {
+                    tPos = creature->getPos();
+                }
+                if (tPos != Vec2i(0,0)) {
+                    Vec2i uPos = unit->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    if (distance < 8) {
+                        importanceHunt = 5 - distance;
                     }
-                } else if (goalName == Goal::HUNT) {
-                    if (topGoal.getImportance() != NULL) {
-                        int importanceHunt = 0;
-                        Vec2i tPos = Vec2i(0,0);
-                        Unit *creature = goalSystem.findCreature(unit, 50);
-                        if (creature != NULL) {
-                            tPos = creature->getPos();
-                        }
-                        if (tPos != Vec2i(0,0)) {
-                            Vec2i uPos = unit->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            if (distance < 50) {
-                                importanceHunt = 50 - distance;
-                            }
-                            if (goalImportance + importanceHunt > topGoal.getImportance()) {
-                                topGoal = goal;
-                            }
-                        }
-                    } else {
+                    if (goalImportance + importanceHunt > topGoal.getImportance()) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::PATROL) {
-                    if (topGoal.getImportance() != NULL) {
-                        int importanceHunt = 0;
-                        Vec2i tPos = Vec2i(0,0);
-                        Unit *creature = goalSystem.findCreature(unit, 8);
-                        if (creature != NULL) {
-                            tPos = creature->getPos();
-                        }
-                        if (tPos != Vec2i(0,0)) {
-                            Vec2i uPos = unit->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            if (distance < 8) {
-                                importanceHunt = 5 - distance;
-                            }
-                            if (goalImportance + importanceHunt > topGoal.getImportance()) {
-                                topGoal = goal;
-                            }
-                        }
-                    } else {
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::FOCUSFIRE) {
+            if (unit->owner) {
+                if (topGoal.getImportance() != NULL) {
+                    if (unit->owner->getGoalStructure() && unit->owner->getCurrCommand()->getType()->getClass() != CmdClass::ATTACK) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::FOCUSFIRE) {
-                    if (unit->owner) {
-                        if (topGoal.getImportance() != NULL) {
-                            if (unit->owner->getGoalStructure() && unit->owner->getCurrCommand()->getType()->getClass() != CmdClass::ATTACK) {
-                                topGoal = goal;
-                            }
-                        } else {
-                            topGoal = goal;
-                        }
-                    }
-                } else if (goalName == Goal::ATTACK) {
-                    if (unit->attackers.size() > 0) {
-                        if (topGoal.getImportance() != NULL) {
-                            int importanceAttack = unit->attackers.size() * 5;
-                            if (goalImportance + importanceAttack > topGoal.getImportance() && unit->attackers.size() > 0) {
-                                topGoal = goal;
-                            }
-                        } else {
-                            topGoal = goal;
-                        }
-                    }
-                } else if (goalName == Goal::DEFEND) {
-                    if (unit->owner->attackers.size() > 0) {
-                        if (topGoal.getImportance() != NULL) {
-                            Vec2i uPos = unit->getPos();
-                            if (unit->isCarried()) {
-                                uPos = unit->owner->getPos();
-                            }
-                            Vec2i tPos = unit->owner->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            int importanceDefend = unit->owner->attackers.size() * 10;
-                            if (distance < 100 + importanceDefend) {
-                                if (goalImportance + importanceDefend > topGoal.getImportance()) {
-                                    topGoal = goal;
-                                }
-                            }
-                        } else {
-                            topGoal = goal;
-                        }
-                    }
-                } else if (goalName == Goal::FOLLOW) {
-                    if (unit->owner) {
-                        if (topGoal.getImportance() != NULL) {
-                            Vec2i uPos = unit->getPos();
-                            if (unit->isCarried()) {
-                                uPos = unit->owner->getPos();
-                            }
-                            Vec2i tPos = unit->owner->getPos();
-                            int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
-                            if (distance > 5) {
-                                if (goalImportance + distance > topGoal.getImportance()) {
-                                    topGoal = goal;
-                                }
-                            }
-                        } else {
-                            topGoal = goal;
-                        }
-                    }
-                } else if (goalName == Goal::BUFF) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
-                            topGoal = goal;
-                        }
-                    } else {
+                } else {
+                    topGoal = goal;
+                }
+            }
+        } else if (goalName == Goal::ATTACK) {
+            if (unit->attackers.size() > 0) {
+                if (topGoal.getImportance() != NULL) {
+                    int importanceAttack = unit->attackers.size() * 5;
+                    if (goalImportance + importanceAttack > topGoal.getImportance() && unit->attackers.size() > 0) {
                         topGoal = goal;
                     }
-                } else if (goalName == Goal::HEAL) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
-                            topGoal = goal;
-                        }
-                    } else {
-                        topGoal = goal;
+                } else {
+                    topGoal = goal;
+                }
+            }
+        } else if (goalName == Goal::DEFEND) {
+            if (unit->owner->attackers.size() > 0) {
+                if (topGoal.getImportance() != NULL) {
+                    Vec2i uPos = unit->getPos();
+                    if (unit->isCarried()) {
+                        uPos = unit->owner->getPos();
                     }
-                } else if (goalName == Goal::SPELL) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
+                    Vec2i tPos = unit->owner->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    int importanceDefend = unit->owner->attackers.size() * 10;
+                    if (distance < 100 + importanceDefend) {
+                        if (goalImportance + importanceDefend > topGoal.getImportance()) {
                             topGoal = goal;
                         }
-                    } else {
-                        topGoal = goal;
                     }
-                } else if (goalName == Goal::REST) {
-                    if (topGoal.getImportance() != NULL) {
-                        if (goalImportance > topGoal.getImportance()) {
+                } else {
+                    topGoal = goal;
+                }
+            }
+        } else if (goalName == Goal::FOLLOW) {
+            if (unit->owner) {
+                if (topGoal.getImportance() != NULL) {
+                    Vec2i uPos = unit->getPos();
+                    if (unit->isCarried()) {
+                        uPos = unit->owner->getPos();
+                    }
+                    Vec2i tPos = unit->owner->getPos();
+                    int distance = sqrt(pow(float(abs(uPos.x - tPos.x)), 2) + pow(float(abs(uPos.y - tPos.y)), 2));
+                    if (distance > 5) {
+                        if (goalImportance + distance > topGoal.getImportance()) {
                             topGoal = goal;
                         }
-                    } else {
-                        topGoal = goal;
                     }
+                } else {
+                    topGoal = goal;
                 }
             }
+        } else if (goalName == Goal::BUFF) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::HEAL) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::SPELL) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
+        } else if (goalName == Goal::REST) {
+            if (topGoal.getImportance() != NULL) {
+                if (goalImportance > topGoal.getImportance()) {
+                    topGoal = goal;
+                }
+            } else {
+                topGoal = goal;
+            }
         }
     }
     return topGoal;
 }
 
-void MandateAISim::computeAction(Unit *unit, string personality, string reason) {
-    if (reason == "compute") {
+void MandateAISim::computeAction(Unit *unit, const Personality *personality, GoalReason reason) {
+    if (reason == GoalReason::COMPUTE) {
         Focus newFocus = getTopGoal(unit, personality);
         goalSystem.computeAction(unit, newFocus);
-    } else if (reason == "follow") {
+    } else if (reason == GoalReason::FOLLOW) {
         if (unit->getGoalStructure() != NULL) {
             if (unit->anyCommand()) {
                 if (unit->getCurrCommand()->getType()->getClass() != CmdClass::MOVE) {
@@ -337,7 +364,7 @@ void MandateAISim::computeAction(Unit *unit, string personality, string reason)
                 }
             }
         }
-    } else if (reason == "kill") {
+    } else if (reason == GoalReason::KILL) {
         if (unit->getGoalStructure() != NULL) {
             if (unit->anyCommand()) {
                 if (unit->getCurrCommand()->getType()->getClass() != CmdClass::ATTACK) {
@@ -346,7 +373,7 @@ void MandateAISim::computeAction(Unit *unit, string personality, string reason)
                 }
             }
         }
-    } else if (reason == "collect") {
+    } else if (reason == GoalReason::COLLECT) {
         if (unit->getGoalStructure() != NULL) {
             Vec2i posUnit = unit->getPos();
             Vec2i posGoal = unit->getGoalStructure()->getPos();
@@ -371,13 +398,13 @@ void MandateAISim::computeAction(Unit *unit, string personality, string reason)
                         unit->getGoalStructure()->taxedGold = unit->getGoalStructure()->getSResource(rt)->getAmount();
                     }
                 }
-                unit->setGoalReason("deliver");
+                unit->setGoalReason(GoalReason::DELIVER);
                 unit->setGoalStructure(unit->owner);
                 const CommandType *ct = unit->getType()->getActions()->getFirstCtOfClass(CmdClass::MOVE);
                 unit->giveCommand(g_world.newCommand(ct, CmdFlags(), unit->getGoalStructure()->getPos()));
             }
         }
-    } else if (reason == "deliver") {
+    } else if (reason == GoalReason::DELIVER) {
         if (unit->getGoalStructure() != NULL) {
             Vec2i posUnit = unit->getPos();
             Vec2i posGoal = unit->owner->getPos();
@@ -390,66 +417,73 @@ void MandateAISim::computeAction(Unit *unit, string personality, string reason)
                     unit->getGoalStructure()->getFaction()->incResourceAmount(rt, taxes);
                 }
                 unit->productionRoute.setProducerId(-1);
-                unit->setGoalReason("compute");
+                unit->setGoalReason(GoalReason::COMPUTE);
                 unit->setGoalStructure(NULL);
             }
         }
     }
 }
 
+/** look at the units the scheduler picks for this frame */
 void MandateAISim::update() {
-    for (int i = 0; i < faction->getUnitCount(); ++i) {
-        Unit *unit = faction->getUnit(i);
-        string personality = unit->getType()->personality;
-        string reason = "compute";
-        if (unit->getType()->inhuman) {
-            if (unit->getGoalStructure() != NULL) {
-                if (!unit->getGoalStructure()->isAlive() || unit->getGoalStructure()->isCarried() || unit->getGoalStructure()->isGarrisoned()) {
-                    unit->setGoalStructure(NULL);
-                    unit->setCurrentFocus("");
-                    unit->setGoalReason("compute");
-                    if (unit->anyCommand()) {
-                        if (unit->getCurrCommand()->getType()->getClass() == CmdClass::ATTACK) {
-                            unit->finishCommand();
-                        }
-                    }
+    vector<Unit*> agents;
+    scheduler.schedule(faction, agents);
+    const int frame = world->getFrameCount();
+    for (int i = 0; i < agents.size(); ++i) {
+        Unit *unit = agents[i];
+        if (unit->getType()->inhuman && unit->isAlive() && unit->getLastAiUpdate() != frame) {
+            const int elapsed = unit->getLastAiUpdate() == -1 ? 1 : frame - unit->getLastAiUpdate();
+            unit->setLastAiUpdate(frame);
+            updateAgent(unit, elapsed);
+        }
+    }
+}
+
+/** an event unit's sim ai should react to, it is looked at next frame */
+void MandateAISim::wake(const Unit *unit) {
+    if (unit->getType()->inhuman && !faction->getCpuControl()) {
+        scheduler.wake(unit);
+    }
+}
+
+/** update unit, elapsed frames since it was last updated */
+void MandateAISim::updateAgent(Unit *unit, int elapsed) {
+    const Personality *personality = findPersonality(unit->getType());
+    if (unit->getGoalStructure() != NULL) {
+        if (!unit->getGoalStructure()->isAlive() || unit->getGoalStructure()->isCarried() || unit->getGoalStructure()->isGarrisoned()) {
+            unit->setGoalStructure(NULL);
+            unit->setCurrentFocus(Goal::INVALID);
+            unit->setGoalReason(GoalReason::COMPUTE);
+            if (unit->anyCommand()) {
+                if (unit->getCurrCommand()->getType()->getClass() == CmdClass::ATTACK) {
+                    unit->finishCommand();
                 }
             }
-            int minHp = fixed(unit->getStatistics()->getEnhancement()->getResourcePools()->
-                              getHealth()->getMaxStat()->getValue() * unit->getType()->live / 100).intp();
-            if (unit->getType()->hasTag("ordermember") && unit->getHp() <= minHp && !unit->isCarried()) {
-                goalSystem.clearSimAi(unit, Goal::LIVE);
-                Focus liveFocus;
-                liveFocus.init(Goal::LIVE, unit->getType()->live);
-                goalSystem.computeAction(unit, liveFocus);
+        }
+    }
+    int minHp = fixed(unit->getStatistics()->getEnhancement()->getResourcePools()->
+                      getHealth()->getMaxStat()->getValue() * unit->getType()->live / 100).intp();
+    static const int orderMemberTag = UnitType::getTagId("ordermember");
+    if (unit->getType()->hasTag(orderMemberTag) && unit->getHp() <= minHp && !unit->isCarried()) {
+        goalSystem.clearSimAi(unit, Goal::LIVE);
+        Focus liveFocus;
+        liveFocus.init(Goal::LIVE, unit->getType()->live);
+        goalSystem.computeAction(unit, liveFocus);
+    } else {
+        if (unit->isCarried() && unit->getCurrentFocus() == Goal::LIVE) {
+            int heal = unit->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue() / 10 / 40;
+            unit->repair(heal * elapsed, 1);
+        }
+        if (unit->isCarried() && unit->getCurrentFocus() == Goal::LIVE && unit->getHp() ==
+            unit->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue()) {
+            goalSystem.ownerUnload(unit);
+        }
+        if (unit->getCurrSkill()->getClass() == SkillClass::STOP) {
+            const GoalReason reason = unit->getGoalReason();
+            if (reason == GoalReason::KILL || reason == GoalReason::COLLECT || reason == GoalReason::DELIVER) {
+                computeAction(unit, personality, reason);
             } else {
-                if (unit->isCarried() && unit->getCurrentFocus() == "live") {
-                    int heal = unit->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue() / 10 / 40;
-                    unit->repair(heal, 1);
-                }
-                if (unit->isCarried() && unit->getCurrentFocus() == "live" && unit->getHp() ==
-                    unit->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue()) {
-                    goalSystem.ownerUnload(unit);
-                }
-                if (unit->getCurrSkill()->getClass() == SkillClass::STOP) {
-                    if (unit->getGoalReason() == "kill") {
-                        reason = "kill";
-                        computeAction(unit, personality, reason);
-                    } else if (unit->getGoalReason() == "collect") {
-                        reason = "collect";
-                        computeAction(unit, personality, reason);
-                    } else if (unit->getGoalReason() == "deliver") {
-                        reason = "deliver";
-                        computeAction(unit, personality, reason);
-                    } else {
-                        if (unit->currentAiUpdate[0].currentStep == 8) {
-                            computeAction(unit, personality, reason);
-                            unit->currentAiUpdate[0].currentStep = 0;
-                        } else {
-                            ++unit->currentAiUpdate[0].currentStep;
-                        }
-                    }
-                }
+                computeAction(unit, personality, GoalReason::COMPUTE);
             }
         }
     }
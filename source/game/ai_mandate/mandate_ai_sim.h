@@ -11,6 +11,7 @@
 
 #include "forward_decs.h"
 #include "mandate_ai_personalities.h"
+#include "mandate_ai_scheduler.h"
 
 using namespace Glest::Sim;
 using namespace Glest::Entities;
@@ -27,19 +28,26 @@ class MandateAISim {
 private:
     World *world;
     Faction *faction;
-    Personalities personalities;
+    Personalities personalities;	/**< one per name */
+    vector<int> typePersonalities;	/**< by UnitType id, index in personalities, -1 for none, -2 not looked up yet */
     GoalSystem goalSystem;
+    AgentScheduler scheduler;
+
+    void addPersonality(const Personality &personality);
+    void updateAgent(Unit *unit, int elapsed);
 
 public:
     const Personalities *getPersonalities() const {return &personalities;}
     const Personality *getPersonality(int i) const {return &personalities[i];}
+    const Personality *findPersonality(const UnitType *ut);
 
-    GoalSystem getGoalSystem() const {return goalSystem;}
+    GoalSystem &getGoalSystem() {return goalSystem;}
 
     void init(World *world, Faction *faction);
-    Focus getTopGoal(Unit *unit, string personality);
+    Focus getTopGoal(Unit *unit, const Personality *personality);
     void update();
-    void computeAction(Unit *unit, string personality, string reason);
+    void wake(const Unit *unit);
+    void computeAction(Unit *unit, const Personality *personality, GoalReason reason);
 
 };
 
@@ -41,9 +41,10 @@ bool DamageType::load(const XmlNode *baseNode) {
     return loadOk;
 }
 
-void DamageType::init(string name, int amount) {
+void DamageType::init(string name, int amount, int id) {
     type_name = name;
     value = amount;
+    this->id = id;
 }
 
 void DamageType::save(XmlNode *node) const {
@@ -97,12 +98,9 @@ bool Statistics::load(const XmlNode *baseNode, const string &dir) {
             for (int i = 0; i < resistancesNode->getChildCount(); ++i) {
                 const XmlNode *resistanceNode = resistancesNode->getChild("resistance", i);
                 string resistanceTypeName = resistanceNode->getAttribute("type")->getRestrictedValue();
-                //int amount = resistanceNode->getAttribute("value")->getIntValue();
-                for (int j = 0; j < resistances.size(); ++j) {
-                    if (resistanceTypeName == resistances[j].getTypeName()) {
-                        //resistances[j].setValue(amount);
-                        resistances[j].load(resistanceNode);
-                    }
+                int id = techTree->getDamageTypeId(resistanceTypeName);
+                if (id != -1) {
+                    resistances[id].load(resistanceNode);
                 }
             }
 	    }
@@ -116,12 +114,9 @@ bool Statistics::load(const XmlNode *baseNode, const string &dir) {
             for (int i = 0; i < damageTypesNode->getChildCount(); ++i) {
                 const XmlNode *damageTypeNode = damageTypesNode->getChild("damage-type", i);
                 string damageTypeName = damageTypeNode->getAttribute("type")->getRestrictedValue();
-                //int amount = damageTypeNode->getAttribute("value")->getIntValue();
-                for (int j = 0; j < damageTypes.size(); ++j) {
-                    if (damageTypeName == damageTypes[j].getTypeName()) {
-                        //damageTypes[j].setValue(amount);
-                        damageTypes[j].load(damageTypeNode);
-                    }
+                int id = techTree->getDamageTypeId(damageTypeName);
+                if (id != -1) {
+                    damageTypes[id].load(damageTypeNode);
                 }
             }
         }
@@ -215,45 +210,37 @@ void Statistics::sum(const Statistics *stats) {
     addResistancesAndDamage(stats);
 }
 
-void Statistics::addResistancesAndDamage(const Statistics *stats) {
-	for (int i = 0; i < stats->getResistanceCount(); ++i) {
-        string name = stats->getResistance(i)->getTypeName();
-        int value = stats->getResistance(i)->getValue();
-        DamageType dType;
-        dType.init(name, value);
-        if (resistances.size() == 0) {
-            resistances.push_back(dType);
-        } else {
-            for (int k = 0; k < resistances.size(); ++k) {
-                if (resistances[k].getTypeName() == dType.getTypeName()) {
-                    resistances[k].setValue(dType.getValue());
-                    break;
-                } else if (k == resistances.size()-1) {
-                    resistances.push_back(dType);
-                    break;
-                }
-            }
+/** add the values of dense list 'from' to 'to', which is dense too or empty */
+static void addDamageValues(DamageTypes &to, const DamageTypes &from) {
+    if (to.size() < from.size()) {
+        assert(to.empty());
+        to.resize(from.size());
+        for (int i = 0; i < from.size(); ++i) {
+            to[i].init(from[i].getTypeName(), 0, from[i].getId());
         }
     }
-	for (int i = 0; i < stats->getDamageTypeCount(); ++i) {
-        string name = stats->getDamageType(i)->getTypeName();
-        int value = stats->getDamageType(i)->getValue();
-        DamageType dType;
-        dType.init(name, value);
-        if (damageTypes.size() == 0) {
-            damageTypes.push_back(dType);
-        } else {
-            for (int k = 0; k < damageTypes.size(); ++k) {
-                if (damageTypes[k].getTypeName() == dType.getTypeName()) {
-                    damageTypes[k].setValue(dType.getValue());
-                    break;
-                } else if (k == damageTypes.size()-1) {
-                    damageTypes.push_back(dType);
-                    break;
-                }
-            }
+    for (int i = 0; i < from.size(); ++i) {
+        assert(to[i].getId() == from[i].getId());
+        to[i].setValue(from[i].getValue());
+    }
+}
+
+void Statistics::addResistancesAndDamage(const Statistics *stats) {
+    addDamageValues(resistances, stats->resistances);
+    addDamageValues(damageTypes, stats->damageTypes);
+}
+
+/** damage these damage types do to defender, for each type what is left after the
+  * defender's resistance to it, or nothing if the resistance is greater */
+int Statistics::getDamageAgainst(const Statistics *defender) const {
+    int total = 0;
+    for (int id = 0; id < damageTypes.size(); ++id) {
+        int damage = damageTypes[id].getValue() - defender->getResistanceValue(id);
+        if (damage > 0) {
+            total += damage;
         }
     }
+    return total;
 }
 
 // ===============================
@@ -20,18 +20,23 @@ using namespace Gui;
 class DamageType {
 private:
     string type_name;
+    int id;     /**< index of the type in the tech tree's damage types, -1 if not interned */
     int value;
     Stat creatorCost;
 
 public:
+    DamageType() : id(-1), value(0) {}
+
     const Stat *getCreatorCost() const {return &creatorCost;}
     string getTypeName() const {return type_name;}
+    int getId() const {return id;}
     int getValue() const {return value;}
     void setValue(int i) {value = value + i;}
+    void setId(int i) {id = i;}
 
 	void getDesc(string &str, const char *pre) const;
 
-    void init(const string name, const int amount);
+    void init(const string name, const int amount, int id = -1);
     bool load(const XmlNode *baseNode);
     void save(XmlNode *node) const;
 };
@@ -41,6 +46,8 @@ public:
 // ===============================
 typedef vector<DamageType> DamageTypes;
 
+/** Damage types and resistances are dense, either empty or one entry for every damage
+  * type of the tech tree, indexed by DamageType id, so they merge element by element */
 class Statistics {
 public:
     EnhancementType enhancement;
@@ -57,6 +64,9 @@ public:
     const DamageType *getResistance(int i) const {return &resistances[i];}
     DamageType *getDamageType(int i) {return &damageTypes[i];}
     DamageType *getResistance(int i) {return &resistances[i];}
+    int getDamageValue(int id) const {return id < damageTypes.size() ? damageTypes[id].getValue() : 0;}
+    int getResistanceValue(int id) const {return id < resistances.size() ? resistances[id].getValue() : 0;}
+    int getDamageAgainst(const Statistics *defender) const;
     bool load(const XmlNode *baseNode, const string &dir);
     bool isEmpty() const;
     void sum(const Statistics *stats);
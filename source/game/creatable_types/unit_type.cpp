@@ -111,10 +111,49 @@ void PetRule::load(const XmlNode *prn, const string &dir, const TechTree *tt, co
 }
 */
 
+// ===============================
+// 	class TagSet
+// ===============================
+
+void TagSet::add(int id) {
+	assert(id >= 0);
+	if (has(id)) {
+		return;
+	}
+	const unsigned w = unsigned(id) >> 5;
+	if (w >= m_words.size()) {
+		m_words.resize(w + 1, 0);
+	}
+	m_words[w] |= Word(1) << (id & 31);
+	m_ids.push_back(id);
+}
+
 // =====================================================
 // 	class UnitType
 // =====================================================
 
+/** tag name to id, shared by all unit types of all tech trees loaded */
+static map<string, int> tagIds;
+
+int UnitType::getTagId(const string &tag) {
+	map<string, int>::iterator it = tagIds.find(tag);
+	if (it != tagIds.end()) {
+		return it->second;
+	}
+	const int id = tagIds.size();
+	tagIds[tag] = id;
+	return id;
+}
+
+int UnitType::findTagId(const string &tag) {
+	map<string, int>::const_iterator it = tagIds.find(tag);
+	return it == tagIds.end() ? -1 : it->second;
+}
+
+int UnitType::getTagCount() {
+	return tagIds.size();
+}
+
 // ===================== PUBLIC ========================
 
 
@@ -246,7 +285,7 @@ bool UnitType::load(const string &dir, const TechTree *techTree, const FactionTy
 			for (int i = 0; i < tagsNode->getChildCount(); ++i) {
 				const XmlNode *tagNode = tagsNode->getChild("tag", i);
 				string tag = tagNode->getRestrictedValue();
-				m_tags.insert(tag);
+				m_tags.add(getTagId(tag));
 			}
 		}
 	} catch (runtime_error &e) {
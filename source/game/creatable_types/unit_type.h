@@ -61,6 +61,26 @@ public:
     bool load(const XmlNode *bonusPowerNode, const string &dir, const TechTree *techTree, const FactionType *factionType);
 };
 
+// ===============================
+// 	class TagSet
+// ===============================
+/** The tags of a unit type as a bitset of interned tag ids, see UnitType::getTagId() */
+class TagSet {
+private:
+	typedef Shared::Platform::uint32 Word;
+	vector<Word> m_words;
+	vector<int>  m_ids;	/**< the set ids, in the order added */
+
+public:
+	void add(int id);
+	bool has(int id) const {
+		const unsigned w = unsigned(id) >> 5;
+		return id >= 0 && w < m_words.size() && (m_words[w] >> (id & 31)) & 1;
+	}
+	int  getCount() const		{ return m_ids.size(); }
+	int  getId(int i) const		{ return m_ids[i]; }
+};
+
 // ===============================
 // 	class UnitType
 //
@@ -117,7 +137,7 @@ private:
     Vec3f lightColour;
 	CloakType	  *m_cloakType;
 	DetectorType  *m_detectorType;
-	set<string> m_tags;
+	TagSet m_tags;
 	SoundContainer selectionSounds;
 	SoundContainer commandSounds;
 	LoadBonuses loadBonuses;
@@ -185,7 +205,15 @@ public:
 	Vec3f getLightColour() const			{return lightColour;}
 	Field getField() const					{return field;}
 	Zone getZone() const					{return zone;}
-	bool hasTag(const string &tag) const	{return m_tags.find(tag) != m_tags.end();}
+	bool hasTag(const string &tag) const	{return m_tags.has(findTagId(tag));}
+	bool hasTag(int tagId) const			{return m_tags.has(tagId);}
+	const TagSet& getTags() const			{return m_tags;}
+
+	/** id of tag, interning it if it hasn't been seen yet, ids are small & dense from 0 */
+	static int getTagId(const string &tag);
+	/** id of tag, or -1 if no unit type has it */
+	static int findTagId(const string &tag);
+	static int getTagCount();
 	const UnitProperties &getProperties() const	{return properties;}
 	bool getProperty(Property property) const	{return properties.get(property);}
 	const MoveSkillType *getFirstMoveSkill() const			{
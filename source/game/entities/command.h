@@ -144,6 +144,7 @@ public:
 	bool isAuto() const							{return flags.get(CmdProps::AUTO);}
 	bool isReserveResources() const				{return !flags.get(CmdProps::DONT_RESERVE_RESOURCES);}
 	bool isMiscEnabled() const					{return flags.get(CmdProps::MISC_ENABLE);}
+	bool isGroupMove() const					{return flags.get(CmdProps::GROUP_MOVE);}
 	Vec2i getPos() const						{return pos;}
 	Vec2i getPos2() const						{return pos2;}
 	UnitId getUnitRef() const					{return unitRef;}
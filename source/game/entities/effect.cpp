@@ -47,18 +47,7 @@ Effect::Effect(CreateParams params)
 	if (type->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getRegenStat()->getValue() < 0) {
         this->actualHpRegen = type->getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getRegenStat()->getValue();
     } else if (type->getStatistics()->getDamageTypeCount() > 0) {
-        for (int i = 0; i < type->getStatistics()->getDamageTypeCount(); ++i) {
-            const DamageType *damage = type->getStatistics()->getDamageType(i);
-            for (int j = 0; j < params.recipient->getStatistics()->getResistanceCount(); ++j) {
-                const DamageType *resistance = params.recipient->getStatistics()->getResistance(j);
-                if (damage->getTypeName() == resistance->getTypeName()) {
-                    int damageChange = damage->getValue() - resistance->getValue();
-                    if (damageChange > 0) {
-                        this->actualHpRegen -= damageChange;
-                    }
-                }
-            }
-        }
+        this->actualHpRegen -= type->getStatistics()->getDamageAgainst(params.recipient->getStatistics());
     }
 }
 
@@ -38,7 +38,8 @@ STRINGY_ENUM( CmdProps,
 	QUEUE,
 	AUTO,
 	DONT_RESERVE_RESOURCES,
-	MISC_ENABLE
+	MISC_ENABLE,
+	GROUP_MOVE
 );
 
 /** Command Directives */
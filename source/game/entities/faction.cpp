@@ -480,6 +480,7 @@ void Faction::finishUpgrade(const UpgradeType *ut) {
 			m_createModifiers[unitType][resType].m_multiplier += (mod.getMultiplier() - 1);
 		}
 	}
+	recomputeUpkeep();
 	// update store caps
 	reEvaluateStore();
 }
@@ -955,17 +956,21 @@ void Faction::applyCostsOnInterval(const ResourceType *rt) {
 		return;
 	}
 	// increment consumables
-	for (int j = 0; j < getUnitCount(); ++j) {
-		Unit *unit = getUnit(j);
-		if (unit->isOperative()) {
-			const ResourceAmount resource = unit->getType()->getCost(rt, this);
-			if (resource.getType() && resource.getAmount() < 0) {
-				incResourceAmount(resource.getType(), -resource.getAmount());
-			}
-		}
+	const int produced = getUpkeepProduced(rt);
+	if (produced) {
+		incResourceAmount(rt, produced);
 	}
 
-	//decrement consumables
+	//decrement consumables, all at once if there's enough to go round
+	const int consumed = getUpkeepConsumed(rt);
+	if (consumed <= getSResource(rt)->getAmount()) {
+		if (consumed) {
+			incResourceAmount(rt, -consumed);
+		}
+		capResource(rt);
+		return;
+	}
+	// else unit by unit, those that go short are damaged
 	for (int j = 0; j < getUnitCount(); ++j) {
 		Unit *unit = getUnit(j);
 		if (unit->isOperative()) {
@@ -1122,10 +1127,19 @@ void Faction::setResourceBalance(const ResourceType *rt, int balance) {
 	assert(false);
 }
 
+/** units are live from when they are added until they are killed (dead units
+  * loaded from a saved game are in their die skill) */
+static bool isLive(const Unit *unit) {
+	return !unit->getCurrSkill() || unit->getCurrSkill()->getClass() != SkillClass::DIE;
+}
+
 void Faction::add(Unit *unit) {
 //	LOG_NETWORK( "Faction: " + intToStr(id) + " unit added Id: " + intToStr(unit->getId()) );
 	units.push_back(unit);
 	unitMap[unit->getId()] = unit;
+	if (isLive(unit)) {
+		indexUnit(unit, unit->getType());
+	}
 }
 
 void Faction::remove(Unit *unit) {
@@ -1134,6 +1148,231 @@ void Faction::remove(Unit *unit) {
 	units.erase(it);
 	unitMap.erase(unit->getId());
 	assert(units.size() == unitMap.size());
+	unindexUnit(unit, unit->getType()); // normally done already, by onUnitDied()
+}
+
+/** take a dead unit out of the live unit indexes, it stays in units until undertaken */
+void Faction::onUnitDied(Unit *unit) {
+	unindexUnit(unit, unit->getType());
+}
+
+/** keep the live unit indexes current when a unit morphs or transforms */
+void Faction::unitTypeChanged(Unit *unit, const UnitType *oldType) {
+	unindexUnit(unit, oldType);
+	if (isLive(unit)) {
+		indexUnit(unit, unit->getType());
+	}
+}
+
+const Units& Faction::getUnitsWithTag(int tagId) const {
+	static const Units none;
+	if (tagId < 0 || tagId >= int(m_unitsByTag.size())) {
+		return none;
+	}
+	return m_unitsByTag[tagId];
+}
+
+const Units& Faction::getUnitsOfType(const UnitType *ut) const {
+	static const Units none;
+	if (ut->getId() < 0 || ut->getId() >= int(m_unitsByType.size())) {
+		return none;
+	}
+	return m_unitsByType[ut->getId()];
+}
+
+/** position of unit in units, for the index based AiInterface, -1 if not in this faction */
+int Faction::getUnitIndex(const Unit *unit) const {
+	Units::const_iterator it = std::find(units.begin(), units.end(), unit);
+	return it == units.end() ? -1 : int(it - units.begin());
+}
+
+static bool unitIdLess(const Unit *a, const Unit *b) {
+	return a->getId() < b->getId();
+}
+
+/** insert unit into list, which is kept sorted by unit id so the indexes
+  * are the same on all peers whatever order units were added in */
+static void insertById(Units &list, Unit *unit) {
+	Units::iterator it = std::lower_bound(list.begin(), list.end(), unit, unitIdLess);
+	assert(it == list.end() || *it != unit);
+	list.insert(it, unit);
+}
+
+/** @return false if unit wasn't in list */
+static bool eraseById(Units &list, Unit *unit) {
+	Units::iterator it = std::lower_bound(list.begin(), list.end(), unit, unitIdLess);
+	if (it == list.end() || *it != unit) {
+		return false;
+	}
+	list.erase(it);
+	return true;
+}
+
+void Faction::indexUnit(Unit *unit, const UnitType *ut) {
+	if (ut->getId() >= int(m_unitsByType.size())) {
+		m_unitsByType.resize(ut->getId() + 1);
+	}
+	insertById(m_unitsByType[ut->getId()], unit);
+
+	const TagSet &tags = ut->getTags();
+	for (int i = 0; i < tags.getCount(); ++i) {
+		const int tagId = tags.getId(i);
+		if (tagId >= int(m_unitsByTag.size())) {
+			m_unitsByTag.resize(tagId + 1);
+		}
+		insertById(m_unitsByTag[tagId], unit);
+	}
+	foreach_enum (CmdClass, cc) {
+		if (ut->getActions()->hasCommandClass(cc)) {
+			insertById(m_unitsByCmdClass[cc], unit);
+		}
+	}
+}
+
+void Faction::unindexUnit(Unit *unit, const UnitType *ut) {
+	if (ut->getId() >= int(m_unitsByType.size())
+	|| !eraseById(m_unitsByType[ut->getId()], unit)) {
+		return; // not indexed, dead already
+	}
+	const TagSet &tags = ut->getTags();
+	for (int i = 0; i < tags.getCount(); ++i) {
+		bool found = eraseById(m_unitsByTag[tags.getId(i)], unit);
+		assert(found);
+	}
+	foreach_enum (CmdClass, cc) {
+		if (ut->getActions()->hasCommandClass(cc)) {
+			bool found = eraseById(m_unitsByCmdClass[cc], unit);
+			assert(found);
+		}
+	}
+}
+
+#ifndef NDEBUG
+/** cross check the live unit indexes against a scan of all units */
+void Faction::checkUnitIndexes() const {
+	vector<Units> byType(m_unitsByType.size());
+	vector<Units> byTag(m_unitsByTag.size());
+	Units byCmdClass[CmdClass::COUNT];
+	foreach_const (Units, it, units) {
+		Unit *unit = *it;
+		if (!isLive(unit)) {
+			continue;
+		}
+		const UnitType *ut = unit->getType();
+		RUNTIME_CHECK_MSG(ut->getId() < int(byType.size()),
+			"unit " << unit->getId() << " of type " << ut->getName() << " not indexed");
+		byType[ut->getId()].push_back(unit);
+		for (int i = 0; i < ut->getTags().getCount(); ++i) {
+			RUNTIME_CHECK(ut->getTags().getId(i) < int(byTag.size()));
+			byTag[ut->getTags().getId(i)].push_back(unit);
+		}
+		foreach_enum (CmdClass, cc) {
+			if (ut->getActions()->hasCommandClass(cc)) {
+				byCmdClass[cc].push_back(unit);
+			}
+		}
+	}
+	for (int i = 0; i < byType.size(); ++i) {
+		std::sort(byType[i].begin(), byType[i].end(), unitIdLess);
+		RUNTIME_CHECK_MSG(byType[i] == m_unitsByType[i], "faction " << m_id << ", unit type " << i);
+	}
+	for (int i = 0; i < byTag.size(); ++i) {
+		std::sort(byTag[i].begin(), byTag[i].end(), unitIdLess);
+		RUNTIME_CHECK_MSG(byTag[i] == m_unitsByTag[i], "faction " << m_id << ", tag " << i);
+	}
+	foreach_enum (CmdClass, cc) {
+		std::sort(byCmdClass[cc].begin(), byCmdClass[cc].end(), unitIdLess);
+		RUNTIME_CHECK_MSG(byCmdClass[cc] == m_unitsByCmdClass[cc], "faction " << m_id << ", " << CmdClassNames[cc]);
+	}
+}
+
+/** cross check the upkeep counts & totals against a scan of all units */
+void Faction::checkUpkeep() const {
+	UnitTypeCountMap counts;
+	foreach_const (Units, it, units) {
+		if ((*it)->getUpkeepType()) {
+			++counts[(*it)->getUpkeepType()];
+		}
+	}
+	foreach_const (UnitTypeCountMap, it, m_upkeepCounts) {
+		RUNTIME_CHECK_MSG(it->second == (counts.count(it->first) ? counts[it->first] : 0),
+			"faction " << m_id << ", upkeep count of " << it->first->getName());
+	}
+	RUNTIME_CHECK_MSG(counts.size() == m_upkeepCounts.size(), "faction " << m_id << ", upkeep counts");
+
+	vector<int> produced(m_upkeepProduced.size(), 0), consumed(m_upkeepConsumed.size(), 0);
+	foreach_const (UnitTypeCountMap, it, counts) {
+		for (int i = 0; i < it->first->getCostCount(); ++i) {
+			const ResourceAmount cost = it->first->getCost(i, this);
+			if (cost.getType()->getClass() == ResourceClass::CONSUMABLE) {
+				vector<int> &totals = cost.getAmount() > 0 ? consumed : produced;
+				RUNTIME_CHECK(cost.getType()->getId() < int(totals.size()));
+				totals[cost.getType()->getId()] += it->second * abs(cost.getAmount());
+			}
+		}
+	}
+	RUNTIME_CHECK_MSG(produced == m_upkeepProduced && consumed == m_upkeepConsumed,
+		"faction " << m_id << ", upkeep totals");
+}
+#endif
+
+/** start (count > 0) or stop (count < 0) charging the upkeep of count units of type ut */
+void Faction::applyUpkeep(const UnitType *ut, int count) {
+	int &n = m_upkeepCounts[ut];
+	n += count;
+	assert(n >= 0);
+	if (!n) {
+		m_upkeepCounts.erase(ut);
+	}
+	applyUpkeepCosts(ut, count);
+}
+
+void Faction::applyUpkeepCosts(const UnitType *ut, int count) {
+	for (int i = 0; i < ut->getCostCount(); ++i) {
+		const ResourceAmount cost = ut->getCost(i, this);
+		const ResourceType *rt = cost.getType();
+		if (rt->getClass() != ResourceClass::CONSUMABLE || !cost.getAmount()) {
+			continue;
+		}
+		if (rt->getId() >= int(m_upkeepConsumed.size())) {
+			m_upkeepProduced.resize(rt->getId() + 1, 0);
+			m_upkeepConsumed.resize(rt->getId() + 1, 0);
+		}
+		if (cost.getAmount() > 0) {
+			m_upkeepConsumed[rt->getId()] += count * cost.getAmount();
+		} else {
+			m_upkeepProduced[rt->getId()] -= count * cost.getAmount();
+		}
+	}
+}
+
+/** rebuild the upkeep totals from the counts, after cost modifiers change */
+void Faction::recomputeUpkeep() {
+	std::fill(m_upkeepProduced.begin(), m_upkeepProduced.end(), 0);
+	std::fill(m_upkeepConsumed.begin(), m_upkeepConsumed.end(), 0);
+	foreach_const (UnitTypeCountMap, it, m_upkeepCounts) {
+		applyUpkeepCosts(it->first, it->second);
+	}
+}
+
+/** amount of consumable rt produced each interval by operative units */
+int Faction::getUpkeepProduced(const ResourceType *rt) const {
+	return rt->getId() < int(m_upkeepProduced.size()) ? m_upkeepProduced[rt->getId()] : 0;
+}
+
+/** amount of consumable rt consumed each interval by operative units */
+int Faction::getUpkeepConsumed(const ResourceType *rt) const {
+	return rt->getId() < int(m_upkeepConsumed.size()) ? m_upkeepConsumed[rt->getId()] : 0;
+}
+
+/** set the balance of each consumable resource from the upkeep totals */
+void Faction::computeResourceBalances() {
+	for (int i = 0; i < sresources.size(); ++i) {
+		const ResourceType *rt = sresources[i].getType();
+		if (rt->getClass() == ResourceClass::CONSUMABLE) {
+			sresources[i].setBalance(getUpkeepProduced(rt) - getUpkeepConsumed(rt));
+		}
+	}
 }
 
 void Faction::addItem(Item *item) {
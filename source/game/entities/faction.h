@@ -150,7 +150,7 @@ private:
 
     EventTypes eventTypes;
 public:
-    MandateAISim getMandateAiSim() const {return mandateAISim;}
+    MandateAISim &getMandateAiSim() {return mandateAISim;}
 
 
     SResources    sresources;
@@ -176,9 +176,23 @@ private:
 	Items items;
 	Units units;
 	UnitMap unitMap;
+	// live (not yet killed) units, each list sorted by unit id
+	vector<Units> m_unitsByType;	/**< indexed by UnitType id */
+	vector<Units> m_unitsByTag;		/**< indexed by tag id, see UnitType::getTagId() */
+	Units         m_unitsByCmdClass[CmdClass::COUNT];
 	Products products;
 	UnitTypeCountMap  m_unitCountMap;  // count of each 'operative' UnitType in factionType.
 	ItemTypeCountMap  m_itemCountMap;  // count of each 'operative' ItemType in factionType.
+	// consumable upkeep of operative units, kept current by Unit::updateUpkeep()
+	UnitTypeCountMap m_upkeepCounts;	/**< units of each type being charged upkeep */
+	vector<int>   m_upkeepProduced;	/**< indexed by ResourceType id, amount produced per interval */
+	vector<int>   m_upkeepConsumed;	/**< indexed by ResourceType id, amount consumed per interval */
+
+	void indexUnit(Unit *unit, const UnitType *ut);
+	void unindexUnit(Unit *unit, const UnitType *ut);
+	void applyUpkeep(const UnitType *ut, int count);
+	void applyUpkeepCosts(const UnitType *ut, int count);
+	void recomputeUpkeep();
 
 typedef int                 UnitId;
 typedef list<UnitId>        UnitIdList;
@@ -249,6 +263,7 @@ public:
 	//get
 	const StoredResource *getSResource(const ResourceType *rt) const;
 	const StoredResource *getSResource(int i) const  {assert(i < sresources.size()); return &sresources[i];}
+	int getSResourceCount() const						{return sresources.size();}
 	int getStoreAmount(const ResourceType *rt) const;
 
     const CreatedResource *getCResource(const ResourceType *rt) const;
@@ -345,6 +360,27 @@ public:
 
 	void add(Unit *unit);
 	void remove(Unit *unit);
+	void onUnitDied(Unit *unit);
+	void unitTypeChanged(Unit *unit, const UnitType *oldType);
+	int  getUnitIndex(const Unit *unit) const;
+
+	// live units by type, tag & command class
+	const Units& getUnitsOfType(const UnitType *ut) const;
+	const Units& getUnitsWithTag(int tagId) const;
+	const Units& getUnitsWithCommandClass(CmdClass cc) const	{ return m_unitsByCmdClass[cc]; }
+	int getLiveCountOfType(const UnitType *ut) const		{ return getUnitsOfType(ut).size(); }
+	int getLiveCountWithTag(int tagId) const				{ return getUnitsWithTag(tagId).size(); }
+
+	void addUpkeep(const UnitType *ut)						{ applyUpkeep(ut, 1); }
+	void removeUpkeep(const UnitType *ut)					{ applyUpkeep(ut, -1); }
+	int getUpkeepProduced(const ResourceType *rt) const;
+	int getUpkeepConsumed(const ResourceType *rt) const;
+	void computeResourceBalances();
+
+#	ifndef NDEBUG
+	void checkUnitIndexes() const;
+	void checkUpkeep() const;
+#	endif
 
 	void addItem(Item *item);
 
@@ -98,19 +98,21 @@ void FireParticleSystem::initParticle(Particle *p, int particleIndex) {
 	);
 }
 
-void FireParticleSystem::updateParticle(Particle *p) {
-	p->lastPos = p->pos;
-	p->pos = p->pos+p->speed;
-	p->energy--;
-
-	if(p->color.r > 0.0f)
-		p->color.r *= 0.98f;
-	if(p->color.g > 0.0f)
-		p->color.g *= 0.98f;
-	if(p->color.a > 0.0f)
-		p->color.a *= 0.98f;
-
-	p->speed.x *= 1.001f; // wind
+void FireParticleSystem::updateParticles(int n) {
+	ParticleArrays &p = particles;
+	memcpy(p.lastPosX, p.posX, n * sizeof(float));
+	memcpy(p.lastPosY, p.posY, n * sizeof(float));
+	memcpy(p.lastPosZ, p.posZ, n * sizeof(float));
+	ParticleArrays::add(p.posX, p.speedX, n);
+	ParticleArrays::add(p.posY, p.speedY, n);
+	ParticleArrays::add(p.posZ, p.speedZ, n);
+	ParticleArrays::decrement(p.energy, n);
+
+	ParticleArrays::scalePositive(p.colorR, 0.98f, n);
+	ParticleArrays::scalePositive(p.colorG, 0.98f, n);
+	ParticleArrays::scalePositive(p.colorA, 0.98f, n);
+
+	ParticleArrays::scale(p.speedX, 1.001f, n); // wind
 }
 
 // ===========================================================================
@@ -306,6 +308,32 @@ void Projectile::updateParticle(Particle *p) {
 	p->energy--;
 }
 
+void Projectile::updateParticles(int n) {
+	ParticleArrays &p = particles;
+	float *energyRatio = p.scratch;
+	ParticleArrays::energyRatio(energyRatio, p.energy, float(energy), n);
+
+	ParticleArrays::add(p.lastPosX, p.speedX, n);
+	ParticleArrays::add(p.lastPosY, p.speedY, n);
+	ParticleArrays::add(p.lastPosZ, p.speedZ, n);
+	ParticleArrays::add(p.posX, p.speedX, n);
+	ParticleArrays::add(p.posY, p.speedY, n);
+	ParticleArrays::add(p.posZ, p.speedZ, n);
+	ParticleArrays::add(p.speedX, p.accelX, n);
+	ParticleArrays::add(p.speedY, p.accelY, n);
+	ParticleArrays::add(p.speedZ, p.accelZ, n);
+	ParticleArrays::lerp(p.colorR, energyRatio, color.r, colorNoEnergy.r, n);
+	ParticleArrays::lerp(p.colorG, energyRatio, color.g, colorNoEnergy.g, n);
+	ParticleArrays::lerp(p.colorB, energyRatio, color.b, colorNoEnergy.b, n);
+	ParticleArrays::lerp(p.colorA, energyRatio, color.a, colorNoEnergy.a, n);
+	ParticleArrays::lerp(p.color2R, energyRatio, color2.r, color2NoEnergy.r, n);
+	ParticleArrays::lerp(p.color2G, energyRatio, color2.g, color2NoEnergy.g, n);
+	ParticleArrays::lerp(p.color2B, energyRatio, color2.b, color2NoEnergy.b, n);
+	ParticleArrays::lerp(p.color2A, energyRatio, color2.a, color2NoEnergy.a, n);
+	ParticleArrays::lerp(p.size, energyRatio, size, sizeNoEnergy, n);
+	ParticleArrays::decrement(p.energy, n);
+}
+
 void Projectile::setPath(Vec3f startPos, Vec3f endPos, int frames) {
 	// compute axis
 	zVector = endPos - startPos;
@@ -395,15 +423,17 @@ void Splash::initParticle(Particle *p, int particleIndex) {
 	p->accel = Vec3f(0.0f, -gravity, 0.0f);
 }
 
-void Splash::updateParticle(Particle *p) {
-	float energyRatio = clamp(static_cast<float>(p->energy) / energy, 0.f, 1.f);
-
-	p->lastPos = p->pos;
-	p->pos = p->pos + p->speed;
-	p->speed = p->speed + p->accel;
-	p->energy--;
-	p->color = color * energyRatio + colorNoEnergy * (1.0f - energyRatio);
-	p->size = size * energyRatio + sizeNoEnergy * (1.0f - energyRatio);
+void Splash::updateParticles(int n) {
+	ParticleArrays &p = particles;
+	float *energyRatio = p.scratch;
+	ParticleArrays::energyRatio(energyRatio, p.energy, float(energy), n);
+
+	p.integrate(n);
+	ParticleArrays::lerp(p.colorR, energyRatio, color.r, colorNoEnergy.r, n);
+	ParticleArrays::lerp(p.colorG, energyRatio, color.g, colorNoEnergy.g, n);
+	ParticleArrays::lerp(p.colorB, energyRatio, color.b, colorNoEnergy.b, n);
+	ParticleArrays::lerp(p.colorA, energyRatio, color.a, colorNoEnergy.a, n);
+	ParticleArrays::lerp(p.size, energyRatio, size, sizeNoEnergy, n);
 }
 
 // ===========================================================================
@@ -504,19 +534,34 @@ void UnitParticleSystem::update() {
 	checkVisibilty(ParticleUse::UNIT);
 }
 
-void UnitParticleSystem::updateParticle(Particle *p) {
-	float energyRatio = clamp(float(p->energy) / maxParticleEnergy, 0.f, 1.f);
-
-	p->lastPos += p->speed;
-	p->pos += p->speed;
+void UnitParticleSystem::updateParticles(int n) {
+	ParticleArrays &p = particles;
+	float *energyRatio = p.scratch;
+	ParticleArrays::energyRatio(energyRatio, p.energy, float(maxParticleEnergy), n);
+
+	ParticleArrays::add(p.lastPosX, p.speedX, n);
+	ParticleArrays::add(p.lastPosY, p.speedY, n);
+	ParticleArrays::add(p.lastPosZ, p.speedZ, n);
+	ParticleArrays::add(p.posX, p.speedX, n);
+	ParticleArrays::add(p.posY, p.speedY, n);
+	ParticleArrays::add(p.posZ, p.speedZ, n);
 	if (fixed) {
-		p->lastPos += fixedAddition;
-		p->pos += fixedAddition;
+		ParticleArrays::add(p.lastPosX, fixedAddition.x, n);
+		ParticleArrays::add(p.lastPosY, fixedAddition.y, n);
+		ParticleArrays::add(p.lastPosZ, fixedAddition.z, n);
+		ParticleArrays::add(p.posX, fixedAddition.x, n);
+		ParticleArrays::add(p.posY, fixedAddition.y, n);
+		ParticleArrays::add(p.posZ, fixedAddition.z, n);
 	}
-	p->speed += p->accel;
-	p->color = color * energyRatio + colorNoEnergy * (1.f - energyRatio);
-	p->size = size * energyRatio + sizeNoEnergy * (1.f - energyRatio);
-	--p->energy;
+	ParticleArrays::add(p.speedX, p.accelX, n);
+	ParticleArrays::add(p.speedY, p.accelY, n);
+	ParticleArrays::add(p.speedZ, p.accelZ, n);
+	ParticleArrays::lerp(p.colorR, energyRatio, color.r, colorNoEnergy.r, n);
+	ParticleArrays::lerp(p.colorG, energyRatio, color.g, colorNoEnergy.g, n);
+	ParticleArrays::lerp(p.colorB, energyRatio, color.b, colorNoEnergy.b, n);
+	ParticleArrays::lerp(p.colorA, energyRatio, color.a, colorNoEnergy.a, n);
+	ParticleArrays::lerp(p.size, energyRatio, size, sizeNoEnergy, n);
+	ParticleArrays::decrement(p.energy, n);
 }
 
 // ================= SET PARAMS ====================
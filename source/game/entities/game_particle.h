@@ -67,7 +67,7 @@ public:
 
 	virtual bool isFinished() const override {
 		if (state == sFade) {
-			return !particles || !aliveParticleCount;
+			return !particles.isAllocated() || !aliveParticleCount;
 		}
 		return false;
 	}
@@ -86,7 +86,7 @@ public:
 	//virtual
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles(int n) override;
 };
 
 // ===========================================================================
@@ -172,6 +172,9 @@ private:
 
 	void setId(int i) { m_id = i; }
 
+	/** the update of updateParticles() for one particle, new particles get one straight away */
+	void updateParticle(Particle *p);
+
 public:
 	void link(Splash *particleSystem);
 	void setCallback(ProjectileCallback *cb);
@@ -180,7 +183,7 @@ public:
 
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles(int n) override;
 
 	void setTrajectory(TrajectoryType trajectory)			{this->trajectory= trajectory;}
 	void setTrajectorySpeed(float trajectorySpeed)			{this->trajectorySpeed= trajectorySpeed;}
@@ -220,7 +223,7 @@ public:
 
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles(int n) override;
 
 	void setEmissionRateFade(float emissionRateFade)	{this->emissionRateFade = emissionRateFade;}
 	void setVerticalSpreadA(float verticalSpreadA)		{this->verticalSpreadA = verticalSpreadA;}
@@ -258,7 +261,7 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles(int n) override;
 	virtual void update() override;
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr) override;
 
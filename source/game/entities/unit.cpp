@@ -39,6 +39,8 @@
 using namespace Shared::Graphics;
 using namespace Shared::Util;
 using namespace Glest::Net;
+using Glest::Sim::UnitFilter;
+using Glest::Sim::TeamRelation;
 
 namespace Glest { namespace Entities {
 
@@ -133,6 +135,8 @@ Unit::Unit(CreateParams params)
 		, targetField(Field::LAND)
 		, faceTarget(true)
 		, useNearestOccupiedCell(true)
+		, m_nearbyRadius(-1)
+		, m_nearbyFrame(-1)
 		, level(0)
 		, specialization(0)
 		, currentResearch(0)
@@ -149,6 +153,7 @@ Unit::Unit(CreateParams params)
 		, type(params.type)
 		, loadType(0)
 		, currSkill(0)
+		, m_upkeepType(0)
 		, toBeUndertaken(false)
 		, carried(false)
 		, garrisoned(false)
@@ -193,6 +198,7 @@ Unit::Unit(CreateParams params)
 	garrisonTest = false;
 
 	goalStructure = NULL;
+	m_lastAiUpdate = -1;
 
     srand ( id );
     int direction = rand() % 8 + 1;
@@ -275,9 +281,6 @@ Unit::Unit(CreateParams params)
 	currentCommandCooldowns[i].currentStep = 0;
 	}
 
-	currentAiUpdate.resize(1);
-	currentAiUpdate[0].currentStep = 0;
-
     ownedUnits.resize(type->getOwnedUnits().size());
     for(int i = 0; i<ownedUnits.size(); ++i){
         const UnitType *type = getType()->getOwnedUnits()[i].getType();
@@ -333,8 +336,12 @@ Unit::Unit(CreateParams params)
 
 Unit::Unit(LoadParams params) //const XmlNode *node, Faction *faction, Map *map, const TechTree *tt, bool putInWorld)
 		: targetRef(params.node->getOptionalIntValue("targetRef", -1))
+		, m_nearbyRadius(-1)
+		, m_nearbyFrame(-1)
 		, effects(params.node->getChild("effects"))
 		, effectsCreated(params.node->getChild("effectsCreated"))
+        , m_lastAiUpdate(-1)
+        , m_upkeepType(0)
         , carried(false)
         , garrisoned(false) {
 	const XmlNode *node = params.node;
@@ -459,6 +466,7 @@ Unit::Unit(LoadParams params) //const XmlNode *node, Faction *faction, Map *map,
 	}
 
 	faction->add(this);
+	updateUpkeep();
 	if (hp) {
 		if (!carried && !garrisoned) {
 			map->putUnitCells(this, pos);
@@ -620,8 +628,11 @@ void Unit::incResourceAmount(const ResourceType *rt, int amount) {
 		    }
 			if (resource->getType()->getClass() != ResourceClass::STATIC
 			&& resource->getType()->getClass() != ResourceClass::CONSUMABLE
-			&& resource->getAmount() > getStoreAmount(rt)) {
+			&& resource->getAmount() >= getStoreAmount(rt)) {
 				resource->setAmount(getStoreAmount(rt));
+				if (amount > 0) {
+					faction->getMandateAiSim().wake(this); // store full
+				}
 			}
 			return;
 		}
@@ -1052,6 +1063,7 @@ void Unit::setCurrSkill(const SkillType *newSkill) {
 	assert(newSkill);
 	//COMMAND_LOG(g_world.getFrameCount() << "::Unit:" << id << " skill set => " << SkillClassNames[currSkill->getClass()] );
 	if (newSkill == currSkill) {
+		updateUpkeep(); // a new unit's start skill can be the stop skill it was constructed with
 		return;
 	}
 	if (newSkill != currSkill) {
@@ -1062,12 +1074,28 @@ void Unit::setCurrSkill(const SkillType *newSkill) {
 	}
 	progress2 = 0;
 	currSkill = newSkill;
+	updateUpkeep();
 
 	if (!isCarried() && !isGarrisoned()) {
 		startSkillParticleSystems();
 	}
 }
 
+/** start or stop charging this unit's consumable upkeep to its faction, called
+  * wherever the unit may become (in)operative or change type */
+void Unit::updateUpkeep() {
+	const UnitType *upkeepType = isOperative() ? type : 0;
+	if (upkeepType != m_upkeepType) {
+		if (m_upkeepType) {
+			faction->removeUpkeep(m_upkeepType);
+		}
+		if (upkeepType) {
+			faction->addUpkeep(upkeepType);
+		}
+		m_upkeepType = upkeepType;
+	}
+}
+
 /** sets unit's target */
 void Unit::setTarget(const Unit *unit, bool faceTarget, bool useNearestOccupiedCell) {
 	if(!unit) {
@@ -1093,6 +1121,20 @@ void Unit::setPos(const Vec2i &pos){
 	}
 }
 
+/** @param host the unit carrying this one, or NULL when it is unloaded */
+void Unit::setCarried(Unit *host) {
+	carried = (host != 0);
+	m_carrier = (host ? host->getId() : -1);
+	g_cartographer.applyUnitVisibility(this);
+}
+
+/** @param host the unit garrisoning this one, or NULL when it leaves */
+void Unit::setGarrisoned(Unit *host) {
+	garrisoned = (host != 0);
+	m_garrison = (host ? host->getId() : -1);
+	g_cartographer.applyUnitVisibility(this);
+}
+
 /** sets targetRotation */
 void Unit::face(const Vec2i &nextPos) {
 	Vec2i relPos = nextPos - pos;
@@ -1553,6 +1595,7 @@ CmdResult Unit::finishCommand() {
 
 	if (commands.empty()) {
 		CMD_LOG( "now has no commands." );
+		faction->getMandateAiSim().wake(this);
 	} else {
 		CMD_LOG( commands.front()->getType()->getName() << " command next on queue." );
 	}
@@ -1713,7 +1756,6 @@ void Unit::born(bool reborn) {
             equipItem(storedItems.size()-1);
         }
 
-		g_world.getCartographer()->applyUnitVisibility(this);
 		g_simInterface.doUnitBorn(this);
 		faction->applyUpgradeBoosts(this);
 		if (faction->isThisFaction() && !g_config.getGsAutoRepairEnabled()
@@ -1732,12 +1774,13 @@ void Unit::born(bool reborn) {
             }
 		}
 	}
+	g_world.getCartographer()->applyUnitVisibility(this);
 	StateChanged(this);
 	faction->onUnitActivated(type);
 }
 
 void checkTargets(const Unit *dead) {
-	typedef list<ParticleSystem*> psList;
+	typedef ParticleManager::ParticleSystemList psList;
 	const psList &list = g_renderer.getParticleManager()->getList();
 	foreach_const (psList, it, list) {
 		if (*it && (*it)->isProjectile()) {
@@ -1882,6 +1925,7 @@ void Unit::kill() {
 		faction->onUnitDeActivated(type);
 	}
 
+	faction->onUnitDied(this);
 	Died(this);
 
 	clearCommands();
@@ -1890,6 +1934,7 @@ void Unit::kill() {
 
 	//REFACTOR use signal, send this to World/Cartographer/SimInterface
 	world.getCartographer()->removeUnitVisibility(this);
+	world.getUnitGrid().remove(this);
 	if (!isCarried() && !isGarrisoned()) { // if not in transport, clear cells
 		map->clearUnitCells(this, pos);
 	}
@@ -1965,6 +2010,7 @@ void Unit::replace() {
 		faction->onUnitDeActivated(type);
 	}
 
+	faction->onUnitDied(this);
 	Died(this);
 
 	clearCommands();
@@ -1972,6 +2018,7 @@ void Unit::replace() {
 	deadCount = 1001;
 
 	world.getCartographer()->removeUnitVisibility(this);
+	world.getUnitGrid().remove(this);
 	if (!isCarried() && !isGarrisoned()) {
 		map->clearUnitCells(this, pos);
 	}
@@ -2045,12 +2092,14 @@ void Unit::capture() {
 		faction->removeStore(type);
 		faction->onUnitDeActivated(type);
 	}
+	faction->onUnitDied(this);
 	Died(this);
 	clearCommands();
 	setCurrSkill(SkillClass::DIE);
 	deadCount = 1001; // random decay time
 	//REFACTOR use signal, send this to World/Cartographer/SimInterface
 	world.getCartographer()->removeUnitVisibility(this);
+	world.getUnitGrid().remove(this);
 	if (!isCarried() && !isGarrisoned()) { // if not in transport, clear cells
 		map->clearUnitCells(this, pos);
 	}
@@ -2068,11 +2117,14 @@ void Unit::housedUnitDied(Unit *unit) {
 	}
 	if (Shared::Util::find(m_garrisonedUnits, unit->getId(), it)) {
 		m_garrisonedUnits.erase(it);
+		invalidateStatLayer(StatLayer::GARRISON);
+		updateTotalUpgrade();
 	}
 }
 
 void Unit::undertake() {
 	faction->remove(this);
+	g_world.getUnitGrid().remove(this);
 	if (!skillParticleSystems.empty()) {
 		foreach (UnitParticleSystems, it, skillParticleSystems) {
 			(*it)->fade();
@@ -2157,6 +2209,10 @@ TravelState Unit::travel(const Vec2i &pos, const MoveSkillType *moveSkill) {
 		case TravelState::ARRIVED:
 			return TravelState::ARRIVED;
 
+		case TravelState::PENDING:
+			setCurrSkill(SkillClass::STOP); // wait for the path request to be serviced
+			return TravelState::PENDING;
+
 		default:
 			throw runtime_error("Unknown TravelState returned by RoutePlanner::findPath().");
 	}
@@ -2577,7 +2633,8 @@ void Unit::equipItem(int ident) {
         actions.sortSkillTypes();
         actions.sortCommandTypes();
     }
-    computeTotalUpgrade();
+    invalidateStatLayer(StatLayer::ITEMS);
+    updateTotalUpgrade();
 }
 
 void Unit::unequipItem(int ident) {
@@ -2605,7 +2662,8 @@ void Unit::unequipItem(int ident) {
             break;
         }
     }
-    computeTotalUpgrade();
+    invalidateStatLayer(StatLayer::ITEMS);
+    updateTotalUpgrade();
 }
 
 void Unit::consumeItem(int ident) {
@@ -2628,7 +2686,8 @@ void Unit::consumeItem(int ident) {
             effectTypes.push_back(ef);
         }
     }
-    computeTotalUpgrade();
+    invalidateStatLayer(StatLayer::ITEMS);
+    updateTotalUpgrade();
 }
 
 void Unit::shop() {
@@ -2716,6 +2775,58 @@ void Unit::doCapture(Unit *killed) {
 	}
 }
 
+/** Intent phase of the unit update, see World::prepareUnits(). If this unit's
+  * skill cycle completes this frame, gathers the hostile units in sight so its
+  * command update can choose targets without searching the map. Only reads
+  * world state, so is safe to call for many units concurrently. */
+void Unit::prepareUpdate() {
+	const int &frame = g_world.getFrameCount();
+	m_nearbyHostiles.clear();
+	m_nearbyRadius = -1;
+	m_nearbyFrame = frame;
+	if (!isAlive() || frame < getNextCommandUpdate()) {
+		return;
+	}
+	// only attacking & auto-flee look at the list, don't search for units that never will
+	if (!actions.getFirstCtOfClass(CmdClass::ATTACK) && !actions.getFirstCtOfClass(CmdClass::ATTACK_STOPPED)
+	&& !actions.getFirstCtOfClass(CmdClass::GUARD) && !actions.getFirstCtOfClass(CmdClass::PATROL)
+	&& !(isAutoCmdEnabled(AutoCmdFlag::FLEE) && actions.getFirstCtOfClass(CmdClass::MOVE))) {
+		return;
+	}
+	int sight = getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue();
+	if (sight <= 0) {
+		return;
+	}
+	const Unit *origin = getRangeOrigin();
+	UnitFilter filter;
+	filter.team = getTeam();
+	filter.relation = TeamRelation::HOSTILE;
+	filter.self = this;
+	filter.inWorldOnly = true;
+	m_nearbyRadius = sight + origin->getType()->getHalfSize().intp();
+	g_world.getUnitGrid().findInRange(origin->getCenteredPos(), m_nearbyRadius, filter, m_nearbyHostiles);
+}
+
+/** @return the hostile units gathered by prepareUpdate() this frame, or NULL if
+  * they were not gathered or were gathered with a radius smaller than radius */
+const UnitDistList* Unit::getNearbyHostiles(int radius) const {
+	if (m_nearbyFrame != g_world.getFrameCount() || m_nearbyRadius < radius) {
+		return 0;
+	}
+	return &m_nearbyHostiles;
+}
+
+/** @return the unit range checks for this unit are made from, its carrier or
+  * garrison if it is in one, else itself */
+const Unit* Unit::getRangeOrigin() const {
+	if (isCarried()) {
+		return g_world.getUnit(m_carrier);
+	} else if (isGarrisoned()) {
+		return g_world.getUnit(m_garrison);
+	}
+	return this;
+}
+
 /** @return true when the current skill has completed a cycle */
 bool Unit::update() { ///@todo should this be renamed to hasFinishedCycle()?
 //	_PROFILE_FUNCTION();
@@ -3031,9 +3142,18 @@ bool Unit::decHp(int i) {
 		}
 		return true;
 	}
+	if (i > 0) { // whatever the damage, the sim ai checks for low hp
+		faction->getMandateAiSim().wake(this);
+	}
 	return false;
 }
 
+/** name of a sim ai goal or task for the descriptions, blank for none */
+template<typename E>
+static string aiStateName(E e, const EnumNames<E> &names) {
+	return e == E::INVALID ? string() : formatString(names[e]);
+}
+
 string Unit::getShortDesc() const {
 	stringstream ss;
 	ss << g_lang.get("Hp") << ": " << hp << "/" << getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue();
@@ -3078,8 +3198,8 @@ string Unit::getShortDesc() const {
             ss << endl << "Open Space: " << getSResource(g_world.getTechTree()->getResourceType("space"))->getAmount();
         }
         if (type->hasTag("ordermember")) {
-            ss << endl << "Focus: " << currentFocus;
-            ss << endl << "Task: " << goalReason;
+            ss << endl << "Focus: " << aiStateName(currentFocus, Plan::GoalNames);
+            ss << endl << "Task: " << aiStateName(goalReason, Plan::GoalReasonNames);
         }
         if (type->hasTag("orderhouse")) {
             for (int i = 0; i < heroClasses.size(); ++i) {
@@ -3103,10 +3223,10 @@ string Unit::getLongDesc() const {
     ss << endl << owner->getType()->getName();
 
 	if (goalStructure != NULL) {
-        ss << endl << "Focus: " << currentFocus;
+        ss << endl << "Focus: " << aiStateName(currentFocus, Plan::GoalNames);
 	}
 
-    ss << endl << "Task: " << goalReason;
+    ss << endl << "Task: " << aiStateName(goalReason, Plan::GoalReasonNames);
     ss << endl << "Structure: " << goalStructure;
     ss << endl << "Producer:" << productionRoute.getProducerId();
     ss << endl << "Store: " << productionRoute.getStoreId();
@@ -3147,7 +3267,7 @@ string Unit::getLongDesc() const {
             ss << endl << "Found: " << getFaction()->getMandateAiSim().getPersonality(i)->getPersonalityName();
         }
 	}
-	ss << endl << "Current Focus: " << getCurrentFocus();
+	ss << endl << "Current Focus: " << aiStateName(getCurrentFocus(), Plan::GoalNames);
 	}
 	ss << endl << lang.get("Sight") << ": " << type->getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue();
 	if (sightBonus) {
@@ -3266,7 +3386,8 @@ void Unit::applyUpgrade(const UpgradeType *upgradeType) {
             const Statistics *stats = us->m_upgrades[i].getStatistics(us->getUpgradeStage());
             if (stats) {
                 totalUpgrade.sum(stats);
-                computeTotalUpgrade();
+                invalidateStatLayer(StatLayer::UPGRADES);
+                updateTotalUpgrade();
                 doRegen(stats->getEnhancement()->getResourcePools()->getHealth()->getBoostStat()->getValue());
             }
             if (us->getUpgradeStage() == 0 && us->m_upgrades[i].getActionsCount() > 0) {
@@ -3302,91 +3423,121 @@ void Unit::applyUpgrade(const UpgradeType *upgradeType) {
 	}
 }
 
-/** recompute stats, re-evaluate upgrades & level and recalculate totalUpgrade */
+/** recompute stats, re-evaluate upgrades & level and recalculate totalUpgrade, for
+  * when any source may have changed (unit type, faction upgrades, loading a game) */
 void Unit::computeTotalUpgrade() {
-    totalUpgrade.cleanse();
-	faction->getUpgradeManager()->computeTotalUpgrade(this, &totalUpgrade);
-	totalUpgrade.sum(type->getStatistics());
-	if (type->isSovereign) {
-	    if (specialization != 0) {
-            const Statistics *specStats = specialization->getStatistics();
-            totalUpgrade.sum(specStats);
-	    }
-        const Statistics *sovStats = type->getSovereign()->getStatistics();
-        totalUpgrade.sum(sovStats);
+	foreach_enum (StatLayer, l) {
+		m_statLayerDirty[l] = true;
 	}
-    if (dayCycle) {
-        const Statistics *stats = &type->dayPower;
-        if (stats) {
-            totalUpgrade.sum(stats);
-        }
-    } if (!dayCycle) {
-        const Statistics *stats = &type->nightPower;
-        if (stats) {
-            totalUpgrade.sum(stats);
-        }
-    }
-	for (int i = 0; i < getEquippedItems().size(); ++i) {
-	    getEquippedItem(i)->computeTotalUpgrade();
-	    const Statistics *stats = static_cast<const Statistics*>(getEquippedItem(i)->getStatistics());
-        if (stats) {
-            totalUpgrade.sum(stats);
-        }
+	updateTotalUpgrade();
+}
+
+/** sum the layers marked with invalidateStatLayer() again, then rebuild totalUpgrade
+  * from the layers and recalculate stats */
+void Unit::updateTotalUpgrade() {
+	const bool limitsChanged = m_statLayerDirty[StatLayer::TYPE] || m_statLayerDirty[StatLayer::ITEMS];
+	foreach_enum (StatLayer, l) {
+		if (m_statLayerDirty[l]) {
+			m_statLayers[l].cleanse();
+			computeStatLayer(l);
+			m_statLayerDirty[l] = false;
+		}
 	}
-	for (int i = 0; i < type->getBonusPowerCount(); ++i) {
-	    const Statistics *stats = static_cast<const Statistics*>(type->getBonusPower(i)->getStatistics());
-        if (stats) {
-            totalUpgrade.sum(stats);
-        }
+	totalUpgrade.cleanse();
+	foreach_enum (StatLayer, l) {
+		totalUpgrade.sum(getStatLayer(l));
 	}
-	for (int i = 0; i < traits.size(); ++i) {
-	    const Statistics *stats = traits[i]->getStatistics();
-        if (stats) {
-            totalUpgrade.sum(stats);
-        }
+	if (limitsChanged) {
+		computeOwnedUnitLimits();
 	}
-    UnitIdList garrisonedUnits = getGarrisonedUnits();
-    if (getGarrisonedCount() > 0) {
-        foreach (UnitIdList, it, garrisonedUnits) {
-            Unit *garUnit = g_world.getUnit(*it);
-            string unitName = garUnit->getType()->getName();
-            for (int l = 0; l < type->getLoadBonuses().size(); ++l) {
-                const LoadBonus lb = type->getLoadBonuses()[l];
-                string bonusName = lb.getSource();
-                if (unitName == bonusName) {
-                    const Statistics *stats = static_cast<const Statistics*>(lb.getStatistics());
-                    totalUpgrade.sum(stats);
-                }
-            }
-        }
-    }
-	level = NULL;
-	int totalExp = exp;
-	int levelInt = 0;
-	for (int i = 0; i < type->getLevelCount(); ++i) {
-		const Level *typeLevel = type->getLevel(i);
-		bool check = true;
-        for (int j = 0; j < typeLevel->getCount(); ++j) {
-            bool nextLevel = false;
-            if (totalExp >= ((typeLevel->getExp() + (typeLevel->getExpAdd()) * j) * (1 + typeLevel->getExpMult() * j)).intp()) {
-                totalExp -= ((typeLevel->getExp() + (typeLevel->getExpAdd()) * j) * (1 + typeLevel->getExpMult() * j)).intp();
-                nextLevel = true;
-            }
-            if (nextLevel == true) {
-                this->level = typeLevel;
-                const Statistics *stats = static_cast<const Statistics*>(typeLevel->getStatistics());
-                totalUpgrade.sum(stats);
-                ++levelInt;
-            } else {
-                check = false;
-                break;
-            }
-        }
-        if (check == false) {
-            break;
-        }
+	recalculateStats();
+}
+
+const Statistics* Unit::getStatLayer(StatLayer layer) const {
+	if (layer == StatLayer::TIME_OF_DAY) {
+		return dayCycle ? &type->dayPower : &type->nightPower;
+	}
+	return &m_statLayers[layer];
+}
+
+/** sum the sources of one layer, into the (cleansed) layer */
+void Unit::computeStatLayer(StatLayer layer) {
+	Statistics &stats = m_statLayers[layer];
+	switch (layer) {
+		case StatLayer::UPGRADES:
+			faction->getUpgradeManager()->computeTotalUpgrade(this, &stats);
+			break;
+		case StatLayer::TYPE:
+			stats.sum(type->getStatistics());
+			if (type->isSovereign) {
+				if (specialization != 0) {
+					stats.sum(specialization->getStatistics());
+				}
+				stats.sum(type->getSovereign()->getStatistics());
+			}
+			break;
+		case StatLayer::TIME_OF_DAY:
+			break;
+		case StatLayer::ITEMS:
+			for (int i = 0; i < getEquippedItems().size(); ++i) {
+				getEquippedItem(i)->computeTotalUpgrade();
+				stats.sum(getEquippedItem(i)->getStatistics());
+			}
+			break;
+		case StatLayer::BONUS_POWERS:
+			for (int i = 0; i < type->getBonusPowerCount(); ++i) {
+				stats.sum(type->getBonusPower(i)->getStatistics());
+			}
+			break;
+		case StatLayer::TRAITS:
+			for (int i = 0; i < traits.size(); ++i) {
+				stats.sum(traits[i]->getStatistics());
+			}
+			break;
+		case StatLayer::GARRISON:
+			foreach (UnitIdList, it, m_garrisonedUnits) {
+				const string &unitName = g_world.getUnit(*it)->getType()->getName();
+				for (int l = 0; l < type->getLoadBonuses().size(); ++l) {
+					const LoadBonus &lb = type->getLoadBonuses()[l];
+					if (unitName == lb.getSource()) {
+						stats.sum(lb.getStatistics());
+					}
+				}
+			}
+			break;
+		case StatLayer::LEVEL: {
+			level = NULL;
+			int totalExp = exp;
+			int levelInt = 0;
+			for (int i = 0; i < type->getLevelCount(); ++i) {
+				const Level *typeLevel = type->getLevel(i);
+				bool check = true;
+				for (int j = 0; j < typeLevel->getCount(); ++j) {
+					int levelExp = ((typeLevel->getExp() + (typeLevel->getExpAdd()) * j) * (1 + typeLevel->getExpMult() * j)).intp();
+					if (totalExp >= levelExp) {
+						totalExp -= levelExp;
+						this->level = typeLevel;
+						stats.sum(typeLevel->getStatistics());
+						++levelInt;
+					} else {
+						check = false;
+						break;
+					}
+				}
+				if (check == false) {
+					break;
+				}
+			}
+			levelNumber = levelInt;
+			break;
+		}
+		default:
+			assert(false);
 	}
-	levelNumber = levelInt;
+}
+
+/** limits on units owned, from the unit type plus any equipped items */
+void Unit::computeOwnedUnitLimits() {
     for (int i = 0; i < type->getOwnedUnits().size(); ++i) {
         int limit = type->getOwnedUnits()[i].getLimit();
         for (int j = 0; j < ownedUnits.size(); ++j) {
@@ -3408,7 +3559,6 @@ void Unit::computeTotalUpgrade() {
             }
         }
     }
-	recalculateStats();
 }
 
 /**
@@ -3451,8 +3601,11 @@ void Unit::recalculateStats() {
 		hp = getStatistics()->getEnhancement()->getResourcePools()->getHealth()->getMaxStat()->getValue();
 	}
 
-	if (oldSight != getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue() && type->getDetectorType()) {
-		g_cartographer.detectorSightModified(this, oldSight);
+	if (oldSight != getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue()) {
+		if (type->getDetectorType()) {
+			g_cartographer.detectorSightModified(this, oldSight);
+		}
+		g_cartographer.applyUnitVisibility(this);
 	}
 
 	// If this guy is dead, make sure they stay dead
@@ -3490,7 +3643,8 @@ void Unit::addTrait(Trait *trait) {
         currentCommandCooldowns.push_back(newCooldown);
     }
     actions.sortCommandTypes();
-    computeTotalUpgrade();
+    invalidateStatLayer(StatLayer::TRAITS);
+    updateTotalUpgrade();
 }
 
 void Unit::initSkillsAndCommands() {
@@ -3511,6 +3665,8 @@ void Unit::initSkillsAndCommands() {
 
 void Unit::addSpecialization(Specialization *spec) {
     specialization = spec;
+    invalidateStatLayer(StatLayer::TYPE);
+    updateTotalUpgrade();
 }
 
 void Unit::processTraits() {
@@ -3885,6 +4041,8 @@ bool Unit::changeType(const UnitType *unitType) {
 		map->clearUnitCells(this, pos);
 		faction->deApplyStaticCosts(type);
 		type = unitType;
+		faction->unitTypeChanged(this, oldType);
+		updateUpkeep();
 		actions.clearActions();
         for (int i =0; i < type->getActions()->getSkillTypeCount(); ++i) {
             actions.addSkillType(type->getActions()->getSkillType(i));
@@ -3897,6 +4055,7 @@ bool Unit::changeType(const UnitType *unitType) {
 		pos += offset;
 		computeTotalUpgrade();
 		map->putUnitCells(this, pos);
+		g_cartographer.applyUnitVisibility(this);
 		faction->applyStaticProduction(unitType);
 		if (type->getCloakType()) {
 			if (m_cloaked && oldCloakClass != unitType->getCloakClass()) {
@@ -3961,7 +4120,8 @@ void Unit::incKills() {
 /** Another one bites the dust. Increment 'exp' & check level */
 void Unit::incExp(int addExp) {
     exp += addExp;
-    computeTotalUpgrade();
+    invalidateStatLayer(StatLayer::LEVEL);
+    updateTotalUpgrade();
 }
 
 /** Perform a morph @param mct the CommandType describing the morph @return true if successful */
@@ -3973,6 +4133,8 @@ bool Unit::morph(const MorphCommandType *mct, const UnitType *ut, Vec2i offset,
 		map->clearUnitCells(this, pos);
 		faction->deApplyStaticCosts(type);
 		type = ut;
+		faction->unitTypeChanged(this, oldType);
+		updateUpkeep();
 		actions.clearActions();
         for (int i =0; i < type->getActions()->getSkillTypeCount(); ++i) {
             actions.addSkillType(type->getActions()->getSkillType(i));
@@ -3985,6 +4147,7 @@ bool Unit::morph(const MorphCommandType *mct, const UnitType *ut, Vec2i offset,
 		pos += offset;
 		computeTotalUpgrade();
 		map->putUnitCells(this, pos);
+		g_cartographer.applyUnitVisibility(this);
 		faction->giveRefund(ut, mct->getRefund());
 		faction->applyStaticProduction(ut);
 		if (type->getCloakType()) {
@@ -4365,6 +4528,10 @@ void UnitFactory::deleteUnit(Unit *unit) {
 	if (it != m_deadList.end()) {
 		m_deadList.erase(it);
 	}
+	g_cartographer.removeUnitVisibility(unit);
+	if (unit->getUpkeepType()) { // not killed, eg. failed to place
+		unit->getFaction()->removeUpkeep(unit->getUpkeepType());
+	}
     deleteInstance(unit->getId());
 }
 
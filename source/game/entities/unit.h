@@ -29,6 +29,7 @@
 #include "factory.h"
 #include "type_factories.h"
 #include "game_particle.h"
+#include "unit_grid.h"
 
 #include "prototypes_enums.h"
 #include "simulation_enums.h"
@@ -48,6 +49,7 @@ using Shared::Util::SingleTypeFactory;
 using namespace Hierarchy;
 using namespace ProtoTypes;
 using Sim::Map;
+using Sim::UnitDistList;
 
 class Unit;
 class UnitFactory;
@@ -68,6 +70,19 @@ WRAPPED_ENUM( AutoCmdState,
 	MIXED
 )
 
+// StatLayer : the sources summed into a unit's totalUpgrade, in the order they are
+// summed, each is cached and only summed again when it changes
+WRAPPED_ENUM( StatLayer,
+	UPGRADES,		// faction upgrades
+	TYPE,			// unit type, specialisation & sovereign
+	TIME_OF_DAY,	// the unit type's day or night power, not cached
+	ITEMS,			// equipped items
+	BONUS_POWERS,	// the unit type's bonus powers
+	TRAITS,
+	GARRISON,		// load bonuses of garrisoned units
+	LEVEL			// levels reached
+)
+
 class Vec2iList : public list<Vec2i> {
 public:
 	void read(const XmlNode *node);
@@ -311,9 +326,10 @@ private:
 	Zone zone;
 	Field field;
 
-	string currentFocus;
+	Plan::Goal currentFocus;		/**< sim ai goal, INVALID for none */
 	Unit *goalStructure;
-	string goalReason;
+	Plan::GoalReason goalReason;	/**< sim ai task, INVALID for none */
+	int m_lastAiUpdate;				/**< frame the sim ai last looked at this unit, -1 if never */
 public:
     Trait *currentResearch;
 
@@ -323,12 +339,14 @@ public:
 	void setZone(Zone newZone)    { zone = newZone; }
 	/**< new system to enable walls */
 
-	string getCurrentFocus() const {return currentFocus;}
-	void setCurrentFocus(string newFocus) {currentFocus = newFocus;}
+	Plan::Goal getCurrentFocus() const {return currentFocus;}
+	void setCurrentFocus(Plan::Goal newFocus) {currentFocus = newFocus;}
 	Unit *getGoalStructure() const {return goalStructure;}
 	void setGoalStructure(Unit *unit) {goalStructure = unit;}
-	string getGoalReason() const {return goalReason;}
-	void setGoalReason(string string) {goalReason = string;}
+	Plan::GoalReason getGoalReason() const {return goalReason;}
+	void setGoalReason(Plan::GoalReason reason) {goalReason = reason;}
+	int getLastAiUpdate() const {return m_lastAiUpdate;}
+	void setLastAiUpdate(int frame) {m_lastAiUpdate = frame;}
 	void shop();
 
     int getTraitCount() {return traits.size();}
@@ -343,7 +361,6 @@ public:
 	BonusPowerTimers bonusPowerTimers;
 
     CurrentStep currentCommandCooldowns; /**< current timer step for skill cooldowns */
-    CurrentStep currentAiUpdate; /**< current timer step for skill cooldowns */
 
     ProductionRoute productionRoute;
     Settlement settlement;
@@ -393,6 +410,11 @@ private:
 	bool faceTarget;				/**< If true and target is set, we continue to face target. */
 	bool useNearestOccupiedCell;	/**< If true, targetPos is set to target->getNearestOccupiedCell() */
 
+	// intent phase info, gathered by prepareUpdate()
+	UnitDistList m_nearbyHostiles;	/**< hostile units in sight at the start of the frame, nearest first */
+	int m_nearbyRadius;				/**< radius m_nearbyHostiles was gathered with */
+	int m_nearbyFrame;				/**< frame m_nearbyHostiles was gathered, -1 if never */
+
 	// position info
 	Vec2i pos;						/**< Current position */
 	Vec2i lastPos;					/**< The last position before current */
@@ -414,6 +436,7 @@ private:
 	const ResourceType *loadType;	/**< the type if resource being carried */
 
 	const SkillType *currSkill;		/**< the SkillType currently being executed */
+	const UnitType *m_upkeepType;	/**< the type faction is charging consumable upkeep for, null while not operative */
 
 	// some flags
 	bool toBeUndertaken;			/**< awaiting a date with the grim reaper */
@@ -436,6 +459,8 @@ private:
 	Effects effects;				/**< Effects (spells, etc.) currently effecting unit. */
 	Effects effectsCreated;			/**< All effects created by this unit. */
 	Statistics totalUpgrade;	/**< All stat changes from upgrades, level ups, garrisoned units and effects */
+	Statistics m_statLayers[StatLayer::COUNT];	/**< the part of totalUpgrade from each source */
+	bool m_statLayerDirty[StatLayer::COUNT];	/**< sources changed since their layer was summed */
 
 	// is this really needed here? maybe keep faction (but change to an index), ditch map
 	Faction *faction;
@@ -519,6 +544,10 @@ private:
 	void checkEffectCloak();
 	void startSkillParticleSystems();
 
+	void computeStatLayer(StatLayer layer);
+	void computeOwnedUnitLimits();
+	const Statistics* getStatLayer(StatLayer layer) const;
+
 public:
 	void save(XmlNode *node) const;
 
@@ -534,6 +563,8 @@ public:
 	int getProgress2() const					{return progress2;}
 
 	int getNextCommandUpdate() const			{ return nextCommandUpdate; }
+	const UnitDistList* getNearbyHostiles(int radius) const;
+	const Unit* getRangeOrigin() const;
 	int getLastCommandUpdate() const			{ return lastCommandUpdate; }
 	int getNextAnimReset() const				{ return nextAnimReset; }
 	int getSystemStartFrame() const				{ return systemStartFrame; }
@@ -611,8 +642,8 @@ public:
 	void housedUnitDied(Unit *unit);
 
 	//bool isVisible() const					{return carried;}
-	void setCarried(Unit *host)				{carried = (host != 0); m_carrier = (host ? host->getId() : -1);}
-	void setGarrisoned(Unit *host)			{garrisoned = (host != 0); m_garrison = (host ? host->getId() : -1);}
+	void setCarried(Unit *host);
+	void setGarrisoned(Unit *host);
 	void loadUnitInit(Command *command);
 	void unloadUnitInit(Command *command);
 	void garrisonUnitInit(Command *command);
@@ -691,9 +722,11 @@ public:
 			|| currSkill->getClass() == SkillClass::BUILD_SELF;
 	}
 	bool isBuilt() const				{return !isBeingBuilt();}
+	const UnitType *getUpkeepType() const	{return m_upkeepType;}
 	// set
 	void setCurrSkill(const SkillType *currSkill);
 	void setCurrSkill(SkillClass sc)					{setCurrSkill(getType()->getActions()->getFirstStOfClass(sc));}
+	void updateUpkeep();
 	void setLoadCount(int loadCount)					{this->loadCount = loadCount;}
 	void setLoadType(const ResourceType *loadType)		{this->loadType = loadType;}
 
@@ -790,6 +823,7 @@ public:
 	void doUpdateCommand();
 
 	// World wrappers
+	void prepareUpdate();
 	void doUpdate();
 	void doKill(Unit *killed);
 	void doCapture(Unit *killed);
@@ -809,6 +843,8 @@ public:
 	Unit *tick();
 	void applyUpgrade(const UpgradeType *upgradeType);
 	void computeTotalUpgrade();
+	void invalidateStatLayer(StatLayer layer)	{ m_statLayerDirty[layer] = true; }
+	void updateTotalUpgrade();
 	void incKills();
 	void incExp(int addExp);
 	bool morph(const MorphCommandType *mct, const UnitType *ut, Vec2i offset = Vec2i(0), bool reprocessCommands = true);
@@ -61,6 +61,8 @@ DebugStats::DebugStats() {
 	loadConfig();
 	m_lastRenderFps = 0;
 	m_lastWorldFps = 0;
+	m_pathQueueDepth = m_pathServiced = m_pathNodes = 0;
+	m_edgesRecomputed = m_edgesReused = 0;
 	foreach_enum (TimerSection, s) {
 		m_currentTickTimers[s] = Chrono();
 		m_totalTimers[s] = Chrono();
@@ -136,6 +138,17 @@ void DebugStats::tick(int renderFps, int worldFps) {
 	doPerformanceReport();
 }
 
+void DebugStats::addPathRequestLatency(int unitId, int frames, int64 micros) {
+	PathLatency latency;
+	latency.unitId = unitId;
+	latency.frames = frames;
+	latency.micros = micros;
+	m_pathLatencies.push_back(latency);
+	if (m_pathLatencies.size() > 8) {
+		m_pathLatencies.pop_front();
+	}
+}
+
 void DebugStats::reportTotal(TimerSection section, stringstream &stream) {
 	int64 time = m_totalTimers[section].getMillis();
 	stream << "   " << formatEnumName(TimerSectionNames[section]) << " : " << formatTime(time) << endl;
@@ -194,7 +207,9 @@ void DebugStats::report(ostream &stream) {
 	if (m_debugSections[DebugSection::CLUSTER_MAP]) {
 		stream << "ClusterMap size (Field::LAND):\n"
 			<< "   Nodes = " << Search::Transition::NumTransitions(Field::LAND) << endl
-			<< "   Edges = " << Search::Edge::NumEdges(Field::LAND) << endl;
+			<< "   Edges = " << Search::Edge::NumEdges(Field::LAND) << endl
+			<< "   Edges recomputed last tick = " << m_edgesRecomputed << endl
+			<< "   Edges re-used last tick = " << m_edgesReused << endl;
 	}
 	if (m_debugSections[DebugSection::PARTICLE_USE]) {
 		stream << "Particle usage counts:\n";
@@ -202,6 +217,15 @@ void DebugStats::report(ostream &stream) {
 			stream << "   " << ParticleUseNames[use] << " : " << ParticleSystem::getParticleUse(use) << endl;
 		}
 	}
+	if (m_debugSections[DebugSection::PATH_REQUESTS]) {
+		stream << "\nPath requests:\n"
+			<< "   Queue depth: " << m_pathQueueDepth << endl
+			<< "   Serviced last frame: " << m_pathServiced << " (" << m_pathNodes << " nodes)" << endl
+			<< "   Latency (unit : frames, time):\n";
+		foreach_const (PathLatencies, it, m_pathLatencies) {
+			stream << "      " << it->unitId << " : " << it->frames << ", " << it->micros << "us" << endl;
+		}
+	}
 }
 
 void DebugStats::doPerformanceReport() {
@@ -15,6 +15,7 @@
 #include "util.h"
 
 #include "properties.h"
+#include "worker_pool.h"
 
 namespace Glest { namespace Debug {
 
@@ -36,6 +37,8 @@ STRINGY_ENUM( TimerSection,
 	RENDER_SELECT,
 
 	WORLD_TOTAL,
+	WORLD_UNIT_INTENT,
+	WORLD_UNIT_COMMIT,
 
 	PATHFINDER_TOTAL,
 	PATHFINDER_LOWLEVEL,
@@ -58,13 +61,22 @@ STRINGY_ENUM( DebugSection,
 	WORLD,
 	RESOURCES,
 	CLUSTER_MAP,
-	PARTICLE_USE
+	PARTICLE_USE,
+	PATH_REQUESTS
 )
 
 class DebugStats {
 public:
 	typedef std::deque<int64> TickRecords;
 
+	/** time taken to service a queued path request */
+	struct PathLatency {
+		int		unitId;
+		int		frames;
+		int64	micros;
+	};
+	typedef std::deque<PathLatency> PathLatencies;
+
 private:
 	// Performance
 	Chrono		m_totalTimers[TimerSection::COUNT];
@@ -82,6 +94,13 @@ private:
 
 	int			m_lastRenderFps, m_lastWorldFps;
 
+	// Path requests
+	int			m_pathQueueDepth, m_pathServiced, m_pathNodes;
+	PathLatencies m_pathLatencies;	/**< the most recently serviced requests, newest last */
+
+	// ClusterMap updates, last tick
+	int			m_edgesRecomputed, m_edgesReused;
+
 	string		m_performanceReportCache;
 
 private:
@@ -110,6 +129,18 @@ public:
 	}
 	void tick(int renderFps, int worldFps);
 
+	void setPathQueueStats(int depth, int serviced, int nodes) {
+		m_pathQueueDepth = depth;
+		m_pathServiced = serviced;
+		m_pathNodes = nodes;
+	}
+	void addPathRequestLatency(int unitId, int frames, int64 micros);
+
+	void setClusterMapStats(int edgesRecomputed, int edgesReused) {
+		m_edgesRecomputed = edgesRecomputed;
+		m_edgesReused = edgesReused;
+	}
+
 	bool isEnabled(DebugSection section) const { return m_debugSections[section]; }
 	bool isEnabled(TimerSection section) const { return m_reportSections[section]; }
 	bool isEnabled(TimerReportFlag flag) const { return m_reportFlags[flag]; }
@@ -123,13 +154,21 @@ public:
 
 extern DebugStats *g_debugStats; // hokey pokey
 
+/** Times the enclosing scope. The timers are not thread safe, so scopes run on
+  * WorkerPool threads go untimed. */
 struct StackTimer {
 	TimerSection m_section;
-	StackTimer(TimerSection section) : m_section(section) {
-		g_debugStats->enterSection(m_section);
+	bool         m_timing;
+	StackTimer(TimerSection section)
+			: m_section(section), m_timing(!WorkerPool::isWorkerThread()) {
+		if (m_timing) {
+			g_debugStats->enterSection(m_section);
+		}
 	}
 	~StackTimer() {
-		g_debugStats->exitSection(m_section);
+		if (m_timing) {
+			g_debugStats->exitSection(m_section);
+		}
 	}
 };
 
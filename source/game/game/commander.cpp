@@ -76,6 +76,13 @@ CmdResult Commander::tryGiveCommand(const Selection *selection, CmdFlags flags,
 	Vec2i refPos = computeRefPos(selection);
 	CmdResults results;
 
+	// big groups sent to a position share a flow field, see RoutePlanner::findPathToLocation()
+	CmdFlags posFlags = flags;
+	const int &groupSize = g_config.getGsFlowFieldGroupSize();
+	if (pos != Command::invalidPos && groupSize && selection->getCount() >= groupSize) {
+		posFlags.set(CmdProps::GROUP_MOVE, true);
+	}
+
 	// give orders to all selected units
 	const UnitVector &units = selection->getUnits();
 	CmdResult result;
@@ -173,7 +180,7 @@ CmdResult Commander::tryGiveCommand(const Selection *selection, CmdFlags flags,
 			} else if(pos != Command::invalidPos) { // 'position' based command
 				//every unit is ordered to a different pos
 				Vec2i currPos = computeDestPos(refPos, (*i)->getPos(), pos);
-				result = pushCommand(g_world.newCommand(effectiveCt, flags, currPos, *i));
+				result = pushCommand(g_world.newCommand(effectiveCt, posFlags, currPos, *i));
 			} else {
 				result = pushCommand(g_world.newCommand(effectiveCt, flags, Command::invalidPos, *i));
 			}
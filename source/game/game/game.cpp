@@ -27,8 +27,10 @@
 #include "auto_test.h"
 #include "profiler.h"
 #include "cluster_map.h"
+#include "route_planner.h"
 #include "sim_interface.h"
 #include "network_interface.h"
+#include "replay.h"
 #include "game_menu.h"
 #include "resource_bar.h"
 #include "mouse_cursor.h"
@@ -95,6 +97,7 @@ GameState::GameState(Program &program)
 		, m_modalDialog(0)
 		, m_chatDialog(0)
 		, m_debugPanel(0)
+		, m_waitingLabel(0)
 		, lastMousePos(0)
 		, weatherParticleSystem(0)
 		, m_options(0) {
@@ -203,6 +206,14 @@ void GameState::init() {
 	m_gameMenu = new GameMenu();
 	m_gameMenu->setVisible(false);
 
+	m_waitingLabel = new StaticText(&g_program);
+	m_waitingLabel->setText(g_lang.get("WaitingForServer"));
+	Vec2i sz = m_waitingLabel->getTextDimensions();
+	m_waitingLabel->setPos(Vec2i(g_metrics.getScreenW() / 2 - sz.w / 2, g_metrics.getScreenH() / 3));
+	m_waitingLabel->setSize(sz);
+	m_waitingLabel->setAlignment(Alignment::CENTERED);
+	m_waitingLabel->setVisible(false);
+
 	///@todo StaticText (?) for script message
 	m_scriptDisplayPos = Vec2i(175, g_metrics.getScreenH() - 64);
 
@@ -273,6 +284,22 @@ void GameState::init() {
 	int maxUpdtBacklog = simInterface->launchGame();
 	program.setMaxUpdateBacklog(maxUpdtBacklog);
 
+	if (program.getCmdArgs().isTest("unit-update")) {
+		g_world.benchmarkUnitUpdate(200);
+	}
+	if (program.getCmdArgs().isTest("path-search")) {
+		g_routePlanner.benchmarkLowLevel(1000);
+	}
+	if (ReplayInterface *replay = simInterface->asReplayInterface()) {
+		const int seekFrame = program.getCmdArgs().getSeekFrame();
+		if (program.getCmdArgs().isTest("replay")) {
+			replay->runHeadless(seekFrame > 0 ? seekFrame : -1);
+			exitProgram = true;
+		} else if (seekFrame > 0) {
+			replay->fastForward(seekFrame);
+		}
+	}
+
 	g_logger.logProgramEvent("Starting music stream", true);
 	if (g_world.getThisFaction()) {
 		StrSound *gameMusic = g_world.getThisFaction()->getType()->getMusic();
@@ -335,6 +362,9 @@ void GameState::update() {
 		// Gui
 		gui.update();
 
+		// only once the keyframe buffer has run dry, not while it refills
+		m_waitingLabel->setVisible(simInterface->isWaitingForServer());
+
 	} catch (Net::NetworkError &e) {
 		LOG_NETWORK(e.what());
 		displayError(e);
@@ -368,6 +398,7 @@ void GameState::displayError(std::exception &e) {
 	if (m_gameMenu->isVisible()) {
 		toggleGameMenu();
 	}
+	m_waitingLabel->setVisible(false);
 	gui.resetState();
 	Vec2i screenDims = g_metrics.getScreenDims();
 	Vec2i size(screenDims.x - 200, screenDims.y / 2);
@@ -110,6 +110,7 @@ protected:
 	DebugPanel*     m_debugPanel;
 	GameMenu*       m_gameMenu;
 	OptionsFrame*   m_options;
+	StaticText*     m_waitingLabel;	/**< shown while a network client's keyframe buffer is empty */
 
 	Vec2i lastMousePos;
 
@@ -24,6 +24,7 @@
 #include "game_constants.h"
 #include "simulation_enums.h"
 #include "input_enums.h"
+#include "mandate_ai_enums.h"
 
 #include "menu_state_root.h"
 #include "widget_style.h"
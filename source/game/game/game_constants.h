@@ -76,6 +76,7 @@ namespace Glest {
 					KEY_FRAME,
 					SKILL_CYCLE_TABLE,
 					SYNC_ERROR,
+					SYNC_HASH,
 					QUIT,
 					INVALID_MSG
 		)
@@ -120,6 +121,7 @@ namespace GameConstants {
 	const int clusterSize = 16;
 
 	const int saveGameVersion = 5;
+	const int replayVersion = 1;
 }
 
 namespace Gui {
@@ -35,6 +35,7 @@ GameSettings::GameSettings(const XmlNode *node) {
 	fogOfWar = node->getChildBoolValue("fogOfWar");
 	shroudOfDarkness = node->getChildBoolValue("shroudOfDarkness");
 	randomStartLocs = node->getChildBoolValue("randomStartLocs");
+	jumpPointSearch = node->getOptionalBoolValue("jumpPointSearch");
 
 	defaultUnits = node->getChildBoolValue("defaultUnits");
 	defaultResources = node->getChildBoolValue("defaultResources");
@@ -99,6 +100,7 @@ void GameSettings::clear() {
 	fogOfWar = true;
 	shroudOfDarkness = true;
 	randomStartLocs = false;
+	jumpPointSearch = false;
 	mapEditor = false;
 }
 
@@ -168,6 +170,7 @@ void GameSettings::save(XmlNode *node) const {
 	node->addChild("fogOfWar", fogOfWar);
 	node->addChild("shroudOfDarkness", shroudOfDarkness);
 	node->addChild("randomStartLocs", randomStartLocs);
+	node->addChild("jumpPointSearch", jumpPointSearch);
 	node->addChild("defaultUnits", defaultUnits);
 	node->addChild("defaultResources", defaultResources);
 	node->addChild("defaultVictoryConditions", defaultVictoryConditions);
@@ -55,6 +55,7 @@ private:
 	bool fogOfWar;
 	bool shroudOfDarkness;
 	bool randomStartLocs;
+	bool jumpPointSearch;
 
 	bool mapEditor;
 
@@ -94,6 +95,7 @@ public:
 	bool getFogOfWar() const						{return fogOfWar;}
 	bool getShroudOfDarkness() const				{return shroudOfDarkness;}
 	bool getRandomStartLocs() const					{return randomStartLocs;}
+	bool getJumpPointSearch() const					{return jumpPointSearch;}
 
 	//set
 	void setDescription(const string& v)			{description = v;}
@@ -119,6 +121,7 @@ public:
 	void setFogOfWar(bool v)						{fogOfWar = v;}
 	void setShroudOfDarkness(bool v)				{shroudOfDarkness = v;}
 	void setRandomStartLocs(bool v)					{randomStartLocs = v;}
+	void setJumpPointSearch(bool v)					{jumpPointSearch = v;}
 	void enableMapEditor()					        {mapEditor = true;}
 	bool getMapEditor()                             {return mapEditor;}
 
@@ -53,11 +53,15 @@ Config::Config(const char* fileName) {
 	gsAutoRepairEnabled = p->getBool("GsAutoRepairEnabled", true);
 	gsAutoReturnEnabled = p->getBool("GsAutoReturnEnabled", false);
 	gsDayTime = p->getFloat("GsDayTime", 1000.f);
+	gsFlowFieldGroupSize = p->getInt("GsFlowFieldGroupSize", 12, 0, 1000);
+	gsJumpPointSearch = p->getBool("GsJumpPointSearch", false);
+	gsUnitUpdateThreads = p->getInt("GsUnitUpdateThreads", 1, 1, 64);
 	gsWorldUpdateFps = p->getInt("GsWorldUpdateFps", 40);
 	miscCatchExceptions = p->getBool("MiscCatchExceptions", true);
 	miscDebugKeys = p->getBool("MiscDebugKeys", false);
 	miscDebugMode = p->getBool("MiscDebugMode", false);
 	miscFirstTime = p->getBool("MiscFirstTime", true);
+	miscRecordReplays = p->getBool("MiscRecordReplays", true);
 	netAnnouceOnLAN = p->getBool("NetAnnouceOnLAN", true);
 	netAnnouncePort = p->getInt("NetAnnouncePort", 4950, 1024, 65535);
 	netConsistencyChecks = p->getBool("NetConsistencyChecks", false);
@@ -177,11 +181,15 @@ void Config::save(const char *path) {
 	p->setBool("GsAutoRepairEnabled", gsAutoRepairEnabled);
 	p->setBool("GsAutoReturnEnabled", gsAutoReturnEnabled);
 	p->setFloat("GsDayTime", gsDayTime);
+	p->setInt("GsFlowFieldGroupSize", gsFlowFieldGroupSize);
+	p->setBool("GsJumpPointSearch", gsJumpPointSearch);
+	p->setInt("GsUnitUpdateThreads", gsUnitUpdateThreads);
 	p->setInt("GsWorldUpdateFps", gsWorldUpdateFps);
 	p->setBool("MiscCatchExceptions", miscCatchExceptions);
 	p->setBool("MiscDebugKeys", miscDebugKeys);
 	p->setBool("MiscDebugMode", miscDebugMode);
 	p->setBool("MiscFirstTime", miscFirstTime);
+	p->setBool("MiscRecordReplays", miscRecordReplays);
 	p->setBool("NetAnnouceOnLAN", netAnnouceOnLAN);
 	p->setInt("NetAnnouncePort", netAnnouncePort);
 	p->setBool("NetConsistencyChecks", netConsistencyChecks);
@@ -48,11 +48,15 @@ private:
 	bool gsAutoRepairEnabled;
 	bool gsAutoReturnEnabled;
 	float gsDayTime;
+	int gsFlowFieldGroupSize;
+	bool gsJumpPointSearch;
+	int gsUnitUpdateThreads;
 	int gsWorldUpdateFps;
 	bool miscCatchExceptions;
 	bool miscDebugKeys;
 	bool miscDebugMode;
 	bool miscFirstTime;
+	bool miscRecordReplays;
 	bool netAnnouceOnLAN;
 	int netAnnouncePort;
 	bool netConsistencyChecks;
@@ -181,11 +185,15 @@ public:
 	bool getGsAutoRepairEnabled() const			{return gsAutoRepairEnabled;}
 	bool getGsAutoReturnEnabled() const			{return gsAutoReturnEnabled;}
 	float getGsDayTime() const					{return gsDayTime;}
+	int getGsFlowFieldGroupSize() const		{return gsFlowFieldGroupSize;}
+	bool getGsJumpPointSearch() const			{return gsJumpPointSearch;}
+	int getGsUnitUpdateThreads() const			{return gsUnitUpdateThreads;}
 	int getGsWorldUpdateFps() const				{return gsWorldUpdateFps;}
 	bool getMiscCatchExceptions() const			{return miscCatchExceptions;}
 	bool getMiscDebugKeys() const				{return miscDebugKeys;}
 	bool getMiscDebugMode() const				{return miscDebugMode;}
 	bool getMiscFirstTime() const				{return miscFirstTime;}
+	bool getMiscRecordReplays() const			{return miscRecordReplays;}
 	bool getNetAnnouceOnLAN() const				{return netAnnouceOnLAN;}
 	int getNetAnnouncePort() const				{return netAnnouncePort;}
 	bool getNetConsistencyChecks() const		{return netConsistencyChecks;}
@@ -296,11 +304,15 @@ public:
 	void setGsAutoRepairEnabled(bool val)		{gsAutoRepairEnabled = val;}
 	void setGsAutoReturnEnabled(bool val)		{gsAutoReturnEnabled = val;}
 	void setGsDayTime(float val)				{gsDayTime = val;}
+	void setGsFlowFieldGroupSize(int val)		{gsFlowFieldGroupSize = val;}
+	void setGsJumpPointSearch(bool val)		{gsJumpPointSearch = val;}
+	void setGsUnitUpdateThreads(int val)		{gsUnitUpdateThreads = val;}
 	void setGsWorldUpdateFps(int val)			{gsWorldUpdateFps = val;}
 	void setMiscCatchExceptions(bool val)		{miscCatchExceptions = val;}
 	void setMiscDebugKeys(bool val)				{miscDebugKeys = val;}
 	void setMiscDebugMode(bool val)				{miscDebugMode = val;}
 	void setMiscFirstTime(bool val)				{miscFirstTime = val;}
+	void setMiscRecordReplays(bool val)			{miscRecordReplays = val;}
 	void setNetAnnouceOnLAN(bool val)			{netAnnouceOnLAN = val;}
 	void setNetAnnouncePort(int val)			{netAnnouncePort = val;}
 	void setNetConsistencyChecks(bool val)		{netConsistencyChecks = val;}
@@ -762,16 +762,27 @@ void Renderer::computeVisibleArea() {
 
 	World &world = g_world;
 
-	// map objects
+	// map objects, on explored tiles in view, the explored plane is masked to each
+	// row's span of visible tiles so unexplored stretches are skipped a word at a time
+	typedef VisibilityPlanes::Word Word;
 	Map *map = world.getMap();
+	const VisibilityPlanes &planes = map->getVisibility();
 	int thisTeamIndex = world.getThisTeamIndex();
-	for (SceneCuller::iterator it = culler.tile_begin(); it != culler.tile_end(); ++it ) {
-		const Vec2i &pos = *it;
-		if (!map->isInsideTile(pos)) continue;
-		Tile *tile = map->getTile(pos);
-		MapObject *o = tile->getObject();
-		if (o && tile->isExplored(thisTeamIndex)) {
-			m_objectsToRender.push_back(o);
+	for (int i = 0; i < culler.getTileSpanCount(); ++i) {
+		const int y = culler.getTileSpanY(i);
+		const int x0 = std::max(culler.getTileSpan(i).first, 0);
+		const int x1 = std::min(culler.getTileSpan(i).second, map->getTileW() - 1);
+		if (y < 0 || y >= map->getTileH() || x0 > x1) continue;
+		const Word *row = planes.getExploredRow(thisTeamIndex, y);
+		for (int wx = x0 / VisibilityPlanes::wordBits; wx <= x1 / VisibilityPlanes::wordBits; ++wx) {
+			Word bits = row[wx] & VisibilityPlanes::spanMask(wx, x0, x1);
+			while (bits) {
+				const int x = wx * VisibilityPlanes::wordBits + VisibilityPlanes::lowestBit(bits);
+				bits &= bits - 1;
+				if (MapObject *o = map->getTile(x, y)->getObject()) {
+					m_objectsToRender.push_back(o);
+				}
+			}
 		}
 	}
 
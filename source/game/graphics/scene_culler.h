@@ -271,6 +271,14 @@ public:
 
 	Rect2i getBoundingRectCell() const { return cellExtrema.getBounds();	}
 	Rect2i getBoundingRectTile() const { return tileExtrema.getBounds();	}
+
+	/** the visible tiles as rows of spans, for walking a row at a time rather than
+	  * tile by tile, row i is tile row getTileSpanY(i) from tile x first to second */
+	int getTileSpanCount() const {
+		return tileExtrema.max_y - tileExtrema.min_y ? int(tileExtrema.spans.size()) : 0;
+	}
+	int getTileSpanY(int i) const							{ return tileExtrema.min_y + i;	}
+	const pair<int,int>& getTileSpan(int i) const			{ return tileExtrema.spans[i];	}
 };
 
 
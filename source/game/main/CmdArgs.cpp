@@ -13,6 +13,7 @@
 #include "CmdArgs.h"
 
 #include <iostream>
+#include <cstdlib>
 
 #include "projectConfig.h"
 #include "util.h"
@@ -36,6 +37,7 @@ CmdArgs::CmdArgs(){
 	test = false;
 	m_redirStreams = true; // ignored on Linux
 	m_lastGame = false;
+	m_seekFrame = 0;
 }
 
 CmdArgs::~CmdArgs(){
@@ -69,6 +71,10 @@ bool CmdArgs::parse(int argc, char **argv){
 			this->scenario = argv[++i];
 		} else if (arg == "-lastgame") {
 			this->m_lastGame = true;
+		} else if (arg == "-replay" && (i+1) < argc) {
+			m_replay = argv[++i];
+		} else if (arg == "-seek" && (i+1) < argc) {
+			m_seekFrame = atoi(argv[++i]);
 		} else if (arg == "-test" && (i+1) < argc) {
 			test = true;
 			testType = argv[++i];
@@ -83,7 +89,10 @@ bool CmdArgs::parse(int argc, char **argv){
 				<< "  -datadir path            set location of data\n"
 				<< "  -loadmap map tileset     load maps/map.gbm with tilesets/tileset for map preview\n"
 				<< "  -scenario category name  load immediately scenario/category/name\n"
-				<< "  -lastgame                immediately start a game with the last used game settings\n";
+				<< "  -lastgame                immediately start a game with the last used game settings\n"
+				<< "  -replay file             watch a recorded game, with -test replay re-simulate it\n"
+				<< "                           without rendering as fast as possible and report the time\n"
+				<< "  -seek frame              skip the replay to frame before showing it\n";
 			return true;
 		}else if(arg=="-list-tilesets"){  //FIXME: only works with physfs
 				cout << "config: " << configDir << "\ndata: " << dataDir << endl;
@@ -40,6 +40,10 @@ private:
 	string scenario;
 
 	bool m_lastGame;
+	/// not empty if -replay, contains following argument as path
+	string m_replay;
+	/// frame to skip to in the replay, 0 if no -seek
+	int m_seekFrame;
 	bool test;
 	string testType;
 
@@ -67,6 +71,8 @@ public:
 	bool isTest(const string &type) const { return (test && testType == type); }
 	bool redirStreams() const { return m_redirStreams; }
 	bool isLoadLastGame() const { return m_lastGame; }
+	const string &getReplay() const { return m_replay; }
+	int getSeekFrame() const { return m_seekFrame; }
 };
 
 }} //namespaces
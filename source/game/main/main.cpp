@@ -150,6 +150,7 @@ int glestMain(int argc, char** argv) {
 	mkdir(configDir + "/addons/", true);
 	mkdir(configDir + "/screens/", true);
 	mkdir(configDir + "/savegames/", true);
+	mkdir(configDir + "/replays/", true);
 
 	try {
 		g_fileFactory.initPhysFS(argv[0], configDir, dataDir);
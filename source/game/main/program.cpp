@@ -30,6 +30,7 @@
 #include "menu_state_map_editor.h"
 #include "sim_interface.h"
 #include "network_interface.h"
+#include "replay.h"
 #include "test_pane.h"
 #include "texture_gl.h"
 #include "leak_dumper.h"
@@ -214,6 +215,19 @@ bool Program::init() {
 			return false;
 		}
 
+	// watch (or with -test replay, time) a recorded game
+	} else if (!cmdArgs.getReplay().empty()) {
+		try {
+			setSimInterface(new ReplayInterface(*this, cmdArgs.getReplay()));
+		} catch (runtime_error &e) {
+			std::stringstream ss;
+			ss << "Error trying to load replay '" << cmdArgs.getReplay() << "'\nException: " << e.what();
+			cout << ss.str();
+			g_logger.logError(ss.str());
+			return false;
+		}
+		setState(new GameState(*this));
+
 	// load last game settings
 	} else if (cmdArgs.isLoadLastGame()) {
 		try {
@@ -625,6 +625,7 @@ void MenuStateNewGame::update() {
 			assert(!hasUnconnectedSlots());
 			GameSettings &gs = g_simInterface.getGameSettings();
 			gs.compact();
+			gs.setJumpPointSearch(g_config.getGsJumpPointSearch());
 			g_config.save();
 			gs.setSovereignType(m_sovereignList->getSelectedItem()->getText());
 			XmlTree *doc = new XmlTree("game-settings");
@@ -39,6 +39,84 @@ using Shared::Platform::Chrono;
 
 namespace Glest { namespace Net {
 
+// =====================================================
+//	class MessageReceiver
+// =====================================================
+
+MessageReceiver::MessageReceiver(Socket *socket)
+		: m_socket(socket), m_holding(false), m_stop(0), m_failed(0) {
+}
+
+MessageReceiver::~MessageReceiver() {
+	Received msg;
+	while (m_queue.pop(msg)) {
+		delete [] msg.raw.data;
+	}
+	if (m_holding) {
+		delete [] m_held.raw.data;
+	}
+}
+
+void MessageReceiver::execute() {
+	try {
+		while (!m_stop) {
+			if (!readMessages()) {
+				sleep(idleSleepTime);
+			}
+		}
+	} catch (std::exception &e) {
+		m_error = e.what();
+		memoryBarrier();
+		m_failed = 1;
+	}
+}
+
+void MessageReceiver::stop() {
+	m_stop = 1;
+	join();
+}
+
+/** split what has arrived into messages & queue them
+  * @return true if anything was queued */
+bool MessageReceiver::readMessages() {
+	if (m_holding) {
+		if (!m_queue.push(m_held)) {
+			return false; // main thread is behind, leave the rest in the socket
+		}
+		m_holding = false;
+	}
+	if (!m_socket->isConnected()) {
+		return false;
+	}
+	bool queued = false;
+	size_t n = m_socket->getDataToRead();
+	while (n >= MsgHeader::headerSize) {
+		MsgHeader header;
+		m_socket->peek(&header, MsgHeader::headerSize);
+		if (n < MsgHeader::headerSize + header.messageSize) {
+			break;
+		}
+		Received msg;
+		msg.raw.type = header.messageType;
+		msg.raw.size = header.messageSize;
+		msg.raw.data = 0;
+		m_socket->skip(MsgHeader::headerSize);
+		if (header.messageSize) {
+			msg.raw.data = new uint8[header.messageSize];
+			m_socket->receive(msg.raw.data, header.messageSize);
+		}
+		msg.arrivalTime = Chrono::getCurMillis();
+		if (!m_queue.push(msg)) {
+			m_held = msg;
+			m_holding = true;
+			return queued;
+		}
+		queued = true;
+		n = m_socket->getDataToRead();
+	}
+	return queued;
+}
+
 // =====================================================
 //	class ClientInterface
 // =====================================================
@@ -49,18 +127,27 @@ ClientInterface::ClientInterface(Program &prog)
 	launchGame = false;
 	introDone = false;
 	playerIndex = -1;
+	m_receiver = 0;
+	m_keyFrameTarget = minKeyFrameBuffer;
+	m_steadyKeyFrames = 0;
+	m_stalled = false;
+	m_stallStart = 0;
+	m_lastKeyFrameTime = 0;
+	m_outOfSync = false;
 }
 
 ClientInterface::~ClientInterface() {
 	if (game || program.isTerminating()) {
 		quitGame(QuitSource::LOCAL);
 	}
+	stopReceiver();
 	delete clientSocket;
 	clientSocket = NULL;
 }
 
 void ClientInterface::connect(const Ip &ip, int port) {
 	NETWORK_LOG( __FUNCTION__ << " connecting to " << ip.getString() << ":" << port );
+	stopReceiver();
 	delete clientSocket;
 	clientSocket = new ClientSocket();
 	clientSocket->connect(ip, port);
@@ -69,6 +156,7 @@ void ClientInterface::connect(const Ip &ip, int port) {
 
 void ClientInterface::reset() {
 	NETWORK_LOG( __FUNCTION__ );
+	stopReceiver();
 	delete clientSocket;
 	clientSocket = NULL;
 }
@@ -230,9 +318,129 @@ void ClientInterface::quitGame(QuitSource source) {
 
 void ClientInterface::startGame() {
 	NETWORK_LOG( __FUNCTION__ );
+	startReceiver();
 	updateKeyframe(0);
 }
 
+/** hand the socket to a MessageReceiver, anything already read goes through the
+  * same path as what it reads */
+void ClientInterface::startReceiver() {
+	assert(!m_receiver);
+	m_lastKeyFrameTime = Chrono::getCurMillis();
+	while (hasMessage()) {
+		processMessage(getNextMessage(), m_lastKeyFrameTime);
+	}
+	m_receiver = new MessageReceiver(clientSocket);
+	m_receiver->start();
+}
+
+void ClientInterface::stopReceiver() {
+	if (m_receiver) {
+		m_receiver->stop();
+		delete m_receiver;
+		m_receiver = 0;
+	}
+	foreach (deque<RawMessage>, it, m_keyFrames) {
+		delete [] it->data;
+	}
+	m_keyFrames.clear();
+}
+
+/** take everything the receiver has read, keyframes are buffered, chat & quit
+  * messages handled now */
+void ClientInterface::processReceived() {
+	if (m_receiver->hasFailed()) {
+		throw Disconnect(m_receiver->getError());
+	}
+	MessageReceiver::Received msg;
+	while (m_receiver->pop(msg)) {
+		processMessage(msg.raw, msg.arrivalTime);
+	}
+}
+
+void ClientInterface::processMessage(RawMessage raw, int64 arrivalTime) {
+	if (raw.type == MessageType::KEY_FRAME) {
+		m_keyFrames.push_back(raw);
+		m_lastKeyFrameTime = arrivalTime;
+	} else if (raw.type == MessageType::TEXT) {
+		TextMessage textMsg(raw);
+		NETWORK_LOG( "Received text message from server. Size: " << raw.size << " from: "
+			<< textMsg.getSender() << " msg: " << textMsg.getText() );
+		NetworkInterface::processTextMessage(textMsg);
+	} else if (raw.type == MessageType::SYNC_HASH) {
+		SyncHashMessage reply(raw);
+		processSyncHash(reply);
+	} else if (raw.type == MessageType::QUIT) {
+		NETWORK_LOG( "Received quit message from server." );
+		QuitMessage quitMsg(raw);
+		quitGame(QuitSource::SERVER);
+	} else {
+		throw InvalidMessage(MessageType::KEY_FRAME, raw.type);
+	}
+}
+
+/** block until the next keyframe is here, only for the first one, after that
+  * getFramesDue() holds the game instead */
+void ClientInterface::waitForKeyFrame() {
+	Chrono chrono;
+	chrono.start();
+	processReceived();
+	while (m_keyFrames.empty()) {
+		if (chrono.getMillis() > messageWaitTimeout) {
+			throw TimeOut(NetSource::SERVER);
+		}
+		sleep(2);
+		processReceived();
+	}
+}
+
+/** The game only runs on keyframes it has, the next one must be here before the
+  * frame that uses it is processed. When the buffer runs dry the game holds until
+  * m_keyFrameTarget have arrived, and the target goes up by one, so the delay grows
+  * to cover the jitter seen. After keyFrameShrinkPeriod keyframes without running
+  * short the target comes down again, and a surplus over the target is worked off
+  * by running two frames an update, so the delay doesn't stay high once the
+  * connection settles. */
+int ClientInterface::getFramesDue() {
+	processReceived();
+	const int period = GameConstants::networkFramePeriod;
+	const int buffered = int(m_keyFrames.size());
+	if (m_stalled) {
+		if (buffered < m_keyFrameTarget) {
+			if (Chrono::getCurMillis() - m_lastKeyFrameTime > messageWaitTimeout) {
+				throw TimeOut(NetSource::SERVER);
+			}
+			return 0;
+		}
+		NETWORK_LOG( __FUNCTION__ << " resuming after " << (Chrono::getCurMillis() - m_stallStart)
+			<< " ms, " << buffered << " keyframes buffered" );
+		m_stalled = false;
+	}
+	const int frame = world->getFrameCount();
+	const int framesToKeyFrame = period - frame % period;
+	if (!buffered && framesToKeyFrame == 1) {
+		// next frame ends with a keyframe update, hold rather than wait on the socket there
+		m_stalled = true;
+		m_stallStart = Chrono::getCurMillis();
+		m_steadyKeyFrames = 0;
+		if (m_keyFrameTarget < maxKeyFrameBuffer) {
+			++m_keyFrameTarget;
+			NETWORK_LOG( __FUNCTION__ << " out of keyframes at frame " << frame
+				<< ", buffer target now " << m_keyFrameTarget );
+		}
+		return 0;
+	}
+	if (buffered > m_keyFrameTarget) {
+		return 2; // further behind than the target delay, catch up
+	}
+	return 1;
+}
+
+bool ClientInterface::isWaitingForServer() const {
+	return m_stalled && m_keyFrames.empty()
+		&& Chrono::getCurMillis() - m_stallStart > stallGraceTime;
+}
+
 void ClientInterface::update() {
 	// chat messages
 	while (hasChatMsg()) {
@@ -255,35 +463,116 @@ void ClientInterface::update() {
 	}
 }
 
-void ClientInterface::updateKeyframe(int frameCount) {
-	// give all commands from last KeyFrame
-	for (size_t i=0; i < keyFrame.getCmdCount(); ++i) {
-		pendingCommands.push_back(*keyFrame.getCmd(i));
+/** Compare our world with the server's as at the end of the keyframe just used up,
+  * if they differ ask the server for its faction hashes, processSyncHash() carries on
+  * from the reply. The game carries on meanwhile, further keyframes aren't checked. */
+void ClientInterface::checkWorldHash(int frameCount) {
+	if (m_outOfSync || keyFrame.getFrameCount() != frameCount) {
+		return; // already looking, or no keyframe for this frame yet (the first)
 	}
-	while (true) {
-		waitForMessage();
-		RawMessage raw = getNextMessage();
-		if (raw.type == MessageType::KEY_FRAME) {
-			keyFrame = KeyFrame(raw);
-			NETWORK_LOG( __FUNCTION__ << " received keyframe " << (keyFrame.getFrameCount() / GameConstants::networkFramePeriod)
-				<< " @ frame " << frameCount );
-			if (keyFrame.getFrameCount() != frameCount + GameConstants::networkFramePeriod) {
-				throw GameSyncError("frame count mismatch. Probable garbled message or memory corruption");
+	m_worldHash.compute(world);
+	if (m_worldHash.getHash() == keyFrame.getWorldHash()) {
+		return;
+	}
+	NETWORK_LOG( __FUNCTION__ << " world hash differs from the server's at frame " << frameCount );
+	m_outOfSync = true;
+	SyncHashMessage query(frameCount, SyncHashLevel::FACTIONS);
+	send(&query);
+}
+
+namespace {
+	/** @return the index of the first entry that differs between a & b, or -1 */
+	int firstDifference(const vector<WorldHash::Entry> &a, const vector<WorldHash::Entry> &b) {
+		for (size_t i = 0; i < a.size() || i < b.size(); ++i) {
+			if (i == a.size() || i == b.size() || a[i].id != b[i].id || a[i].hash != b[i].hash) {
+				return int(i);
 			}
-			return;
-		} else if (raw.type == MessageType::TEXT) {
-			TextMessage textMsg(raw);
-			NETWORK_LOG( "Received text message from server. Size: " << raw.size << " from: "
-				<< textMsg.getSender() << " msg: " << textMsg.getText() );
-			NetworkInterface::processTextMessage(textMsg);
-		} else if (raw.type == MessageType::QUIT) {
-			NETWORK_LOG( "Received quit message from server." );
-			QuitMessage quitMsg(raw);
-			quitGame(QuitSource::SERVER);
-			return;
+		}
+		return -1;
+	}
+}
+
+/** One level of narrowing down a desync, compare the server's hashes with ours and
+  * ask about the first that differs a level down, or report it if it's a unit. */
+void ClientInterface::processSyncHash(const SyncHashMessage &reply) {
+	if (!m_outOfSync || !reply.isReply() || reply.getFrame() != m_worldHash.getFrame()) {
+		throw InvalidMessage(MessageType::KEY_FRAME, MessageType::SYNC_HASH);
+	}
+	const int faction = reply.getFaction();
+	if (!reply.isKnown()) {
+		reportSyncError("the server no longer has its hashes");
+	}
+	vector<WorldHash::Entry> ours;
+	if (reply.getLevel() == SyncHashLevel::FACTIONS) {
+		ours = m_worldHash.getFactionHashes();
+	} else if (reply.getLevel() == SyncHashLevel::RANGES) {
+		m_worldHash.getRangeHashes(faction, ours);
+	} else {
+		m_worldHash.getUnitHashes(faction, reply.getRange(), ours);
+	}
+	const vector<WorldHash::Entry> &theirs = reply.getHashes();
+	const int i = firstDifference(ours, theirs);
+	stringstream ss;
+	if (reply.getLevel() == SyncHashLevel::FACTIONS) {
+		if (i == -1 || i == int(ours.size()) || i == int(theirs.size())) {
+			reportSyncError(i == -1 ? "unknown" : "number of factions");
+		}
+		SyncHashMessage query(reply.getFrame(), SyncHashLevel::RANGES, i);
+		send(&query);
+	} else if (reply.getLevel() == SyncHashLevel::RANGES) {
+		if (i == -1) { // same units, it's in the stored resources or explored tiles
+			ss << "faction " << faction << " resources or explored tiles";
+			reportSyncError(ss.str());
+		}
+		SyncHashMessage query(reply.getFrame(), SyncHashLevel::UNITS, faction, i);
+		send(&query);
+	} else {
+		if (i == -1) {
+			ss << "faction " << faction << " units " << (reply.getRange() * WorldHash::rangeSize) << "+";
+		} else if (i < int(ours.size()) && (i == int(theirs.size()) || ours[i].id < theirs[i].id)) {
+			ss << "unit " << ours[i].id << " not on server";
+		} else if (i == int(ours.size()) || ours[i].id > theirs[i].id) {
+			ss << "unit " << theirs[i].id << " only on server";
 		} else {
-			throw InvalidMessage(MessageType::KEY_FRAME, raw.type);
+			ss << "unit " << ours[i].id;
+			if (const Unit *unit = world->findUnitById(ours[i].id)) {
+				ss << " (" << unit->getType()->getName() << ", faction " << faction << ")";
+			}
 		}
+		reportSyncError(ss.str());
+	}
+}
+
+/** tell everyone where the game went out of sync, and leave it */
+void ClientInterface::reportSyncError(const string &where) {
+	stringstream ss;
+	ss << "Out of sync at frame " << m_worldHash.getFrame() << ": " << where;
+	NETWORK_LOG( __FUNCTION__ << " " << ss.str() );
+	sendTextMessage(ss.str(), -1);
+	throw GameSyncError(ss.str());
+}
+
+void ClientInterface::updateKeyframe(int frameCount) {
+	checkWorldHash(frameCount);
+	// give all commands from last KeyFrame
+	for (size_t i=0; i < keyFrame.getCmdCount(); ++i) {
+		givePlayerCommand(*keyFrame.getCmd(i));
+	}
+	if (m_keyFrames.empty()) {
+		waitForKeyFrame();
+	}
+	RawMessage raw = m_keyFrames.front();
+	m_keyFrames.pop_front();
+	keyFrame.read(raw);
+	NETWORK_LOG( __FUNCTION__ << " using keyframe " << (keyFrame.getFrameCount() / GameConstants::networkFramePeriod)
+		<< " @ frame " << frameCount << ", " << m_keyFrames.size() << " more buffered" );
+	if (keyFrame.getFrameCount() != frameCount + GameConstants::networkFramePeriod) {
+		throw GameSyncError("frame count mismatch. Probable garbled message or memory corruption");
+	}
+	if (++m_steadyKeyFrames >= keyFrameShrinkPeriod && m_keyFrameTarget > minKeyFrameBuffer) {
+		--m_keyFrameTarget;
+		m_steadyKeyFrames = 0;
+		NETWORK_LOG( __FUNCTION__ << " steady, buffer target now " << m_keyFrameTarget );
 	}
 }
 
@@ -13,19 +13,70 @@
 #define _GLEST_GAME_CLIENTINTERFACE_H_
 
 #include <vector>
+#include <deque>
 #include <fstream>
 
 #include "network_interface.h"
 #include "game_settings.h"
 
 #include "socket.h"
+#include "thread.h"
+#include "spsc_queue.h"
 
 using Shared::Platform::Ip;
 using Shared::Platform::ClientSocket;
-using std::vector; //using std::deque;
+using Shared::Platform::Thread;
+using Shared::Platform::int64;
+using Shared::Util::SpscQueue;
+using std::vector;
+using std::deque;
 
 namespace Glest { namespace Net {
 
+// =====================================================
+//	class MessageReceiver
+// =====================================================
+/** Reads a socket on its own thread, splitting the stream into messages & handing
+  * them over through a lock free queue, so the main loop never waits on the socket.
+  * Once started it must be the only reader of the socket, sending from the main
+  * thread is still fine. If reading fails the thread stops & getError() says why. */
+class MessageReceiver : public Thread {
+public:
+	struct Received {
+		RawMessage  raw;
+		int64       arrivalTime;	/**< Chrono::getCurMillis() when read */
+	};
+
+private:
+	typedef SpscQueue<Received, 256> Queue;
+	static const int idleSleepTime = 1; // milli-seconds
+
+	Socket        *m_socket;
+	Queue          m_queue;
+	Received       m_held;			/**< read while the queue was full */
+	bool           m_holding;
+	volatile int   m_stop;
+	volatile int   m_failed;
+	string         m_error;			/**< set before m_failed */
+
+	bool readMessages();
+
+public:
+	MessageReceiver(Socket *socket);
+	~MessageReceiver();
+
+	virtual void execute();
+
+	/** ask the thread to finish & wait for it */
+	void stop();
+
+	/** main thread, @return false if there was nothing waiting */
+	bool pop(Received &msg)		{ return m_queue.pop(msg); }
+
+	bool hasFailed() const		{ return m_failed != 0; }
+	string getError() const		{ return m_error; }
+};
+
 // =====================================================
 //	class ClientInterface
 // =====================================================
@@ -35,12 +86,32 @@ private:
 	static const int messageWaitTimeout = 10000; // 10 seconds
 	static const int waitSleepTime = 5; // 5 milli-seconds
 
+	/** keyframes to hold before resuming after the buffer runs dry, this is the input
+	  * delay the client adds on top of the network's, it adapts to the jitter seen */
+	static const int minKeyFrameBuffer = 1;
+	static const int maxKeyFrameBuffer = 8;
+	/** keyframes in a row with no shortfall before the buffer target is lowered */
+	static const int keyFrameShrinkPeriod = 40;
+	/** milli-seconds without a keyframe before the wait is shown */
+	static const int stallGraceTime = 200;
+
 	ClientSocket *clientSocket;
 	string serverName;
 	bool introDone;
 	bool launchGame;
 	int playerIndex;
 
+	MessageReceiver *m_receiver;	/**< reads the socket from startGame() on */
+	deque<RawMessage> m_keyFrames;	/**< received, not yet used, oldest first */
+	int   m_keyFrameTarget;			/**< keyframes to buffer before resuming after a stall */
+	int   m_steadyKeyFrames;		/**< keyframes used since the last shortfall */
+	bool  m_stalled;				/**< out of keyframes, waiting to refill to the target */
+	int64 m_stallStart;				/**< Chrono::getCurMillis() when the buffer ran dry */
+	int64 m_lastKeyFrameTime;		/**< Chrono::getCurMillis() when the last keyframe arrived */
+
+	WorldHash m_worldHash;			/**< ours at the last keyframe checked */
+	bool      m_outOfSync;			/**< our hash differed from the server's, asking where */
+
 public:
 	ClientInterface(Program &prog);
 	virtual ~ClientInterface();
@@ -71,6 +142,9 @@ protected:
 	virtual void update();
 	virtual void updateKeyframe(int frameCount);
 
+	// keyframe buffering, SimulationInterface virtual
+	virtual int getFramesDue();
+
 	// projectile updates, SimulationInterface virtuals
 	virtual void updateProjectilePath(Unit *u, Projectile *pps, const Vec3f &start, const Vec3f &end);
 
@@ -90,6 +164,9 @@ protected:
 	//misc
 	virtual string getStatus() const;
 
+public:
+	virtual bool isWaitingForServer() const;
+
 public:
 	//accessors
 	string getServerName() const			{return serverName;}
@@ -107,6 +184,15 @@ public:
 private:
 	void waitForMessage(int timeout = messageWaitTimeout);
 
+	void startReceiver();
+	void stopReceiver();
+	void processReceived();
+	void processMessage(RawMessage raw, int64 arrivalTime);
+	void waitForKeyFrame();
+	void checkWorldHash(int frameCount);
+	void processSyncHash(const SyncHashMessage &reply);
+	void reportSyncError(const string &where);
+
 	void doIntroMessage();
 	void doLaunchMessage();
 };
@@ -0,0 +1,189 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "command_codec.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Net {
+
+namespace {
+
+	/** tag byte, low three bits are the NetworkCommandType */
+	struct Tag {
+		enum {
+			TYPE_MASK	= 0x07,
+			POSITION	= 0x08,
+			TARGET		= 0x10,
+			PROD_TYPE	= 0x20,
+			FLAGS		= 0x40,
+			RUN			= 0x80		/**< record covers several units */
+		};
+	};
+
+	/** can b share a's record, everything but the unit the same */
+	bool sameOrder(const NetworkCommand &a, const NetworkCommand &b) {
+		return a.getNetworkCommandType() == b.getNetworkCommandType()
+			&& a.getCommandTypeId() == b.getCommandTypeId()
+			&& a.getPosition() == b.getPosition()
+			&& a.getProdTypeId() == b.getProdTypeId()
+			&& a.getTargetId() == b.getTargetId()
+			&& a.getFlags() == b.getFlags();
+	}
+
+}
+
+void encodeCommands(ByteWriter &out, const NetworkCommand *commands, int count) {
+	out.writeVarUint(count);
+	if (!count) {
+		return;
+	}
+	// dictionary of command type ids, in order of first use
+	std::vector<int> dictionary;
+	for (int i = 0; i < count; ++i) {
+		const int id = commands[i].getCommandTypeId();
+		if (std::find(dictionary.begin(), dictionary.end(), id) == dictionary.end()) {
+			dictionary.push_back(id);
+		}
+	}
+	out.writeVarUint(dictionary.size());
+	for (size_t i = 0; i < dictionary.size(); ++i) {
+		out.writeVarInt(dictionary[i]);
+	}
+
+	int prevUnitId = 0;
+	Vec2i prevPos(0);
+	for (int i = 0; i < count; ) {
+		const NetworkCommand &cmd = commands[i];
+		int runEnd = i + 1;
+		while (runEnd < count && sameOrder(cmd, commands[runEnd])) {
+			++runEnd;
+		}
+		const Vec2i pos = cmd.getPosition();
+		int tag = cmd.getNetworkCommandType();
+		if (pos != Vec2i(-1)) {
+			tag |= Tag::POSITION;
+		}
+		if (cmd.getTargetId() != -1) {
+			tag |= Tag::TARGET;
+		}
+		if (cmd.getProdTypeId() != -1) {
+			tag |= Tag::PROD_TYPE;
+		}
+		if (cmd.getFlags()) {
+			tag |= Tag::FLAGS;
+		}
+		if (runEnd - i > 1) {
+			tag |= Tag::RUN;
+		}
+		out.writeByte(tag);
+		out.writeVarUint(std::find(dictionary.begin(), dictionary.end(), cmd.getCommandTypeId())
+			- dictionary.begin());
+		if (tag & Tag::RUN) {
+			out.writeVarUint(runEnd - i - 2);
+		}
+		for (int j = i; j < runEnd; ++j) {
+			out.writeVarInt(commands[j].getUnitId() - prevUnitId);
+			prevUnitId = commands[j].getUnitId();
+		}
+		if (tag & Tag::POSITION) {
+			out.writeVarInt(pos.x - prevPos.x);
+			out.writeVarInt(pos.y - prevPos.y);
+			prevPos = pos;
+		}
+		if (tag & Tag::TARGET) {
+			out.writeVarInt(cmd.getTargetId());
+		}
+		if (tag & Tag::PROD_TYPE) {
+			out.writeVarInt(cmd.getProdTypeId());
+		}
+		if (tag & Tag::FLAGS) {
+			out.writeByte(cmd.getFlags());
+		}
+		i = runEnd;
+	}
+}
+
+int decodeCommands(ByteReader &in, NetworkCommand *commands, int maxCount) {
+	const uint32 count = in.readVarUint();
+	if (!in.isGood() || count > uint32(maxCount)) {
+		return -1;
+	}
+	if (!count) {
+		return 0;
+	}
+	const uint32 dictSize = in.readVarUint();
+	if (!in.isGood() || !dictSize || dictSize > count) {
+		return -1;
+	}
+	std::vector<int> dictionary(dictSize);
+	for (uint32 i = 0; i < dictSize; ++i) {
+		dictionary[i] = in.readVarInt();
+	}
+
+	int prevUnitId = 0;
+	Vec2i prevPos(0);
+	for (uint32 n = 0; n < count; ) {
+		const int tag = in.readByte();
+		const uint32 ndx = in.readVarUint();
+		const uint32 runLength = (tag & Tag::RUN) ? in.readVarUint() + 2 : 1;
+		if (!in.isGood() || (tag & Tag::TYPE_MASK) >= NetworkCommandType::COUNT
+		|| ndx >= dictSize || runLength > count - n) {
+			return -1;
+		}
+		const uint32 first = n;
+		for (uint32 j = 0; j < runLength; ++j) {
+			prevUnitId += in.readVarInt();
+			commands[n + j] = NetworkCommand(NetworkCommandType(tag & Tag::TYPE_MASK), prevUnitId,
+				dictionary[ndx], Vec2i(-1), -1, -1, 0);
+		}
+		Vec2i pos(-1);
+		if (tag & Tag::POSITION) {
+			prevPos.x += in.readVarInt();
+			prevPos.y += in.readVarInt();
+			pos = prevPos;
+		}
+		const int targetId = (tag & Tag::TARGET) ? in.readVarInt() : -1;
+		const int prodTypeId = (tag & Tag::PROD_TYPE) ? in.readVarInt() : -1;
+		const int flags = (tag & Tag::FLAGS) ? in.readByte() : 0;
+		n += runLength;
+		for (uint32 j = first; j < n; ++j) {
+			commands[j] = NetworkCommand(NetworkCommandType(tag & Tag::TYPE_MASK),
+				commands[j].getUnitId(), dictionary[ndx], pos, prodTypeId, targetId, flags);
+		}
+	}
+	return in.isGood() ? int(count) : -1;
+}
+
+void encodeHashes(ByteWriter &out, const vector<WorldHash::Entry> &hashes) {
+	out.writeVarUint(hashes.size());
+	foreach_const (vector<WorldHash::Entry>, it, hashes) {
+		out.writeVarInt(it->id);
+		out.writeBytes(&it->hash, sizeof(it->hash));
+	}
+}
+
+bool decodeHashes(ByteReader &in, vector<WorldHash::Entry> &hashes, int maxCount) {
+	hashes.clear();
+	const uint32 count = in.readVarUint();
+	if (!in.isGood() || count > uint32(maxCount)) {
+		return false;
+	}
+	hashes.resize(count);
+	foreach (vector<WorldHash::Entry>, it, hashes) {
+		it->id = in.readVarInt();
+		in.readBytes(&it->hash, sizeof(it->hash));
+	}
+	return in.isGood();
+}
+
+}}
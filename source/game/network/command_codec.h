@@ -0,0 +1,49 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_COMMAND_CODEC_H_
+#define _GLEST_GAME_COMMAND_CODEC_H_
+
+#include "network_types.h"
+#include "byte_stream.h"
+#include "world_hash.h"
+
+namespace Glest { namespace Net {
+
+using Shared::Util::ByteWriter;
+using Shared::Util::ByteReader;
+
+// =====================================================
+//	Command list encoding
+// =====================================================
+/** Commands go over the wire in a few bytes each instead of sizeof(NetworkCommand).
+  * The list starts with a dictionary of the command type ids it uses, then each
+  * record is a tag byte (network command type & which optional fields follow), the
+  * dictionary index, and the unit id as a varint delta from the previous command's.
+  * Positions are deltas from the previous position sent, target, producible &
+  * flags only appear if set. Consecutive commands that differ only in unit id, as
+  * when a selection is given an order, share one record listing the unit ids. */
+void encodeCommands(ByteWriter &out, const NetworkCommand *commands, int count);
+
+/** decode a list written by encodeCommands()
+  * @return the number of commands decoded, or -1 if the data is garbled or holds
+  * more than maxCount */
+int decodeCommands(ByteReader &in, NetworkCommand *commands, int maxCount);
+
+// =====================================================
+//	Hash list encoding
+// =====================================================
+/** The hashes in a SyncHashMessage, the count then each entry's id as a varint and
+  * its hash as eight bytes. */
+void encodeHashes(ByteWriter &out, const vector<WorldHash::Entry> &hashes);
+
+/** decode a list written by encodeHashes()
+  * @return false if the data is garbled or holds more than maxCount */
+bool decodeHashes(ByteReader &in, vector<WorldHash::Entry> &hashes, int maxCount);
+
+}}
+
+#endif
@@ -105,6 +105,10 @@ void ConnectionSlot::update() {
 			string msg = getRemotePlayerName() + " [" + getRemoteHostName() + "] has quit the game!";
 			serverInterface->sendTextMessage(msg, -1);
 			throw Disconnect();
+		} else if (raw.type == MessageType::SYNC_HASH) {
+			NETWORK_LOG( "Received sync hash query on slot " << playerIndex );
+			SyncHashMessage msg(raw);
+			serverInterface->process(msg, playerIndex);
 #		if MAD_SYNC_CHECKING
 		} else if (raw.type == MessageType::SYNC_ERROR) {
 			SyncErrorMsg e(raw);
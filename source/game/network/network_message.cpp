@@ -27,6 +27,7 @@
 #include "unit.h"
 #include "world.h"
 #include "network_interface.h"
+#include "command_codec.h"
 #include "profiler.h"
 
 using namespace Shared::Platform;
@@ -75,6 +76,15 @@ void Message::send(Socket* socket, const void* data, int dataSize) const {
 	}
 }
 
+void Message::sendEncoded(NetworkConnection* connection, MessageType type, vector<uint8> &bytes) const {
+	assert(bytes.size() >= MsgHeader::headerSize && bytes.size() - MsgHeader::headerSize < (1u << 24));
+	MsgHeader header;
+	header.messageType = type;
+	header.messageSize = bytes.size() - MsgHeader::headerSize;
+	memcpy(&bytes[0], &header, MsgHeader::headerSize);
+	send(connection, &bytes[0], bytes.size());
+}
+
 // =====================================================
 //	class IntroMessage
 // =====================================================
@@ -208,6 +218,7 @@ LaunchMessage::LaunchMessage(const GameSettings *gameSettings){
 	data.defaultVictoryConditions= gameSettings->getDefaultVictoryConditions();
 	data.fogOfWar = gameSettings->getFogOfWar();
 	data.shroudOfDarkness = gameSettings->getShroudOfDarkness();
+	data.jumpPointSearch = gameSettings->getJumpPointSearch();
 
 	for(int i= 0; i<data.factionCount; ++i){
 		data.factionTypeNames[i]= gameSettings->getFactionTypeName(i);
@@ -239,6 +250,7 @@ void LaunchMessage::buildGameSettings(GameSettings *gameSettings) const{
 	gameSettings->setDefaultVictoryConditions(data.defaultVictoryConditions);
 	gameSettings->setFogOfWar(data.fogOfWar);
 	gameSettings->setShroudOfDarkness(data.shroudOfDarkness);
+	gameSettings->setJumpPointSearch(data.jumpPointSearch);
 
 	for(int i= 0; i<data.factionCount; ++i){
 		gameSettings->setFactionTypeName(i, data.factionTypeNames[i].getString());
@@ -462,34 +474,37 @@ bool CommandListMessage::addCommand(const NetworkCommand* networkCommand){
 CommandListMessage::CommandListMessage(RawMessage raw) {
 	data.messageType = raw.type;
 	data.messageSize = raw.size;
-	uint8* ptr = reinterpret_cast<uint8*>(&data);
-	ptr += 4;
-	memcpy(ptr, raw.data, raw.size);
-	delete raw.data;
+	ByteReader in(raw.data, raw.size);
+	data.frameCount = in.readVarUint();
+	const int count = decodeCommands(in, data.commands, maxCommandCount);
+	delete [] raw.data;
+	if (count < 0) {
+		throw GarbledMessage(MessageType::COMMAND_LIST, NetSource::CLIENT);
+	}
+	data.commandCount = count;
+	NETWORK_LOG(
+		__FUNCTION__ << "(): message received, type: " << MessageTypeNames[MessageType(data.messageType)]
+		<< ", messageSize: " << data.messageSize << ", number of commands: " << data.commandCount
+	);
 }
 
 bool CommandListMessage::receive(NetworkConnection* connection) {
-	MsgHeader header; // peek Message Header first
-	if (!Message::peek(connection, &header, sizeof(MsgHeader))) {
-		return false;
-	}
-	bool ok = Message::receive(connection, &data, sizeof(MsgHeader) + header.messageSize);
-	if (ok) {
-		NETWORK_LOG(
-			__FUNCTION__ << "(): message received, type: " << MessageTypeNames[MessageType(data.messageType)]
-			<< ", messageSize: " << data.messageSize << ", number of commands: " << data.commandCount
-		);
-	}
-	return ok;
+	throw runtime_error(string(__FUNCTION__) + "() called.");
+	return true;
 }
 
 void CommandListMessage::send(NetworkConnection* connection) const {
 	assert(data.messageType == MessageType::COMMAND_LIST);
+	vector<uint8> bytes(MsgHeader::headerSize);
+	ByteWriter out(bytes);
+	out.writeVarUint(data.frameCount);
+	encodeCommands(out, data.commands, data.commandCount);
 	NETWORK_LOG(
 		__FUNCTION__ << "(): message sent, type: " << MessageTypeNames[MessageType(data.messageType)]
-		<< ", messageSize: " << data.messageSize << ", number of commands: " << data.commandCount
+		<< ", messageSize: " << (bytes.size() - MsgHeader::headerSize)
+		<< ", number of commands: " << data.commandCount
 	);
-	Message::send(connection, &data, dataHeaderSize + sizeof(NetworkCommand) * data.commandCount);
+	sendEncoded(connection, MessageType::COMMAND_LIST, bytes);
 }
 
 // =====================================================
@@ -550,53 +565,41 @@ void QuitMessage::send(NetworkConnection* connection) const {
 //	class KeyFrame
 // =====================================================
 
-#pragma pack(push, 1)
-struct KeyFrameMsgHeader {
-	uint8	cmdCount;
-	IF_MAD_SYNC_CHECKS(
-		uint16	checksumCount;
-	)
-	uint16 moveUpdateCount;
-	uint16 projUpdateCount;
-	uint16 updateSize;
-	int32 frame;
-
-};
-#pragma pack(pop)
-
-KeyFrame::KeyFrame(RawMessage raw) {
+/** The wire format, after the MsgHeader: the frame, (the checksums), the move &
+  * projectile update counts and the update bytes, then the commands as written by
+  * encodeCommands(). Counts & sizes are varints. */
+void KeyFrame::read(RawMessage raw) {
 	reset();
-	uint8 *ptr = raw.data;
-	KeyFrameMsgHeader header;
-	memcpy(&header, ptr, sizeof(KeyFrameMsgHeader));
-	ptr += sizeof(KeyFrameMsgHeader);
-
-	frame = header.frame;
-	IF_MAD_SYNC_CHECKS(
-		checksumCount = header.checksumCount;
-	)
-	moveUpdateCount = header.moveUpdateCount;
-	projUpdateCount = header.projUpdateCount;
-	updateSize = header.updateSize;
-	cmdCount = header.cmdCount;
-
-	NETWORK_LOG( "KeyFrame message size: " << raw.size << ", Move updates: " << moveUpdateCount
-		<< ", Projectile updates: " << projUpdateCount << ", Commands: " << cmdCount );
-
-	IF_MAD_SYNC_CHECKS(
-		if (checksumCount) {
-			memcpy(checksums, ptr, checksumCount * sizeof(int32));
-			ptr += checksumCount * sizeof(int32);
+	ByteReader in(raw.data, raw.size);
+	frame = in.readVarUint();
+	in.readBytes(&worldHash, sizeof(worldHash));
+	bool ok = true;
+#	if MAD_SYNC_CHECKING
+		const uint32 checksumsSent = in.readVarUint();
+		if (checksumsSent <= uint32(max_checksums)) {
+			checksumCount = checksumsSent;
+		} else {
+			ok = false;
 		}
-	)
-	if (updateSize) {
-		memcpy(updateBuffer, ptr, updateSize);
-		ptr += updateSize;
+		in.readBytes(checksums, checksumCount * sizeof(int32));
+#	endif
+	moveUpdateCount = in.readVarUint();
+	projUpdateCount = in.readVarUint();
+	const uint32 updatesSent = in.readVarUint();
+	if (updatesSent <= uint32(buffer_size)) {
+		updateSize = updatesSent;
+	} else {
+		ok = false;
 	}
-	if (cmdCount) {
-		memcpy(commands, ptr, cmdCount * sizeof(NetworkCommand));
+	in.readBytes(updateBuffer, updateSize);
+	const int count = ok ? decodeCommands(in, commands, max_cmds) : -1;
+	delete [] raw.data;
+	if (count < 0) {
+		throw GarbledMessage(MessageType::KEY_FRAME, NetSource::SERVER);
 	}
-	delete raw.data;
+	cmdCount = count;
+	NETWORK_LOG( "KeyFrame message size: " << raw.size << ", Move updates: " << moveUpdateCount
+		<< ", Projectile updates: " << projUpdateCount << ", Commands: " << cmdCount );
 }
 
 bool KeyFrame::receive(NetworkConnection* connection) {
@@ -605,56 +608,25 @@ bool KeyFrame::receive(NetworkConnection* connection) {
 }
 
 void KeyFrame::send(NetworkConnection* connection) const {
-	MsgHeader msgHeader;
-	KeyFrameMsgHeader header;
-	msgHeader.messageType = MessageType::KEY_FRAME;
-	header.frame = this->frame;
-	header.cmdCount = this->cmdCount;
-	IF_MAD_SYNC_CHECKS(
-		header.checksumCount = this->checksumCount;
-	)
-	header.moveUpdateCount = this->moveUpdateCount;
-	header.projUpdateCount = this->projUpdateCount;
-	header.updateSize = this->updateSize;
-
-	size_t commandsSize = header.cmdCount * sizeof(NetworkCommand);
-	//size_t headerSize = sizeof(KeyFrameMsgHeader);
-	msgHeader.messageSize = sizeof(KeyFrameMsgHeader) + updateSize + commandsSize;
-	IF_MAD_SYNC_CHECKS(
-		msgHeader.messageSize += checksumCount * sizeof(int32);
-	)
-	size_t totalSize = msgHeader.messageSize + sizeof(MsgHeader);
-
-	NETWORK_LOG( "KeyFrame message size: " << msgHeader.messageSize << ", Move updates: "
+	vector<uint8> bytes(MsgHeader::headerSize);
+	bytes.reserve(MsgHeader::headerSize + 16 + updateSize + cmdCount * 4);
+	ByteWriter out(bytes);
+	out.writeVarUint(frame);
+	out.writeBytes(&worldHash, sizeof(worldHash));
+#	if MAD_SYNC_CHECKING
+		out.writeVarUint(checksumCount);
+		out.writeBytes(checksums, checksumCount * sizeof(int32));
+#	endif
+	out.writeVarUint(moveUpdateCount);
+	out.writeVarUint(projUpdateCount);
+	out.writeVarUint(updateSize);
+	out.writeBytes(updateBuffer, updateSize);
+	encodeCommands(out, commands, cmdCount);
+
+	NETWORK_LOG( "KeyFrame message size: " << (bytes.size() - MsgHeader::headerSize) << ", Move updates: "
 		<< moveUpdateCount << ", Projectile updates: " << projUpdateCount
 		<< ", Commands: " << cmdCount );
-
-	uint8 *buf = new uint8[totalSize];
-	uint8 *ptr = buf;
-	memcpy(ptr, &msgHeader, sizeof(MsgHeader));
-	ptr += sizeof(MsgHeader);
-	memcpy(ptr, &header, sizeof(KeyFrameMsgHeader));
-	ptr += sizeof(KeyFrameMsgHeader);
-	IF_MAD_SYNC_CHECKS(
-		if (checksumCount) {
-			memcpy(ptr, checksums, checksumCount * sizeof(int32));
-			ptr += checksumCount * sizeof(int32);
-		}
-	)
-	if (updateSize) {
-		memcpy(ptr, updateBuffer, updateSize);
-		ptr += updateSize;
-	}
-	if (commandsSize) {
-		memcpy(ptr, commands, commandsSize);
-	}
-	try {
-		Message::send(connection, buf, totalSize);
-	} catch (...) {
-		delete [] buf;
-		throw;
-	}
-	delete [] buf;
+	sendEncoded(connection, MessageType::KEY_FRAME, bytes);
 }
 
 #if MAD_SYNC_CHECKING
@@ -689,6 +661,8 @@ void KeyFrame::reset() {
 	)
 	projUpdateCount = moveUpdateCount = cmdCount = 0;
 	updateSize = 0;
+	frame = -1;
+	worldHash = 0;
 	writePtr = updateBuffer;
 	readPtr = updateBuffer;
 }
@@ -737,6 +711,71 @@ ProjectileUpdate KeyFrame::getProjUpdate() {
 	return res;
 }
 
+// =====================================================
+//	class SyncHashMessage
+// =====================================================
+
+SyncHashMessage::SyncHashMessage(int frame, SyncHashLevel level, int faction, int range)
+		: m_frame(frame), m_level(level), m_faction(faction), m_range(range)
+		, m_reply(false), m_known(false) {
+}
+
+SyncHashMessage::SyncHashMessage(RawMessage raw) {
+	ByteReader in(raw.data, raw.size);
+	m_frame = in.readVarUint();
+	const uint8 level = in.readByte();
+	const uint8 flags = in.readByte();
+	m_faction = in.readVarInt();
+	m_range = in.readVarInt();
+	const bool good = decodeHashes(in, m_hashes, maxHashCount);
+	delete [] raw.data; // read everything before this, in points into it
+	m_reply = (flags & 1) != 0;
+	m_known = (flags & 2) != 0;
+	if (!good || level >= SyncHashLevel::COUNT) {
+		throw GarbledMessage(MessageType::SYNC_HASH, m_reply ? NetSource::SERVER : NetSource::CLIENT);
+	}
+	m_level = SyncHashLevel(level);
+}
+
+void SyncHashMessage::setReply(const WorldHash *worldHash) {
+	m_reply = true;
+	m_known = worldHash != 0;
+	m_hashes.clear();
+	if (!worldHash) {
+		return;
+	}
+	if (m_level == SyncHashLevel::FACTIONS) {
+		m_hashes = worldHash->getFactionHashes();
+	} else if (m_level == SyncHashLevel::RANGES) {
+		worldHash->getRangeHashes(m_faction, m_hashes);
+	} else {
+		worldHash->getUnitHashes(m_faction, m_range, m_hashes);
+	}
+	if (int(m_hashes.size()) > maxHashCount) {
+		m_hashes.resize(maxHashCount);
+	}
+}
+
+bool SyncHashMessage::receive(NetworkConnection* connection) {
+	throw runtime_error(string(__FUNCTION__) + "() called.");
+	return false;
+}
+
+void SyncHashMessage::send(NetworkConnection* connection) const {
+	vector<uint8> bytes(MsgHeader::headerSize);
+	ByteWriter out(bytes);
+	out.writeVarUint(m_frame);
+	out.writeByte(uint8(m_level));
+	out.writeByte(uint8((m_reply ? 1 : 0) | (m_known ? 2 : 0)));
+	out.writeVarInt(m_faction);
+	out.writeVarInt(m_range);
+	encodeHashes(out, m_hashes);
+	NETWORK_LOG( __FUNCTION__ << "(): " << (m_reply ? "reply" : "query") << ", frame " << m_frame
+		<< ", level " << int(m_level) << ", faction " << m_faction << ", range " << m_range
+		<< ", hashes: " << m_hashes.size() );
+	sendEncoded(connection, MessageType::SYNC_HASH, bytes);
+}
+
 #if MAD_SYNC_CHECKING
 
 SyncErrorMsg::SyncErrorMsg(RawMessage raw) {
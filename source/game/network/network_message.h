@@ -16,10 +16,13 @@
 #include "game_constants.h"
 #include "network_types.h"
 #include "checksum.h"
+#include "world_hash.h"
 
 #include <map>
+#include <vector>
 
 using std::map;
+using std::vector;
 using Shared::Platform::Socket;
 using Shared::Platform::int8;
 using Shared::Platform::int16;
@@ -62,6 +65,10 @@ protected:
 	bool peek(NetworkConnection* connection, void *data, int dataSize);
 	void send(NetworkConnection* connection, const void* data, int dataSize) const;
 	void send(Socket* socket, const void* data, int dataSize) const;
+
+	/** send a variable length message, bytes starts with MsgHeader::headerSize bytes for
+	  * the header, which is filled in here, followed by the message */
+	void sendEncoded(NetworkConnection* connection, MessageType type, vector<uint8> &bytes) const;
 };
 
 // ==============================================================
@@ -175,6 +182,7 @@ private:
 		int8 defaultVictoryConditions;
 		int8 fogOfWar;
 		int8 shroudOfDarkness;
+		int8 jumpPointSearch;
 	} data;
 
 public:
@@ -337,6 +345,7 @@ private:
 	typedef uint8* byte_ptr;
 
 	int32	frame;
+	uint64	worldHash;	/**< the server's WorldHash at frame */
 
 	IF_MAD_SYNC_CHECKS(
 		int32	checksums[max_checksums];
@@ -356,7 +365,10 @@ private:
 
 public:
 	KeyFrame()		{ reset(); }
-	KeyFrame(RawMessage raw);
+	KeyFrame(RawMessage raw) { read(raw); }
+
+	/** replace contents with a received keyframe, takes ownership of raw.data */
+	void read(RawMessage raw);
 
 	virtual bool receive(NetworkConnection* connection);
 	virtual void send(NetworkConnection* connection) const;
@@ -364,6 +376,9 @@ public:
 	void setFrameCount(int fc) { frame = fc; }
 	int getFrameCount() const { return frame; }
 
+	void setWorldHash(uint64 hash) { worldHash = hash; }
+	uint64 getWorldHash() const { return worldHash; }
+
 	const size_t& getCmdCount() const	{ return cmdCount; }
 	const NetworkCommand* getCmd(size_t ndx) const { return &commands[ndx]; }
 
@@ -379,6 +394,50 @@ public:
 	ProjectileUpdate getProjUpdate();
 };
 
+// =====================================================
+//	class SyncHashMessage
+// =====================================================
+
+WRAPPED_ENUM( SyncHashLevel, FACTIONS, RANGES, UNITS )
+
+/** Sent by a client whose WorldHash for a keyframe differs from the server's, to
+  * find out where. It asks for the server's hashes one level down at a time, the
+  * factions, then the ranges of one faction's units, then the units in one range,
+  * until it has the unit that differs. The server answers with the same message,
+  * holding the hashes, or none & isKnown() false if it no longer has that frame. */
+class SyncHashMessage : public Message {
+private:
+	static const int maxHashCount = 4096;
+
+	int32			m_frame;
+	SyncHashLevel	m_level;
+	int32			m_faction;
+	int32			m_range;
+	bool			m_reply;
+	bool			m_known;
+	vector<WorldHash::Entry> m_hashes;
+
+public:
+	/** a query, faction is needed for RANGES & UNITS, range for UNITS */
+	SyncHashMessage(int frame, SyncHashLevel level, int faction = -1, int range = -1);
+	SyncHashMessage(RawMessage raw);
+
+	/** turn a query into its reply, worldHash is the server's for the frame asked
+	  * about, or null if it hasn't got it any more */
+	void setReply(const WorldHash *worldHash);
+
+	int getFrame() const			{ return m_frame; }
+	SyncHashLevel getLevel() const	{ return m_level; }
+	int getFaction() const			{ return m_faction; }
+	int getRange() const			{ return m_range; }
+	bool isReply() const			{ return m_reply; }
+	bool isKnown() const			{ return m_known; }
+	const vector<WorldHash::Entry>& getHashes() const { return m_hashes; }
+
+	virtual bool receive(NetworkConnection* connection);
+	virtual void send(NetworkConnection* connection) const;
+};
+
 #if MAD_SYNC_CHECKING
 
 class SyncErrorMsg : public Message {
@@ -48,6 +48,7 @@ NetworkCommand::NetworkCommand(Command *command) {
 	if (!command->isReserveResources()) flags |= Flags::NO_RESERVE_RESOURCES;
 	if (command->isQueue()) flags |= Flags::QUEUE;
 	if (command->isMiscEnabled()) flags |= Flags::MISC_ENABLE;
+	if (command->isGroupMove()) flags |= Flags::GROUP_MOVE;
 }
 
 /** Construct archetype SET_AUTO_ [REPAIR|ATTACK|FLEE] */
@@ -154,9 +155,11 @@ Command *NetworkCommand::toCommand() const {
 	Command *command= NULL;
 	bool queue = flags & Flags::QUEUE;
 	bool no_reserve_res = flags & Flags::NO_RESERVE_RESOURCES;
+	bool group_move = flags & Flags::GROUP_MOVE;
 	CmdFlags cmdFlags;
 	cmdFlags.set(CmdProps::QUEUE, queue);
 	cmdFlags.set(CmdProps::DONT_RESERVE_RESOURCES, no_reserve_res);
+	cmdFlags.set(CmdProps::GROUP_MOVE, group_move);
 	if (target) {
 		command = g_world.newCommand(ct, cmdFlags, target, unit);
 	} else {
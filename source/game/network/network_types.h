@@ -208,7 +208,7 @@ WRAPPED_ENUM( NetworkCommandType,
 #pragma pack(push, 4)
 	class NetworkCommand {
 	private:
-		struct Flags { enum { QUEUE = 1, NO_RESERVE_RESOURCES = 2, MISC_ENABLE = 4 }; };
+		struct Flags { enum { QUEUE = 1, NO_RESERVE_RESOURCES = 2, MISC_ENABLE = 4, GROUP_MOVE = 8 }; };
 		uint32 networkCommandType	:  8;
 		int32 unitId				: 24;
 		int32 commandTypeId			: 16;
@@ -223,6 +223,13 @@ WRAPPED_ENUM( NetworkCommandType,
 		NetworkCommand(Command *command);
 		NetworkCommand(NetworkCommandType type, const Unit *unit, const Vec2i &pos);
 		NetworkCommand(NetworkCommandType type, const Unit *unit, bool value);
+
+		/** every field given, for decoding */
+		NetworkCommand(NetworkCommandType type, int unitId, int commandTypeId, const Vec2i &pos,
+				int prodTypeId, int targetId, int flags)
+				: networkCommandType(type), unitId(unitId), commandTypeId(commandTypeId)
+				, prodTypeId(prodTypeId), targetId(targetId), flags(flags)
+				, positionX(pos.x), positionY(pos.y) {}
 		//NetworkCommand(int networkCommandType, int unitId, int commandTypeId= -1, const Vec2i &pos= Vec2i(0), int unitTypeId= -1, int targetId= -1);
 
 		MEMORY_CHECK_DECLARATIONS(NetworkCommand);
@@ -234,6 +241,7 @@ WRAPPED_ENUM( NetworkCommandType,
 		Vec2i getPosition() const							{return Vec2i(positionX, positionY);}
 		int getProdTypeId() const							{return prodTypeId;}
 		int getTargetId() const								{return targetId;}
+		int getFlags() const								{return flags;}
 	};
 #pragma pack(pop)
 
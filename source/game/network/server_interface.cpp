@@ -321,16 +321,39 @@ void ServerInterface::process(TextMessage &msg, int requestor) {
 	NetworkInterface::processTextMessage(msg);
 }
 
+/** answer a client narrowing down where its world went out of sync with ours */
+void ServerInterface::process(SyncHashMessage &msg, int requestor) {
+	if (msg.isReply()) {
+		throw InvalidMessage(MessageType::SYNC_HASH);
+	}
+	const WorldHash *worldHash = 0;
+	foreach_const (deque<WorldHash>, it, m_worldHashes) {
+		if (it->getFrame() == msg.getFrame()) {
+			worldHash = &*it;
+		}
+	}
+	NETWORK_LOG( __FUNCTION__ << " slot " << requestor << " out of sync at frame " << msg.getFrame()
+		<< (worldHash ? "" : ", frame no longer held") );
+	msg.setReply(worldHash);
+	slots[requestor]->send(&msg);
+}
+
 void ServerInterface::updateKeyframe(int frameCount) {
 	NETWORK_LOG( __FUNCTION__ << " building & sending keyframe "
 		<< (frameCount / GameConstants::networkFramePeriod) << " @ frame " << frameCount);
 	// build command list, remove commands from requested and add to pending
 	while (!requestedCommands.empty()) {
 		keyFrame.add(requestedCommands.back());
-		pendingCommands.push_back(requestedCommands.back());
+		givePlayerCommand(requestedCommands.back());
 		requestedCommands.pop_back();
 	}
+	m_worldHashes.push_back(WorldHash());
+	m_worldHashes.back().compute(world);
+	if (int(m_worldHashes.size()) > worldHashHistory) {
+		m_worldHashes.pop_front();
+	}
 	keyFrame.setFrameCount(frameCount);
+	keyFrame.setWorldHash(m_worldHashes.back().getHash());
 	broadcastMessage(&keyFrame);
 
 	keyFrame.reset();
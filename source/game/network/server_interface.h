@@ -13,6 +13,7 @@
 #define _GLEST_GAME_SERVERINTERFACE_H_
 
 #include <vector>
+#include <deque>
 
 #include "game_constants.h"
 #include "network_interface.h"
@@ -20,6 +21,7 @@
 #include "socket.h"
 
 using std::vector;
+using std::deque;
 using Shared::Platform::ServerSocket;
 
 namespace Glest { namespace Net {
@@ -37,6 +39,9 @@ private:
 		int64 timeDropped;
 	};
 
+	/** keyframes' worth of WorldHashes kept to answer clients' sync hash queries */
+	static const int worldHashHistory = 64;
+
 private:
 	ConnectionSlot* slots[GameConstants::maxPlayers];
 	ServerSocket serverSocket;
@@ -46,6 +51,7 @@ private:
 	DataSyncMessage *m_dataSync;
 	int m_syncCounter;
 	bool m_dataSyncDone;
+	deque<WorldHash> m_worldHashes;	/**< the last worldHashHistory, oldest first */
 
 private:
 	void bindPort();
@@ -105,6 +111,7 @@ public:
 	void dataSync(int playerNdx, DataSyncMessage &msg);
 	void doLaunchBroadcast();
 	void process(TextMessage &msg, int requestor);
+	void process(SyncHashMessage &msg, int requestor);
 
 	// message sending
 	virtual void sendTextMessage(const string &text, int teamIndex);
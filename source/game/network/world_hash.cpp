@@ -0,0 +1,106 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "world_hash.h"
+
+#include <algorithm>
+
+#include "world.h"
+#include "checksum.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Net {
+
+using Shared::Util::Hash64;
+using namespace Glest::Entities;
+
+static uint64 hashUnit(const Unit *unit) {
+	Hash64 hash;
+	hash.add(unit->getId());
+	hash.add(unit->getType()->getId());
+	hash.add(unit->getPos().x);
+	hash.add(unit->getPos().y);
+	hash.add(unit->getHp());
+	hash.add(unit->getCp());
+	hash.add(unit->getCurrSkill() ? unit->getCurrSkill()->getId() : -1);
+	return hash.getHash();
+}
+
+void WorldHash::compute(const World *world) {
+	m_frame = world->getFrameCount();
+	const int factionCount = world->getFactionCount();
+	m_factionHashes.resize(factionCount);
+	m_unitHashes.resize(factionCount);
+
+	Hash64 worldHash;
+	worldHash.add(m_frame);
+	for (int i = 0; i < factionCount; ++i) {
+		const Faction *faction = world->getFaction(i);
+		vector<Entry> &units = m_unitHashes[i];
+		units.clear();
+		for (int j = 0; j < faction->getUnitCount(); ++j) {
+			const Unit *unit = faction->getUnit(j);
+			units.push_back(Entry(unit->getId(), hashUnit(unit)));
+		}
+		std::sort(units.begin(), units.end());
+
+		Hash64 hash;
+		for (int j = 0; j < faction->getSResourceCount(); ++j) {
+			hash.add(faction->getSResource(j)->getAmount());
+		}
+		hash.add(units.size());
+		foreach_const (vector<Entry>, it, units) {
+			hash.add(it->hash);
+		}
+		// the sim reads explored tiles (path finding, the ai), peers must agree on them
+		const VisibilityPlanes &planes = world->getMap()->getVisibility();
+		for (int y = 0; y < planes.getH(); ++y) {
+			const VisibilityPlanes::Word *row = planes.getExploredRow(faction->getTeam(), y);
+			for (int wx = 0; wx < planes.getRowWords(); ++wx) {
+				hash.add(row[wx]);
+			}
+		}
+		m_factionHashes[i] = Entry(i, hash.getHash());
+		worldHash.add(m_factionHashes[i].hash);
+	}
+	m_hash = worldHash.getHash();
+}
+
+void WorldHash::getRangeHashes(int faction, vector<Entry> &out) const {
+	out.clear();
+	if (faction < 0 || faction >= int(m_unitHashes.size())) {
+		return;
+	}
+	const vector<Entry> &units = m_unitHashes[faction];
+	for (int first = 0, range = 0; first < int(units.size()); first += rangeSize, ++range) {
+		const int end = std::min(first + rangeSize, int(units.size()));
+		Hash64 hash;
+		for (int i = first; i < end; ++i) {
+			hash.add(units[i].hash);
+		}
+		out.push_back(Entry(range, hash.getHash()));
+	}
+}
+
+void WorldHash::getUnitHashes(int faction, int range, vector<Entry> &out) const {
+	out.clear();
+	if (faction < 0 || faction >= int(m_unitHashes.size())) {
+		return;
+	}
+	const vector<Entry> &units = m_unitHashes[faction];
+	if (range < 0 || range > int(units.size()) / rangeSize) { // range comes from a client
+		return;
+	}
+	const int first = range * rangeSize;
+	const int end = std::min(first + rangeSize, int(units.size()));
+	for (int i = first; i < end; ++i) {
+		out.push_back(units[i]);
+	}
+}
+
+}}
@@ -0,0 +1,74 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_WORLD_HASH_H_
+#define _GLEST_GAME_WORLD_HASH_H_
+
+#include <vector>
+
+#include "types.h"
+#include "forward_decs.h"
+
+namespace Glest { namespace Net {
+
+using std::vector;
+using Shared::Platform::int32;
+using Shared::Platform::uint64;
+using Glest::Sim::World;
+
+// =====================================================
+//	class WorldHash
+// =====================================================
+/** Hashes of the game state at one keyframe, so peers can tell they've gone out of
+  * sync as soon as it happens & find the unit it started with. A unit's hash covers
+  * its id, type, position, hp, cp & current skill, a faction's covers its stored
+  * resources, its units' hashes in id order and the tiles its team has explored, the
+  * world hash covers the factions'.
+  * A faction's units are also hashed in ranges of rangeSize, so peers that disagree
+  * can narrow it down a level at a time without sending every unit's hash. */
+class WorldHash {
+public:
+	static const int rangeSize = 16;
+
+	/** a hash & what it's the hash of, a faction index, range index or unit id */
+	struct Entry {
+		int32   id;
+		uint64  hash;
+
+		Entry() : id(-1), hash(0) {}
+		Entry(int32 id, uint64 hash) : id(id), hash(hash) {}
+		bool operator<(const Entry &that) const { return id < that.id; }
+	};
+
+private:
+	int                      m_frame;
+	uint64                   m_hash;
+	vector<Entry>            m_factionHashes;
+	vector< vector<Entry> >  m_unitHashes;		/**< per faction, in id order */
+
+public:
+	WorldHash() : m_frame(-1), m_hash(0) {}
+
+	/** hash the world as it is now, one pass over every faction & unit */
+	void compute(const World *world);
+
+	int getFrame() const		{ return m_frame; }
+	uint64 getHash() const		{ return m_hash; }
+
+	/** the faction hashes, ids are faction indices */
+	const vector<Entry>& getFactionHashes() const { return m_factionHashes; }
+
+	/** hashes of each range of a faction's units, ids are range indices, empty if
+	  * there's no such faction */
+	void getRangeHashes(int faction, vector<Entry> &out) const;
+
+	/** the unit hashes in one range of a faction's units, ids are unit ids */
+	void getUnitHashes(int faction, int range, vector<Entry> &out) const;
+};
+
+}}
+
+#endif
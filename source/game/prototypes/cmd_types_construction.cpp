@@ -731,6 +731,10 @@ void MaintainCommandType::update(Unit *unit) const {
 				REPAIR_LOG( unit, "Unit: " << unit->getId() << " path impossible, cancelling." );
 				break;
 
+			case TravelState::PENDING:
+				unit->setCurrSkill(SkillClass::STOP);
+				break;
+
 			default: throw runtime_error("Error: RoutePlanner::findPath() returned invalid result.");
 		}
 	}
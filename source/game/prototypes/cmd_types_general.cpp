@@ -2262,7 +2262,8 @@ void GarrisonCommandType::update(Unit *unit) const {
 		closest->setPos(Vec2i(-1));
 		g_userInterface.getSelection()->unSelect(closest);
 		unit->getGarrisonedUnits().push_back(closest->getId());
-		unit->computeTotalUpgrade();
+		unit->invalidateStatLayer(StatLayer::GARRISON);
+		unit->updateTotalUpgrade();
 		unitsToGarrison.erase(std::find(unitsToGarrison.begin(), unitsToGarrison.end(), closest->getId()));
 		unit->setCurrSkill(loadSkillType);
 		unit->clearPath();
@@ -2393,7 +2394,8 @@ void DegarrisonCommandType::update(Unit *unit) const {
 				unit->getUnitsToDegarrison().pop_front();
                 unit->getGarrisonedUnits().erase(std::find(unit->getGarrisonedUnits().begin(), unit->getGarrisonedUnits().end(), targetUnit->getId()));
 				unit->StateChanged(unit);
-				unit->computeTotalUpgrade();
+				unit->invalidateStatLayer(StatLayer::GARRISON);
+				unit->updateTotalUpgrade();
 				// keep unloading, curr skill is ok
 			} else {
 				// must be crowded, stop unloading
@@ -2553,24 +2555,10 @@ CmdResult SetMeetingPointCommandType::check(const Unit *unit, const Command &com
 bool CommandType::unitInRange(const Unit *unit, int range, Unit **rangedPtr,
 					const AttackSkillTypes *asts, const AttackSkillType **past) {
 	_PROFILE_COMMAND_UPDATE();
-	Vec2i effectivePos;
-	fixedVec2 fixedCentre;
-	fixed halfSize;
-	if (unit->isCarried()) {
-		Unit *carrier = g_world.getUnit(unit->getCarrier());
-		effectivePos = carrier->getCenteredPos();
-		fixedCentre = carrier->getFixedCenteredPos();
-		halfSize = carrier->getType()->getHalfSize();
-	} else if (unit->isGarrisoned()) {
-		Unit *garrison = g_world.getUnit(unit->getGarrison());
-		effectivePos = garrison->getCenteredPos();
-		fixedCentre = garrison->getFixedCenteredPos();
-		halfSize = garrison->getType()->getHalfSize();
-	} else {
-		effectivePos = unit->getCenteredPos();
-		fixedCentre = unit->getFixedCenteredPos();
-		halfSize = unit->getType()->getHalfSize();
-	}
+	const Unit *origin = unit->getRangeOrigin();
+	Vec2i effectivePos = origin->getCenteredPos();
+	fixedVec2 fixedCentre = origin->getFixedCenteredPos();
+	fixed halfSize = origin->getType()->getHalfSize();
 	fixed distance;
 	bool needDistance = false;
 
@@ -2597,34 +2585,56 @@ bool CommandType::unitInRange(const Unit *unit, int range, Unit **rangedPtr,
 		needDistance = true;
 	} else {
 		Targets enemies;
-		Vec2i pos;
-		PosCircularIteratorOrdered pci(g_world.getMap()->getBounds(), effectivePos,
-			g_world.getPosIteratorFactory().getInsideOutIterator(1, range + halfSize.intp()));
-
-		Map *map = g_world.getMap();
-		while (pci.getNext(pos, distance)) {
-			foreach_enum (Zone, z) { // all zones
-				if (!asts || asts->getZone(z)) { // looking for target in z?
-					// does cell contain a bad guy?
-					Unit *possibleEnemy = map->getCell(pos)->getUnit(z);
-					if (possibleEnemy && possibleEnemy->isAlive() && !unit->isAlly(possibleEnemy)) {
-						if (possibleEnemy->isCloaked()) {
-							int cloakGroup = possibleEnemy->getCloakGroup();
-							Vec2i tpos = Map::toTileCoords(possibleEnemy->getCenteredPos());
-							if (!g_cartographer.canDetect(unit->getTeam(), cloakGroup, tpos)) {
-								continue;
-							}
-						}
-						// If bad guy has an attack command we can short circut this loop now
-						if (possibleEnemy->getType()->getActions()->hasCommandClass(CmdClass::ATTACK)) {
-							*rangedPtr = possibleEnemy;
-							goto unitOnRange_exitLoop;
-						}
-						// otherwise, we'll record it and figure out who to slap later.
-						enemies.record(possibleEnemy, distance);
-					}
+		const int radius = range + halfSize.intp();
+
+		// use the hostiles gathered in the intent phase if there are any, else search now
+		UnitDistList candidates;
+		const UnitDistList *nearby = unit->getNearbyHostiles(radius);
+		if (!nearby) {
+			UnitFilter filter;
+			filter.team = unit->getTeam();
+			filter.relation = TeamRelation::HOSTILE;
+			filter.self = unit;
+			filter.inWorldOnly = true;
+			g_world.getUnitGrid().findInRange(effectivePos, radius, filter, candidates);
+			nearby = &candidates;
+		}
+		const bool fresh = nearby == &candidates;
+
+		foreach_const (UnitDistList, it, *nearby) { // nearest first
+			if (fresh && it->dist > radius) {
+				break;
+			}
+			Unit *possibleEnemy = it->unit;
+			// the intent phase list may be out of date by (at most) this frame's commits
+			if (!possibleEnemy->isAlive() || unit->isAlly(possibleEnemy)
+			|| possibleEnemy->isCarried() || possibleEnemy->isGarrisoned()) {
+				continue;
+			}
+			// and so may its distances, either unit may have moved since
+			const fixed dist = fresh ? it->dist
+				: fixedDist(effectivePos, possibleEnemy->getNearestOccupiedCell(effectivePos));
+			if (dist > radius) {
+				continue;
+			}
+			if (asts && !asts->getZone(possibleEnemy->getCurrZone())) { // looking for target in this zone?
+				continue;
+			}
+			if (possibleEnemy->isCloaked()) {
+				int cloakGroup = possibleEnemy->getCloakGroup();
+				Vec2i tpos = Map::toTileCoords(possibleEnemy->getCenteredPos());
+				if (!g_cartographer.canDetect(unit->getTeam(), cloakGroup, tpos)) {
+					continue;
 				}
 			}
+			// If bad guy has an attack command we can short circut this loop now
+			if (possibleEnemy->getType()->getActions()->hasCommandClass(CmdClass::ATTACK)) {
+				*rangedPtr = possibleEnemy;
+				distance = dist;
+				goto unitOnRange_exitLoop;
+			}
+			// otherwise, we'll record it and figure out who to slap later.
+			enemies.record(possibleEnemy, dist);
 		}
 
 		if (!enemies.size()) {
@@ -336,6 +336,10 @@ void RepairCommandType::update(Unit *unit) const {
 				REPAIR_LOG( unit, "Unit: " << unit->getId() << " path impossible, cancelling." );
 				break;
 
+			case TravelState::PENDING:
+				unit->setCurrSkill(SkillClass::STOP);
+				break;
+
 			default: throw runtime_error("Error: RoutePlanner::findPath() returned invalid result.");
 		}
 	}
@@ -1288,7 +1292,7 @@ void TransportCommandType::update(Unit *unit) const {
             if (unit->travel(unit->productionRoute.getDestination(), m_moveLoadedSkillType) == TravelState::ARRIVED) {
                 goToStore(unit, store, producer);
                 unit->productionRoute.setDestination(producer->getPos());
-                if (unit->getCurrentFocus() == "transport" && unit->getGoalStructure() == NULL) {
+                if (unit->getCurrentFocus() == Goal::TRANSPORT && unit->getGoalStructure() == NULL) {
                     unit->productionRoute.setProducerId(-1);
                     unit->finishCommand();
                 }
@@ -1298,7 +1302,7 @@ void TransportCommandType::update(Unit *unit) const {
             if (unit->travel(unit->productionRoute.getDestination(), m_moveLoadedSkillType) == TravelState::ARRIVED) {
                 goToProducer(unit, store, producer);
                 unit->productionRoute.setDestination(store->getPos());
-                if (unit->getCurrentFocus() == "transport") {
+                if (unit->getCurrentFocus() == Goal::TRANSPORT) {
                     unit->setGoalStructure(NULL);
                 }
             }
@@ -1600,7 +1604,7 @@ void TradeCommandType::update(Unit *unit) const {
             if (unit->travel(unit->productionRoute.getDestination(), m_moveLoadedSkillType) == TravelState::ARRIVED) {
                 goToOwner(unit, store, producer);
                 unit->productionRoute.setDestination(producer->getPos());
-                if (unit->getCurrentFocus() == "trade") {
+                if (unit->getCurrentFocus() == Goal::TRADE) {
                     unit->productionRoute.setProducerId(-1);
                     unit->finishCommand();
                 }
@@ -1766,9 +1770,9 @@ void ProcureCommandType::update(Unit *unit) const {
             if (unit->travel(unit->productionRoute.getDestination(), m_moveLoadedSkillType) == TravelState::ARRIVED) {
                 goToOwner(unit, store, producer);
                 unit->productionRoute.setDestination(producer->getPos());
-                if (unit->getCurrentFocus() == "procure") {
+                if (unit->getCurrentFocus() == Goal::PROCURE) {
                     unit->productionRoute.setProducerId(-1);
-                    unit->setGoalReason("compute");
+                    unit->setGoalReason(GoalReason::COMPUTE);
                     unit->finishCommand();
                 }
             }
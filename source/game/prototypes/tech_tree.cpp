@@ -60,10 +60,17 @@ bool TechTree::preload(const string &dir, const set<string> &factionNames){
     const XmlNode *damagesNode = techTreeNode->getChild("damage-types");
     damageTypes.resize(damagesNode->getChildCount());
     resistances.resize(damagesNode->getChildCount());
+    damageTypeIds.clear();
+	// damage types are interned in the order they are declared, so ids are the same for all clients
 	for (int i = 0; i < damagesNode->getChildCount(); ++i) {
 	    const XmlNode *damageNode = damagesNode->getChild("damage-type", i);
         damageTypes[i].load(damageNode);
         resistances[i].load(damageNode);
+        damageTypes[i].setId(i);
+        resistances[i].setId(i);
+        if (damageTypeIds.find(damageTypes[i].getTypeName()) == damageTypeIds.end()) {
+            damageTypeIds[damageTypes[i].getTypeName()] = i;
+        }
 	}
 
     // check for included factions
@@ -304,6 +311,11 @@ void TechTree::doChecksumFaction(Checksum &checksum, int i) const {
 }
 
 void TechTree::doChecksum(Checksum &checksum) const {
+	// stats hold damage types by id, so the ids must agree as well as the names
+	for (int i=0; i < damageTypes.size(); ++i) {
+		checksum.add(damageTypes[i].getTypeName());
+		checksum.add(damageTypes[i].getId());
+	}
 	doChecksumResources(checksum);
 	for (int i=0; i < factionTypes.size(); ++i) {
 		factionTypes[i].doChecksum(checksum);
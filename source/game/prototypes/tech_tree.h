@@ -48,6 +48,7 @@ private:
 	EffectTypes effectTypes;
 	DamageTypes damageTypes;
 	DamageTypes resistances;
+	map<string, int> damageTypeIds;	/**< damage type name to id (index in damageTypes) */
 
 	CraftResources resourceStats;
 	CraftStats weaponStats;
@@ -97,6 +98,10 @@ public:
 	const EffectType *getEffectType(int i) const			{return effectTypes[i];}
 	DamageType getDamageType(int i) const			        {return damageTypes[i];}
 	DamageType getResistance(int i) const			        {return resistances[i];}
+	int getDamageTypeId(const string &name) const {
+		map<string, int>::const_iterator it = damageTypeIds.find(name);
+		return it != damageTypeIds.end() ? it->second : -1;
+	}
 
 	// get by name
 	const ResourceType *getResourceType(const string &name) const;
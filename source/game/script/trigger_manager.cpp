@@ -58,7 +58,10 @@ void TriggerManager::reset() {
 	deleteMapValues(regions.begin(), regions.end());
 	regions.clear();
 	events.clear();
+	tileRegions.clear();
+	tileW = tileH = 0;
 	unitPosTriggers.clear();
+	factionPosTriggers.clear();
 	attackedTriggers.clear();
 	hpBelowTriggers.clear();
 	hpAboveTriggers.clear();
@@ -71,9 +74,33 @@ bool TriggerManager::registerRegion(const string &name, const Rect &rect) {
 	if (regions.find(name) != regions.end()) return false;
  	Region *region = new Rect(rect);
  	regions[name] = region;
+	indexRegion(region, rect);
  	return true;
  }
 
+/** add region to the lists of every tile rect overlaps */
+void TriggerManager::indexRegion(const Region *region, const Rect &rect) {
+	if (tileRegions.empty()) {
+		tileW = g_map.getTileW();
+		tileH = g_map.getTileH();
+		tileRegions.resize(tileW * tileH);
+	}
+	if (rect.w <= 0 || rect.h <= 0) {
+		return;
+	}
+	Vec2i tl = Map::toTileCoords(rect.x, rect.y);
+	Vec2i br = Map::toTileCoords(rect.x + rect.w - 1, rect.y + rect.h - 1);
+	tl.x = std::max(tl.x, 0);
+	tl.y = std::max(tl.y, 0);
+	br.x = std::min(br.x, tileW - 1);
+	br.y = std::min(br.y, tileH - 1);
+	for (int y = tl.y; y <= br.y; ++y) {
+		for (int x = tl.x; x <= br.x; ++x) {
+			tileRegions[y * tileW + x].push_back(region);
+		}
+	}
+}
+
 int TriggerManager::registerEvent(const string &name) {
 	if (events.find(name) != events.end()) return -1;
 	events.insert(name);
@@ -146,45 +173,44 @@ SetTriggerRes TriggerManager::addDeathTrigger(int unitId, const string &eventNam
 	return SetTriggerRes::OK;
 }
 
-void TriggerManager::unitMoved(const Unit *unit) {
-	// check id
-	int id = unit->getId();
-	PosTriggerMap::iterator tmit = unitPosTriggers.find(id);
+/** move the triggers of those regions in rgns that unit is inside from triggers to fired */
+void TriggerManager::checkPosTriggers(RegionTriggers &triggers, const RegionList &rgns, 
+		const Unit *unit, FiredTriggers &fired) {
+	foreach_const (RegionList, it, rgns) {
+		RegionTriggers::iterator rtit = triggers.find(*it);
+		if (rtit != triggers.end() && (*it)->isInside(unit->getPos())) {
+			foreach_const (PosTriggers, tit, rtit->second) {
+				fired.push_back(FiredTrigger(tit->evnt, unit->getId(), tit->user_dat));
+			}
+			triggers.erase(rtit);
+		}
+	}
+}
 
+void TriggerManager::unitMoved(const Unit *unit) {
+	if (tileRegions.empty()) {
+		return;
+	}
+	Vec2i tile = Map::toTileCoords(unit->getPos());
+	if (tile.x < 0 || tile.y < 0 || tile.x >= tileW || tile.y >= tileH) {
+		return;
+	}
+	const RegionList &rgns = tileRegions[tile.y * tileW + tile.x];
+	if (rgns.empty()) {
+		return;
+	}
+	// collect first, firing calls into lua which may well set (or remove) triggers
+	FiredTriggers fired;
+	PosTriggerMap::iterator tmit = unitPosTriggers.find(unit->getId());
 	if (tmit != unitPosTriggers.end()) { // if any pos triggers for this specific unit
-		PosTriggers &triggers = tmit->second;
-	start:
-		PosTriggers::iterator it = triggers.begin();
- 		while (it != triggers.end()) {
-			if (it->region->isInside(unit->getPos())) {
-				// setting another trigger on this unit in response to this trigger will cause our
-				// iterators here to go bad... :(
-				string evnt = it->evnt;
-				int ud = it->user_dat;
-				it = triggers.erase(it);
-				ScriptManager::onTrigger(evnt, id, ud);
-				goto start;
- 			} else {
- 				++it;
- 			}
-		}
+		checkPosTriggers(tmit->second, rgns, unit, fired);
 	}
 	tmit = factionPosTriggers.find(unit->getFactionIndex());
 	if (tmit != factionPosTriggers.end()) { // if any pos triggers for this unit's faction
-		PosTriggers &triggers = tmit->second;
-	start2:
-		PosTriggers::iterator it = triggers.begin();
- 		while (it != triggers.end()) {
-			if (it->region->isInside(unit->getPos())) {
-				string evnt = it->evnt;
-				int ud = it->user_dat;
-				it = triggers.erase(it);
-				ScriptManager::onTrigger(evnt, id, ud);
-				goto start2;
- 			} else {
- 				++it;
- 			}
-		}
+		checkPosTriggers(tmit->second, rgns, unit, fired);
+	}
+	foreach_const (FiredTriggers, it, fired) {
+		ScriptManager::onTrigger(it->evnt, it->unitId, it->user_dat);
 	}
 }
 
@@ -211,31 +237,33 @@ void TriggerManager::checkTrigger(TriggerMap &triggerMap, const Unit *unit) {
 	ScriptManager::onTrigger(evnt, unit->getId(), ud);
 }
 
+/** add a trigger for eventName on region to triggers (a unit's or faction's pos triggers) */
+SetTriggerRes TriggerManager::addPosTrigger(RegionTriggers &triggers, const string &region, 
+		const string &eventName, int userData) {
+	if (events.find(eventName) == events.end()) return SetTriggerRes::UNKNOWN_EVENT;
+	Regions::iterator rit = regions.find(region);
+	if (rit == regions.end()) return SetTriggerRes::UNKNOWN_REGION;
+	PosTriggers &rgnTriggers = triggers[rit->second];
+	PosTriggers::iterator it = rgnTriggers.begin();
+	for (; it != rgnTriggers.end(); ++it) {
+		if (it->evnt == eventName) {
+			return SetTriggerRes::DUPLICATE_TRIGGER;
+		}
+ 	}
+	rgnTriggers.push_back(PosTrigger());
+	rgnTriggers.back().region = rit->second;
+	rgnTriggers.back().evnt = eventName;
+	rgnTriggers.back().user_dat = userData;
+	return SetTriggerRes::OK;
+}
+
 /** @return 0 if ok, -1 if bad unit id, -2 if event not found, -3 region not found,
   * -4 unit already has a trigger for this region,event pair */
 SetTriggerRes TriggerManager::addUnitPosTrigger	(int unitId, const string &region, const string &eventName, int userData) {
 	//g_logger.logProgramEvent("adding unit="+intToStr(unitId)+ ", event=" + eventName + " trigger");
 	Unit *unit = g_world.findUnitById(unitId);
 	if (!unit) return SetTriggerRes::BAD_UNIT_ID;
-	if (events.find(eventName) == events.end()) return SetTriggerRes::UNKNOWN_EVENT;
-	Region *rgn = NULL;
-	if (regions.find(region) != regions.end()) rgn = regions[region];
-	if (!rgn) return SetTriggerRes::UNKNOWN_REGION;
-	if (unitPosTriggers.find(unitId) == unitPosTriggers.end()) {
-		unitPosTriggers.insert(pair<int,PosTriggers>(unitId,PosTriggers()));
- 	}
-	PosTriggers &triggers = unitPosTriggers.find(unitId)->second;
-	PosTriggers::iterator it = triggers.begin();
-	for (; it != triggers.end(); ++it) {
-		if (it->region == rgn && it->evnt == eventName) {
-			return SetTriggerRes::DUPLICATE_TRIGGER;
-		}
- 	}
-	triggers.push_back(PosTrigger());
-	triggers.back().region = rgn;
-	triggers.back().evnt = eventName;
-	triggers.back().user_dat = userData;
-	return SetTriggerRes::OK;
+	return addPosTrigger(unitPosTriggers[unitId], region, eventName, userData);
 }
 
 bool TriggerManager::removeUnitPosTriggers(int unitId) {
@@ -252,26 +280,7 @@ bool TriggerManager::removeUnitPosTriggers(int unitId) {
 SetTriggerRes TriggerManager::addFactionPosTrigger (int ndx, const string &region, const string &eventName, int userData) {
 	//g_logger.logProgramEvent("adding unit="+intToStr(unitId)+ ", event=" + eventName + " trigger");
 	if (ndx < 0 || ndx >= GameConstants::maxPlayers) return SetTriggerRes::BAD_FACTION_INDEX;
-	if (events.find(eventName) == events.end()) return SetTriggerRes::UNKNOWN_EVENT;
-	Region *rgn = NULL;
-	if (regions.find(region) != regions.end()) rgn = regions[region];
-	if (!rgn) return SetTriggerRes::UNKNOWN_REGION;
-
-	if (factionPosTriggers.find(ndx) == factionPosTriggers.end()) {
-		factionPosTriggers.insert(pair<int,PosTriggers>(ndx,PosTriggers()));
- 	}
-	PosTriggers &triggers = factionPosTriggers.find(ndx)->second;
-	PosTriggers::iterator it = triggers.begin();
-	for (; it != triggers.end(); ++it) {
-		if (it->region == rgn && it->evnt == eventName) {
-			return SetTriggerRes::DUPLICATE_TRIGGER;
-		}
- 	}
-	triggers.push_back(PosTrigger());
-	triggers.back().region = rgn;
-	triggers.back().evnt = eventName;
-	triggers.back().user_dat = userData;
-	return SetTriggerRes::OK;
+	return addPosTrigger(factionPosTriggers[ndx], region, eventName, userData);
 }
 
 }}
@@ -133,12 +133,20 @@ struct CompoundRegion : public Region {
 // =====================================================
 
 struct PosTrigger {
-	Region *region;
+	const Region *region;
 	string evnt;
 	int user_dat;
 	PosTrigger() : region(NULL), evnt(""), user_dat(0) {}
 };
 
+/** a trigger that has been hit, waiting to be fired */
+struct FiredTrigger {
+	string evnt;
+	int unitId;
+	int user_dat;
+	FiredTrigger(const string &evnt, int unitId, int ud) : evnt(evnt), unitId(unitId), user_dat(ud) {}
+};
+
 struct Trigger {
 	string evnt;
 	int user_dat;
@@ -159,16 +167,26 @@ WRAPPED_ENUM( SetTriggerRes
 //	class TriggerManager
 // =====================================================
 
+/** Position triggers are checked on every unit move, so they are found through the regions
+  * covering the unit's tile rather than tested one by one. Each map tile has a list of the
+  * regions overlapping it (in the order they were registered), and each unit & faction keeps
+  * its triggers by region, so a move to a tile no region covers costs one look up. */
 class TriggerManager {
 	typedef map<string,Region*>			Regions;
 	typedef set<string>					Events;
 	typedef vector<PosTrigger>			PosTriggers;
-	typedef map<int,PosTriggers>		PosTriggerMap;
+	typedef map<const Region*,PosTriggers>	RegionTriggers;	/**< one unit or faction's pos triggers, by region */
+	typedef map<int,RegionTriggers>		PosTriggerMap;
 	typedef map<int,Trigger>			TriggerMap;
+	typedef vector<const Region*>		RegionList;
+	typedef vector<FiredTrigger>		FiredTriggers;
 
 	Events  events;
 	Regions regions;
 
+	vector<RegionList>	tileRegions;	/**< per map tile, the regions overlapping it */
+	int					tileW, tileH;
+
 	PosTriggerMap	unitPosTriggers;
 	PosTriggerMap	factionPosTriggers;
 	TriggerMap		attackedTriggers;
@@ -179,8 +197,12 @@ class TriggerManager {
 	TriggerMap		commandCallbacks;
 	TriggerMap		deathTriggers;
 
+	void indexRegion(const Region *region, const Rect &rect);
+	void checkPosTriggers(RegionTriggers &triggers, const RegionList &rgns, const Unit *unit, FiredTriggers &fired);
+	SetTriggerRes addPosTrigger(RegionTriggers &triggers, const string &region, const string &eventName, int userData);
+
 public:
-	TriggerManager() {}
+	TriggerManager() : tileW(0), tileH(0) {}
 	~TriggerManager();
 
 	/** clean-up */
@@ -278,7 +300,9 @@ private:
 public:
 	// Engine interface, actually all called from ScriptManager.
 
-	/** checks position triggers, called whenever a unit is moved or created, unloaded, etc? */
+	/** checks position triggers, called whenever a unit is moved or created, unloaded, etc?
+	  * Triggers hit are removed, then fired once all have been checked. Triggers set from the
+	  * event handlers are not checked until the unit next moves. */
 	void unitMoved(const Unit *unit);
 
 	/** check death triggers and removes any other triggers for unit */
@@ -122,7 +122,7 @@ struct MudFlinger {
 
 	inline void setDirty(const Vec2i &pos) {
 		Vec2i cluster = ClusterMap::cellToCluster(pos);
-		cm->setClusterDirty(cluster);
+		cm->setCellDirty(pos);
 		LOG_CLUSTER_DIRTYING( "MapMetrics changed @ pos = " << pos << endl )
 		LOG_CLUSTER_DIRTYING( cout << "\tCluster = " << cluster << " dirty\n" )
 		int ymod = pos.y % GameConstants::clusterSize;
@@ -351,7 +351,7 @@ void AnnotatedMap::annotateLocal(const Unit *unit) {
 	const int &size = unit->getSize();
 	assert(cellMap->isInside(pos));
 	assert(cellMap->isInside(pos.x + size - 1, pos.y + size - 1));
-	const int dist = 3;
+	const int dist = localAnnotationRadius;
 	set<Unit*> annotate;
 
 	// find surrounding units
@@ -179,6 +179,9 @@ public:
 	bool isDirty(const Vec2i &pos) const			{ return metrics[pos].isDirty(); }
 	void setDirty(const Vec2i &pos, const bool val)	{ metrics[pos].setDirty(val);	}
 
+	/** how far around a unit annotateLocal() looks for other units */
+	static const int localAnnotationRadius = 3;
+
 	void annotateLocal(const Unit *unit);
 	void clearLocalAnnotations(const Unit *unit);
 
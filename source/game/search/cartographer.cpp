@@ -61,6 +61,7 @@ Cartographer::Cartographer(World *world)
 	clusterMap = new ClusterMap(masterMap, this);
 
 	// team search and visibility maps
+	m_fowChanged.resize(cellMap->getTileW() * cellMap->getTileH(), false);
 	set<int> teams;
 	for (int i=0; i < world->getFactionCount(); ++i) {
 		const Faction *f = world->getFaction(i);
@@ -149,6 +150,9 @@ Cartographer::~Cartographer() {
 	deleteMapValues(resourceMaps);
 	deleteMapValues(storeMaps);
 	deleteMapValues(siteMaps);
+
+	// Flow fields
+	deleteValues(m_flowFields.begin(), m_flowFields.end());
 }
 
 void Cartographer::initResourceMap(ResourceMapKey key, PatchMap<1> *pMap) {
@@ -395,9 +399,13 @@ void Cartographer::detectorSightModified(Unit *unit, int oldSight) {
 }
 
 void Cartographer::tick() {
+	int edgesRecomputed = 0, edgesReused = 0;
 	if (clusterMap->isDirty()) {
 		clusterMap->update();
+		edgesRecomputed = clusterMap->getEdgesRecomputed();
+		edgesReused = clusterMap->getEdgesReused();
 	}
+	g_debugStats->setClusterMapStats(edgesRecomputed, edgesReused);
 	foreach (ResourcePosMap, it, resDirtyAreas) {
 		if (!it->second.empty()) {
 			foreach (V2iList, posIt, it->second) {
@@ -439,6 +447,83 @@ void Cartographer::adjustGlestimalMap(Field f, TypeMap<float> &iMap, const Vec2i
 	nmSearchEngine->aStar(goal, cost, zero);
 }
 
+/** MoveCost confined to a rectangle, for searches that need only part of the map */
+class RegionMoveCost {
+private:
+	MoveCost   cost;
+	Rectangle  region;
+
+public:
+	RegionMoveCost(Field f, int size, const AnnotatedMap *aMap, const Rectangle &region)
+			: cost(f, size, aMap), region(region) {}
+
+	float operator()(const Vec2i &p1, const Vec2i &p2) const {
+		if (p2.x < region.x || p2.y < region.y || p2.x >= region.x + region.w || p2.y >= region.y + region.h) {
+			return numeric_limits<float>::infinity();
+		}
+		return cost(p1, p2);
+	}
+};
+
+/** Dijkstra search out from goal over the clusters spanning from & goal (plus a cluster
+  * either side, to leave room to go around things), writing the cost to goal of each cell
+  * into a new flow field. */
+FlowField* Cartographer::buildFlowField(const Vec2i &dest, const Vec2i &goal, const Vec2i &from, Field f, int size) {
+	const int cs = GameConstants::clusterSize;
+	Vec2i tl(std::min(from.x, goal.x) / cs - 1, std::min(from.y, goal.y) / cs - 1);
+	Vec2i br(std::max(from.x, goal.x) / cs + 2, std::max(from.y, goal.y) / cs + 2);
+	tl = Vec2i(std::max(tl.x * cs, 0), std::max(tl.y * cs, 0));
+	br = Vec2i(std::min(br.x * cs, cellMap->getW()), std::min(br.y * cs, cellMap->getH()));
+	Rectangle region(tl.x, tl.y, br.x - tl.x, br.y - tl.y);
+
+	FlowField *flowField = new FlowField(dest, goal, f, size, region);
+	nmSearchEngine->setStart(goal, 0.f);
+	RegionMoveCost cost(f, size, masterMap, region);
+	DistanceBuilderGoal goalFunc(&flowField->m_distance);
+	ZeroHeuristic zero;
+	nmSearchEngine->aStar(goalFunc, cost, zero);
+	return flowField;
+}
+
+FlowField* Cartographer::getFlowField(const Vec2i &dest, const Vec2i &goal, const Vec2i &from, Field f, int size) {
+	foreach (FlowFields, it, m_flowFields) {
+		FlowField *ff = *it;
+		if (!ff->m_stale && ff->m_field == f && ff->m_size == size
+		&& abs(ff->m_dest.x - dest.x) <= flowFieldShareRange && abs(ff->m_dest.y - dest.y) <= flowFieldShareRange
+		&& ff->isReachable(from)) {
+			++ff->m_refCount;
+			return ff;
+		}
+	}
+	FlowField *ff = buildFlowField(dest, goal, from, f, size);
+	if (!ff->isReachable(from)) {
+		delete ff;
+		return 0;
+	}
+	++ff->m_refCount;
+	m_flowFields.push_back(ff);
+	return ff;
+}
+
+void Cartographer::releaseFlowField(FlowField *flowField) {
+	assert(flowField->m_refCount > 0);
+	if (--flowField->m_refCount == 0) {
+		FlowFields::iterator it = std::find(m_flowFields.begin(), m_flowFields.end(), flowField);
+		assert(it != m_flowFields.end());
+		m_flowFields.erase(it);
+		delete flowField;
+	}
+}
+
+/** flag flow fields an obstacle change at pos could invalidate, their users will get new ones */
+void Cartographer::markFlowFieldsStale(const Vec2i &pos, int size) {
+	foreach (FlowFields, it, m_flowFields) {
+		if ((*it)->overlaps(pos, size)) {
+			(*it)->m_stale = true;
+		}
+	}
+}
+
 /** constructs an influence map using djkstra search from all tech resources, fills 'positions' with
   * a collection of Vec2i that are each at least 25 cells distant from a tech resource, and at
   * least 15 cells distant from each other. */
@@ -502,61 +587,197 @@ void Cartographer::initTeamMaps() {
 	}
 }
 
-/** Custom Goal function for maintaining the exploration maps */
-class VisibilityMaintainerGoal {
-private:
-	float range;			/**< range of entity sight */
-	ExplorationMap *eMap;	/**< exploration map to adjust */
-	bool inc;				/**< true to increment, false to decrement */
-public:
-	/** Construct goal function object
-	  * @param range the range of visibility
-	  * @param eMap the ExplorationMap to adjust
-	  * @param inc true to apply visibility, false to remove
-	  */
-	VisibilityMaintainerGoal(float range, ExplorationMap *eMap, bool inc)
-		: range(range), eMap(eMap), inc(inc) {}
+/** radius (in tiles) of the circle a unit with sight range sight (in cells) makes visible,
+  * a tile is inside if its distance from the centre tile is less than this */
+static inline int surfSightRange(int sight) {
+	return sight / GameConstants::cellScale + 1;
+}
 
-	/** The goal function
-	  * @param pos position to test
-	  * @param costSoFar the cost of the shortest path to pos
-	  * @return true when range is exceeded.
-	  */
-	bool operator()(const Vec2i &pos, const float costSoFar) const {
-		if ( costSoFar > range ) {
-			return true;
+/** radius (in tiles) of the circle a unit with sight range sight explores */
+static inline int sweepRange(int sight) {
+	return surfSightRange(sight) + World::indirectSightRange + 1;
+}
+
+static inline bool inCircle(const Vec2i &centre, int radius, int x, int y) {
+	const int dx = x - centre.x, dy = y - centre.y;
+	return dx * dx + dy * dy < radius * radius;
+}
+
+/** Maintains visibility on a per team basis. Brings what a unit adds to its team's
+  * exploration map up to date, only the tiles that enter or leave its sight are touched.
+  * @param unit the unit to update visibility for
+  * @param add true to apply the unit's current visibility, false to remove it entirely
+  */
+void Cartographer::maintainUnitVisibility(Unit *unit, bool add) {
+	TeamExplorationMaps::iterator mit = m_explorationMaps.find(unit->getTeam());
+	if (mit == m_explorationMaps.end()) {
+		return; // glestimals
+	}
+	UnitSight now;
+	now.active = add && unit->isOperative() && !unit->isCarried() && !unit->isGarrisoned();
+	if (now.active) {
+		now.tilePos = Map::toTileCoords(unit->getCenteredPos());
+		now.sight = unit->getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue();
+	}
+	UnitSights::iterator it = m_unitSights.find(unit->getId());
+	const UnitSight was = it == m_unitSights.end() ? UnitSight() : it->second;
+	if (was == now) {
+		return;
+	}
+	adjustVisibility(unit->getTeam(), mit->second, was, now);
+	if (now.active) {
+		m_unitSights[unit->getId()] = now;
+	} else if (it != m_unitSights.end()) {
+		m_unitSights.erase(it);
+	}
+}
+
+/** Moves one source of visibility for team from was to now: decrements the counters
+  * of tiles that were in sight and are not now, increments those newly in sight, and
+  * explores the tiles newly in the sweep range. */
+void Cartographer::adjustVisibility(int team, ExplorationMap *eMap, const UnitSight &was, const UnitSight &now) {
+	const int w = cellMap->getTileW(), h = cellMap->getTileH();
+	if (was.active) {
+		const int r = surfSightRange(was.sight);
+		const int x0 = std::max(was.tilePos.x - r, 0), x1 = std::min(was.tilePos.x + r, w - 1);
+		const int y0 = std::max(was.tilePos.y - r, 0), y1 = std::min(was.tilePos.y + r, h - 1);
+		const int nr = now.active ? surfSightRange(now.sight) : 0;
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				if (inCircle(was.tilePos, r, x, y)
+				&& !(now.active && inCircle(now.tilePos, nr, x, y))) {
+					Vec2i tPos(x, y);
+					if (!eMap->decVisCounter(tPos)) {
+						refreshTileVisibility(team, tPos);
+					}
+				}
+			}
 		}
-		if ( inc ) {
-			eMap->incVisCounter(pos);
-		} else {
-			eMap->decVisCounter(pos);
+	}
+	if (now.active) {
+		const int r = surfSightRange(now.sight);
+		const int sr = sweepRange(now.sight);
+		const int wr = was.active ? surfSightRange(was.sight) : 0;
+		const int wsr = was.active ? sweepRange(was.sight) : 0;
+		const bool explore = world->getShroudOfDarkness();
+		const int x0 = std::max(now.tilePos.x - sr, 0), x1 = std::min(now.tilePos.x + sr, w - 1);
+		const int y0 = std::max(now.tilePos.y - sr, 0), y1 = std::min(now.tilePos.y + sr, h - 1);
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				if (!inCircle(now.tilePos, sr, x, y)) {
+					continue;
+				}
+				Vec2i tPos(x, y);
+				if (explore && !(was.active && inCircle(was.tilePos, wsr, x, y))) {
+					exploreTile(team, tPos);
+				}
+				if (inCircle(now.tilePos, r, x, y) && !(was.active && inCircle(was.tilePos, wr, x, y))) {
+					if (eMap->incVisCounter(tPos) == 1) {
+						refreshTileVisibility(team, tPos);
+					}
+				}
+			}
 		}
-		return false;
 	}
-};
+}
 
-/** Maintains visibility on a per team basis. Adds or removes a unit's visibility
-  * to (or from) its team exploration map, using a Dijkstra search.
-  * @param unit the unit to remove or add visibility for
-  * @param add true to add this units visibility to its team map, false to remove
-  */
-void Cartographer::maintainUnitVisibility(Unit *unit, bool add) {
+void Cartographer::markFowChanged(const Vec2i &tPos) {
+	const int ndx = tPos.y * cellMap->getTileW() + tPos.x;
+	if (!m_fowChanged[ndx]) {
+		m_fowChanged[ndx] = true;
+		m_fowChanges.push_back(tPos);
+	}
+}
 
-	/* This might be too expensive using Dijkstra...
+/** set a tile's visible flag for team from its counter & the fog settings, and note
+  * the tile for the minimap if it changed for this team */
+void Cartographer::refreshTileVisibility(int team, const Vec2i &tPos) {
+	Tile *tile = cellMap->getTile(tPos);
+	TeamExplorationMaps::iterator it = m_explorationMaps.find(team);
+	bool visible = (it != m_explorationMaps.end() && it->second->getVisCounter(tPos))
+		|| (!world->getFogOfWar() && tile->isExplored(team));
+	if (visible != tile->isVisible(team)) {
+		tile->setVisible(team, visible);
+		if (team == world->getThisTeamIndex()) {
+			markFowChanged(tPos);
+		}
+	}
+}
 
-	// set up goal function
-	VisibilityMaintainerGoal goalFunc((float)unit->getSight(), m_explorationMaps[unit->getTeam()], add);
-	// set up search engine
-	GridNeighbours::setSearchSpace(SearchSpace::TILEMAP);
-	nmSearchEngine->setNodeLimit(-1);
-	nmSearchEngine->reset();
-	nmSearchEngine->setOpen(Map::toTileCoords(unit->getCenteredPos()), 0.f);
-	// zap
-	nmSearchEngine->aStar<VisibilityMaintainerGoal,DistanceCost,ZeroHeuristic>
-						 (goalFunc,DistanceCost(),ZeroHeuristic());
-	// reset search space
-	GridNeighbours::setSearchSpace(SearchSpace::CELLMAP);
-	*/
+void Cartographer::exploreTile(int team, const Vec2i &tPos) {
+	Tile *tile = cellMap->getTile(tPos);
+	if (!tile->isExplored(team)) {
+		tile->setExplored(team, true);
+		if (team == world->getThisTeamIndex()) {
+			markFowChanged(tPos);
+		}
+		refreshTileVisibility(team, tPos); // visible if no fog
+	}
+}
+
+void Cartographer::revealArea(int team, const Vec2i &tl, const Vec2i &br, bool reveal) {
+	TeamExplorationMaps::iterator it = m_explorationMaps.find(team);
+	if (it == m_explorationMaps.end()) {
+		return;
+	}
+	const int x0 = std::max(tl.x, 0), x1 = std::min(br.x, cellMap->getTileW() - 1);
+	const int y0 = std::max(tl.y, 0), y1 = std::min(br.y, cellMap->getTileH() - 1);
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			Vec2i tPos(x, y);
+			if (reveal) {
+				exploreTile(team, tPos);
+				if (it->second->incVisCounter(tPos) == 1) {
+					refreshTileVisibility(team, tPos);
+				}
+			} else if (!it->second->decVisCounter(tPos)) {
+				refreshTileVisibility(team, tPos);
+			}
+		}
+	}
+}
+
+/** rebuilds every team's visible plane a row at a time, explored words (without
+  * fog) or nothing (with), then the tiles in sight of any of the team's units */
+void Cartographer::initVisibility() {
+	typedef VisibilityPlanes::Word Word;
+	const int w = cellMap->getTileW(), h = cellMap->getTileH();
+	VisibilityPlanes &planes = cellMap->getVisibility();
+	const int rowWords = planes.getRowWords();
+	const bool fog = world->getFogOfWar();
+	for (int team = 0; team < GameConstants::maxPlayers; ++team) {
+		TeamExplorationMaps::iterator it = m_explorationMaps.find(team);
+		const ExplorationMap *eMap = it != m_explorationMaps.end() ? it->second : 0;
+		for (int y = 0; y < h; ++y) {
+			Word *visRow = planes.getVisibleRow(team, y);
+			const Word *expRow = planes.getExploredRow(team, y);
+			for (int wx = 0; wx < rowWords; ++wx) {
+				visRow[wx] = fog ? 0 : expRow[wx];
+			}
+			if (eMap) {
+				for (int x = 0; x < w; ++x) {
+					if (eMap->getVisCounter(Vec2i(x, y))) {
+						visRow[x / VisibilityPlanes::wordBits] |= Word(1) << (x % VisibilityPlanes::wordBits);
+					}
+				}
+			}
+		}
+	}
+	m_fowChanges.clear();
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			m_fowChanges.push_back(Vec2i(x, y));
+		}
+	}
+	m_fowChanged.assign(w * h, true);
+}
+
+void Cartographer::takeFowChanges(V2iList &changes) {
+	changes.clear();
+	changes.swap(m_fowChanges);
+	for (V2iList::const_iterator it = changes.begin(); it != changes.end(); ++it) {
+		m_fowChanged[it->y * cellMap->getTileW() + it->x] = false;
+	}
 }
 
 /** Custom Goal function for finding resources */
@@ -16,6 +16,7 @@
 
 #include "influence_map.h"
 #include "annotated_map.h"
+#include "flow_field.h"
 
 #include "world.h"
 #include "config.h"
@@ -27,34 +28,42 @@ using std::make_pair;
 
 namespace Glest { namespace Search {
 
-/** A map containing a visility counter and explored flag for every map tile. 
-  * WIP, not in use, exploration state is currently maintained in the tile map */
+/** A visibility counter for every map tile, for one team: the number of the team's
+  * units (and map reveals) that can see the tile. Tile::isVisible() is kept in step
+  * with it by the Cartographer, see Cartographer::maintainUnitVisibility(). Explored
+  * state is kept in the tile map. */
 class ExplorationMap {
-#	pragma pack(push, 2)
-		struct ExplorationState {	/**< The exploration state of one tile for one team */			
-			uint16 visCounter : 15;	/**< Visibility counter, the number of team's units that can see this tile */ 
-			uint16 explored	  :  1;	/**< Explored flag */
-		}; // max 32768 units per _team_
-#	pragma pack(pop)
-	ExplorationState *state; /**< The Data */
+	uint16 *visCounter; /**< per tile, max 65535 sources per _team_ */
 	Map *cellMap;
 public:
 	ExplorationMap(Map *cMap) : cellMap(cMap) { /**< Construct ExplorationMap, sets everything to zero */
-		state = new ExplorationState[cellMap->getTileW() * cellMap->getTileH()];
-		memset(state, 0, sizeof(ExplorationState) * cellMap->getTileW() * cellMap->getTileH());
+		visCounter = new uint16[cellMap->getTileW() * cellMap->getTileH()];
+		memset(visCounter, 0, sizeof(uint16) * cellMap->getTileW() * cellMap->getTileH());
 	}
-	~ExplorationMap(){ delete[] state; }
-	/** @param pos cell coordinates @return number of units that can see this tile */
-	int  getVisCounter(const Vec2i &pos) const	{ return state[pos.y * cellMap->getTileH() + pos.x].visCounter; }
-	/** @param pos tile coordinates to increase visibilty on */
-	void incVisCounter(const Vec2i &pos) const	{ ++state[pos.y * cellMap->getTileH() + pos.x].visCounter;		}
-	/** @param pos tile coordinates to decrease visibilty on */
-	void decVisCounter(const Vec2i &pos) const	{ --state[pos.y * cellMap->getTileH() + pos.x].visCounter;		}
-	/** @param pos tile coordinates @return true if explored. */
-	bool isExplored(const Vec2i &pos)	 const	{ return state[pos.y * cellMap->getTileH() + pos.x].explored;	}
-	/** @param pos coordinates of tile to set as explored */
-	void setExplored(const Vec2i &pos)	 const	{ state[pos.y * cellMap->getTileH() + pos.x].explored = 1;		}
+	~ExplorationMap(){ delete[] visCounter; }
+	/** @param pos tile coordinates @return number of units that can see this tile */
+	int  getVisCounter(const Vec2i &pos) const	{ return visCounter[pos.y * cellMap->getTileW() + pos.x]; }
+	/** @param pos tile coordinates to increase visibilty on @return the new count */
+	int  incVisCounter(const Vec2i &pos)		{ return ++visCounter[pos.y * cellMap->getTileW() + pos.x]; }
+	/** @param pos tile coordinates to decrease visibilty on @return the new count */
+	int  decVisCounter(const Vec2i &pos)		{
+		assert(visCounter[pos.y * cellMap->getTileW() + pos.x]);
+		return --visCounter[pos.y * cellMap->getTileW() + pos.x];
+	}
+};
+
+/** the tiles a unit is currently adding to its team's visibility counters */
+struct UnitSight {
+	bool   active;	/**< false if the unit sees nothing (dead, carried, being built...) */
+	Vec2i  tilePos;	/**< tile the unit's sight is centred on */
+	int    sight;	/**< sight range in cells */
 
+	UnitSight() : active(false), tilePos(-1), sight(0) {}
+
+	bool operator==(const UnitSight &that) const {
+		return active == that.active && (!active || (tilePos == that.tilePos && sight == that.sight));
+	}
+	bool operator!=(const UnitSight &that) const { return !(*this == that); }
 };
 
 
@@ -124,6 +133,9 @@ private:
 
 	typedef map<int, AnnotatedMap*>     TeamAnnotatedMaps;
 	typedef map<int, ExplorationMap*>   TeamExplorationMaps;
+	typedef map<int, UnitSight>         UnitSights;
+
+	typedef vector<FlowField*>          FlowFields;
 
 private:
 	// Map abstractions for A* and HAA* search
@@ -141,8 +153,14 @@ private:
 	StoreMaps      storeMaps;    /**< Goal maps for 'store' units */
 	SiteMaps       siteMaps;     /**< Goal maps for building sites */
 
+	// Group moves
+	FlowFields     m_flowFields; /**< Flow fields in use, see getFlowField() */
+
 	// Exploration
 	TeamExplorationMaps  m_explorationMaps; /**< Exploration maps for each team */
+	UnitSights           m_unitSights;      /**< what each unit (by id) has applied to its team's map */
+	V2iList              m_fowChanges;      /**< tiles this team's visible/explored state changed on */
+	vector<bool>         m_fowChanged;      /**< per tile, true if in m_fowChanges */
 	TeamDetectorMaps     m_detectorMaps;    /**< Detector maps */
 
 	// A* stuff
@@ -187,6 +205,13 @@ private:
 	//void onUnitDied(Unit *unit);
 
 	void maintainUnitVisibility(Unit *unit, bool add);
+	void adjustVisibility(int team, ExplorationMap *eMap, const UnitSight &was, const UnitSight &now);
+	void refreshTileVisibility(int team, const Vec2i &tPos);
+	void exploreTile(int team, const Vec2i &tPos);
+	void markFowChanged(const Vec2i &tPos);
+
+	FlowField* buildFlowField(const Vec2i &dest, const Vec2i &goal, const Vec2i &from, Field f, int size);
+	void markFlowFieldsStale(const Vec2i &pos, int size);
 
 	void saveResourceState(XmlNode *node);
 	void loadResourceState(XmlNode *node);
@@ -202,10 +227,20 @@ public:
 	  * @param team team index 
 	  * @param pos the co-ordinates of the <b>tile</b> of interest. */
 	int getTeamVisibility(int team, const Vec2i &pos) { return m_explorationMaps[team]->getVisCounter(pos); }
-	/** Adds a unit's visibility to its team's exploration map */
+	/** Brings a unit's visibility on its team's exploration map up to date with its
+	  * position, sight & state, call when any of them may have changed */
 	void applyUnitVisibility(Unit *unit)	{ maintainUnitVisibility(unit, true); }
 	/** Removes a unit's visibility from its team's exploration map */
 	void removeUnitVisibility(Unit *unit)	{ maintainUnitVisibility(unit, false); }
+	/** Adds (or removes) a scripted reveal of the tiles from tl to br inclusive for team,
+	  * revealed tiles are also explored */
+	void revealArea(int team, const Vec2i &tl, const Vec2i &br, bool reveal);
+	/** Sets every tile's visibility from the counters & the game's fog settings, and
+	  * flags them all as changed, call once the map & exploration state are loaded */
+	void initVisibility();
+	/** Moves the list of tiles whose visible or explored state changed for this team
+	  * since the last call into changes */
+	void takeFowChanges(V2iList &changes);
 
 	void initTeamMaps();
 
@@ -216,6 +251,9 @@ public:
 	  * @param size size of obstacle	*/
 	void updateMapMetrics(const Vec2i &pos, const int size) { 
 		masterMap->updateMapMetrics(pos, size);
+		if (!m_flowFields.empty()) {
+			markFlowFieldsStale(pos, size);
+		}
 		// who can see it ? update their maps too.
 		// set cells as dirty for those that can't see it
 	}
@@ -267,6 +305,18 @@ public:
 		return getSiteMap(key);
 	}
 
+	/** Get a flow field towards dest for units of size in field f, sharing one already built
+	  * for a nearby destination if one covers from, else building one. Must be released with
+	  * releaseFlowField() when the unit is done with it.
+	  * @param dest the destination asked for
+	  * @param goal the nearest free position to dest, where the field leads to
+	  * @param from position of the unit wanting the field, the field must cover it
+	  * @return the flow field, or NULL if goal can not be reached from from */
+	FlowField* getFlowField(const Vec2i &dest, const Vec2i &goal, const Vec2i &from, Field f, int size);
+	/** drop a reference to a flow field got from getFlowField() */
+	void releaseFlowField(FlowField *flowField);
+	int  getFlowFieldCount() const { return m_flowFields.size(); }
+
 	void adjustGlestimalMap(Field f, TypeMap<float> &iMap, const Vec2i &pos, float range);
 	void buildGlestimalMap(Field f, V2iList &positions);
 
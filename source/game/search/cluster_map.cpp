@@ -50,7 +50,7 @@ void Transition::zeroCounters() {
 }
 
 ClusterMap::ClusterMap(AnnotatedMap *aMap, Cartographer *carto) 
-		: carto(carto), aMap(aMap), dirty(false) {
+		: carto(carto), aMap(aMap), dirty(false), edgesRecomputed(0), edgesReused(0) {
 	//_PROFILE_FUNCTION();
 	w = aMap->getWidth() / clusterSize;
 	h = aMap->getHeight() / clusterSize;
@@ -71,6 +71,7 @@ ClusterMap::ClusterMap(AnnotatedMap *aMap, Cartographer *carto)
 			//g_logger.clusterInit();
 		}
 	}
+	freshTransitions.clear();
 }
 
 ClusterMap::~ClusterMap() {
@@ -317,7 +318,9 @@ void ClusterMap::initClusterBorder(const Vec2i &cluster, bool north) {
 				}
 			) // DEBUG_EDITION
 
-			cb->transitions[f].clear();
+			// keep the old transitions aside, any that come back unchanged are re-used
+			TransitionCollection old = cb->transitions[f];
+			cb->transitions[f].n = 0;
 			clear = false;
 			inf.f = f;
 			inf.max_clear = -1;
@@ -356,6 +359,30 @@ void ClusterMap::initClusterBorder(const Vec2i &cluster, bool north) {
 				inf.startPos = inf.endPos = inf.max_clear = -1;
 				clear = false;
 			}
+			// a transition at the same place with the same clearance is the same transition,
+			// keep the old one (and its edges), anything else is new or gone
+			TransitionCollection &now = cb->transitions[f];
+			for (int i=0; i < now.n; ++i) {
+				bool found = false;
+				for (int j=0; j < old.n; ++j) {
+					if (old.transitions[j] && old.transitions[j]->nwPos == now.transitions[i]->nwPos
+					&& old.transitions[j]->clearance == now.transitions[i]->clearance) {
+						delete now.transitions[i];
+						now.transitions[i] = old.transitions[j];
+						old.transitions[j] = 0;
+						found = true;
+						break;
+					}
+				}
+				if (!found) {
+					freshTransitions.insert(now.transitions[i]);
+				}
+			}
+			for (int j=0; j < old.n; ++j) {
+				if (old.transitions[j]) {
+					removedTransitions.push_back(old.transitions[j]);
+				}
+			}
 		}// for each Field
 
 		IF_DEBUG_EDITION(
@@ -437,38 +464,78 @@ void ClusterMap::getTransitions(const Vec2i &cluster, Field f, Transitions &t) {
 	}
 }
 
-void ClusterMap::disconnectCluster(const Vec2i &cluster) {
-	//cout << "Disconnecting cluster " << cluster << endl;
+void ClusterMap::DirtyRect::add(const Vec2i &pos) {
+	tl.x = min(tl.x, pos.x);
+	tl.y = min(tl.y, pos.y);
+	br.x = std::max(br.x, pos.x);
+	br.y = std::max(br.y, pos.y);
+}
+
+/** @return true if any dirty cell is in the rectangle with corners a & b (in any order) */
+bool ClusterMap::DirtyRect::intersects(const Vec2i &a, const Vec2i &b) const {
+	return min(a.x, b.x) <= br.x && std::max(a.x, b.x) >= tl.x
+		&& min(a.y, b.y) <= br.y && std::max(a.y, b.y) >= tl.y;
+}
+
+void ClusterMap::addDirtyCell(const Vec2i &cluster, const Vec2i &pos) {
+	setClusterDirty(cluster);
+	DirtyRects::iterator it = dirtyCells.find(cluster);
+	if (it == dirtyCells.end()) {
+		dirtyCells[cluster] = DirtyRect(pos);
+	} else {
+		it->second.add(pos);
+	}
+}
+
+/** the metrics of the cell at pos have changed. Transitions on the north & west borders
+  * of a cluster are in the last row/column of the clusters beyond, so cells there are
+  * also dirty cells of the clusters to the south & east. */
+void ClusterMap::setCellDirty(const Vec2i &pos) {
+	Vec2i cluster = cellToCluster(pos);
+	addDirtyCell(cluster, pos);
+	bool east = pos.x % clusterSize == clusterSize - 1 && cluster.x < w - 1;
+	bool south = pos.y % clusterSize == clusterSize - 1 && cluster.y < h - 1;
+	if (east) {
+		addDirtyCell(Vec2i(cluster.x + 1, cluster.y), pos);
+	}
+	if (south) {
+		addDirtyCell(Vec2i(cluster.x, cluster.y + 1), pos);
+	}
+	if (east && south) {
+		addDirtyCell(Vec2i(cluster.x + 1, cluster.y + 1), pos);
+	}
+}
+
+/** remove the edges of cluster's transitions to transitions about to be deleted */
+void ClusterMap::disconnectRemoved(const Vec2i &cluster) {
+	set<const Transition*> removed(removedTransitions.begin(), removedTransitions.end());
 	for (Field f(0); f < Field::COUNT; ++f) {
 		if (!aMap->maxClearance[f] || f == Field::AIR) continue;
 		Transitions t;
 		getTransitions(cluster, f, t);
-		set<const Transition*> tset;
-		for (Transitions::iterator it = t.begin(); it != t.end(); ++it) {
-			tset.insert(*it);
-		}
-		//int del = 0;
 		for (Transitions::iterator it = t.begin(); it != t.end(); ++it) {
 			Transition *t = const_cast<Transition*>(*it);
 			Edges::iterator eit = t->edges.begin(); 
 			while (eit != t->edges.end()) {
-				if (tset.find((*eit)->transition()) != tset.end()) {
+				if (removed.find((*eit)->transition()) != removed.end()) {
 					delete *eit;
 					eit = t->edges.erase(eit);
-					//++del;
 				} else {
 					++eit;
 				}
 			}
 		}
-		//cout << "\tDeleted " << del << " edges in Field = " << FieldNames[f] << ".\n";
 	}
-	
 }
 
+/** Bring the abstract graph up to date with the map metrics. Only dirty borders
+  * have their entrances searched for again, transitions that come back unchanged
+  * are kept, and only the edges of dirty clusters that could have changed are
+  * searched for again, see evalCluster() */
 void ClusterMap::update() {
 	//_PROFILE_FUNCTION();
 	//cout << "ClusterMap::update()" << endl;
+	edgesRecomputed = edgesReused = 0;
 	for (set<Vec2i>::iterator it = dirtyNorthBorders.begin(); it != dirtyNorthBorders.end(); ++it) {
 		if (it->y > 0 && it->y < h) {
 			dirtyClusters.insert(Vec2i(it->x, it->y));
@@ -481,10 +548,6 @@ void ClusterMap::update() {
 			dirtyClusters.insert(Vec2i(it->x - 1, it->y));
 		}
 	}
-	for (set<Vec2i>::iterator it = dirtyClusters.begin(); it != dirtyClusters.end(); ++it) {
-		//cout << "cluster " << *it << " dirty." << endl;
-		disconnectCluster(*it);
-	}
 	for (set<Vec2i>::iterator it = dirtyNorthBorders.begin(); it != dirtyNorthBorders.end(); ++it) {
 		//cout << "cluster " << *it << " north border dirty." << endl;
 		initClusterBorder(*it, true);
@@ -493,23 +556,49 @@ void ClusterMap::update() {
 		//cout << "cluster " << *it << " west border dirty." << endl;
 		initClusterBorder(*it, false);
 	}
+	// edges to a transition only come from the two clusters either side of its border, and 
+	// both of those are dirty if the border is
+	if (!removedTransitions.empty()) {
+		for (set<Vec2i>::iterator it = dirtyClusters.begin(); it != dirtyClusters.end(); ++it) {
+			disconnectRemoved(*it);
+		}
+		deleteValues(removedTransitions.begin(), removedTransitions.end());
+		removedTransitions.clear();
+	}
 	for (set<Vec2i>::iterator it = dirtyClusters.begin(); it != dirtyClusters.end(); ++it) {
+		//cout << "cluster " << *it << " dirty." << endl;
 		evalCluster(*it);
 	}
 	
+	freshTransitions.clear();
 	dirtyClusters.clear();
 	dirtyNorthBorders.clear();
 	dirtyWestBorders.clear();
+	dirtyCells.clear();
 	dirty = false;
 }
 
+/** @return true if edge e, from t, made by an earlier evaluation of cluster, is still good.
+  * Line path costs are optimal (they are the diagonal distance) and depend only on the cells
+  * between the ends, so they stand if none of those cells changed. A* costs could be changed
+  * by any cell of the cluster. */
+bool ClusterMap::canReuse(const Vec2i &cluster, const Edge *e, const Transition *t) const {
+	DirtyRects::const_iterator it = dirtyCells.find(cluster);
+	if (it == dirtyCells.end()) {
+		return true; // no cell of the cluster changed, only its borders
+	}
+	return e->isLinePath() && !it->second.intersects(t->nwPos, e->transition()->nwPos);
+}
 
-/** compute intra-cluster path lengths */
+/** compute intra-cluster path lengths, keeping those of existing edges that can not
+  * have changed. Pairs of old transitions without an edge stay that way if no cell
+  * of the cluster changed. */
 void ClusterMap::evalCluster(const Vec2i &cluster) {
 	//_PROFILE_FUNCTION();
 	//int linePathSuccess = 0, linePathFail = 0;
 	SearchEngine<NodePool> *se = carto->getRoutePlanner()->getSearchEngine();
 	se->getNeighbourFunc().setSearchCluster(cluster);
+	const bool cellsDirty = dirtyCells.find(cluster) != dirtyCells.end();
 	Transitions transitions;
 	for (Field f(0); f < Field::COUNT; ++f) {
 		if (!aMap->maxClearance[f] || f == Field::AIR) continue;
@@ -518,48 +607,73 @@ void ClusterMap::evalCluster(const Vec2i &cluster) {
 		Transitions::iterator it = transitions.begin();
 		for ( ; it != transitions.end(); ++it) { // foreach transition
 			Transition *t = const_cast<Transition*>(*it);
-			Vec2i start = t->nwPos;
+			const bool fresh = freshTransitions.find(t) != freshTransitions.end();
 			Transitions::iterator it2 = transitions.begin();
 			for ( ; it2 != transitions.end(); ++it2) { // foreach other transition
 				const Transition* &t2 = *it2;
 				if (t == t2) continue;
-				Vec2i dest = t2->nwPos;
-#				if _USE_LINE_PATH_
-					float cost = linePathLength(f, 1, start, dest);
-					if (cost == numeric_limits<float>::infinity()) {
-						cost  = aStarPathLength(f, 1, start, dest);
-					}
-#				else
-					float cost  = aStarPathLength(f, 1, start, dest);
-#				endif
-				if (cost == numeric_limits<float>::infinity()) continue;
-				Edge *e = new Edge(t2, f);
-				t->edges.push_back(e);
-				e->addWeight(cost);
-				int size = 2;
-				int maxClear = t->clearance > t2->clearance ? t2->clearance : t->clearance;
-				while (size <= maxClear) {
-#					if _USE_LINE_PATH_
-						cost = linePathLength(f, 1, start, dest);
-						if (cost == numeric_limits<float>::infinity()) {
-							cost  = aStarPathLength(f, size, start, dest);
-						}
-#					else
-						float cost  = aStarPathLength(f, size, start, dest);
-#					endif
-					if (cost == numeric_limits<float>::infinity()) {
-						break;
+				Edges::iterator eit = t->edges.begin();
+				while (eit != t->edges.end()
+				&& ((*eit)->transition() != t2 || (*eit)->getOwner() != cluster)) {
+					++eit;
+				}
+				if (eit != t->edges.end()) {
+					if (canReuse(cluster, *eit, t)) {
+						++edgesReused;
+						continue;
 					}
-					e->addWeight(cost);
-					assert(size == e->maxClear());
-					++size;
+					delete *eit;
+					t->edges.erase(eit);
+				} else if (!cellsDirty && !fresh && freshTransitions.find(t2) == freshTransitions.end()) {
+					continue; // no path before, nothing has changed
 				}
+				evalEdge(cluster, f, t, t2);
 			} // for each other transition
 		} // for each transition
 	} // for each Field
 	se->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
 }
 
+/** search for the path lengths from t to t2 within cluster, adds an edge if there are any */
+void ClusterMap::evalEdge(const Vec2i &cluster, Field f, Transition *t, const Transition *t2) {
+	++edgesRecomputed;
+	Vec2i start = t->nwPos;
+	Vec2i dest = t2->nwPos;
+	bool line = false;
+#	if _USE_LINE_PATH_
+		float cost = linePathLength(f, 1, start, dest);
+		if (cost == numeric_limits<float>::infinity()) {
+			cost  = aStarPathLength(f, 1, start, dest);
+		} else {
+			line = true;
+		}
+#	else
+		float cost  = aStarPathLength(f, 1, start, dest);
+#	endif
+	if (cost == numeric_limits<float>::infinity()) return;
+	Edge *e = new Edge(t2, f, cluster, line);
+	t->edges.push_back(e);
+	e->addWeight(cost);
+	int size = 2;
+	int maxClear = t->clearance > t2->clearance ? t2->clearance : t->clearance;
+	while (size <= maxClear) {
+#		if _USE_LINE_PATH_
+			cost = linePathLength(f, 1, start, dest);
+			if (cost == numeric_limits<float>::infinity()) {
+				cost  = aStarPathLength(f, size, start, dest);
+			}
+#		else
+			float cost  = aStarPathLength(f, size, start, dest);
+#		endif
+		if (cost == numeric_limits<float>::infinity()) {
+			break;
+		}
+		e->addWeight(cost);
+		assert(size == e->maxClear());
+		++size;
+	}
+}
+
 // ========================================================
 // class TransitionNodeStorage
 // ========================================================
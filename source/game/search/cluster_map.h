@@ -43,8 +43,12 @@ private:
 
 	Field f; // for diagnostics... remove this one day
 
+	Vec2i owner;	/**< the cluster whose evaluation made this edge */
+	bool  line;		/**< weights are the line path cost, depend only on the cells between the ends */
+
 public:
-	Edge(const Transition *t, Field f) : f(f) {
+	Edge(const Transition *t, Field f, const Vec2i &owner, bool line)
+			: f(f), owner(owner), line(line) {
 		dest = t;
 		++numEdges[f];
 	}
@@ -57,6 +61,8 @@ public:
 	const Transition* transition() const { return dest; }
 	float cost(int size) const { return weights[size-1]; }
 	int maxClear() { return weights.size(); }
+	const Vec2i& getOwner() const { return owner; }
+	bool isLinePath() const { return line; }
 
 	static int NumEdges(Field f) { return numEdges[f]; }
 	static void zeroCounters();
@@ -183,11 +189,29 @@ private:
 	Cartographer *carto;
 	AnnotatedMap *aMap;
 
+	/** bounds of the cells of a cluster whose metrics have changed since the last update */
+	struct DirtyRect {
+		Vec2i tl, br;
+
+		DirtyRect() {}
+		DirtyRect(const Vec2i &pos) : tl(pos), br(pos) {}
+
+		void add(const Vec2i &pos);
+		bool intersects(const Vec2i &a, const Vec2i &b) const;
+	};
+	typedef map<Vec2i, DirtyRect> DirtyRects;
+
 	set<Vec2i> dirtyClusters;
 	set<Vec2i> dirtyNorthBorders;
 	set<Vec2i> dirtyWestBorders;
+	DirtyRects dirtyCells;
 	bool dirty;
 
+	// per update
+	set<const Transition*> freshTransitions;	/**< made by this update, have no edges yet */
+	vector<Transition*> removedTransitions;		/**< replaced by this update, to be deleted */
+	int edgesRecomputed, edgesReused;
+
 	int eClear[GameConstants::clusterSize];
 
 public:
@@ -233,6 +257,11 @@ public:
 	bool isDirty() const { return dirty; }
 	void update();
 
+	/** number of edges searched for / kept as they were, by the last update() */
+	int getEdgesRecomputed() const	{ return edgesRecomputed; }
+	int getEdgesReused() const		{ return edgesReused; }
+
+	void setCellDirty(const Vec2i &pos);
 	void setClusterDirty(const Vec2i &cluster)		{ dirty = true; dirtyClusters.insert(cluster);		}
 	void setNorthBorderDirty(const Vec2i &cluster)	{ dirty = true; dirtyNorthBorders.insert(cluster);	}
 	void setWestBorderDirty(const Vec2i &cluster)	{ dirty = true; dirtyWestBorders.insert(cluster);	}
@@ -256,11 +285,14 @@ private:
 	}
 
 	void evalCluster(const Vec2i &cluster);
+	void evalEdge(const Vec2i &cluster, Field f, Transition *t, const Transition *t2);
+	bool canReuse(const Vec2i &cluster, const Edge *e, const Transition *t) const;
 
 	float linePathLength(Field f, int size, const Vec2i &start, const Vec2i &dest);
 	float aStarPathLength(Field f, int size, const Vec2i &start, const Vec2i &dest);
 
-	void disconnectCluster(const Vec2i &cluster);
+	void disconnectRemoved(const Vec2i &cluster);
+	void addDirtyCell(const Vec2i &cluster, const Vec2i &pos);
 };
 
 struct TransitionAStarNode {
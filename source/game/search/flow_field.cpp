@@ -0,0 +1,65 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "flow_field.h"
+
+#include <limits>
+
+#include "search_engine.h"
+
+#include "leak_dumper.h"
+
+using std::numeric_limits;
+
+namespace Glest { namespace Search {
+
+// =====================================================
+// 	class FlowField
+// =====================================================
+
+FlowField::FlowField(const Vec2i &dest, const Vec2i &goal, Field field, int size, const Rectangle &region)
+		: m_dest(dest), m_goal(goal), m_field(field), m_size(size)
+		, m_distance(region, numeric_limits<float>::infinity())
+		, m_refCount(0), m_stale(false) {
+	m_distance.clearMap(numeric_limits<float>::infinity());
+}
+
+bool FlowField::isReachable(const Vec2i &pos) const {
+	return getDistance(pos) != numeric_limits<float>::infinity();
+}
+
+bool FlowField::overlaps(const Vec2i &pos, int size) const {
+	const Rectangle r = getRegion();
+	// cells up to m_size - 1 up & left of the obstacle have it in their footprint
+	return pos.x + size > r.x && pos.x - m_size + 1 < r.x + r.w
+		&& pos.y + size > r.y && pos.y - m_size + 1 < r.y + r.h;
+}
+
+int FlowField::getDownhill(const Vec2i &pos, Vec2i out[OrdinalDir::COUNT]) const {
+	const float here = getDistance(pos);
+	float dist[OrdinalDir::COUNT];
+	int n = 0;
+	for (OrdinalDir d(0); d < OrdinalDir::COUNT; ++d) {
+		Vec2i nPos = pos + OrdinalOffsets[d];
+		float nDist = getDistance(nPos);
+		if (nDist >= here) {
+			continue;
+		}
+		// insertion sort, ties stay in direction order
+		int i = n++;
+		while (i > 0 && dist[i - 1] > nDist) {
+			dist[i] = dist[i - 1];
+			out[i] = out[i - 1];
+			--i;
+		}
+		dist[i] = nDist;
+		out[i] = nPos;
+	}
+	return n;
+}
+
+}}
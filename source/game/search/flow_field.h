@@ -0,0 +1,70 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_FLOW_FIELD_H_
+#define _GLEST_GAME_FLOW_FIELD_H_
+
+#include "vec.h"
+#include "simulation_enums.h"
+#include "influence_map.h"
+#include "search_enums.h"
+
+namespace Glest { namespace Search {
+
+using Shared::Math::Vec2i;
+using Glest::Sim::Field;
+
+/** minimum distance from its destination a unit must be to follow a flow field,
+  * closer than this units find their own way, see RoutePlanner::followFlowField() */
+const int flowFieldFollowRange = 6;
+
+/** destinations at most this far apart (on each axis) share a flow field */
+const int flowFieldShareRange = 4;
+
+// =====================================================
+// 	class FlowField
+// =====================================================
+/** The cost of travel to a destination from every cell of a region, for one field
+  * and unit size. Built with a single Dijkstra search out from the destination, then
+  * every unit of a group move walks downhill on it instead of searching for its own
+  * path. Owned by the Cartographer and shared by reference count, see
+  * Cartographer::getFlowField() & Cartographer::releaseFlowField(). */
+class FlowField {
+	friend class Cartographer;
+
+private:
+	Vec2i           m_dest;		/**< the destination the field was built for */
+	Vec2i           m_goal;		/**< where the search started, the nearest free cell to m_dest */
+	Field           m_field;
+	int             m_size;
+	TypeMap<float>  m_distance;	/**< cost to m_goal, infinity if unreachable or outside the region */
+	int             m_refCount;
+	bool            m_stale;	/**< an obstacle has come or gone in the region since it was built */
+
+	FlowField(const Vec2i &dest, const Vec2i &goal, Field field, int size, const Rectangle &region);
+
+public:
+	const Vec2i& getDest() const	{ return m_dest; }
+	const Vec2i& getGoal() const	{ return m_goal; }
+	Field getField() const			{ return m_field; }
+	int   getSize() const			{ return m_size; }
+	Rectangle getRegion() const		{ return m_distance.getBounds(); }
+	bool  isStale() const			{ return m_stale; }
+
+	float getDistance(const Vec2i &pos) const	{ return m_distance.getInfluence(pos); }
+	bool  isReachable(const Vec2i &pos) const;
+
+	/** @return true if an obstacle at pos of size could change what m_size units can occupy here */
+	bool  overlaps(const Vec2i &pos, int size) const;
+
+	/** fill out with the neighbours of pos that are nearer the goal, nearest first
+	  * @return the number of neighbours written, 0 at the goal or if pos is off the field */
+	int   getDownhill(const Vec2i &pos, Vec2i out[OrdinalDir::COUNT]) const;
+};
+
+}}
+
+#endif
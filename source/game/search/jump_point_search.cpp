@@ -0,0 +1,288 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "jump_point_search.h"
+
+#include <algorithm>
+
+#include "annotated_map.h"
+#include "search_engine.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Search {
+
+static inline int sign(int v) {
+	return v > 0 ? 1 : (v < 0 ? -1 : 0);
+}
+
+/** cost of a straight or diagonal run from a to b */
+static inline float runCost(const Vec2i &a, const Vec2i &b) {
+	const int dx = abs(a.x - b.x), dy = abs(a.y - b.y);
+	const int diag = std::min(dx, dy);
+	return diag * SQRT2 + float(std::max(dx, dy) - diag);
+}
+
+// =====================================================
+// 	class JumpPointSearch
+// =====================================================
+
+/** ordering for the std heap functions, the entry to expand next is the 'greatest':
+  * lowest estimate, then nearest the goal, then first pushed */
+bool JumpPointSearch::OpenEntry::operator<(const OpenEntry &that) const {
+	if (est != that.est) {
+		return est > that.est;
+	}
+	if (heuristic != that.heuristic) {
+		return heuristic > that.heuristic;
+	}
+	return seq > that.seq;
+}
+
+JumpPointSearch::JumpPointSearch(int width, int height)
+		: m_width(width), m_height(height)
+		, m_marker(width * height, 0)
+		, m_nodeIndex(width * height, -1)
+		, m_counter(0)
+		, m_pushed(0)
+		, m_nodeLimit(-1)
+		, m_expanded(0)
+		, m_goalNode(-1)
+		, m_aMap(0), m_field(Field::LAND), m_size(1) {
+}
+
+bool JumpPointSearch::isOpenCell(int x, int y) const {
+	return x >= 0 && y >= 0 && x < m_width && y < m_height
+		&& m_aMap->canOccupy(Vec2i(x, y), m_size, m_field);
+}
+
+/** walk from pos (an open cell) in straight direction dir until reaching the
+  * destination, a cell with a forced neighbour, or an obstacle */
+bool JumpPointSearch::jumpStraight(Vec2i pos, const Vec2i &dir, Vec2i &jumpPoint) const {
+	while (true) {
+		if (pos == m_dest) {
+			jumpPoint = pos;
+			return true;
+		}
+		if (dir.x) {
+			if ((isOpenCell(pos.x, pos.y - 1) && !isOpenCell(pos.x - dir.x, pos.y - 1))
+			|| (isOpenCell(pos.x, pos.y + 1) && !isOpenCell(pos.x - dir.x, pos.y + 1))) {
+				jumpPoint = pos;
+				return true;
+			}
+		} else {
+			if ((isOpenCell(pos.x - 1, pos.y) && !isOpenCell(pos.x - 1, pos.y - dir.y))
+			|| (isOpenCell(pos.x + 1, pos.y) && !isOpenCell(pos.x + 1, pos.y - dir.y))) {
+				jumpPoint = pos;
+				return true;
+			}
+		}
+		pos += dir;
+		if (!isOpenCell(pos)) {
+			return false;
+		}
+	}
+}
+
+/** walk from pos (an open cell) in diagonal direction dir until reaching the
+  * destination, a cell a straight jump from which finds a jump point, or an obstacle */
+bool JumpPointSearch::jumpDiagonal(Vec2i pos, const Vec2i &dir, Vec2i &jumpPoint) const {
+	const Vec2i dirX(dir.x, 0), dirY(0, dir.y);
+	Vec2i junk;
+	while (true) {
+		if (pos == m_dest) {
+			jumpPoint = pos;
+			return true;
+		}
+		const bool openX = isOpenCell(pos + dirX);
+		const bool openY = isOpenCell(pos + dirY);
+		if ((openX && jumpStraight(pos + dirX, dirX, junk))
+		|| (openY && jumpStraight(pos + dirY, dirY, junk))) {
+			jumpPoint = pos;
+			return true;
+		}
+		if (!openX || !openY || !isOpenCell(pos + dir)) {
+			return false;
+		}
+		pos += dir;
+	}
+}
+
+/** find the next jump point from 'from' in direction dir, if any */
+bool JumpPointSearch::jump(const Vec2i &from, const Vec2i &dir, Vec2i &jumpPoint) const {
+	const Vec2i next = from + dir;
+	if (!isOpenCell(next)) {
+		return false;
+	}
+	if (dir.x && dir.y) {
+		if (!isOpenCell(from.x + dir.x, from.y) || !isOpenCell(from.x, from.y + dir.y)) {
+			return false; // corner
+		}
+		return jumpDiagonal(next, dir, jumpPoint);
+	}
+	return jumpStraight(next, dir, jumpPoint);
+}
+
+/** directions to look for successors of node in, all eight from the start, else
+  * those a path arriving from node's parent could need to go next */
+int JumpPointSearch::getDirections(const Node &node, Vec2i *dirs) const {
+	if (node.parent == -1) {
+		for (int i = 0; i < OrdinalDir::COUNT; ++i) {
+			dirs[i] = OrdinalOffsets[i];
+		}
+		return OrdinalDir::COUNT;
+	}
+	const Vec2i &pos = node.pos;
+	const Vec2i &from = m_nodes[node.parent].pos;
+	const int dx = sign(pos.x - from.x), dy = sign(pos.y - from.y);
+	int n = 0;
+	if (dx && dy) {
+		dirs[n++] = Vec2i(dx, dy);
+		dirs[n++] = Vec2i(dx, 0);
+		dirs[n++] = Vec2i(0, dy);
+	} else if (dx) {
+		dirs[n++] = Vec2i(dx, 0);
+		for (int side = -1; side <= 1; side += 2) {
+			if (isOpenCell(pos.x, pos.y + side)) {
+				dirs[n++] = Vec2i(dx, side);
+				dirs[n++] = Vec2i(0, side);
+			}
+		}
+	} else {
+		dirs[n++] = Vec2i(0, dy);
+		for (int side = -1; side <= 1; side += 2) {
+			if (isOpenCell(pos.x + side, pos.y)) {
+				dirs[n++] = Vec2i(side, dy);
+				dirs[n++] = Vec2i(side, 0);
+			}
+		}
+	}
+	return n;
+}
+
+void JumpPointSearch::push(int node) {
+	OpenEntry entry;
+	entry.node = node;
+	entry.cost = m_nodes[node].cost;
+	entry.heuristic = DiagonalDistance(m_dest)(m_nodes[node].pos);
+	entry.est = entry.cost + entry.heuristic;
+	entry.seq = m_pushed++;
+	m_open.push_back(entry);
+	std::push_heap(m_open.begin(), m_open.end());
+}
+
+/** open pos from node 'from', or update it if this is a cheaper way there
+  * @return false if the node limit has been reached */
+bool JumpPointSearch::addSuccessor(int from, const Vec2i &pos) {
+	const int ndx = pos.y * m_width + pos.x;
+	const float cost = m_nodes[from].cost + runCost(m_nodes[from].pos, pos);
+	if (m_marker[ndx] == m_counter + 1) {
+		return true; // closed
+	}
+	if (m_marker[ndx] == m_counter) {
+		Node &node = m_nodes[m_nodeIndex[ndx]];
+		if (cost < node.cost) {
+			node.cost = cost;
+			node.parent = from;
+			push(m_nodeIndex[ndx]);
+		}
+		return true;
+	}
+	if (m_nodeLimit > 0 && int(m_nodes.size()) >= m_nodeLimit) {
+		return false;
+	}
+	Node node;
+	node.pos = pos;
+	node.parent = from;
+	node.cost = cost;
+	m_nodes.push_back(node);
+	m_marker[ndx] = m_counter;
+	m_nodeIndex[ndx] = m_nodes.size() - 1;
+	push(m_nodes.size() - 1);
+	return true;
+}
+
+AStarResult JumpPointSearch::search(const AnnotatedMap *aMap, Field field, int size,
+		const Vec2i &start, const Vec2i &dest) {
+	m_aMap = aMap;
+	m_field = field;
+	m_size = size;
+	m_dest = dest;
+	m_nodes.clear();
+	m_open.clear();
+	m_pushed = 0;
+	m_expanded = 0;
+	m_goalNode = -1;
+	if (m_counter >= 0xFFFFFFFD) {
+		std::fill(m_marker.begin(), m_marker.end(), 0);
+		m_counter = 0;
+	}
+	m_counter += 2;
+
+	Node startNode;
+	startNode.pos = start;
+	startNode.parent = -1;
+	startNode.cost = 0.f;
+	m_nodes.push_back(startNode);
+	m_marker[start.y * m_width + start.x] = m_counter;
+	m_nodeIndex[start.y * m_width + start.x] = 0;
+	push(0);
+
+	Vec2i dirs[OrdinalDir::COUNT];
+	while (!m_open.empty()) {
+		std::pop_heap(m_open.begin(), m_open.end());
+		const OpenEntry entry = m_open.back();
+		m_open.pop_back();
+		const Vec2i pos = m_nodes[entry.node].pos;
+		uint32 &marker = m_marker[pos.y * m_width + pos.x];
+		if (marker == m_counter + 1 || entry.cost > m_nodes[entry.node].cost) {
+			continue; // closed already, or a stale entry
+		}
+		marker = m_counter + 1;
+		if (pos == dest) {
+			m_goalNode = entry.node;
+			return AStarResult::COMPLETE;
+		}
+		++m_expanded;
+		const int n = getDirections(m_nodes[entry.node], dirs);
+		for (int i = 0; i < n; ++i) {
+			Vec2i jumpPoint;
+			if (jump(pos, dirs[i], jumpPoint) && !addSuccessor(entry.node, jumpPoint)) {
+				return AStarResult::NODE_LIMIT;
+			}
+		}
+	}
+	return AStarResult::FAILURE;
+}
+
+float JumpPointSearch::getCost() const {
+	assert(m_goalNode != -1);
+	return m_nodes[m_goalNode].cost;
+}
+
+void JumpPointSearch::getPath(list<Vec2i> &path) const {
+	assert(m_goalNode != -1);
+	path.clear();
+	// jump points, goal first
+	vector<Vec2i> jumpPoints;
+	for (int n = m_goalNode; n != -1; n = m_nodes[n].parent) {
+		jumpPoints.push_back(m_nodes[n].pos);
+	}
+	// fill in the cells between, each run is straight or diagonal
+	Vec2i pos = jumpPoints.back();
+	path.push_back(pos);
+	for (int i = int(jumpPoints.size()) - 2; i >= 0; --i) {
+		const Vec2i &next = jumpPoints[i];
+		const Vec2i step(sign(next.x - pos.x), sign(next.y - pos.y));
+		while (pos != next) {
+			pos += step;
+			path.push_back(pos);
+		}
+	}
+}
+
+}}
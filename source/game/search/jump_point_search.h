@@ -0,0 +1,106 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_JUMP_POINT_SEARCH_H_
+#define _GLEST_GAME_JUMP_POINT_SEARCH_H_
+
+#include <vector>
+#include <list>
+
+#include "vec.h"
+#include "simulation_enums.h"
+#include "search_enums.h"
+
+namespace Glest { namespace Search {
+
+using std::vector;
+using std::list;
+using Shared::Math::Vec2i;
+using Shared::Platform::uint32;
+using Glest::Sim::Field;
+
+class AnnotatedMap;
+
+// =====================================================
+// 	class JumpPointSearch
+// =====================================================
+/** Jump Point Search on the cell map, an alternative to SearchEngine<NodePool> for
+  * low level searches to a single position. Runs of cells that an optimal path would
+  * cross without turning are skipped in one go, only cells where a path may need to
+  * change direction (jump points) go on the open list, so open ground costs a handful
+  * of nodes instead of hundreds.
+  *
+  * A cell is open to a unit if AnnotatedMap::canOccupy() says the unit fits there. A
+  * diagonal step needs both cells beside it open too, this is the same as the corner
+  * check in MoveCost (see getDiags()) when the start & end of the step are open, so
+  * paths are the same cost as those SearchEngine finds with MoveCost & PosGoal. */
+class JumpPointSearch {
+private:
+	struct Node {
+		Vec2i  pos;
+		int    parent;	/**< index of the node the best path to here is from, -1 for the start */
+		float  cost;	/**< cost from the start */
+	};
+
+	struct OpenEntry {
+		float  est;		/**< cost + heuristic */
+		float  heuristic;
+		int    seq;		/**< order pushed, breaks remaining ties */
+		int    node;
+		float  cost;	/**< node's cost when pushed, stale entries are skipped */
+
+		bool operator<(const OpenEntry &that) const;
+	};
+
+	int             m_width, m_height;
+	vector<uint32>  m_marker;		/**< per cell, == m_counter: open, == m_counter + 1: closed */
+	vector<int>     m_nodeIndex;	/**< per cell, index into m_nodes (if marked) */
+	uint32          m_counter;
+	vector<Node>    m_nodes;
+	vector<OpenEntry> m_open;		/**< heap */
+	int             m_pushed;		/**< entries pushed on m_open this search */
+	int             m_nodeLimit;
+	int             m_expanded;
+	int             m_goalNode;
+
+	// the current search
+	const AnnotatedMap *m_aMap;
+	Field           m_field;
+	int             m_size;
+	Vec2i           m_dest;
+
+	bool  isOpenCell(int x, int y) const;
+	bool  isOpenCell(const Vec2i &pos) const { return isOpenCell(pos.x, pos.y); }
+	bool  jumpStraight(Vec2i pos, const Vec2i &dir, Vec2i &jumpPoint) const;
+	bool  jumpDiagonal(Vec2i pos, const Vec2i &dir, Vec2i &jumpPoint) const;
+	bool  jump(const Vec2i &from, const Vec2i &dir, Vec2i &jumpPoint) const;
+	int   getDirections(const Node &node, Vec2i *dirs) const;
+	bool  addSuccessor(int from, const Vec2i &pos);
+	void  push(int node);
+
+public:
+	JumpPointSearch(int width, int height);
+
+	/** limit the number of jump points a search may open, <= 0 for no limit */
+	void setNodeLimit(int limit) { m_nodeLimit = limit; }
+
+	/** search for a path from start to dest for a unit of size in field, on aMap
+	  * @return COMPLETE, FAILURE (no path) or NODE_LIMIT (gave up) */
+	AStarResult search(const AnnotatedMap *aMap, Field field, int size, const Vec2i &start, const Vec2i &dest);
+
+	/** number of jump points expanded by the last search */
+	int getExpandedLastRun() const { return m_expanded; }
+
+	/** cost of the path found by the last (COMPLETE) search */
+	float getCost() const;
+
+	/** the path found by the last (COMPLETE) search, every cell from start to dest inclusive */
+	void getPath(list<Vec2i> &path) const;
+};
+
+}}
+
+#endif
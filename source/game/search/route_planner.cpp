@@ -29,6 +29,7 @@
 #include "unit_type.h"
 #include "sim_interface.h"
 #include "debug_stats.h"
+#include "worker_pool.h"
 
 #include "leak_dumper.h"
 
@@ -41,6 +42,8 @@
 
 using namespace Shared::Graphics;
 using namespace Shared::Util;
+using Shared::Platform::WorkerPool;
+using Shared::Platform::RangeTask;
 
 using std::cout;
 using std::endl;
@@ -95,13 +98,22 @@ namespace Glest { namespace Search {
 
 // ===================== PUBLIC ========================
 
+/** id of the command a path is wanted for, -1 if none */
+static int commandIdOf(const Unit *unit) {
+	return unit->anyCommand() ? unit->getCurrCommand()->getId() : -1;
+}
+
 /** Construct RoutePlanner object */
 RoutePlanner::RoutePlanner(World *world)
 		: world(world)
 		, nsgSearchEngine(NULL)
 		, nodeStore(NULL)
 		, tSearchEngine(NULL)
-		, tNodeStore(NULL) {
+		, tNodeStore(NULL)
+		, m_jumpPoints(NULL)
+		, m_nodesExpanded(0)
+		, m_sharedAnnotations(false)
+		, m_startBlocked(false) {
 	//g_logger.logProgramEvent( "Initialising SearchEngine", true );
 
 	const int &w = world->getMap()->getW();
@@ -120,12 +132,19 @@ RoutePlanner::RoutePlanner(World *world)
 	TransitionNeighbours tNeighbours;
 	tSearchEngine = new TransitionSearchEngine(tNeighbours, tNodeStore, true);
 	tSearchEngine->setInvalidKey(NULL);
+
+	if (g_simInterface.getGameSettings().getJumpPointSearch()) {
+		m_jumpPoints = new JumpPointSearch(w, h);
+		m_jumpPoints->setNodeLimit(jumpPointNodeLimit);
+	}
 }
 
 /** delete SearchEngine objects */
 RoutePlanner::~RoutePlanner() {
 	delete nsgSearchEngine;
 	delete tSearchEngine;
+	delete m_jumpPoints;
+	deleteValues(m_searchers.begin(), m_searchers.end());
 }
 
 /** Determine legality of a proposed move for a unit. This function is the absolute last say
@@ -193,6 +212,7 @@ float RoutePlanner::quickSearch(Field field, int size, const Vec2i &start, const
 
 	PosGoal goal(dest);
 	AStarResult r = nsgSearchEngine->aStar(goal, moveCost, heuristic);
+	m_nodesExpanded += nsgSearchEngine->getExpandedLastRun();
 	if (r == AStarResult::COMPLETE && nsgSearchEngine->getGoalPos() == dest) {
 		return nsgSearchEngine->getCostTo(dest);
 	}
@@ -214,7 +234,9 @@ HAAStarResult RoutePlanner::setupHierarchicalOpenList(Unit *unit, const Vec2i &t
 	// if successful add transition to open list
 
 	AnnotatedMap *aMap = world->getCartographer()->getMasterMap();
-	aMap->annotateLocal(unit);
+	if (!m_sharedAnnotations) {
+		aMap->annotateLocal(unit);
+	}
 	for (Transitions::iterator it = transitions.begin(); it != transitions.end(); ++it) {
 		float cost = quickSearch(unit->getCurrField(), unit->getSize(), unit->getPos(), (*it)->nwPos);
 		if (cost != numeric_limits<float>::infinity()) {
@@ -222,7 +244,14 @@ HAAStarResult RoutePlanner::setupHierarchicalOpenList(Unit *unit, const Vec2i &t
 			startTrap = false;
 		}
 	}
-	aMap->clearLocalAnnotations(unit);
+	if (!m_sharedAnnotations) {
+		aMap->clearLocalAnnotations(unit);
+	} else if (startTrap) {
+		// the annotations belong to the whole batch and can't be lifted to look
+		// for a way out, runBatch() searches again for this unit on its own
+		m_startBlocked = true;
+		return HAAStarResult::FAILURE;
+	}
 	if (startTrap) {
 		// do again, without annnotations, return TRAPPED if all else goes well
 		bool locked = true;
@@ -286,6 +315,7 @@ HAAStarResult RoutePlanner::findWaypointPath(Unit *unit, const Vec2i &dest, Wayp
 	TransitionCost cost(unit->getCurrField(), unit->getSize());
 	TransitionHeuristic heuristic(dest);
 	AStarResult res = tSearchEngine->aStar(goal,cost,heuristic);
+	m_nodesExpanded += tSearchEngine->getExpandedLastRun();
 	if (res == AStarResult::COMPLETE) {
 		WaypointPath &wpPath = *unit->getWaypointPath();
 		wpPath.clear();
@@ -377,6 +407,7 @@ HAAStarResult RoutePlanner::findWaypointPathUnExplored(Unit *unit, const Vec2i &
 	UnexploredCost cost(unit->getCurrField(), unit->getSize(), unit->getTeam());
 	TransitionHeuristic heuristic(dest);
 	tSearchEngine->aStar(goal, cost, heuristic);
+	m_nodesExpanded += tSearchEngine->getExpandedLastRun();
 	const Transition *t = goal.getBestSeen(unit->getPos(), dest);
 	if (!t) {
 		return HAAStarResult::FAILURE;
@@ -404,12 +435,26 @@ bool RoutePlanner::refinePath(Unit *unit) {
 	const Vec2i &destPos = wpPath.front();
 	AnnotatedMap *aMap = world->getCartographer()->getAnnotatedMap(unit);
 
+	if (m_jumpPoints) {
+		AStarResult res = m_jumpPoints->search(aMap, unit->getCurrField(), unit->getSize(), startPos, destPos);
+		m_nodesExpanded += m_jumpPoints->getExpandedLastRun();
+		if (res != AStarResult::COMPLETE) {
+			return false;
+		}
+		list<Vec2i> cells;
+		m_jumpPoints->getPath(cells);
+		// skip start point (already on path or is start pos)
+		path.insert(path.end(), ++cells.begin(), cells.end());
+		wpPath.pop();
+		return true;
+	}
 	MoveCost cost(unit, aMap);
 	DiagonalDistance dd(destPos);
 	PosGoal posGoal(destPos);
 
 	nsgSearchEngine->setStart(startPos, dd(startPos));
 	AStarResult res = nsgSearchEngine->aStar(posGoal, cost, dd);
+	m_nodesExpanded += nsgSearchEngine->getExpandedLastRun();
 	if (res != AStarResult::COMPLETE) {
 		return false;
 	}
@@ -553,36 +598,33 @@ TravelState RoutePlanner::doRouteCache(Unit *unit) {
 	return TravelState::BLOCKED;
 }
 
-TravelState RoutePlanner::doQuickPathSearch(Unit *unit, const Vec2i &target) {
-	SECTION_TIMER(PATHFINDER_LOWLEVEL);
-	_PROFILE_PATHFINDER();
-	AnnotatedMap *aMap = world->getCartographer()->getAnnotatedMap(unit);
+/** Low level search from the unit's position to target, with the JumpPointSearch if
+  * the game uses it, else A*. The path found, start included, goes on the front of
+  * the unit's path. @return true if a path was found */
+bool RoutePlanner::lowLevelSearch(Unit *unit, const Vec2i &target) {
 	UnitPath &path = *unit->getPath();
-	IF_DEBUG_EDITION( clearOpenClosed(unit->getPos(), target); )
-	aMap->annotateLocal(unit);
-	float cost = quickSearch(unit->getCurrField(), unit->getSize(), unit->getPos(), target);
-	aMap->clearLocalAnnotations(unit);
-	IF_DEBUG_EDITION( collectOpenClosed<NodePool>(nodeStore); )
-	if (cost != numeric_limits<float>::infinity()) {
-		Vec2i pos = nsgSearchEngine->getGoalPos();
-		while (pos.x != -1) {
-			path.push_front(pos);
-			pos = nsgSearchEngine->getPreviousPos(pos);
-		}
-		if (path.size() > 1) {
-			path.pop();
-			if (attemptMove(unit)) {
-				IF_DEBUG_EDITION( collectPath(unit); )
-				PF_LOG( "doQuickPathSearch() ok. moving from " << unit->getPos() << " to " << unit->getNextPos() );
-				PF_PATH_LOG( unit );
-				return TravelState::MOVING;
-			}
+	if (m_jumpPoints) {
+		AnnotatedMap *aMap = world->getCartographer()->getAnnotatedMap(unit);
+		AStarResult res = m_jumpPoints->search(aMap, unit->getCurrField(), unit->getSize(), unit->getPos(), target);
+		m_nodesExpanded += m_jumpPoints->getExpandedLastRun();
+		if (res != AStarResult::COMPLETE) {
+			return false;
 		}
-		PF_LOG( "doQuickPathSearch() search success, but path invalid. clearing path." );
-		unit->clearPath();
+		list<Vec2i> cells;
+		m_jumpPoints->getPath(cells);
+		path.insert(path.begin(), cells.begin(), cells.end());
+		return true;
 	}
-	PF_LOG( "doQuickPathSearch() failed." );
-	return TravelState::BLOCKED;
+	if (quickSearch(unit->getCurrField(), unit->getSize(), unit->getPos(), target)
+			== numeric_limits<float>::infinity()) {
+		return false;
+	}
+	Vec2i pos = nsgSearchEngine->getGoalPos();
+	while (pos.x != -1) {
+		path.push_front(pos);
+		pos = nsgSearchEngine->getPreviousPos(pos);
+	}
+	return true;
 }
 
 TravelState RoutePlanner::findAerialPath(Unit *unit, const Vec2i &targetPos) {
@@ -622,10 +664,12 @@ TravelState RoutePlanner::findAerialPath(Unit *unit, const Vec2i &targetPos) {
 	return TravelState::BLOCKED;
 }
 
-/** Find a path to a location.
+/** Find a path to a location. Units on a group move walk a shared flow field while
+  * they are far from the destination, see followFlowField(). If the unit needs a new
+  * path and there is a node budget the search is queued, see processRequests(), and the unit is told to wait.
   * @param unit the unit requesting the path
   * @param finalPos the position the unit desires to go to
-  * @return ARRIVED, MOVING, BLOCKED or IMPOSSIBLE
+  * @return ARRIVED, MOVING, BLOCKED, IMPOSSIBLE or PENDING
   */
 TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos) {
 	SECTION_TIMER(PATHFINDER_TOTAL);
@@ -648,6 +692,36 @@ TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos)
 		PF_PATH_LOG( unit );
 		return TravelState::ARRIVED;
 	}
+	// queued request
+	RequestIndex::iterator qit = m_requestIndex.find(unit->getId());
+	if (qit != m_requestIndex.end()) {
+		if (qit->second->dest == finalPos && qit->second->commandId == commandIdOf(unit)) {
+			return TravelState::PENDING;
+		}
+		PF_LOG( "Destination changed, dropping queued request." );
+		m_requests.erase(qit->second);
+		m_requestIndex.erase(qit);
+	}
+	PathResults::iterator rit = m_results.find(unit->getId());
+	if (rit != m_results.end()) {
+		PathResult result = rit->second;
+		m_results.erase(rit);
+		if (result.dest == finalPos && result.commandId == commandIdOf(unit)) {
+			if (result.state == TravelState::IMPOSSIBLE && unit->getFaction()->isThisFaction()) {
+				g_console.addLine(g_lang.get("DestinationUnreachable"));
+			}
+			PF_LOG( "Queued request result: " << TravelStateNames[result.state] );
+			return result.state;
+		}
+	}
+	// group move
+	const Command *cmd = unit->anyCommand() ? unit->getCurrCommand() : 0;
+	if (cmd && cmd->isGroupMove() && cmd->getPos() == finalPos && unit->getCurrField() != Field::AIR) {
+		TravelState result;
+		if (followFlowField(unit, finalPos, result)) {
+			return result;
+		}
+	}
 	// route cache
 	if (!path.empty()) {
 		if (doRouteCache(unit) == TravelState::MOVING) {
@@ -674,82 +748,306 @@ TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos)
 	if (unit->getCurrField() == Field::AIR) {
 		return findAerialPath(unit, target);
 	}
+	return queueRequest(unit, finalPos, target);
+}
+
+/** Move a unit on a group move a step down its flow field, getting the field first
+  * if need be. Units go back to their own paths when near their destination, when
+  * blocked for too long or when the field can't get them there.
+  * @return false if the unit should path as normal, else true with result set */
+bool RoutePlanner::followFlowField(Unit *unit, const Vec2i &finalPos, TravelState &result) {
+	const int cmdId = commandIdOf(unit);
+	UnitPath &path = *unit->getPath();
+	FlowFollowers::iterator it = m_flowFollowers.find(unit->getId());
+	if (it != m_flowFollowers.end() && (it->second.commandId != cmdId
+	|| (it->second.field && it->second.field->isStale()))) {
+		PF_LOG( "New command or flow field stale." );
+		releaseFollower(it->second);
+		m_flowFollowers.erase(it);
+		it = m_flowFollowers.end();
+	}
+	if (it == m_flowFollowers.end()) {
+		FlowField *field = 0;
+		if (unit->getPos().dist(finalPos) >= flowFieldFollowRange) {
+			Vec2i goal = computeNearestFreePos(unit, finalPos);
+			field = world->getCartographer()->getFlowField(finalPos, goal, unit->getPos(),
+				unit->getCurrField(), unit->getSize());
+			if (field) {
+				unit->clearPath();
+			}
+		}
+		it = m_flowFollowers.insert(std::make_pair(unit->getId(), FlowFollower(field, cmdId))).first;
+	}
+	FlowFollower &follower = it->second;
+	if (!follower.field) {
+		return false; // finished with it, or couldn't get one
+	}
+	if (unit->getPos().dist(finalPos) < flowFieldFollowRange) {
+		PF_LOG( "Near destination, leaving flow field." );
+		releaseFollower(follower);
+		unit->clearPath();
+		return false;
+	}
+	Vec2i downhill[OrdinalDir::COUNT];
+	const int n = follower.field->getDownhill(unit->getPos(), downhill);
+	if (!n || path.isBlocked()) {
+		PF_LOG( "Leaving flow field, " << (n ? "blocked." : "at goal or off field.") );
+		releaseFollower(follower);
+		unit->clearPath();
+		return false;
+	}
+	for (int i = 0; i < n; ++i) {
+		if (isLegalMove(unit, downhill[i])) {
+			unit->setNextPos(downhill[i]);
+			path.resetBlockCount();
+			PF_LOG( "Flow field, moving from " << unit->getPos() << " to " << unit->getNextPos() );
+			result = TravelState::MOVING;
+			return true;
+		}
+	}
+	path.incBlockCount();
+	result = TravelState::BLOCKED;
+	return true;
+}
+
+/** drop a follower's flow field, it will path as normal for the rest of the command */
+void RoutePlanner::releaseFollower(FlowFollower &follower) {
+	if (follower.field) {
+		world->getCartographer()->releaseFlowField(follower.field);
+		follower.field = 0;
+	}
+}
+
+TravelState RoutePlanner::queueRequest(Unit *unit, const Vec2i &dest, const Vec2i &target) {
+	PathRequest req;
+	req.unitId = unit->getId();
+	req.commandId = commandIdOf(unit);
+	req.dest = dest;
+	req.target = target;
+	req.field = unit->getCurrField();
+	req.frame = world->getFrameCount();
+	req.micros = Chrono::getCurMicros();
+	m_requestIndex[req.unitId] = m_requests.insert(m_requests.end(), req);
+	PF_LOG( "Queued path request, queue depth " << m_requests.size() );
+	return TravelState::PENDING;
+}
+
+/** The searching part of findPathToLocation(), run by the searchers for queued
+  * requests, and by runBatch() for a unit boxed in by the batch annotations. The
+  * master map has already been annotated around the unit.
+  * @return MOVING if the unit has been given a path, else BLOCKED or IMPOSSIBLE */
+TravelState RoutePlanner::searchPath(Unit *unit, const Vec2i &target) {
+	m_nodesExpanded = 0;
+	m_startBlocked = false;
+	UnitPath &path = *unit->getPath();
+	WaypointPath &wpPath = *unit->getWaypointPath();
 
 	// QuickSearch if close to target
 	Vec2i startCluster = ClusterMap::cellToCluster(unit->getPos());
 	Vec2i destCluster  = ClusterMap::cellToCluster(target);
 	if (startCluster.dist(destCluster) < 3.f) {
-		if (doQuickPathSearch(unit, target) == TravelState::MOVING) {
-			return TravelState::MOVING;
+		if (lowLevelSearch(unit, target)) {
+			if (path.size() > 1) {
+				path.pop();
+				return TravelState::MOVING;
+			}
+			unit->clearPath();
 		}
 	}
-	PF_LOG( "Performing hierarchical search." );
 
 	// Hierarchical Search
 	tSearchEngine->reset();
 	HAAStarResult res;
-	// Hierarchical Search
-	tSearchEngine->reset();
-
-	RUNTIME_CHECK(world->getMap()->isInside(target));
-
 	if (unit->getTeam() == -1 || g_map.getTile(Map::toTileCoords(target))->isExplored(unit->getTeam())) {
 		res = findWaypointPath(unit, target, wpPath);
 	} else {
 		res = findWaypointPathUnExplored(unit, target, wpPath);
 	}
 	if (res == HAAStarResult::FAILURE) {
-		if (unit->getFaction()->isThisFaction()) {
-			g_console.addLine(g_lang.get("DestinationUnreachable"));
-		}
-		PF_LOG( "Route not possible." );
-		return TravelState::IMPOSSIBLE;
-	} else if (res == HAAStarResult::START_TRAP) {
-		PF_UNIT_LOG( unit, "START_TRAP." );
-		if (wpPath.size() < 2) {
-			PF_LOG( "Only one waypoint, blocked." );
-			PF_PATH_LOG( unit );
-			return TravelState::BLOCKED;
-		}
+		return m_startBlocked ? TravelState::BLOCKED : TravelState::IMPOSSIBLE;
+	} else if (res == HAAStarResult::START_TRAP && wpPath.size() < 2) {
+		return TravelState::BLOCKED;
+	}
+	if (!m_sharedAnnotations) {
+		// the hierarchical setup lifted them
+		world->getCartographer()->getMasterMap()->annotateLocal(unit);
 	}
-
-	IF_DEBUG_EDITION( collectWaypointPath(unit); )
-	//CONSOLE_LOG( "WaypointPath size : " + intToStr(wpPath.size()) )
-
-	RUNTIME_CHECK(!wpPath.empty());
-	IF_DEBUG_EDITION( clearOpenClosed(unit->getPos(), target); )
-	// refine path, to at least 20 steps (or end of path)
-	AnnotatedMap *aMap = world->getCartographer()->getMasterMap();
-	aMap->annotateLocal(unit);
 	wpPath.condense();
 	while (!wpPath.empty() && path.size() < minPathRefinement) {
 		if (!refinePath(unit)) {
-			PF_LOG( "refinePath failed." );
-			PF_PATH_LOG( unit );
-			aMap->clearLocalAnnotations(unit);
 			path.incBlockCount();
-			//CONSOLE_LOG( "   blockCount = " + intToStr(path.getBlockCount()) )
 			return TravelState::BLOCKED;
 		}
 	}
 	smoothPath(unit);
-	aMap->clearLocalAnnotations(unit);
-	IF_DEBUG_EDITION( collectPath(unit); )
-	if (path.empty()) {
-		PF_LOG( "post hierarchical search failure, path empty." );
-		PF_PATH_LOG( unit );
-		return TravelState::BLOCKED;
+	return path.empty() ? TravelState::BLOCKED : TravelState::MOVING;
+}
+
+// =====================================================
+// 	class PathSearchTask
+// =====================================================
+/** Runs the searches for a batch of queued requests, searcher s takes requests
+  * s, s + searcherCount, s + 2 * searcherCount ... */
+class PathSearchTask : public RangeTask {
+	RoutePlanner::RequestBatch &m_batch;
+	vector<RoutePlanner*>      &m_searchers;
+	int                         m_searcherCount;
+	vector<TravelState>        &m_results;
+	vector<int>                &m_nodes;
+	vector<char>               &m_trapped;
+
+public:
+	PathSearchTask(RoutePlanner::RequestBatch &batch, vector<RoutePlanner*> &searchers, int searcherCount,
+			vector<TravelState> &results, vector<int> &nodes, vector<char> &trapped)
+			: m_batch(batch), m_searchers(searchers), m_searcherCount(searcherCount)
+			, m_results(results), m_nodes(nodes), m_trapped(trapped) {}
+
+	virtual void execute(int begin, int end) {
+		for (int s = begin; s < end; ++s) {
+			RoutePlanner *searcher = m_searchers[s];
+			for (int i = s; i < m_batch.size(); i += m_searcherCount) {
+				m_results[i] = searcher->searchPath(m_batch[i].second, m_batch[i].first.target);
+				m_nodes[i] = searcher->m_nodesExpanded;
+				m_trapped[i] = searcher->m_startBlocked;
+			}
+		}
 	}
-	if (attemptMove(unit)) {
-		PF_LOG( "moving from " << unit->getPos() << " to " << unit->getNextPos() );
-		PF_PATH_LOG( unit );
-		return TravelState::MOVING;
+};
+
+/** Per frame upkeep, called once per world frame before the units are updated. Lets go
+  * of the flow fields of units that have died or moved on to other commands, then
+  * services queued path requests. */
+void RoutePlanner::update() {
+	FlowFollowers::iterator it = m_flowFollowers.begin();
+	while (it != m_flowFollowers.end()) {
+		Unit *unit = world->findUnitById(it->first);
+		if (!unit || !unit->isAlive() || commandIdOf(unit) != it->second.commandId) {
+			releaseFollower(it->second);
+			m_flowFollowers.erase(it++);
+		} else {
+			++it;
+		}
+	}
+	processRequests();
+}
+
+/** Service queued path requests, called once per world frame before the units are
+  * updated. Requests are taken oldest first, in batches of up to pathRequestBatchSize
+  * whose units are far enough apart that the local annotations for one can't touch
+  * another. The master map is annotated for the whole batch, the searches are spread
+  * over the world's worker pool, each searcher with its own node pools, then the
+  * annotations are cleared and the results handed out. Units the batch annotations
+  * boxed in are searched for again one at a time, so they can look for a way out
+  * without annotations as an unqueued search would. Batches don't depend on the
+  * number of threads, so neither do the paths found. Batches are run until the frame's
+  * node budget is spent, at least one is run each frame so the queue always drains. */
+void RoutePlanner::processRequests() {
+	// forget results for units that died before collecting them
+	PathResults::iterator rit = m_results.begin();
+	while (rit != m_results.end()) {
+		Unit *unit = world->findUnitById(rit->first);
+		if (!unit || !unit->isAlive()) {
+			m_results.erase(rit++);
+		} else {
+			++rit;
+		}
+	}
+	int nodes = 0, serviced = 0;
+	RequestBatch batch;
+	while (!m_requests.empty() && nodes < pathNodeBudget) {
+		selectBatch(batch);
+		if (batch.empty()) {
+			break;
+		}
+		nodes += runBatch(batch);
+		serviced += batch.size();
+	}
+	g_debugStats->setPathQueueStats(m_requests.size(), serviced, nodes);
+}
+
+/** take the next batch of requests off the queue, dropping any that are no longer wanted */
+void RoutePlanner::selectBatch(RequestBatch &batch) {
+	batch.clear();
+	vector<Rect2i> windows;
+	const int r = AnnotatedMap::localAnnotationRadius;
+	Requests::iterator it = m_requests.begin();
+	while (it != m_requests.end() && batch.size() < pathRequestBatchSize) {
+		Unit *unit = world->findUnitById(it->unitId);
+		if (!unit || !unit->isAlive() || unit->isCarried() || unit->isGarrisoned()
+		|| commandIdOf(unit) != it->commandId || unit->getCurrField() != it->field) {
+			m_requestIndex.erase(it->unitId);
+			it = m_requests.erase(it);
+			continue;
+		}
+		Rect2i window(unit->getPos() - Vec2i(r), unit->getPos() + Vec2i(unit->getSize() + r));
+		bool independent = batch.empty() || it->field == batch.front().first.field;
+		for (int i = 0; independent && i < windows.size(); ++i) {
+			Rect2i overlap = window.interection(windows[i]);
+			independent = overlap.p[0] == overlap.p[1];
+		}
+		if (independent) {
+			batch.push_back(std::make_pair(*it, unit));
+			windows.push_back(window);
+			m_requestIndex.erase(it->unitId);
+			it = m_requests.erase(it);
+		} else {
+			++it; // stays at the front of the queue for the next batch
+		}
 	}
-	PF_LOG( "post hierarchical search failure, path invalid?" );
-	PF_PATH_LOG( unit );
-	unit->stop();
-	path.incBlockCount();
-	return TravelState::BLOCKED;
+}
+
+/** search for the paths of a batch of requests
+  * @return the number of nodes expanded */
+int RoutePlanner::runBatch(RequestBatch &batch) {
+	const int n = batch.size();
+	AnnotatedMap *aMap = world->getCartographer()->getMasterMap();
+	foreach (RequestBatch, it, batch) {
+		aMap->annotateLocal(it->second);
+	}
+	WorkerPool *pool = world->getWorkerPool();
+	int searcherCount = std::min(pool->getThreadCount(), n);
+#	if _GAE_DEBUG_EDITION_ || defined(SL_PROFILE)
+		searcherCount = 1; // the debug renderer and profiler can only be fed from one thread
+#	endif
+	while (m_searchers.size() < searcherCount) {
+		RoutePlanner *searcher = new RoutePlanner(world);
+		searcher->m_sharedAnnotations = true;
+		m_searchers.push_back(searcher);
+	}
+	vector<TravelState> results(n);
+	vector<int> nodes(n);
+	vector<char> trapped(n);
+	PathSearchTask task(batch, m_searchers, searcherCount, results, nodes, trapped);
+	pool->parallelFor(searcherCount, 1, task);
+	aMap->clearLocalAnnotations(batch.front().second);
+
+	// boxed in by the batch annotations, search again with only the unit's own
+	for (int i = 0; i < n; ++i) {
+		if (trapped[i]) {
+			Unit *unit = batch[i].second;
+			aMap->annotateLocal(unit);
+			results[i] = searchPath(unit, batch[i].first.target);
+			nodes[i] += m_nodesExpanded;
+			aMap->clearLocalAnnotations(unit);
+		}
+	}
+
+	const int frame = world->getFrameCount();
+	const int64 now = Chrono::getCurMicros();
+	int total = 0;
+	for (int i = 0; i < n; ++i) {
+		const PathRequest &req = batch[i].first;
+		if (results[i] != TravelState::MOVING) {
+			PathResult res;
+			res.commandId = req.commandId;
+			res.dest = req.dest;
+			res.state = results[i];
+			m_results[req.unitId] = res;
+		}
+		total += nodes[i];
+		g_debugStats->addPathRequestLatency(req.unitId, frame - req.frame, now - req.micros);
+	}
+	return total;
 }
 
 TravelState RoutePlanner::customGoalSearch(PMap1Goal &goal, Unit *unit, const Vec2i &target) {
@@ -925,6 +1223,70 @@ bool RoutePlanner::repairPath(Unit *unit) {
 	return false;
 }
 
+/** Runs the same low level searches, between pseudo-random pairs of open cells on the
+  * current map up to three clusters apart, with SearchEngine<NodePool> A* and with
+  * JumpPointSearch, and logs the nodes expanded and time taken by each, for units of
+  * size 1 and 2 on land. Also logs how many searches each gave up on, and how many paths
+  * found by both differ in cost, which should be none.
+  * Started from GameState::init() with '-test path-search'. */
+void RoutePlanner::benchmarkLowLevel(int searches) {
+	AnnotatedMap *aMap = world->getCartographer()->getMasterMap();
+	const Map &map = *world->getMap();
+	const int range = GameConstants::clusterSize * 3;
+	JumpPointSearch jps(map.getW(), map.getH());
+	jps.setNodeLimit(jumpPointNodeLimit);
+	const int nodeLimit = nsgSearchEngine->getNodeLimit();
+	nsgSearchEngine->setNodeLimit(-1);
+	nsgSearchEngine->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
+
+	for (int size = 1; size <= 2; ++size) {
+		Random rand(size);
+		int pairs = 0, aStarFound = 0, jpsFound = 0, mismatched = 0;
+		int64 aStarNodes = 0, jpsNodes = 0, aStarTime = 0, jpsTime = 0;
+		for (int i = 0; i < searches * 10 && pairs < searches; ++i) {
+			Vec2i start(rand.randRange(0, map.getW() - 1), rand.randRange(0, map.getH() - 1));
+			Vec2i dest(clamp(start.x + rand.randRange(-range, range), 0, map.getW() - 1),
+				clamp(start.y + rand.randRange(-range, range), 0, map.getH() - 1));
+			if (start == dest || !aMap->canOccupy(start, size, Field::LAND)
+			|| !aMap->canOccupy(dest, size, Field::LAND)) {
+				continue;
+			}
+			++pairs;
+			MoveCost cost(Field::LAND, size, aMap);
+			DiagonalDistance dd(dest);
+			PosGoal goal(dest);
+			int64 t0 = Chrono::getCurMicros();
+			nsgSearchEngine->setStart(start, dd(start));
+			AStarResult aStarRes = nsgSearchEngine->aStar(goal, cost, dd);
+			int64 t1 = Chrono::getCurMicros();
+			AStarResult jpsRes = jps.search(aMap, Field::LAND, size, start, dest);
+			int64 t2 = Chrono::getCurMicros();
+
+			aStarTime += t1 - t0;
+			jpsTime += t2 - t1;
+			aStarNodes += nsgSearchEngine->getExpandedLastRun();
+			jpsNodes += jps.getExpandedLastRun();
+			bool aStarOk = aStarRes == AStarResult::COMPLETE && nsgSearchEngine->getGoalPos() == dest;
+			bool jpsOk = jpsRes == AStarResult::COMPLETE;
+			aStarFound += aStarOk ? 1 : 0;
+			jpsFound += jpsOk ? 1 : 0;
+			if (aStarOk && jpsOk && fabs(nsgSearchEngine->getCostTo(dest) - jps.getCost()) > 0.01f) {
+				++mismatched;
+			}
+		}
+		if (!pairs) {
+			continue;
+		}
+		STREAM_LOG( "Low level search benchmark: size " << size << ", " << pairs << " searches. "
+			<< "A*: " << aStarFound << " found, " << (aStarNodes / pairs) << " nodes & "
+			<< (aStarTime / pairs) << "us per search. "
+			<< "JPS: " << jpsFound << " found, " << (jpsNodes / pairs) << " nodes & "
+			<< (jpsTime / pairs) << "us per search. "
+			<< mismatched << " paths of different cost." );
+	}
+	nsgSearchEngine->setNodeLimit(nodeLimit);
+}
+
 #if _GAE_DEBUG_EDITION_
 
 TravelState RoutePlanner::doFullLowLevelAStar(Unit *unit, const Vec2i &dest) {
@@ -21,6 +21,7 @@
 #include "profiler.h"
 
 #include "search_engine.h"
+#include "jump_point_search.h"
 #include "cartographer.h"
 
 #include "world.h"
@@ -34,6 +35,7 @@ using std::map;
 
 using Shared::Math::Vec2i;
 using Shared::Platform::uint32;
+using Shared::Platform::int64;
 
 namespace Glest { namespace Search {
 
@@ -42,8 +44,37 @@ const int maxFreeSearchRadius = 10;
 /** @deprecated not in use */
 const int pathFindNodesMax = 2048;
 
+/** maximum number of queued path requests searched for together, see RoutePlanner::processRequests() */
+const int pathRequestBatchSize = 8;
+
+/** nodes expanded on queued path requests each world frame, requests over budget wait for
+  * later frames. Decides which frame a unit gets its path on, so it's part of the
+  * simulation and must be the same on every peer. */
+const int pathNodeBudget = 8192;
+
+/** most jump points a low level JumpPointSearch may open, as many as a NodePool holds */
+const int jumpPointNodeLimit = GameConstants::clusterSize * GameConstants::clusterSize * 2;
+
 typedef SearchEngine<TransitionNodeStore,TransitionNeighbours,const Transition*> TransitionSearchEngine;
 
+/** A path a unit is waiting on, see RoutePlanner::findPathToLocation() */
+struct PathRequest {
+	int     unitId;
+	int     commandId;	/**< command the path is for, the request is dropped if this changes */
+	Vec2i   dest;		/**< position asked for */
+	Vec2i   target;		/**< nearest free position to dest, what the search heads for */
+	Field   field;
+	int     frame;		/**< world frame the request was made on */
+	int64   micros;		/**< time the request was made */
+};
+
+/** Outcome of a queued request that failed, held for the unit to collect */
+struct PathResult {
+	int          commandId;
+	Vec2i        dest;
+	TravelState  state;
+};
+
 class PMap1Goal {
 protected:
 	PatchMap<1> *pMap;
@@ -166,13 +197,47 @@ public:
 
 	SearchEngine<NodePool>* getSearchEngine() { return nsgSearchEngine; }
 
+	void update();
+	void processRequests();
+
+	bool isPathPending(const Unit *unit) const { return m_requestIndex.find(unit->getId()) != m_requestIndex.end(); }
+	int  getQueueDepth() const			{ return m_requests.size(); }
+
+	bool isUsingJumpPoints() const		{ return m_jumpPoints != 0; }
+
+	void benchmarkLowLevel(int searches);
+
 private:
+	friend class PathSearchTask;
+
+	typedef list<PathRequest> Requests;
+	typedef map<int, Requests::iterator> RequestIndex;
+	typedef map<int, PathResult> PathResults;
+	typedef vector<std::pair<PathRequest, Unit*> > RequestBatch;
+
+	/** a unit on a group move, walking a flow field */
+	struct FlowFollower {
+		FlowField  *field;		/**< NULL once the unit has gone back to its own paths */
+		int         commandId;	/**< command the field is for */
+
+		FlowFollower(FlowField *field, int commandId) : field(field), commandId(commandId) {}
+	};
+	typedef map<int, FlowFollower> FlowFollowers;
+
+	bool followFlowField(Unit *unit, const Vec2i &finalPos, TravelState &result);
+	void releaseFollower(FlowFollower &follower);
+
+	TravelState queueRequest(Unit *unit, const Vec2i &dest, const Vec2i &target);
+	TravelState searchPath(Unit *unit, const Vec2i &target);
+	void selectBatch(RequestBatch &batch);
+	int  runBatch(RequestBatch &batch);
+
 	bool repairPath(Unit *unit);
 
 	TravelState findAerialPath(Unit *unit, const Vec2i &targetPos);
 
 	TravelState doRouteCache(Unit *unit);
-	TravelState doQuickPathSearch(Unit *unit, const Vec2i &target);
+	bool lowLevelSearch(Unit *unit, const Vec2i &target);
 
 	TravelState findPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2i &targetPos);
 	TravelState customGoalSearch(PMap1Goal &goal, Unit *unit, const Vec2i &target);
@@ -191,6 +256,16 @@ private:
 	NodePool *nodeStore;
 	TransitionSearchEngine *tSearchEngine;
 	TransitionNodeStore *tNodeStore;
+	JumpPointSearch *m_jumpPoints;	/**< replaces nsgSearchEngine for lowLevelSearch() & refinePath() if the game settings ask, or NULL */
+
+	Requests      m_requests;		/**< paths waiting to be searched for, oldest first */
+	RequestIndex  m_requestIndex;	/**< queued request by unit id */
+	PathResults   m_results;		/**< failed requests, by unit id */
+	FlowFollowers m_flowFollowers;	/**< units on group moves, by unit id */
+	vector<RoutePlanner*> m_searchers;	/**< run the searches for queued requests, one per thread */
+	int   m_nodesExpanded;		/**< nodes expanded by searchPath() */
+	bool  m_sharedAnnotations;	/**< searcher, the master map has been annotated for us */
+	bool  m_startBlocked;		/**< searcher, the last search was boxed in by local annotations */
 
 	Vec2i computeNearestFreePos(const Unit *unit, const Vec2i &targetPos);
 
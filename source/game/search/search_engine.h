@@ -205,6 +205,7 @@ public:
 	
 	/** limit search to use at most limit nodes */
 	void setNodeLimit(int limit) { nodeLimit = limit > 0 ? limit : -1; }
+	int  getNodeLimit() const { return nodeLimit; }
 	
 	/** set an 'expanded nodes' limit, for a resumable search */
 	void setTimeLimit(int limit) { expandLimit = limit > 0 ? limit : -1; }
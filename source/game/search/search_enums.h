@@ -17,13 +17,16 @@ namespace Glest { namespace Search {
 /** result set for path finding 
   * <ul><li><b>ARRIVED</b> Arrived at destination (or as close as unit can get to target)</li>
   *		<li><b>MOVING</b> On the way to destination</li>
-  *		<li><b>BLOCKED</b> path is blocked</li></ul>
+  *		<li><b>BLOCKED</b> path is blocked</li>
+  *		<li><b>IMPOSSIBLE</b> no path exists</li>
+  *		<li><b>PENDING</b> a path has been requested, the unit should wait</li></ul>
   */
 STRINGY_ENUM( TravelState, 
 	ARRIVED,
 	MOVING,
 	BLOCKED,
-	IMPOSSIBLE
+	IMPOSSIBLE,
+	PENDING
 );
 
 /** result set for A*
@@ -46,6 +46,39 @@ using Main::Program;
 using Search::Cartographer;
 using Gui::Selection;
 
+// =====================================================
+// 	class VisibilityPlanes
+// =====================================================
+
+void VisibilityPlanes::init(int w, int h) {
+	delete [] m_planes;
+	m_w = w;
+	m_h = h;
+	m_rowWords = (w + wordBits - 1) / wordBits;
+	m_lastWordMask = spanMask(m_rowWords - 1, 0, w - 1);
+	const int words = 2 * GameConstants::maxPlayers * h * m_rowWords;
+	m_planes = new Word[words];
+	memset(m_planes, 0, words * sizeof(Word));
+}
+
+void VisibilityPlanes::fill(Word *plane, bool v) {
+	if (!v) {
+		memset(plane, 0, m_h * m_rowWords * sizeof(Word));
+		return;
+	}
+	for (int y = 0; y < m_h; ++y) {
+		Word *row = plane + y * m_rowWords;
+		for (int wx = 0; wx < m_rowWords - 1; ++wx) {
+			row[wx] = ~Word(0);
+		}
+		row[m_rowWords - 1] = m_lastWordMask;
+	}
+}
+
+// =====================================================
+// 	class Tile
+// =====================================================
+
 void Tile::deleteResource() {
 	g_world.getMapObjectFactory().deleteInstance(object);
 	object = 0;
@@ -256,6 +289,12 @@ void Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 		// Tiles & Cells
 		cells = new Cell[m_cellSize.w * m_cellSize.h];
 		tiles = new Tile[m_tileSize.w * m_tileSize.h];
+		m_visibility.init(m_tileSize.w, m_tileSize.h);
+		for (int y = 0; y < m_tileSize.h; ++y) {
+			for (int x = 0; x < m_tileSize.w; ++x) {
+				getTile(x, y)->initVisibility(&m_visibility, x, y);
+			}
+		}
 
 		m_heightMap = new float[m_tileSize.w * m_tileSize.h];
 
@@ -917,6 +956,7 @@ void Map::putUnitCells(Unit *unit, const Vec2i &pos){
 		}
 	}
 	unit->setPos(pos);
+	g_world.getUnitGrid().unitMoved(unit);
 	ScriptManager::unitMoved(unit);
 }
 
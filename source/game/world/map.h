@@ -91,6 +91,107 @@ public:
 	void setType(SurfaceType type)			{ surfaceType = type;	}
 };
 
+// =====================================================
+// 	class VisibilityPlanes
+//
+///	The visible & explored flags of every tile, for every team
+// =====================================================
+/** One bitplane per team for visibility, and another for exploration, owned by the
+  * Map. Each plane is row-major with getRowWords() 64 bit words to a row, tile x of a
+  * row is bit (x % 64) of word (x / 64). Bits past the map width are always clear, so
+  * whole rows can be set, cleared, copied & combined a word at a time. */
+class VisibilityPlanes {
+public:
+	typedef Shared::Platform::uint64 Word;
+	static const int wordBits = 64;
+
+private:
+	int   m_w, m_h;
+	int   m_rowWords;
+	Word *m_planes;	/**< visible planes for teams 0 to maxPlayers-1, then explored planes */
+	Word  m_lastWordMask; /**< the bits of the last word of a row that are on the map */
+
+	VisibilityPlanes(const VisibilityPlanes&);
+	void operator=(const VisibilityPlanes&);
+
+	Word* plane(int ndx) const { return m_planes + ndx * m_h * m_rowWords; }
+
+public:
+	VisibilityPlanes() : m_w(0), m_h(0), m_rowWords(0), m_planes(0), m_lastWordMask(0) {}
+	~VisibilityPlanes() { delete [] m_planes; }
+
+	/** allocate planes for a w x h tile map, everything hidden & unexplored */
+	void init(int w, int h);
+
+	int getW() const		{ return m_w; }
+	int getH() const		{ return m_h; }
+	int getRowWords() const	{ return m_rowWords; }
+
+	Word* getVisibleRow(int team, int y) const {
+		ASSERT_RANGE(team, GameConstants::maxPlayers);
+		return plane(team) + y * m_rowWords;
+	}
+	Word* getExploredRow(int team, int y) const {
+		ASSERT_RANGE(team, GameConstants::maxPlayers);
+		return plane(GameConstants::maxPlayers + team) + y * m_rowWords;
+	}
+
+	bool isVisible(int team, int x, int y) const {
+		return (getVisibleRow(team, y)[x / wordBits] >> (x % wordBits)) & 1;
+	}
+	bool isExplored(int team, int x, int y) const {
+		return (getExploredRow(team, y)[x / wordBits] >> (x % wordBits)) & 1;
+	}
+	void setVisible(int team, int x, int y, bool v)  { setBit(getVisibleRow(team, y), x, v); }
+	void setExplored(int team, int x, int y, bool v) { setBit(getExploredRow(team, y), x, v); }
+
+	/** set or clear every tile's visible (explored) flag for team */
+	void fillVisible(int team, bool v)	{ fill(getVisibleRow(team, 0), v); }
+	void fillExplored(int team, bool v)	{ fill(getExploredRow(team, 0), v); }
+
+	/** mask of the bits of word wx of a row that are in the span of tiles [x0, x1] */
+	static Word spanMask(int wx, int x0, int x1) {
+		const int first = wx * wordBits, last = first + wordBits - 1;
+		if (x1 < first || x0 > last) {
+			return 0;
+		}
+		Word mask = ~Word(0);
+		if (x0 > first) {
+			mask &= ~Word(0) << (x0 - first);
+		}
+		if (x1 < last) {
+			mask &= ~Word(0) >> (last - x1);
+		}
+		return mask;
+	}
+
+	/** index of the lowest set bit of w, w must not be 0 */
+	static int lowestBit(Word w) {
+		assert(w);
+#		if defined(__GNUC__)
+			return __builtin_ctzll(w);
+#		else
+			int n = 0;
+			while (!(w & 1)) {
+				w >>= 1;
+				++n;
+			}
+			return n;
+#		endif
+	}
+
+private:
+	static void setBit(Word *row, int x, bool v) {
+		const Word bit = Word(1) << (x % wordBits);
+		if (v) {
+			row[x / wordBits] |= bit;
+		} else {
+			row[x / wordBits] &= ~bit;
+		}
+	}
+	void fill(Word *plane, bool v);
+};
+
 // =====================================================
 // 	class Tile
 //
@@ -109,17 +210,23 @@ private:
 	// object & resource
 	MapObject *object;
 
-	// visibility
-	bool visible[GameConstants::maxPlayers];
-	bool explored[GameConstants::maxPlayers];
+	// visibility, flags are kept in the map's VisibilityPlanes
+	VisibilityPlanes *planes;
+	int16 x, y;
 
 	// cache
 	bool nearSubmerged;
 
 public:
-	Tile() : tileType(-1), texId(0), object(0), nearSubmerged(false) { }
+	Tile() : tileType(-1), texId(0), object(0), planes(0), x(0), y(0), nearSubmerged(false) { }
 	~Tile() { }
 
+	void initVisibility(VisibilityPlanes *planes, int x, int y) {
+		this->planes = planes;
+		this->x = x;
+		this->y = y;
+	}
+
 	// get/is
 	const Vec3f &getColor() const               { return color;                              }
 	int getTileType() const                     { return tileType;                           }
@@ -127,28 +234,16 @@ public:
 	MapObject *getObject() const                { return object;                             }
 	MapResource *getResource() const            { return object ? object->getResource() : 0; }
 	bool getNearSubmerged() const               { return nearSubmerged;                      }
-	bool isVisible(int teamIndex) const			{
-		ASSERT_RANGE(teamIndex, GameConstants::maxPlayers);
-		return visible[teamIndex];
-	}
-	bool isExplored(int teamIndex) const		{
-		ASSERT_RANGE(teamIndex, GameConstants::maxPlayers);
-		return explored[teamIndex];
-	}
+	bool isVisible(int teamIndex) const			{ return planes->isVisible(teamIndex, x, y);  }
+	bool isExplored(int teamIndex) const		{ return planes->isExplored(teamIndex, x, y); }
 
 	//set
 	void setColor(const Vec3f &color)               { this->color= color;        }
 	void setTileType(int tileType)                  { this->tileType= tileType;  }
 	void setTexId(int id)                           { this->texId = id;          }
 	void setObject(MapObject *object)               { this->object= object;      }
-	void setExplored(int teamIndex, bool explored)	{
-		ASSERT_RANGE(teamIndex, GameConstants::maxPlayers);
-		this->explored[teamIndex]= explored;
-	}
-	void setVisible(int teamIndex, bool visible)	{
-		ASSERT_RANGE(teamIndex, GameConstants::maxPlayers);
-		this->visible[teamIndex]= visible;
-	}
+	void setExplored(int teamIndex, bool explored)	{ planes->setExplored(teamIndex, x, y, explored); }
+	void setVisible(int teamIndex, bool visible)	{ planes->setVisible(teamIndex, x, y, visible);   }
 
 	void setNearSubmerged(bool nearSubmerged)		{this->nearSubmerged= nearSubmerged;	}
 
@@ -235,6 +330,7 @@ private:
 	int maxPlayers;
 	Cell *cells;
 	Tile *tiles;
+	VisibilityPlanes m_visibility;
 	Vec2i *startLocations;
 
 	float *m_heightMap;
@@ -275,6 +371,9 @@ public:
 	}
 	Tile *getTile(const Vec2i &sPos) const { return getTile(sPos.x, sPos.y); }
 
+	VisibilityPlanes& getVisibility()				{ return m_visibility; }
+	const VisibilityPlanes& getVisibility() const	{ return m_visibility; }
+
 	Tile *getTileFromCellPos(int x, int y) const {
 		return getTile(x / GameConstants::cellScale, y / GameConstants::cellScale);
 	}
@@ -248,6 +248,7 @@ void Minimap::init(int w, int h, const World *world, bool resumingGame) {
 	m_fowPixmap0 = new Pixmap2D(nextPowerOf2(tileW), nextPowerOf2(tileH), 1);
 	m_fowPixmap1 = new Pixmap2D(nextPowerOf2(tileW), nextPowerOf2(tileH), 1);
 	m_fowPixmap0->setPixels(&f);
+	m_fowDirtyRows.assign(m_fowPixmap1->getH(), true);
 	if (!m_shroudOfDarkness) {
 		f = 0.f;
 		m_fowPixmap1->setPixels(&f);
@@ -362,52 +363,44 @@ void Minimap::reset() {
 
 // ==================== set ====================
 
+/** m_fowPixmap1 holds the alpha each tile is heading for, m_fowPixmap0 the alpha it
+  * started from, the last fade is done so its targets are the new starting values */
 void Minimap::resetFowTex() {
-	Pixmap2D *tmpPixmap= m_fowPixmap0;
-	m_fowPixmap0 = m_fowPixmap1;
-	m_fowPixmap1 = tmpPixmap;
-	const int width = m_fowTex->getPixmap()->getW();
-	const int height = m_fowTex->getPixmap()->getH();
-	for (int i=0; i < width; ++i) {
-		for (int j=0; j < height; ++j) {
-			if (!m_fogOfWar && m_shroudOfDarkness) { // shroud, but no fog
-				float p0 = m_fowPixmap0->getPixelf(i, j);
-				float p1 = m_fowPixmap1->getPixelf(i, j);
-				if (p0 > p1) {
-					m_fowPixmap1->setPixel(i, j, p0);
-				} else {
-					m_fowPixmap1->setPixel(i, j, p1);
-				}
-			} else if (m_fogOfWar || m_shroudOfDarkness) { // else if either,
-				float p0 = m_fowPixmap0->getPixelf(i, j);
-				float p1 = m_fowPixmap1->getPixelf(i, j);
-
-				if (p1 > exploredAlpha) { // if old value is greater than 0.5, reset to 0.5
-					m_fowPixmap1->setPixel(i, j, exploredAlpha);
-				}
-				if (p0 > p1) { // if new value is greater than old, copy new
-					m_fowPixmap1->setPixel(i, j, p0);
-				}
-			} else { // else no shroud or fog
-				if (i == 0 || j == 0 || i == width - 1 || j == height - 1) {
-					m_fowPixmap1->setPixel(i, j, 0.f);
-				} else {
-					m_fowPixmap1->setPixel(i, j, 1.f);
-				}
-			}
-		}
+	const Pixmap2D *pixmap = m_fowPixmap1;
+	memcpy(m_fowPixmap0->getPixels(), pixmap->getPixels(),
+		pixmap->getW() * pixmap->getH() * pixmap->getComponents());
+}
+
+/** set the alpha tile tPos fades to, edge tiles are always black */
+void Minimap::setFowState(const Vec2i &tPos, ExplorationState state) {
+	const int tileW = m_w / GameConstants::cellScale;
+	const int tileH = m_h / GameConstants::cellScale;
+	assert(tPos.x >= 0 && tPos.y >= 0 && tPos.x < tileW && tPos.y < tileH);
+	float alpha;
+	if (tPos.x == 0 || tPos.y == 0 || tPos.x == tileW - 1 || tPos.y == tileH - 1) {
+		alpha = 0.f;
+	} else if (state == esVisible) {
+		alpha = 1.f;
+	} else if (state == esExplored || !m_shroudOfDarkness) {
+		alpha = exploredAlpha;
+	} else {
+		alpha = 0.f;
 	}
+	m_fowPixmap1->setPixel(tPos.x, tPos.y, alpha);
+	m_fowDirtyRows[tPos.y] = true;
 }
 
+/** interpolate the fog texture from m_fowPixmap0 to m_fowPixmap1, for the pixels not
+  * at their target, a row at a time with fadeAlpha(). Rows that reach their targets
+  * are skipped until setFowState() changes one of their targets again. */
 void Minimap::updateFowTex(float t) {
-	for (int i=0; i < m_fowPixmap0->getW(); ++i) {
-		for (int j=0; j < m_fowPixmap0->getH(); ++j) {
-			float p1 = m_fowPixmap1->getPixelf(i, j);
-			if (p1 != m_fowTex->getPixmap()->getPixelf(i, j)) {
-				// interpolate p0 -> p1
-				float p0 = m_fowPixmap0->getPixelf(i, j);
-				m_fowTex->getPixmap()->setPixel(i, j, p0 + (t * (p1 - p0)));
-			}
+	Pixmap2D *pixmap = m_fowTex->getPixmap();
+	const int w = pixmap->getW();
+	assert(pixmap->getComponents() == 1 && m_fowPixmap1->getW() == w);
+	for (int y=0; y < pixmap->getH(); ++y) {
+		if (m_fowDirtyRows[y]) {
+			m_fowDirtyRows[y] = fadeAlpha(pixmap->getPixels() + y * w,
+				m_fowPixmap0->getPixels() + y * w, m_fowPixmap1->getPixels() + y * w, w, t);
 		}
 	}
 }
@@ -452,27 +445,36 @@ FuzzySize Minimap::getMinimapSize() const {
 // ==================== PRIVATE ====================
 
 void buildVisLists(ConstUnitVector &srfList, ConstUnitVector &airList) {
+	typedef VisibilityPlanes::Word Word;
 	UnitSet srfSet; // surface units seen already
 	UnitSet airSet; // air units seen already
 	const Faction *thisFaction = g_world.getThisFaction();
-	RectIterator iter(Vec2i(0), Vec2i(g_map.getW() - 1, g_map.getH() - 1));
-	while (iter.more()) {
-		Vec2i pos = iter.next();
-		Tile *tile = g_map.getTile(Map::toTileCoords(pos));
-		if (tile->isVisible(thisFaction->getTeam())) {
-			Cell *cell = g_map.getCell(pos);
-			Unit *u = cell->getUnit(Zone::AIR);
-			if (u && thisFaction->canSee(u)) {
-				if (airSet.find(u) == airSet.end()) {
-					airSet.insert(u);
-					airList.push_back(u);
-				}
-			} else {
-				u = cell->getUnit(Zone::LAND);
-				if (u && thisFaction->canSee(u)) {
-					if (srfSet.find(u) == srfSet.end()) {
-						srfSet.insert(u);
-						srfList.push_back(u);
+	const VisibilityPlanes &planes = g_map.getVisibility();
+	// only the cells of visible tiles, found a word of the visible plane at a time,
+	// in the same (row major) order as walking every cell
+	for (int y = 0; y < g_map.getH(); ++y) {
+		const Word *row = planes.getVisibleRow(thisFaction->getTeam(), y / GameConstants::cellScale);
+		for (int wx = 0; wx < planes.getRowWords(); ++wx) {
+			Word bits = row[wx];
+			while (bits) {
+				const int tx = wx * VisibilityPlanes::wordBits + VisibilityPlanes::lowestBit(bits);
+				bits &= bits - 1;
+				for (int x = tx * GameConstants::cellScale; x < (tx + 1) * GameConstants::cellScale; ++x) {
+					Cell *cell = g_map.getCell(x, y);
+					Unit *u = cell->getUnit(Zone::AIR);
+					if (u && thisFaction->canSee(u)) {
+						if (airSet.find(u) == airSet.end()) {
+							airSet.insert(u);
+							airList.push_back(u);
+						}
+					} else {
+						u = cell->getUnit(Zone::LAND);
+						if (u && thisFaction->canSee(u)) {
+							if (srfSet.find(u) == srfSet.end()) {
+								srfSet.insert(u);
+								srfList.push_back(u);
+							}
+						}
 					}
 				}
 			}
@@ -640,14 +642,21 @@ void Minimap::computeTerrainTexture(const World *world) {
 }
 
 void Minimap::setExploredState(const World *world) {
+	typedef VisibilityPlanes::Word Word;
 	const Map &map = *world->getMap();
+	const VisibilityPlanes &planes = map.getVisibility();
 	for (int y=0; y < map.getTileH(); ++y) {
-		for (int x=0; x < map.getTileW(); ++x) {
-			if (!m_shroudOfDarkness || map.getTile(x,y)->isExplored(world->getThisFactionIndex())) {
+		const Word *row = planes.getExploredRow(world->getThisTeamIndex(), y);
+		for (int wx=0; wx < planes.getRowWords(); ++wx) {
+			Word bits = m_shroudOfDarkness ? row[wx] : VisibilityPlanes::spanMask(wx, 0, map.getTileW() - 1);
+			while (bits) {
+				const int x = wx * VisibilityPlanes::wordBits + VisibilityPlanes::lowestBit(bits);
+				bits &= bits - 1;
 				m_fowPixmap0->setPixel(x, y, exploredAlpha);
 				m_fowPixmap1->setPixel(x, y, exploredAlpha);
 			}
 		}
+		m_fowDirtyRows[y] = true;
 	}
 }
 
@@ -63,6 +63,7 @@ private:
 	Texture2D*		m_fowTex;		// Fog Of War texture
 	Texture2D*		m_unitsTex;		// Units 'overlay' texture
 	TypeMap<int8>*	m_unitsPMap;	// overlay construction helper (at cell resolution)
+	vector<bool>	m_fowDirtyRows;	// rows of m_fowTex that may not have reached m_fowPixmap1 yet
 
 	Texture2D*		m_attackNoticeTex;
 	AttackNotices	m_attackNotices;
@@ -110,18 +111,11 @@ public:
 	void setMinimapSize(FuzzySize size);
 	FuzzySize getMinimapSize() const;
 
-	void resetFowTex();          // swap FoW pixmaps, resetting values on the now 'old' one
+	void resetFowTex();          // start a new fade, the current targets become the starting values
 	void updateFowTex(float t);  // update FoW tex, interpolating between pixmaps (according to 't')
+	void setFowState(const Vec2i &tPos, ExplorationState state); // set a tile's target for this fade
 	void updateUnitTex();
 
-	// heavy use function
-	void incFowTextureAlphaSurface(const Vec2i &sPos, float alpha) {
-		assert(sPos.x < m_fowPixmap1->getW() && sPos.y < m_fowPixmap1->getH());
-		if (m_fowPixmap1->getPixelf(sPos.x, sPos.y) < alpha) {
-			m_fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
-		}
-	}
-
 	virtual bool mouseDown(MouseButton btn, Vec2i pos);
 	virtual bool mouseUp(MouseButton btn, Vec2i pos);
 	virtual bool mouseMove(Vec2i pos);
@@ -0,0 +1,316 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "replay.h"
+
+#include <stdexcept>
+
+#include "FSFactory.hpp"
+#include "xml_parser.h"
+#include "byte_stream.h"
+#include "command_codec.h"
+#include "world_hash.h"
+#include "game_util.h"
+#include "conversion.h"
+#include "renderer.h"
+#include "logger.h"
+#include "timer.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Sim {
+
+using std::runtime_error;
+using Shared::Util::ByteWriter;
+using Shared::Util::ByteReader;
+using Shared::Xml::XmlTree;
+using Shared::Platform::Chrono;
+using Glest::Net::WorldHash;
+
+namespace {
+
+	const char replayMagic[4] = { 'M', 'R', 'P', 'L' };
+
+	/** kind byte of a record */
+	struct Record {
+		enum {
+			END			= 0,
+			COMMANDS	= 1,
+			CHECKPOINT	= 2
+		};
+	};
+
+	/** more commands than this in one frame means the file is garbled */
+	const int maxFrameCommands = 4096;
+
+	/** write out in chunks of about this many bytes */
+	const size_t flushSize = 4096;
+
+	void writeString(ByteWriter &out, const string &s) {
+		out.writeVarUint(s.size());
+		out.writeBytes(s.data(), s.size());
+	}
+
+	string readString(ByteReader &in) {
+		const uint32 size = in.readVarUint();
+		if (size > in.remaining()) {
+			while (in.isGood()) {
+				in.readByte(); // run off the end, so the reader reports it
+			}
+			return string();
+		}
+		string s(size, '\0');
+		if (size) {
+			in.readBytes(&s[0], size);
+		}
+		return s;
+	}
+}
+
+// =====================================================
+//	class ReplayWriter
+// =====================================================
+
+ReplayWriter::ReplayWriter(const string &path, const GameSettings &settings, const vector<int32> &aiSeeds)
+		: m_file(0), m_frame(0) {
+	XmlTree doc("game-settings");
+	settings.save(doc.getRootNode());
+
+	ByteWriter out(m_bytes);
+	out.writeBytes(replayMagic, sizeof(replayMagic));
+	out.writeVarUint(GameConstants::replayVersion);
+	writeString(out, getNetworkVersionString());
+	writeString(out, *doc.toString());
+	out.writeVarUint(aiSeeds.size());
+	foreach_const (vector<int32>, it, aiSeeds) {
+		out.writeVarInt(*it);
+	}
+	m_file = g_fileFactory.getFileOps();
+	try {
+		m_file->openWrite(path.c_str());
+	} catch (runtime_error &) {
+		delete m_file;
+		throw;
+	}
+	flush();
+}
+
+ReplayWriter::~ReplayWriter() {
+	ByteWriter out(m_bytes);
+	out.writeVarUint(0);
+	out.writeByte(Record::END);
+	flush();
+	delete m_file;
+}
+
+void ReplayWriter::flush() {
+	if (!m_bytes.empty()) {
+		m_file->write(&m_bytes[0], 1, m_bytes.size());
+		m_bytes.clear();
+	}
+}
+
+void ReplayWriter::endFrame(const World *world) {
+	const int frame = world->getFrameCount();
+	ByteWriter out(m_bytes);
+	if (!m_commands.empty()) {
+		out.writeVarUint(frame - m_frame);
+		out.writeByte(Record::COMMANDS);
+		encodeCommands(out, &m_commands[0], m_commands.size());
+		m_commands.clear();
+		m_frame = frame;
+	}
+	if (frame % checkpointPeriod == 0) {
+		WorldHash worldHash;
+		worldHash.compute(world);
+		const uint64 hash = worldHash.getHash();
+		out.writeVarUint(frame - m_frame);
+		out.writeByte(Record::CHECKPOINT);
+		out.writeBytes(&hash, sizeof(hash));
+		m_frame = frame;
+	}
+	if (m_bytes.size() >= flushSize || frame % checkpointPeriod == 0) {
+		flush();
+	}
+}
+
+// =====================================================
+//	class Replay
+// =====================================================
+
+void Replay::load(const string &path) {
+	vector<uint8> bytes;
+	FileOps *file = g_fileFactory.getFileOps();
+	try {
+		file->openRead(path.c_str());
+		uint8 buffer[4096];
+		int n;
+		while ((n = file->read(buffer, 1, sizeof(buffer))) > 0) {
+			bytes.insert(bytes.end(), buffer, buffer + n);
+		}
+	} catch (runtime_error &) {
+		delete file;
+		throw;
+	}
+	delete file;
+
+	ByteReader in(bytes.empty() ? 0 : &bytes[0], bytes.size());
+	char magic[sizeof(replayMagic)];
+	in.readBytes(magic, sizeof(magic));
+	if (!in.isGood() || memcmp(magic, replayMagic, sizeof(magic))) {
+		throw runtime_error(path + " is not a replay");
+	}
+	const uint32 version = in.readVarUint();
+	if (version != GameConstants::replayVersion) {
+		throw runtime_error(path + " is a replay from another version, replay version "
+			+ intToStr(version));
+	}
+	m_engineVersion = readString(in);
+	m_settingsXml = readString(in);
+	const uint32 seedCount = in.readVarUint();
+	for (uint32 i = 0; i < seedCount && in.isGood(); ++i) {
+		m_aiSeeds.push_back(in.readVarInt());
+	}
+	if (!in.isGood()) {
+		throw runtime_error(path + " is cut short");
+	}
+
+	// records, up to the last complete one
+	m_commands.clear();
+	m_frames.clear();
+	m_checkpoints.clear();
+	m_complete = false;
+	vector<NetworkCommand> commands(maxFrameCommands);
+	int frame = 0;
+	while (in.remaining()) {
+		frame += in.readVarUint();
+		const uint8 kind = in.readByte();
+		if (kind == Record::END && in.isGood()) {
+			m_complete = true;
+			m_lastFrame = std::max(m_lastFrame, frame);
+			break;
+		} else if (kind == Record::COMMANDS) {
+			const int count = decodeCommands(in, &commands[0], maxFrameCommands);
+			if (count < 0 || !in.isGood()) {
+				break;
+			}
+			Frame f = { frame, int(m_commands.size()), count };
+			m_commands.insert(m_commands.end(), commands.begin(), commands.begin() + count);
+			m_frames.push_back(f);
+		} else if (kind == Record::CHECKPOINT) {
+			Checkpoint c;
+			c.frame = frame;
+			in.readBytes(&c.hash, sizeof(c.hash));
+			if (!in.isGood()) {
+				break;
+			}
+			m_checkpoints.push_back(c);
+		} else {
+			break;
+		}
+		m_lastFrame = frame;
+	}
+}
+
+// =====================================================
+//	class ReplayInterface
+// =====================================================
+
+ReplayInterface::ReplayInterface(Program &program, const string &path)
+		: SimulationInterface(program)
+		, m_nextFrame(0)
+		, m_nextCheckpoint(0)
+		, m_divergedFrame(-1)
+		, m_ended(false) {
+	m_replay.load(path);
+	XmlTree doc;
+	doc.parse(m_replay.getSettingsXml());
+	gameSettings = GameSettings(doc.getRootNode());
+	if (m_replay.getEngineVersion() != getNetworkVersionString()) {
+		g_logger.logProgramEvent("Replay " + path + " was recorded with " + m_replay.getEngineVersion()
+			+ ", it may not play back the same");
+	}
+	g_logger.logProgramEvent("Replay " + path + ": " + intToStr(m_replay.getLastFrame()) + " frames, "
+		+ intToStr(m_replay.getCommands().size()) + " commands"
+		+ (m_replay.isComplete() ? "" : ", cut short"));
+}
+
+void ReplayInterface::syncAiSeeds(int aiCount, int *seeds) {
+	const vector<int32> &recorded = m_replay.getAiSeeds();
+	if (aiCount != int(recorded.size())) {
+		throw runtime_error("Replay has " + intToStr(recorded.size()) + " AI seeds, the game needs "
+			+ intToStr(aiCount));
+	}
+	std::copy(recorded.begin(), recorded.end(), seeds);
+}
+
+/** give the commands recorded for this frame & check the world against the
+  * checkpoint if there is one */
+void ReplayInterface::frameProccessed() {
+	requestedCommands.clear(); // watching, not playing
+	const int frame = world->getFrameCount();
+
+	const vector<Replay::Frame> &frames = m_replay.getFrames();
+	while (m_nextFrame < frames.size() && frames[m_nextFrame].frame <= frame) {
+		const Replay::Frame &f = frames[m_nextFrame++];
+		if (f.frame == frame) {
+			const NetworkCommand *commands = &m_replay.getCommands()[f.firstCommand];
+			pendingCommands.insert(pendingCommands.end(), commands, commands + f.commandCount);
+		}
+	}
+
+	const vector<Replay::Checkpoint> &checkpoints = m_replay.getCheckpoints();
+	while (m_nextCheckpoint < checkpoints.size() && checkpoints[m_nextCheckpoint].frame <= frame) {
+		const Replay::Checkpoint &c = checkpoints[m_nextCheckpoint++];
+		if (c.frame != frame || m_divergedFrame != -1) {
+			continue;
+		}
+		WorldHash worldHash;
+		worldHash.compute(world);
+		if (worldHash.getHash() != c.hash) {
+			m_divergedFrame = frame;
+			g_logger.logError("Replay differs from the recording at frame " + intToStr(frame));
+		}
+	}
+
+	if (!m_ended && frame >= m_replay.getLastFrame()) {
+		m_ended = true;
+		g_logger.logProgramEvent("Replay ended at frame " + intToStr(frame));
+	}
+}
+
+int ReplayInterface::fastForward(int frame) {
+	const int last = frame < 0 ? m_replay.getLastFrame() : frame;
+	int count = 0;
+	while (world->getFrameCount() < last) {
+		processFrame();
+		g_renderer.updateParticleManager(ResourceScope::GAME);
+		++count;
+	}
+	return count;
+}
+
+void ReplayInterface::runHeadless(int frame) {
+	Chrono chrono;
+	chrono.start();
+	const int count = fastForward(frame);
+	const int64 millis = std::max(int64(1), chrono.getMillis());
+
+	std::stringstream ss;
+	ss << "Replay: " << count << " frames in " << millis << " ms, "
+		<< (count * 1000 / millis) << " frames/s, "
+		<< (millis * 1000 / std::max(1, count)) << " us/frame, ";
+	if (m_divergedFrame == -1) {
+		ss << "matched all checkpoints";
+	} else {
+		ss << "differs from the recording from frame " << m_divergedFrame;
+	}
+	std::cout << ss.str() << std::endl;
+	g_logger.logProgramEvent(ss.str());
+}
+
+}}
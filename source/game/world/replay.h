@@ -0,0 +1,148 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_REPLAY_H_
+#define _GLEST_GAME_REPLAY_H_
+
+#include <string>
+#include <vector>
+
+#include "sim_interface.h"
+
+namespace Shared { namespace PhysFS {
+	class FileOps;
+}}
+
+namespace Glest { namespace Sim {
+
+using std::string;
+using std::vector;
+using Shared::PhysFS::FileOps;
+using Shared::Platform::uint8;
+using Shared::Platform::uint64;
+
+// =====================================================
+//	class ReplayWriter
+// =====================================================
+/** Records a game as it's played, the settings & AI seeds it started with, then the
+  * player commands given each frame, with a WorldHash every checkpointPeriod frames
+  * so a replay that plays back differently can say where. Everything else follows
+  * from these, the AIs & the world are deterministic. Written as it goes, a game
+  * that crashes or goes out of sync still leaves a replay up to that point.
+  *
+  * The file is a header (magic, replay version, engine version, the settings as xml
+  * & the AI seeds) then records of a varint frame delta, a kind byte & a payload,
+  * commands in the keyframe encoding or an 8 byte hash, and an END record. */
+class ReplayWriter {
+public:
+	/** frames between checkpoint hashes, a second at normal speed */
+	static const int checkpointPeriod = 40;
+
+private:
+	FileOps                 *m_file;
+	vector<uint8>            m_bytes;		/**< not yet written */
+	vector<NetworkCommand>   m_commands;	/**< given in the current frame */
+	int                      m_frame;		/**< frame of the last record written */
+
+	void flush();
+
+public:
+	ReplayWriter(const string &path, const GameSettings &settings, const vector<int32> &aiSeeds);
+	~ReplayWriter();
+
+	/** a player command given at the end of the current frame */
+	void addCommand(const NetworkCommand &nc) { m_commands.push_back(nc); }
+
+	/** record the current frame, after its commands have been added */
+	void endFrame(const World *world);
+};
+
+// =====================================================
+//	class Replay
+// =====================================================
+/** A replay file read back into memory. A replay whose recording was cut short
+  * reads up to the last complete record, isComplete() says if it got to the end. */
+class Replay {
+public:
+	/** the commands given at the end of one frame */
+	struct Frame {
+		int  frame;
+		int  firstCommand;	/**< index into getCommands() */
+		int  commandCount;
+	};
+
+	struct Checkpoint {
+		int     frame;
+		uint64  hash;		/**< WorldHash::getHash() when recorded */
+	};
+
+private:
+	string              m_engineVersion;
+	string              m_settingsXml;
+	vector<int32>       m_aiSeeds;
+	vector<NetworkCommand> m_commands;
+	vector<Frame>       m_frames;
+	vector<Checkpoint>  m_checkpoints;
+	int                 m_lastFrame;
+	bool                m_complete;
+
+public:
+	Replay() : m_lastFrame(0), m_complete(false) {}
+
+	/** @throws runtime_error if path can't be read or isn't a replay of this version */
+	void load(const string &path);
+
+	const string& getEngineVersion() const			{ return m_engineVersion; }
+	const string& getSettingsXml() const			{ return m_settingsXml; }
+	const vector<int32>& getAiSeeds() const			{ return m_aiSeeds; }
+	const vector<NetworkCommand>& getCommands() const { return m_commands; }
+	const vector<Frame>& getFrames() const			{ return m_frames; }
+	const vector<Checkpoint>& getCheckpoints() const { return m_checkpoints; }
+	int getLastFrame() const						{ return m_lastFrame; }
+	bool isComplete() const							{ return m_complete; }
+};
+
+// =====================================================
+//	class ReplayInterface
+// =====================================================
+/** A SimulationInterface that plays a Replay, giving its recorded commands at the
+  * frames they were given and checking the world against each checkpoint. Commands
+  * from the gui are dropped. Playback runs normally in a GameState, or without
+  * rendering at full speed with fastForward(), to seek or to time the whole game. */
+class ReplayInterface : public SimulationInterface {
+private:
+	Replay  m_replay;
+	size_t  m_nextFrame;		/**< index of the next Replay::Frame to give */
+	size_t  m_nextCheckpoint;	/**< index of the next Replay::Checkpoint to check */
+	int     m_divergedFrame;	/**< first checkpoint that didn't match, -1 if none has */
+	bool    m_ended;
+
+public:
+	/** @throws runtime_error if the replay can't be loaded */
+	ReplayInterface(Program &program, const string &path);
+
+	virtual bool isReplay() const { return true; }
+
+	const Replay& getReplay() const	{ return m_replay; }
+	int getDivergedFrame() const	{ return m_divergedFrame; }
+	bool hasEnded() const			{ return m_ended; }
+
+	/** process world frames without rendering up to frame, or to the end of the
+	  * replay if frame is -1 @return frames processed */
+	int fastForward(int frame = -1);
+
+	/** fastForward() and report how long it took, for a deterministic benchmark of
+	  * the whole simulation */
+	void runHeadless(int frame = -1);
+
+protected:
+	virtual void syncAiSeeds(int aiCount, int *seeds);
+	virtual void frameProccessed();
+};
+
+}}
+
+#endif
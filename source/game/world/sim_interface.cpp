@@ -12,6 +12,7 @@
 
 #include "client_interface.h"
 #include "server_interface.h"
+#include "replay.h"
 
 #include "profiler.h"
 #include "leak_dumper.h"
@@ -87,11 +88,13 @@ SimulationInterface::SimulationInterface(Program &program)
 		, speed(GameSpeed::NORMAL)
 		, m_prototypeFactory(0)
 		, m_skillCycleTable(0)
+		, m_replayWriter(0)
 		, m_processingCommand(CmdClass::NULL_COMMAND) {
 	m_prototypeFactory = new PrototypeFactory();
 }
 
 SimulationInterface::~SimulationInterface() {
+	delete m_replayWriter;
 	delete stats;
 	stats = 0;
 	delete m_gaia;
@@ -115,6 +118,8 @@ void SimulationInterface::constructGameWorld(GameState *g) {
 
 void SimulationInterface::destroyGameWorld() {
 	NETWORK_LOG( __FUNCTION__ );
+	delete m_replayWriter;
+	m_replayWriter = 0;
 	deleteValues(aiInterfaces.begin(), aiInterfaces.end());
 	aiInterfaces.clear();
 	delete world;
@@ -148,6 +153,13 @@ ServerInterface* SimulationInterface::asServerInterface() {
 	return 0;
 }
 
+ReplayInterface* SimulationInterface::asReplayInterface() {
+	if (isReplay()) {
+		return static_cast<ReplayInterface*>(this);
+	}
+	return 0;
+}
+
 void SimulationInterface::loadWorld() {
 	NETWORK_LOG( __FUNCTION__ );
 	const string &scenarioPath = gameSettings.getScenarioPath();
@@ -188,6 +200,7 @@ void SimulationInterface::initWorld() {
 	if (seeds) {
 		syncAiSeeds(aiCount, seeds);
 	}
+	m_aiSeeds.assign(seeds, seeds + aiCount);
 	// create AIs
 	int seedCount = 0;
 	aiInterfaces.resize(world->getFactionCount());
@@ -227,6 +240,14 @@ int SimulationInterface::launchGame() {
 		throw e;
 	}
 
+	// record from the start, a saved game's replay would have nothing to start from
+	if (g_config.getMiscRecordReplays() && !savedGame && !isReplay()) {
+		try {
+			m_replayWriter = new ReplayWriter("replays/last.rpl", gameSettings, m_aiSeeds);
+		} catch (runtime_error &e) {
+			g_logger.logError(string("Not recording a replay: ") + e.what());
+		}
+	}
 	startGame();
 	world->activateUnits(savedGame);
 	return getNetworkRole() == GameRole::LOCAL ? 2 : -1;
@@ -241,6 +262,14 @@ bool SimulationInterface::updateWorld() {
 	//if (gameSettings.getMapEditor() == true && g_gameState.getWorldFps() > 10) {
     //    return false;
 	//}
+	const int frames = getFramesDue();
+	for (int i = 0; i < frames; ++i) {
+		processFrame();
+	}
+	return frames > 0;
+}
+
+void SimulationInterface::processFrame() {
 	// Ai-Interfaces
 	for (int i = 0; i < world->getFactionCount(); ++i) {
 		if (world->getFaction(i)->getCpuControl()
@@ -257,13 +286,15 @@ bool SimulationInterface::updateWorld() {
 	// World
 	world->processFrame();
 	frameProccessed();
+	if (m_replayWriter) {
+		m_replayWriter->endFrame(world);
+	}
 
 	// give pending commands
 	foreach (Commands, it, pendingCommands) {
 		commander->giveCommand(it->toCommand());
 	}
 	pendingCommands.clear();
-	return true;
 }
 
 GameStatus SimulationInterface::checkWinner(){
@@ -388,6 +419,13 @@ void SimulationInterface::doQuitGame(QuitSource source) {
 	quit = true;
 }
 
+void SimulationInterface::givePlayerCommand(const NetworkCommand &nc) {
+	pendingCommands.push_back(nc);
+	if (m_replayWriter) {
+		m_replayWriter->addCommand(nc);
+	}
+}
+
 void SimulationInterface::requestCommand(Command *command) {
 	Unit *unit = command->getCommandedUnit();
 
@@ -33,6 +33,12 @@ namespace Glest { namespace Net {
 	class ClientInterface;
 	class ServerInterface;
 }}
+
+namespace Glest { namespace Sim {
+	class ReplayWriter;
+	class ReplayInterface;
+}}
+
 using namespace Glest::Net;
 
 namespace Glest {
@@ -202,6 +208,9 @@ protected:
 	PrototypeFactory *m_prototypeFactory;
 	SkillCycleTable *m_skillCycleTable;
 
+	vector<int32>	m_aiSeeds;			/**< as synced in initWorld() */
+	ReplayWriter*	m_replayWriter;		/**< recording this game, or null */
+
 	IF_MAD_SYNC_CHECKS(
 		WorldLog *worldLog;
 	)
@@ -251,6 +260,9 @@ public:
 	/** Called after a command has been updated, determines skill cycle length */
 	virtual void updateSkillCycle(Unit*);
 
+	/** @return true if the game is held up because nothing has arrived from the server */
+	virtual bool isWaitingForServer() const { return false; }
+
 	// game over checks
 	GameStatus checkWinner();
 	GameStatus checkWinnerStandard();
@@ -279,11 +291,13 @@ public:
 	// query interface type
 	virtual GameRole getNetworkRole() const { return GameRole::LOCAL; }
 	bool isNetworkInterface() const { return getNetworkRole() != GameRole::LOCAL; }
+	virtual bool isReplay() const { return false; }
 
 	// retrieve derived type, or NULL (ie, calling is always 'safe', but check the return for NULL)
 	NetworkInterface*	asNetworkInterface();
 	ClientInterface*	asClientInterface();
 	ServerInterface*	asServerInterface();
+	ReplayInterface*	asReplayInterface();
 
 	IF_DEBUG_EDITION(
 		Plan::Gaia* getGaia() { return m_gaia; }
@@ -316,9 +330,22 @@ protected:
 	/** Indicator that the game should now start, only used by ClientInterface */
 	virtual void startGame() { }
 
+	/** @return number of world frames to process this update, a network client returns 0
+	  * while it is short of keyframes and 2 while working off a surplus */
+	virtual int getFramesDue() { return 1; }
+
+	/** Runs the AIs & one world frame, then gives the commands due */
+	void processFrame();
+
+	/** Queue a player's command to be given at the end of this frame, recording it
+	  * if the game is being recorded */
+	void givePlayerCommand(const NetworkCommand &nc);
+
 	/** Called after each world frame is processed, issues pending commands */
 	virtual void frameProccessed() {
-		std::copy(requestedCommands.begin(), requestedCommands.end(), std::back_inserter(pendingCommands));
+		foreach (Commands, it, requestedCommands) {
+			givePlayerCommand(*it);
+		}
 		requestedCommands.clear();
 	}
 
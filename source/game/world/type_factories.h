@@ -9,8 +9,12 @@
 #ifndef _GLEST_SIM_TYPE_FACTORY_
 #define _GLEST_SIM_TYPE_FACTORY_
 
+#include <new>
+
 #include "util.h"
 #include "factory.h"
+#include "slab_pool.h"
+#include "id_table.h"
 #include "unit_type.h"
 #include "upgrade_type.h"
 #include "item_type.h"
@@ -22,34 +26,48 @@
 
 namespace Glest { namespace Sim {
 using namespace ProtoTypes;
+using Shared::Util::SlabPool;
+using Shared::Util::IdTable;
 
 // ===================================================================
 //  class EntityFactory, a factory class for transient instance types
 // ===================================================================
-
+/** Entities of factories that own them (deleteObjs) live in a SlabPool, so creating
+  * & deleting them doesn't go to the heap. An IdTable maps ids to the entities and
+  * their positions in a dense array of the live entities, deletion swap-removes from
+  * that array.
+  * Iteration (begin() to end()) is in an order that depends only on the sequence of
+  * creations & deletions, so it is the same on all network peers, but it is not
+  * creation order. Factories that don't own their entities allocate them with new,
+  * whoever does own them deletes them. */
 template<typename Entity> class EntityFactory {
 
 	friend class World; // needs to get and set id counters for save games
 
 private:
-	typedef std::map<int, Entity*>  ObjectTable;
-	typedef std::list<Entity*>      ObjectList;
+	typedef std::vector<Entity*>  ObjectList;
 
 private:
-	ObjectTable  m_objTable;
-	ObjectList   m_allObjs;
-	int          m_idCounter;
-	const bool   m_destoryObjects;
+	SlabPool<Entity>  m_pool;
+	IdTable<Entity>   m_objTable;
+	ObjectList        m_allObjs;
+	int               m_idCounter;
+	const bool        m_destoryObjects;
 
 private:
 	void registerInstance(Entity *obj) {
 		if (obj->getId() == -1) {
 			obj->setId(m_idCounter++);
 		} else {
-			RUNTIME_CHECK(m_objTable.find(obj->getId()) == m_objTable.end());
+			RUNTIME_CHECK(!m_objTable.get(obj->getId()));
 		}
+		m_objTable.set(obj->getId(), obj, m_allObjs.size());
 		m_allObjs.push_back(obj);
-		m_objTable[obj->getId()] = obj;
+	}
+
+	void destroy(Entity *obj) {
+		obj->~Entity();
+		m_pool.release(obj);
 	}
 
 protected:
@@ -59,17 +77,37 @@ protected:
 public:
 	template <typename Arg1>
 	Entity* newInstance(Arg1 a1) {
-		Entity *newbie = new Entity(a1);
+		Entity *newbie;
+		if (m_destoryObjects) {
+			void *mem = m_pool.allocate();
+			try {
+				newbie = ::new (mem) Entity(a1); // the debug build gives some entities a class operator new
+			} catch (...) {
+				m_pool.release(mem);
+				throw;
+			}
+		} else {
+			newbie = new Entity(a1);
+		}
 		registerInstance(newbie);
 		return newbie;
 	}
 
 	void deleteInstance(int id) {
-		typename ObjectTable::iterator it = m_objTable.find(id);
-		RUNTIME_CHECK(it != m_objTable.end());
-		m_allObjs.erase(std::find(m_allObjs.begin(), m_allObjs.end(), it->second));
-		delete it->second;
-		m_objTable.erase(it);
+		const int ndx = m_objTable.getPos(id);
+		RUNTIME_CHECK(ndx != -1);
+		Entity *obj = m_allObjs[ndx];
+		if (ndx != int(m_allObjs.size()) - 1) {
+			m_allObjs[ndx] = m_allObjs.back();
+			m_objTable.setPos(m_allObjs[ndx]->getId(), ndx);
+		}
+		m_allObjs.pop_back();
+		m_objTable.clear(id);
+		if (m_destoryObjects) {
+			destroy(obj);
+		} else {
+			delete obj;
+		}
 	}
 
 	void deleteInstance(const Entity *ptr) {
@@ -82,21 +120,20 @@ public:
 	virtual ~EntityFactory() {
 		if (m_destoryObjects) {
 			for (typename ObjectList::iterator it = m_allObjs.begin(); it != m_allObjs.end(); ++it) {
-				delete *it;
+				destroy(*it);
 			}
 		}
 	}
 
 	unsigned getInstanceCount() const { return m_allObjs.size(); }
 
-	Entity* getInstance(int id) {
-		typename ObjectTable::iterator it = m_objTable.find(id);
-		if (it != m_objTable.end()) {
-			return it->second;
-		} else {
-			return 0;
-		}
-	}
+	typedef typename IdTable<Entity>::Handle Handle;
+
+	Entity* getInstance(int id) const				{ return m_objTable.get(id); }
+
+	/** @return the entity handle refers to, or null if it has been deleted since */
+	Entity* getInstance(const Handle &handle) const	{ return m_objTable.get(handle); }
+	Handle  getHandle(const Entity *obj) const		{ return m_objTable.getHandle(obj->getId()); }
 
 	typename ObjectList::const_iterator begin() const { return m_allObjs.begin(); }
 	typename ObjectList::const_iterator end() const { return m_allObjs.end();}
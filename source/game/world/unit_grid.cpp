@@ -0,0 +1,275 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "unit_grid.h"
+
+#include <algorithm>
+
+#include "unit.h"
+#include "faction.h"
+#include "world.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Glest { namespace Sim {
+
+// =====================================================
+// 	struct UnitFilter
+// =====================================================
+
+void UnitFilter::addAnyTag(const string &tag) {
+	anyTags.push_back(UnitType::getTagId(tag));
+}
+
+void UnitFilter::addNoTag(const string &tag) {
+	noTags.push_back(UnitType::getTagId(tag));
+}
+
+bool UnitFilter::match(const Unit *unit) const {
+	if (unit == self) {
+		return false;
+	}
+	if (aliveOnly && !unit->isAlive()) {
+		return false;
+	}
+	if (inWorldOnly && (unit->isCarried() || unit->isGarrisoned())) {
+		return false;
+	}
+	if (faction != -1 && unit->getFactionIndex() != faction) {
+		return false;
+	}
+	if (relation == TeamRelation::ALLIED && unit->getTeam() != team) {
+		return false;
+	} else if (relation == TeamRelation::HOSTILE && unit->getTeam() == team) {
+		return false;
+	}
+	const UnitType *ut = unit->getType();
+	if (!anyTags.empty()) {
+		bool found = false;
+		foreach_const (vector<int>, it, anyTags) {
+			if (ut->hasTag(*it)) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	foreach_const (vector<int>, it, noTags) {
+		if (ut->hasTag(*it)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// =====================================================
+// 	struct UnitDist
+// =====================================================
+
+bool UnitDist::operator<(const UnitDist &that) const {
+	if (dist != that.dist) {
+		return dist < that.dist;
+	}
+	return unit->getId() < that.unit->getId();
+}
+
+// =====================================================
+// 	class UnitGrid
+// =====================================================
+
+void UnitGrid::init(int cellWidth, int cellHeight) {
+	m_width = (cellWidth + bucketSize - 1) / bucketSize;
+	m_height = (cellHeight + bucketSize - 1) / bucketSize;
+	m_buckets.clear();
+	m_buckets.resize(m_width * m_height);
+	m_unitBucket.clear();
+	m_maxUnitSize = 1;
+}
+
+void UnitGrid::clear() {
+	foreach (vector<Bucket>, it, m_buckets) {
+		it->clear();
+	}
+	m_unitBucket.clear();
+	m_maxUnitSize = 1;
+}
+
+int UnitGrid::bucketIndex(const Vec2i &pos) const {
+	int x = clamp(pos.x / bucketSize, 0, m_width - 1);
+	int y = clamp(pos.y / bucketSize, 0, m_height - 1);
+	return y * m_width + x;
+}
+
+void UnitGrid::addToBucket(Unit *unit, int ndx) {
+	m_buckets[ndx].push_back(unit);
+	m_unitBucket[unit->getId()] = ndx;
+}
+
+void UnitGrid::removeFromBucket(Unit *unit, int ndx) {
+	Bucket &bucket = m_buckets[ndx];
+	Bucket::iterator it = std::find(bucket.begin(), bucket.end(), unit);
+	assert(it != bucket.end());
+	*it = bucket.back();
+	bucket.pop_back();
+	m_unitBucket[unit->getId()] = -1;
+}
+
+bool UnitGrid::contains(const Unit *unit) const {
+	return unit->getId() < int(m_unitBucket.size()) && m_unitBucket[unit->getId()] != -1;
+}
+
+void UnitGrid::add(Unit *unit) {
+	if (m_buckets.empty() || contains(unit)) {
+		return;
+	}
+	if (unit->getId() >= int(m_unitBucket.size())) {
+		m_unitBucket.resize(unit->getId() + 1, -1);
+	}
+	m_maxUnitSize = std::max(m_maxUnitSize, unit->getSize());
+	addToBucket(unit, bucketIndex(unit->getPos()));
+}
+
+void UnitGrid::remove(Unit *unit) {
+	if (contains(unit)) {
+		removeFromBucket(unit, m_unitBucket[unit->getId()]);
+	}
+}
+
+/** re-bin a unit after its position (or size, after a morph) changed, adds
+  * units that are not yet in the grid */
+void UnitGrid::unitMoved(Unit *unit) {
+	if (!contains(unit)) {
+		add(unit);
+		return;
+	}
+	m_maxUnitSize = std::max(m_maxUnitSize, unit->getSize());
+	int oldNdx = m_unitBucket[unit->getId()];
+	int newNdx = bucketIndex(unit->getPos());
+	if (oldNdx != newNdx) {
+		removeFromBucket(unit, oldNdx);
+		addToBucket(unit, newNdx);
+	}
+}
+
+/** test every unit in buckets tl to br (inclusive, in bucket coords) against filter & radius */
+void UnitGrid::gather(const Vec2i &centre, const Vec2i &tl, const Vec2i &br, int radius,
+		const UnitFilter &filter, UnitDistList &out) const {
+	for (int by = tl.y; by <= br.y; ++by) {
+		for (int bx = tl.x; bx <= br.x; ++bx) {
+			const Bucket &bucket = m_buckets[by * m_width + bx];
+			foreach_const (Bucket, it, bucket) {
+				Unit *unit = *it;
+				if (!filter.match(unit)) {
+					continue;
+				}
+				fixed dist = fixedDist(centre, unit->getNearestOccupiedCell(centre));
+				if (dist <= radius) {
+					out.push_back(UnitDist(unit, dist));
+				}
+			}
+		}
+	}
+}
+
+/** test the units of filter.faction with any of filter.anyTags, rather than
+  * everything in the buckets, for queries that want a few kinds of unit of one faction */
+void UnitGrid::gatherTagged(const Vec2i &centre, int radius, const UnitFilter &filter, UnitDistList &out) const {
+	const Faction *faction = g_world.getFaction(filter.faction);
+	for (int i = 0; i < filter.anyTags.size(); ++i) {
+		const Units &units = faction->getUnitsWithTag(filter.anyTags[i]);
+		foreach_const (Units, it, units) {
+			Unit *unit = *it;
+			bool seen = false; // a unit with two of the tags is in both lists
+			for (int j = 0; j < i && !seen; ++j) {
+				seen = unit->getType()->hasTag(filter.anyTags[j]);
+			}
+			if (seen || !contains(unit) || !filter.match(unit)) {
+				continue;
+			}
+			fixed dist = fixedDist(centre, unit->getNearestOccupiedCell(centre));
+			if (dist <= radius) {
+				out.push_back(UnitDist(unit, dist));
+			}
+		}
+	}
+}
+
+int UnitGrid::findInRange(const Vec2i &centre, int radius, const UnitFilter &filter, UnitDistList &out) const {
+	out.clear();
+	if (m_buckets.empty() || radius < 0) {
+		return 0;
+	}
+	if (filter.faction != -1 && !filter.anyTags.empty()) {
+		gatherTagged(centre, radius, filter, out);
+		std::sort(out.begin(), out.end());
+		return out.size();
+	}
+	// units are binned by top-left cell, so pad up & left by the biggest footprint
+	Vec2i tl = centre - Vec2i(radius + m_maxUnitSize - 1);
+	Vec2i br = centre + Vec2i(radius);
+	tl = Vec2i(clamp(tl.x / bucketSize, 0, m_width - 1), clamp(tl.y / bucketSize, 0, m_height - 1));
+	br = Vec2i(clamp(br.x / bucketSize, 0, m_width - 1), clamp(br.y / bucketSize, 0, m_height - 1));
+	gather(centre, tl, br, radius, filter, out);
+	std::sort(out.begin(), out.end());
+	return out.size();
+}
+
+int UnitGrid::findNearest(const Vec2i &centre, int k, int maxRadius, const UnitFilter &filter, UnitDistList &out) const {
+	out.clear();
+	if (m_buckets.empty() || k <= 0 || maxRadius < 0) {
+		return 0;
+	}
+	const int cx = clamp(centre.x / bucketSize, 0, m_width - 1);
+	const int cy = clamp(centre.y / bucketSize, 0, m_height - 1);
+	const int maxRing = (maxRadius + m_maxUnitSize - 1) / bucketSize + 1;
+
+	for (int r = 0; r <= maxRing; ++r) {
+		// nothing in ring r can be closer than this, stop once we have k nearer than it
+		int bound = (r - 1) * bucketSize + 1 - (m_maxUnitSize - 1);
+		if (int(out.size()) >= k && bound > 0 && out[k - 1].dist < bound) {
+			break;
+		}
+		if (cx - r < 0 && cy - r < 0 && cx + r >= m_width && cy + r >= m_height) {
+			break; // ring entirely off map
+		}
+		for (int by = cy - r; by <= cy + r; ++by) {
+			if (by < 0 || by >= m_height) {
+				continue;
+			}
+			if (by == cy - r || by == cy + r) {
+				int x0 = std::max(cx - r, 0), x1 = std::min(cx + r, m_width - 1);
+				gather(centre, Vec2i(x0, by), Vec2i(x1, by), maxRadius, filter, out);
+			} else {
+				if (cx - r >= 0) {
+					gather(centre, Vec2i(cx - r, by), Vec2i(cx - r, by), maxRadius, filter, out);
+				}
+				if (cx + r < m_width) {
+					gather(centre, Vec2i(cx + r, by), Vec2i(cx + r, by), maxRadius, filter, out);
+				}
+			}
+		}
+		std::sort(out.begin(), out.end());
+		if (int(out.size()) > k) {
+			out.erase(out.begin() + k, out.end());
+		}
+	}
+	return out.size();
+}
+
+Unit* UnitGrid::findNearest(const Vec2i &centre, int maxRadius, const UnitFilter &filter) const {
+	UnitDistList res;
+	if (findNearest(centre, 1, maxRadius, filter, res)) {
+		return res.front().unit;
+	}
+	return 0;
+}
+
+}}//end namespace
@@ -0,0 +1,130 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _GLEST_GAME_UNIT_GRID_H_
+#define _GLEST_GAME_UNIT_GRID_H_
+
+#include <vector>
+#include <string>
+
+#include "util.h"
+#include "vec.h"
+#include "fixed.h"
+#include "forward_decs.h"
+
+using std::vector;
+using std::string;
+
+namespace Glest { namespace Sim {
+
+using Shared::Math::Vec2i;
+using Shared::Math::fixed;
+using Entities::Unit;
+
+/** relationship a unit must have to UnitFilter::team to pass a filter */
+WRAPPED_ENUM( TeamRelation,
+	ANY,
+	ALLIED,
+	HOSTILE
+)
+
+// =====================================================
+// 	struct UnitFilter
+// =====================================================
+/** Criteria a unit must satisfy to be returned from a UnitGrid query. */
+struct UnitFilter {
+	int           team;           /**< team to test relation against (ignored if relation is ANY) */
+	TeamRelation  relation;       /**< required relationship to team */
+	int           faction;        /**< faction index unit must belong to, -1 for any */
+	const Unit   *self;           /**< unit to exclude from results (usually the querying unit) */
+	vector<int>   anyTags;        /**< tag ids, if not empty unit type must have at least one of these */
+	vector<int>   noTags;         /**< tag ids, unit type must have none of these */
+	bool          aliveOnly;      /**< skip dead units */
+	bool          inWorldOnly;    /**< skip carried and garrisoned units */
+
+	UnitFilter()
+			: team(-1), relation(TeamRelation::ANY), faction(-1), self(0)
+			, aliveOnly(true), inWorldOnly(false) {}
+
+	void addAnyTag(const string &tag);
+	void addNoTag(const string &tag);
+
+	bool match(const Unit *unit) const;
+};
+
+// =====================================================
+// 	struct UnitDist
+// =====================================================
+/** a unit and its distance from the centre of a query */
+struct UnitDist {
+	Unit  *unit;
+	fixed  dist;
+
+	UnitDist(Unit *unit, fixed dist) : unit(unit), dist(dist) {}
+
+	bool operator<(const UnitDist &that) const;
+};
+
+typedef vector<UnitDist> UnitDistList;
+
+// =====================================================
+// 	class UnitGrid
+//
+/// Bucketed spatial index of the units in the world
+// =====================================================
+/** Units are binned by position into square buckets of bucketSize cells, so
+  * proximity queries only visit the buckets overlapping the search area. Bucket
+  * membership is kept current by Map::putUnitCells (which adds or re-bins) and
+  * Unit::kill/replace/capture/undertake (which remove). Query results are sorted by distance then unit id, so they are
+  * identical on all network peers regardless of insertion history. */
+class UnitGrid {
+public:
+	static const int bucketSize = 8;
+
+private:
+	typedef vector<Unit*> Bucket;
+
+	int             m_width;         /**< width in buckets */
+	int             m_height;        /**< height in buckets */
+	int             m_maxUnitSize;   /**< largest unit size seen, to pad search areas */
+	vector<Bucket>  m_buckets;
+	vector<int>     m_unitBucket;    /**< bucket index, indexed by unit id, -1 if not in grid */
+
+	int  bucketIndex(const Vec2i &pos) const;
+	void addToBucket(Unit *unit, int ndx);
+	void removeFromBucket(Unit *unit, int ndx);
+	void gather(const Vec2i &centre, const Vec2i &tl, const Vec2i &br, int radius,
+			const UnitFilter &filter, UnitDistList &out) const;
+	void gatherTagged(const Vec2i &centre, int radius, const UnitFilter &filter, UnitDistList &out) const;
+
+public:
+	UnitGrid() : m_width(0), m_height(0), m_maxUnitSize(1) {}
+
+	void init(int cellWidth, int cellHeight);
+	void clear();
+
+	void add(Unit *unit);
+	void remove(Unit *unit);
+	void unitMoved(Unit *unit);
+
+	bool contains(const Unit *unit) const;
+
+	/** all units passing filter within radius of centre, nearest first. If the filter
+	  * has a faction and anyTags only that faction's units with those tags are tested.
+	  * @return number of units found */
+	int findInRange(const Vec2i &centre, int radius, const UnitFilter &filter, UnitDistList &out) const;
+
+	/** the (up to) k nearest units passing filter within maxRadius of centre, nearest first
+	  * @return number of units found */
+	int findNearest(const Vec2i &centre, int k, int maxRadius, const UnitFilter &filter, UnitDistList &out) const;
+
+	/** the nearest unit passing filter within maxRadius of centre, or NULL */
+	Unit* findNearest(const Vec2i &centre, int maxRadius, const UnitFilter &filter) const;
+};
+
+}}//end namespace
+
+#endif
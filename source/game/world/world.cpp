@@ -75,6 +75,7 @@ World::World(SimulationInterface *simInterface)
 		, game(*simInterface->getGameState())
 		, cartographer(0)
 		, routePlanner(0)
+		, m_workerPool(0)
 		, thisFactionIndex(-1)
 		, posIteratorFactory(65)
 		, m_cloakGroupIdCounter(0) {
@@ -87,6 +88,7 @@ World::World(SimulationInterface *simInterface)
 
 	fogOfWarSmoothing = g_config.getRenderFogOfWarSmoothing();
 	fogOfWarSmoothingFrameSkip = g_config.getRenderFogOfWarSmoothingFrameSkip();
+	setUpdateThreadCount(g_config.getGsUnitUpdateThreads());
 
 	unfogActive = false;
 	frameCount = 0;
@@ -102,6 +104,7 @@ World::~World() {
 	delete scenario;
 	delete cartographer;
 	delete routePlanner;
+	delete m_workerPool;
 
 	singleton = 0;
 }
@@ -128,6 +131,7 @@ void World::init(const XmlNode *worldNode) {
 	map.init();
 
 	// must be done after map.init()
+	m_unitGrid.init(map.getW(), map.getH());
 	routePlanner = new RoutePlanner(this);
 	cartographer = new Cartographer(this);
 
@@ -137,12 +141,11 @@ void World::init(const XmlNode *worldNode) {
 		g_cartographer.loadMapState(worldNode->getChild("mapState"));
 	} else if (m_simInterface->getGameSettings().getDefaultUnits()) {
 		g_userInterface.initMinimap(fogOfWar, shroudOfDarkness, false);
-		initUnits();
-		initExplorationState(true); // reset for human, so we get funky alpha fade in
+		initUnits(); // explores the start areas, so no resetting the exploration state after
 	} else {
 		g_userInterface.initMinimap(fogOfWar, shroudOfDarkness, false);
 	}
-	computeFow();
+	initFow();
 	alive = true;
 }
 
@@ -285,7 +288,47 @@ void World::updateEarthquakes(float seconds) {
 }
 #endif // Disable Earthquakes
 
+/** Runs Unit::prepareUpdate() over a range of World::m_updateList */
+class PrepareUnitsTask : public Shared::Platform::RangeTask {
+	Units &m_units;
+
+public:
+	PrepareUnitsTask(Units &units) : m_units(units) {}
+
+	virtual void execute(int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			m_units[i]->prepareUpdate();
+		}
+	}
+};
+
+void World::setUpdateThreadCount(int threads) {
+	delete m_workerPool;
+	m_workerPool = new WorkerPool(clamp(threads, 1, 64));
+}
+
+/** Intent phase of the unit update. Every unit gathers what it needs from the
+  * world as it stands at the start of the frame, without modifying anything, so
+  * this is spread over the worker pool. The commit phase (updateUnits) then runs
+  * serially in faction & unit order, and since neither phase depends on how the
+  * first was split between threads the results are identical for any thread count. */
+void World::prepareUnits() {
+	SECTION_TIMER(WORLD_UNIT_INTENT);
+	m_updateList.clear();
+	foreach_const (Factions, f, factions) {
+		for (int i = 0; i < f->getUnitCount(); ++i) {
+			m_updateList.push_back(f->getUnit(i));
+		}
+	}
+	for (int i = 0; i < glestimals.getUnitCount(); ++i) {
+		m_updateList.push_back(glestimals.getUnit(i));
+	}
+	PrepareUnitsTask task(m_updateList);
+	m_workerPool->parallelFor(m_updateList.size(), 32, task);
+}
+
 void World::updateUnits(const Faction *f) {
+	SECTION_TIMER(WORLD_UNIT_COMMIT);
 	const int n = f->getUnitCount();
 	for (int i=0; i < n; ++i) {
 		Unit *unit = f->getUnit(i);
@@ -311,7 +354,11 @@ void World::processFrame() {
 	//water effects
 	waterEffects.update();
 
+	//flow fields & queued path requests
+	routePlanner->update();
+
 	//update units
+	prepareUnits();
 	for (Factions::const_iterator f = factions.begin(); f != factions.end(); ++f) {
 		updateUnits(&*f);
 	}
@@ -342,11 +389,39 @@ void World::processFrame() {
 
 	//tick
 	if (frameCount % WORLD_FPS == 0) {
-		computeFow();
+		updateFow();
 		tick();
 	}
 }
 
+/** Times the unit update at 1, 4 and 16 threads and logs the average time per
+  * frame. The intent phase is timed by re-running it on the current state, which
+  * it does not change, then whole frames are timed by running the simulation on
+  * for the given number of frames, so each thread count sees a later game state.
+  * Started from GameState::init() with '-test unit-update'. */
+void World::benchmarkUnitUpdate(int frames) {
+	const int threadCounts[] = { 1, 4, 16 };
+	const int oldCount = getUpdateThreadCount();
+	frames = std::max(frames, 1);
+	for (int i = 0; i < 3; ++i) {
+		setUpdateThreadCount(threadCounts[i]);
+		int64 start = Chrono::getCurMicros();
+		for (int f = 0; f < frames; ++f) {
+			prepareUnits();
+		}
+		int64 intentTime = Chrono::getCurMicros() - start;
+		start = Chrono::getCurMicros();
+		for (int f = 0; f < frames; ++f) {
+			processFrame();
+		}
+		int64 frameTime = Chrono::getCurMicros() - start;
+		STREAM_LOG( "Unit update benchmark: " << threadCounts[i] << " thread(s), "
+			<< m_updateList.size() << " units, intent phase " << (intentTime / frames)
+			<< "us, whole frame " << (frameTime / frames) << "us" );
+	}
+	setUpdateThreadCount(oldCount);
+}
+
 void World::hit(Unit *attacker) {
 	hit(attacker, static_cast<const AttackSkillType*>(attacker->getCurrSkill()), attacker->getTargetPos(), attacker->getTargetField());
 }
@@ -399,6 +474,7 @@ void World::hit(Unit *attacker, const AttackSkillType* ast, const Vec2i &targetP
                     attacked->attackers.push_back(newAttacker);
                 }
 		    }
+			attacked->getFaction()->getMandateAiSim().wake(attacked);
 			damage(attacker, ast, attacked, 0);
 			capture(attacker, ast, attacked, 0); /**< Added by MoLAoS, capturing */
 			if (ast->hasEffects()) {
@@ -426,23 +502,7 @@ void World::damage(Unit *attacker, const AttackSkillType* ast, Unit *attacked, f
     Statistics damages;
     damages.addResistancesAndDamage(stats);
     damages.addResistancesAndDamage(attacker->getStatistics());
-    for (int t = 0; t < damages.getDamageTypes()->size(); ++t) {
-    const DamageType *dType = damages.getDamageType(t);
-    string damageType = dType->getTypeName();
-    int mDamage = dType->getValue();
-        for (int i = 0; i < attacked->getStatistics()->getResistances()->size(); ++i) {
-        const DamageType *rType = attacked->getStatistics()->getResistance(i);
-        string resistType = rType->getTypeName();
-            if (damageType==resistType) {
-                int resist = rType->getValue();
-                mDamage -= resist;
-                if (mDamage < 0) {
-                    mDamage = 0;
-                }
-            }
-        }
-    totalDamage += mDamage;
-    }
+    totalDamage += damages.getDamageAgainst(attacked->getStatistics());
     /**< Added by MoLAoS, magic damage and resistances */
     int damage = totalDamage.intp();
     if (attacker->getFaction()->getType()->getOnHitExp() == true) {
@@ -810,6 +870,12 @@ void World::computeProduction() {
 
 /** Called every 40 (or whatever WORLD_FPS resolves as) world frames */
 void World::tick() {
+#	ifndef NDEBUG
+		for (int i = 0; i < getFactionCount(); ++i) {
+			getFaction(i)->checkUnitIndexes();
+			getFaction(i)->checkUpkeep();
+		}
+#	endif
 	if (!fogOfWarSmoothing) {
 		g_userInterface.getMinimap()->updateFowTex(1.f);
 	}
@@ -851,10 +917,12 @@ void World::tick() {
 		    Unit *unit = getFaction(i)->getUnit(j);
 		    if (timeFlow.isDay() && !unit->dayCycle) {
 		        unit->dayCycle = true;
-		        unit->computeTotalUpgrade();
+		        unit->invalidateStatLayer(StatLayer::TIME_OF_DAY);
+		        unit->updateTotalUpgrade();
 		    } else if (timeFlow.isNight() && unit->dayCycle) {
 		        unit->dayCycle = false;
-		        unit->computeTotalUpgrade();
+		        unit->invalidateStatLayer(StatLayer::TIME_OF_DAY);
+		        unit->updateTotalUpgrade();
 		    }
 		}
 	}
@@ -871,51 +939,32 @@ void World::tick() {
 			}
 		}
 	}
-	///@todo foreach(Factions, f, factions) { (*f)->computeResourceBalances(); }
-	//compute resources balance
+	//compute resources balance, from the upkeep the factions keep current
 	for (int k = 0; k < getFactionCount(); ++k) {
-		Faction *faction = getFaction(k);
-		//for each resource
-		for (int i = 0; i < techTree.getResourceTypeCount(); ++i) {
-			const ResourceType *rt = techTree.getResourceType(i);
-			//if consumable
-			if (rt->getClass() == ResourceClass::CONSUMABLE) {
-				int balance = 0;
-				for (int j = 0; j < faction->getUnitCount(); ++j) {
-					//if unit operative and has this cost
-					const Unit *u =  faction->getUnit(j);
-					if (u->isOperative()) {
-						ResourceAmount r = u->getType()->getCost(rt, faction);
-						if (r.getType()) {
-							balance -= r.getAmount();
-						}
-					}
-				}
-				faction->setResourceBalance(rt, balance);
-			}
-		}
+		getFaction(k)->computeResourceBalances();
 	}
 	computeProduction();
+	static const int houseTag = UnitType::getTagId("house");
 	for (int k = 0; k < getFactionCount(); ++k) {
 		Faction *faction = getFaction(k);
 		if (!faction->getCpuControl()) {
-            for (int i = 0; i < faction->getUnitCount(); ++i) {
-                Unit *unit = faction->getUnit(i);
-                if (unit->getType()->hasTag("house")) {
-                    if (unit->getDevelopmentLevel() > 10) {
-                        int citizens = unit->getSResource(getTechTree()->getResourceType("citizens"))->getAmount();
-                        int educatedCitizens = 0;
-                        int maxEducated = 0;
-                        for (int o = 0; o < unit->ownedUnits.size(); ++o) {
-                            if (unit->ownedUnits[o].getType()->getName() == "educated_citizen") {
-                                educatedCitizens = unit->ownedUnits[o].getOwned();
-                                maxEducated = unit->ownedUnits[o].getLimit();
-                            }
-                        }
-                        if (citizens >= 10 && citizens / 10 > educatedCitizens && educatedCitizens <= maxEducated) {
-                            unit->generateCitizen();
+            // a copy, generating citizens adds units to the faction
+            const Units houses = faction->getUnitsWithTag(houseTag);
+            for (int i = 0; i < houses.size(); ++i) {
+                Unit *unit = houses[i];
+                if (unit->getDevelopmentLevel() > 10) {
+                    int citizens = unit->getSResource(getTechTree()->getResourceType("citizens"))->getAmount();
+                    int educatedCitizens = 0;
+                    int maxEducated = 0;
+                    for (int o = 0; o < unit->ownedUnits.size(); ++o) {
+                        if (unit->ownedUnits[o].getType()->getName() == "educated_citizen") {
+                            educatedCitizens = unit->ownedUnits[o].getOwned();
+                            maxEducated = unit->ownedUnits[o].getLimit();
                         }
                     }
+                    if (citizens >= 10 && citizens / 10 > educatedCitizens && educatedCitizens <= maxEducated) {
+                        unit->generateCitizen();
+                    }
                 }
             }
 		}
@@ -980,8 +1029,6 @@ void World::moveUnitCells(Unit *unit) {
 
 	if (Map::toTileCoords(centrePos) != Map::toTileCoords(newCentrePos)) {
 		changingTiles = true;
-		// remove unit's visibility
-		cartographer->removeUnitVisibility(unit);
 	}
 	if (unit->getCurrCommand()->getType()->getClass() != CmdClass::TELEPORT) {
 		RUNTIME_CHECK(routePlanner->isLegalMove(unit, newPos));
@@ -989,7 +1036,7 @@ void World::moveUnitCells(Unit *unit) {
 	map.clearUnitCells(unit, unit->getPos());
 	map.putUnitCells(unit, newPos);
 	if (changingTiles) {
-		// re-apply unit's visibility
+		// move unit's visibility
 		cartographer->applyUnitVisibility(unit);
 		if (unit->getType()->isDetector()) {
 			cartographer->detectorMoved(unit, centrePos);
@@ -1080,19 +1127,16 @@ int World::giveResource(const string &resourceName, int factionIndex, int amount
 
 void World::unfogMap(const Vec4i &rect, int time) {
 	if (time < 1) return;
+	Vec2i tl, br;
+	if (unfogActive) {
+		getUnfogTiles(tl, br);
+		cartographer->revealArea(thisTeamIndex, tl, br, false);
+	}
 	unfogActive = true;
 	unfogTTL = time;
 	unfogArea = rect;
-	const Vec2i start = Map::toTileCoords(Vec2i(unfogArea.x, unfogArea.y));
-	const Vec2i end = Map::toTileCoords(Vec2i(unfogArea.x + unfogArea.z, unfogArea.y + unfogArea.w));
-	RectIterator iter(start, end);
-	Vec2i pos;
-	while (iter.more()) {
-		pos = iter.next();
-		if (map.isInsideTile(pos)) {
-			map.getTile(pos)->setExplored(thisTeamIndex, true);
-		}
-	}
+	getUnfogTiles(tl, br);
+	cartographer->revealArea(thisTeamIndex, tl, br, true);
 }
 
 /** @return < 0 on error (see LuaCmdResult) else see CmdResult */
@@ -1342,18 +1386,11 @@ int World::getUnitCount(int factionIndex) {
 int World::getUnitCountOfType(int factionIndex, const string &typeName) {
 	if (factionIndex >= 0 && factionIndex < factions.size()) {
 		Faction* faction= &factions[factionIndex];
-		int count= 0;
 		const string &ftName = faction->getType()->getName();
 		if (unitTypes[ftName].find(typeName) == unitTypes[ftName].end()) {
 			return LuaCmdResult::PRODUCIBLE_NOT_FOUND;
 		}
-		for(int i= 0; i< faction->getUnitCount(); ++i) {
-			const Unit* unit= faction->getUnit(i);
-			if (unit->isAlive() && unit->getType()->getName()==typeName) {
-				++count;
-			}
-		}
-		return count;
+		return faction->getLiveCountOfType(faction->getType()->getUnitType(typeName));
 	} else {
 		return LuaCmdResult::INVALID_FACTION_INDEX;
 	}
@@ -1457,186 +1494,49 @@ void World::activateUnits(bool resumingGame) {
 }
 
 // init tile exploration state
-void World::initExplorationState(bool thisFactionOnly) {
-	for (int i = 0; i < map.getTileW(); ++i) {
-		for (int j = 0; j < map.getTileH(); ++j) {
-			Tile *tile = map.getTile(i, j);
-			if (thisFactionOnly) {
-				tile->setVisible(thisTeamIndex, !fogOfWar);
-				tile->setExplored(thisTeamIndex, !shroudOfDarkness);
-			} else {
-				for (int k = 0; k < GameConstants::maxPlayers; ++k) {
-					tile->setVisible(k, !fogOfWar);
-					tile->setExplored(k, !shroudOfDarkness);
-				}
-			}
-		}
+void World::initExplorationState() {
+	VisibilityPlanes &planes = map.getVisibility();
+	for (int k = 0; k < GameConstants::maxPlayers; ++k) {
+		planes.fillVisible(k, !fogOfWar);
+		planes.fillExplored(k, !shroudOfDarkness);
 	}
 }
 
 
 // ==================== exploration ====================
 
-void World::doUnfog() {
-	const Vec2i start = Map::toTileCoords(Vec2i(unfogArea.x, unfogArea.y));
-	const Vec2i end = Map::toTileCoords(Vec2i(unfogArea.x + unfogArea.z, unfogArea.y + unfogArea.w));
-	RectIterator iter(start, end);
-	Vec2i pos;
-	while (iter.more()) {
-		pos = iter.next();
-		if (map.isInsideTile(pos)) {
-			map.getTile(pos)->setVisible(thisTeamIndex, true);
-			g_userInterface.getMinimap()->incFowTextureAlphaSurface(pos, 1.f);
-		}
-	}
-	--unfogTTL;
-	if (!unfogTTL) {
-		unfogActive = false;
-	}
+/** tiles covered by the current scripted map reveal */
+void World::getUnfogTiles(Vec2i &tl, Vec2i &br) const {
+	tl = Map::toTileCoords(Vec2i(unfogArea.x, unfogArea.y));
+	br = Map::toTileCoords(Vec2i(unfogArea.x + unfogArea.z, unfogArea.y + unfogArea.w));
 }
 
-void World::exploreCells(const Vec2i &newPos, int sightRange, int teamIndex) {
-
-	Vec2i newSurfPos = Map::toTileCoords(newPos);
-	int surfSightRange = sightRange / GameConstants::cellScale + 1;
-	int sweepRange = surfSightRange + indirectSightRange + 1;
-
-	//explore
-	for (int x = -sweepRange; x <= sweepRange; ++x) {
-		for (int y = -sweepRange; y <= sweepRange; ++y) {
-			Vec2i currRelPos(x, y);
-			Vec2i currPos = newSurfPos + currRelPos;
-
-			if (map.isInsideTile(currPos)) {
-				float dist = currRelPos.length();
-				Tile *sc = map.getTile(currPos);
-
-				// explore
-				if (shroudOfDarkness && dist < sweepRange) {
-					sc->setExplored(teamIndex, true);
-				}
-
-				// visible
-				if (dist < surfSightRange) {
-					sc->setVisible(teamIndex, true);
-				}
-			}
-		}
-	}
+/** Sets up tile visibility & the fog texture once the map, exploration state & units
+  * are in place, from then on they are kept up to date as things change */
+void World::initFow() {
+	cartographer->initVisibility();
+	updateFow();
 }
 
-//computes the fog of war texture, contained in the minimap
-void World::computeFow() {
-	//GameSettings &gs = m_simInterface->getGameSettings();
-
-	///@todo move to Minimap
-	//reset texture
+/** Called once a second, ends an expired map reveal and starts the fog texture fading
+  * to the new state of the tiles whose visibility changed since the last call. Tile
+  * visibility itself is maintained as units move, see Cartographer::maintainUnitVisibility() */
+void World::updateFow() {
+	if (unfogActive && !--unfogTTL) {
+		unfogActive = false;
+		Vec2i tl, br;
+		getUnfogTiles(tl, br);
+		cartographer->revealArea(thisTeamIndex, tl, br, false);
+	}
 	Minimap *minimap = g_userInterface.getMinimap();
 	minimap->resetFowTex();
-
-	// reset visibility in cells
-	for (int i = 0; i < map.getTileW(); ++i) {
-		for (int j = 0; j < map.getTileH(); ++j) {
-			Tile *tile = map.getTile(i, j);
-			for (int k = 0; k < GameConstants::maxPlayers; ++k) {
-				bool val =			// if no fog and no shroud, or no fog and shroud with this
-					(!fogOfWar		// tile seen previously, then set visible
-					&& (!shroudOfDarkness || (shroudOfDarkness && tile->isExplored(k))));
-				tile->setVisible(k, val);
-			}
-		}
-	}
-	// explore cells
-	for (int i = 0; i < getFactionCount(); ++i) {
-		for (int j = 0; j < getFaction(i)->getUnitCount(); ++j) {
-			Unit *unit = getFaction(i)->getUnit(j);
-			if (unit->isOperative() && !unit->isCarried()  && !unit->isGarrisoned()) {
-				exploreCells(unit->getCenteredPos(), unit->getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue(), unit->getTeam());
-			}
-		}
-	}
-	// turn fires on/off (redundant ? all particle-systems now subjected to visibilty checks)
-	for (int i = 0; i < getFactionCount(); ++i) {
-		for (int j = 0; j < getFaction(i)->getUnitCount(); ++j) {
-			Unit *unit = getFaction(i)->getUnit(j);
-			// fire
-			ParticleSystem *fire = unit->getFire();
-			if (fire) {
-				fire->setActive(map.getTile(Map::toTileCoords(unit->getPos()))->isVisible(thisTeamIndex));
-			}
-		}
-	}
-
-	// compute texture
-	if (unfogActive) { // scripted map reveal
-		doUnfog();
-	}
-	Rectangle rect(0,0, map.getTileW(), map.getTileH());
-	TypeMap<> tmpMap(rect, numeric_limits<float>::infinity());
-	tmpMap.clearMap(numeric_limits<float>::infinity());
-	for (int i = 0; i < getFactionCount(); ++i) {
-		Faction *faction = getFaction(i);
-		if (faction->getTeam() != thisTeamIndex) {
-			continue;
-		}
-		for (int j = 0; j < faction->getUnitCount(); ++j) {
-			const Unit *unit = faction->getUnit(j);
-			if (unit->isOperative() && !unit->isCarried()  && !unit->isGarrisoned()) {
-				int sightRange = unit->getStatistics()->getEnhancement()->getUnitStats()->getSight()->getValue();
-				Vec2i pos;
-				float distance;
-
-				//iterate through all cells
-				PosCircularIteratorSimple pci(map.getBounds(), unit->getPos(), sightRange + indirectSightRange);
-				while (pci.getNext(pos, distance)) {
-					Vec2i surfPos = Map::toTileCoords(pos);
-					float curr = tmpMap.getInfluence(surfPos);
-					if (curr == 1.f) {
-						continue; // already max
-					}
-
-					// compute max alpha
-					float maxAlpha;
-					if (surfPos.x > 1 && surfPos.y > 1 && surfPos.x < map.getTileW() - 2 && surfPos.y < map.getTileH() - 2) {
-						// strictly inside map
-						maxAlpha = 1.f;
-					} else {
-						// map boundary
-						maxAlpha = 0.f;
-						if (tmpMap.getInfluence(surfPos) == 0.3f) {
-							continue; // already max
-						}
-					}
-
-					// compute alpha
-					float alpha;
-
-					if (distance > sightRange) {
-						alpha = clamp(1.f - (distance - sightRange) / (indirectSightRange), 0.f, maxAlpha);
-					} else {
-						alpha = maxAlpha;
-					}
-					if (alpha != 0.f && (curr == numeric_limits<float>::infinity() || alpha > curr)) {
-						tmpMap.setInfluence(surfPos, alpha);
-					}
-					//minimap->incFowTextureAlphaSurface(surfPos, alpha);
-				}
-			}
-		}
-	}
-	RectIterator iter(Vec2i(0,0), Vec2i(rect.w - 1, rect.h - 1));
-	while (iter.more()) {
-		Vec2i tPos = iter.next();
-		float val = tmpMap.getInfluence(tPos);
-		if (val != numeric_limits<float>::infinity()) {
-			minimap->incFowTextureAlphaSurface(tPos, val);
-		} else if (!shroudOfDarkness) {
-			if (tPos.x == 0 || tPos.y == 0 || tPos.x == map.getTileW() - 1 || tPos.y == map.getTileH() - 1) {
-				minimap->incFowTextureAlphaSurface(tPos, 0.f);
-			} else {
-				minimap->incFowTextureAlphaSurface(tPos, 0.5f);
-			}
-		}
+	vector<Vec2i> changes;
+	cartographer->takeFowChanges(changes);
+	for (vector<Vec2i>::const_iterator it = changes.begin(); it != changes.end(); ++it) {
+		const Tile *tile = map.getTile(*it);
+		ExplorationState state = tile->isVisible(thisTeamIndex) ? esVisible
+			: tile->isExplored(thisTeamIndex) ? esExplored : esNotExplored;
+		minimap->setFowState(*it, state);
 	}
 }
 
@@ -35,6 +35,8 @@
 #include "upgrade.h"
 #include "event.h"
 #include "events.h"
+#include "unit_grid.h"
+#include "worker_pool.h"
 
 #include "forward_decs.h"
 
@@ -44,6 +46,7 @@ namespace Glest { namespace Sim {
 using Shared::Math::Quad2i;
 using Shared::Math::Rect2i;
 using Shared::Util::Random;
+using Shared::Platform::WorkerPool;
 
 // Glest
 using Util::PosCircularIteratorFactory;
@@ -216,6 +219,10 @@ private:
 	Cartographer *cartographer;
 	RoutePlanner *routePlanner;
 	std::map<int, Surveyor*>	m_surveyorMap;
+	UnitGrid     m_unitGrid;
+
+	WorkerPool  *m_workerPool;		/**< runs the intent phase of the unit update and queued path searches */
+	Units        m_updateList;		/**< units taking part in this frame's update, in update order */
 
 	// to UserInterface, code using these should ultimately be reimplemented
 	// by Connecting signals from 'this' factions/teams units to the UserInterface
@@ -265,6 +272,8 @@ public:
 	int getMaxPlayers() const						{return map.getMaxPlayers();}
 	int getThisFactionIndex() const					{return thisFactionIndex;}
 	int getThisTeamIndex() const					{return thisTeamIndex;}
+	bool getFogOfWar() const						{return fogOfWar;}
+	bool getShroudOfDarkness() const				{return shroudOfDarkness;}
 	const Faction *getThisFaction() const			{return factions.empty() ? 0 : &factions[thisFactionIndex];}
 	int getFactionCount() const						{return factions.size();}
 	const Map *getMap() const 						{return &map;}
@@ -277,6 +286,9 @@ public:
 	Map *getMap() 									{return &map;}
 	Cartographer* getCartographer()					{return cartographer;}
 	RoutePlanner* getRoutePlanner()					{return routePlanner;}
+	UnitGrid& getUnitGrid()							{return m_unitGrid;}
+	const UnitGrid& getUnitGrid() const				{return m_unitGrid;}
+	WorkerPool* getWorkerPool()						{return m_workerPool;}
 	Surveyor* getSurveyor(int ndx)					{return m_surveyorMap[ndx];}
 	Surveyor* getSurveyor(Faction *f)				{return m_surveyorMap[f->getIndex()];}
 	const Faction *getFaction(int i) const			{return &factions[i];}
@@ -307,6 +319,9 @@ public:
 
 	// update
 	void processFrame();
+	int  getUpdateThreadCount() const	{return m_workerPool->getThreadCount();}
+	void setUpdateThreadCount(int threads);
+	void benchmarkUnitUpdate(int frames);
 
 	//misc
 	void moveUnitCells(Unit *unit);
@@ -357,17 +372,18 @@ private:
 	void initSplattedTextures();
 	void initFactions();
 	void initUnits();
-	void initExplorationState(bool thisFctionOnly = false);
+	void initExplorationState();
 
 	//misc
 	//void updateEarthquakes(float seconds);
 	void tick();
 	void computeProduction();
-	void computeFow();
-	void doUnfog();
-	void exploreCells(const Vec2i &newPos, int sightRange, int teamIndex);
+	void initFow();
+	void updateFow();
+	void getUnfogTiles(Vec2i &tl, Vec2i &br) const;
 	void loadSaved(const XmlNode *worldNode);
 	void moveAndEvict(Unit *unit, vector<Unit*> &evicted, Vec2i *oldPos);
+	void prepareUnits();
 	void updateUnits(const Faction *f);
 };
 
@@ -13,6 +13,7 @@
 #define _SHARED_GRAPHICS_PARTICLE_H_
 
 #include <list>
+#include <vector>
 #include <cassert>
 
 #include "vec.h"
@@ -24,6 +25,7 @@
 #include "util.h"
 
 using std::list;
+using std::vector;
 
 namespace Shared{ 
 
@@ -125,6 +127,75 @@ public:
 	MEMORY_CHECK_DECLARATIONS(Particle);
 };
 
+// =====================================================
+//	class ParticleArrays
+// =====================================================
+/** Particle storage for a ParticleSystem, struct-of-arrays. Every array starts on a
+  * 16 byte boundary and is padded to a multiple of four particles, so the update
+  * kernels can work on four particles at a time with SSE, see the static helpers.
+  * Particles [0, alive) are alive, the padding is kept zeroed at allocation and
+  * updated along with the rest, it is never read. */
+class ParticleArrays {
+public:
+	float *posX, *posY, *posZ;
+	float *lastPosX, *lastPosY, *lastPosZ;
+	float *speedX, *speedY, *speedZ;
+	float *accelX, *accelY, *accelZ;
+	float *colorR, *colorG, *colorB, *colorA;
+	float *color2R, *color2G, *color2B, *color2A;
+	float *size;
+	float *scratch;		/**< for kernels, eg. energy ratios */
+	int   *energy;
+
+private:
+	static const int floatArrayCount = 22;
+
+	void *block;
+	int capacity;		/**< particles allocated for, a multiple of 4 */
+
+	void setPointers();
+
+	ParticleArrays(const ParticleArrays&);
+	void operator=(const ParticleArrays&);
+
+public:
+	ParticleArrays();
+	~ParticleArrays() { release(); }
+
+	void allocate(int count);
+	void release();
+
+	bool isAllocated() const	{return block != 0;}
+	int getCapacity() const		{return capacity;}
+
+	Particle get(int i) const;
+	void set(int i, const Particle &p);
+	void move(int from, int to);
+
+	/** number of particles to process for n alive, n rounded up to a multiple of 4 */
+	static int padded(int n) { return (n + 3) & ~3; }
+
+	/** the common step for the first n particles in one pass: lastPos = pos,
+	  * pos += speed, speed += accel, --energy. n a multiple of 4 */
+	void integrate(int n);
+
+	// SSE kernels, arrays as above, n a multiple of 4
+	/** dst[i] += src[i] */
+	static void add(float *dst, const float *src, int n);
+	/** dst[i] += v */
+	static void add(float *dst, float v, int n);
+	/** dst[i] *= v */
+	static void scale(float *dst, float v, int n);
+	/** dst[i] *= v, where dst[i] > 0 */
+	static void scalePositive(float *dst, float v, int n);
+	/** --energy[i] */
+	static void decrement(int *energy, int n);
+	/** ratio[i] = clamp(energy[i] / maxEnergy, 0, 1) */
+	static void energyRatio(float *ratio, const int *energy, float maxEnergy, int n);
+	/** dst[i] = a * ratio[i] + b * (1 - ratio[i]) */
+	static void lerp(float *dst, const float *ratio, float a, float b, int n);
+};
+
 // =====================================================
 //	class ParticleSystemType
 // =====================================================
@@ -231,6 +302,11 @@ protected:
 		sFade		// No new particles
 	};
 
+	enum DeathTest {
+		dtEnergy,		// dies when out of energy
+		dtBelowGround	// dies when it falls through y = 0
+	};
+
 private:
 	//static int idCounter;
 	static int particleCounts[ParticleUse::COUNT];
@@ -248,7 +324,8 @@ protected:
 	//int id;
 	ParticleUse use;
 	int particleCount;
-	Particle *particles;
+	ParticleArrays particles;
+	DeathTest deathTest;
 	State state;
 	bool active;
 	bool visible;
@@ -274,8 +351,8 @@ public:
 	//get
 	State getState() const						{return state;}
 	Vec3f getPos() const						{return pos;}
-	Particle *getParticle(int i)				{return &particles[i];}
-	const Particle *getParticle(int i) const	{return &particles[i];}
+	Particle getParticle(int i) const			{return particles.get(i);}
+	const ParticleArrays& getParticles() const	{return particles;}
 	int getAliveParticleCount() const			{return aliveParticleCount;}
 	bool getActive() const						{return active;}
 	bool getVisible() const						{return visible;}
@@ -308,13 +385,14 @@ public:
 
 protected:
 	//protected
-	Particle *createParticle();
-	void killParticle(Particle *p)				{aliveParticleCount--;}
+	int createParticle();
+	void killDeadParticles();
 
 	//virtual protected
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
-	virtual bool deathTest(Particle *p)			{return p->energy <= 0;}
+
+	/** update particles [0, n), n is a multiple of 4, see ParticleArrays */
+	virtual void updateParticles(int n);
 };
 
 // =====================================================
@@ -329,7 +407,6 @@ public:
 	//virtual
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr);
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
 };
 
 // =====================================================
@@ -343,7 +420,6 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
 };
 
 // =====================================================
@@ -352,7 +428,7 @@ public:
 
 class ParticleManager {
 public:
-	typedef list<ParticleSystem*> ParticleSystemList;
+	typedef vector<ParticleSystem*> ParticleSystemList;
 
 protected:
 	ParticleSystemList particleSystems;
@@ -363,10 +439,8 @@ public:
 	void render(ParticleRenderer *pr, ModelRenderer *mr) const;
 	void manage(ParticleSystem *ps);
 	void end() {
-		while(!particleSystems.empty()) {
-			delete particleSystems.front();
-			particleSystems.pop_front();
-		}
+		Util::deleteValues(particleSystems.begin(), particleSystems.end());
+		particleSystems.clear();
 	}
 	// used to remove dead targets from target tracking projectiles, to be replaced by target's 
 	// Unit::Died being connected to tracking proj's Projectile::onTargetDied().
@@ -345,6 +345,18 @@ public:
 	const Pixmap2D *getFace(int face) const	{return &faces[face];}
 };
 
+// =====================================================
+//	alpha fades
+// =====================================================
+
+/** Fades single byte pixels toward a target, for each i where to[i] != dst[i] sets
+  * dst[i] to from[i] + t * (to[i] - from[i]), with the byte <-> float conversions of
+  * Pixmap2D::getPixelf() & Pixmap2D::setPixel(float), so the result is the same as
+  * doing it pixel by pixel (fadeAlphaScalar() does just that, for reference).
+  * @return true if any dst[i] still differs from to[i] */
+bool fadeAlpha(uint8 *dst, const uint8 *from, const uint8 *to, int n, float t);
+bool fadeAlphaScalar(uint8 *dst, const uint8 *from, const uint8 *to, int n, float t);
+
 }}//end namespace
 
 #endif
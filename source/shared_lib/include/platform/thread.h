@@ -61,6 +61,9 @@ public:
 	void suspend();
 	void resume();
 
+	/** give up the rest of the calling thread's time slice */
+	static void yield();
+
 	/**
 	 * Waits a max of maxWaitMillis milliseconds for thread to die.
 	 * @return true if the thread terminated or false if maxWaitMillis lapsed.
@@ -108,6 +111,48 @@ public:
 	~MutexLock() {mutex.v();}
 };
 
+// =====================================================
+//	class Semaphore
+// =====================================================
+
+class Semaphore {
+private:
+	SemaphoreType semaphore;
+
+public:
+	Semaphore(int initialValue = 0);
+	~Semaphore();
+	void p(); /**< wait until the count is positive, then decrement it */
+	void v(); /**< increment the count, waking one waiter */
+};
+
+/** Atomically add delta to value. @return the value before the addition */
+inline int atomicAdd(volatile int *value, int delta) {
+#if defined(WIN32) || defined(WIN64)
+	return InterlockedExchangeAdd(reinterpret_cast<volatile LONG*>(value), delta);
+#else
+	return __sync_fetch_and_add(value, delta);
+#endif
+}
+
+/** Atomically set value to desired if it equals expected. @return true if value was set */
+inline bool atomicCompareExchange(volatile int *value, int expected, int desired) {
+#if defined(WIN32) || defined(WIN64)
+	return InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(value), desired, expected) == expected;
+#else
+	return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+}
+
+/** Full memory barrier, no loads or stores are moved across it */
+inline void memoryBarrier() {
+#if defined(WIN32) || defined(WIN64)
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
 }}//end namespace
 
 #endif
@@ -31,6 +31,7 @@ namespace Shared { namespace Platform {
 	typedef HDC DeviceContextHandle;
 	typedef HGLRC GlContextHandle;
 	typedef CRITICAL_SECTION MutexType;
+	typedef HANDLE SemaphoreType;
 	typedef HANDLE ThreadType;
 	typedef DWORD NativeKeyCode;
 	typedef unsigned char NativeKeyCodeCompact;
@@ -54,6 +55,7 @@ namespace Shared { namespace Platform {
 	typedef void* DeviceContextHandle;
 	typedef void* GlContextHandle;
 	typedef SDL_mutex* MutexType;
+	typedef SDL_sem* SemaphoreType;
 	typedef SDL_Thread* ThreadType;
 	typedef SDLKey NativeKeyCode;
 	typedef unsigned short NativeKeyCodeCompact;
@@ -0,0 +1,139 @@
+// ==============================================================
+//	This file is part of The Glest Advanced Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _SHARED_PLATFORM_WORKER_POOL_H_
+#define _SHARED_PLATFORM_WORKER_POOL_H_
+
+#include <vector>
+#include <deque>
+
+#include "thread.h"
+
+namespace Shared { namespace Platform {
+
+using std::vector;
+
+class WorkerPool;
+class TaskGroup;
+class TaskDeque;
+
+// =====================================================
+//	class Task
+// =====================================================
+/** A unit of work run by a WorkerPool, see TaskGroup::run() */
+class Task {
+	friend class WorkerPool;
+	friend class TaskGroup;
+
+private:
+	TaskGroup  *m_group;
+	bool        m_poolOwned;	/**< delete after execute()ing */
+
+public:
+	Task() : m_group(0), m_poolOwned(false) {}
+	virtual ~Task() {}
+	virtual void execute() = 0;
+};
+
+// =====================================================
+//	class TaskGroup
+// =====================================================
+/** A set of tasks that can be waited on together. Tasks may be added from any
+  * thread, including from inside other tasks of the group. */
+class TaskGroup {
+	friend class WorkerPool;
+
+private:
+	WorkerPool     &m_pool;
+	volatile int    m_pending;
+
+public:
+	TaskGroup(WorkerPool &pool) : m_pool(pool), m_pending(0) {}
+	~TaskGroup() { wait(); }
+
+	/** queue task to be run, the caller keeps ownership and task must live until wait() returns */
+	void run(Task *task);
+
+	/** queue task to be run, the pool deletes it when it is done */
+	void runOwned(Task *task);
+
+	/** run queued tasks on the calling thread until every task of this group is done */
+	void wait();
+
+	bool isDone() const { return m_pending == 0; }
+};
+
+// =====================================================
+//	class RangeTask
+// =====================================================
+/** Body of a parallel-for, execute() is called with disjoint sub-ranges of
+  * the full index range, possibly from several threads at once. */
+class RangeTask {
+public:
+	virtual ~RangeTask() {}
+	virtual void execute(int begin, int end) = 0;
+};
+
+// =====================================================
+//	class WorkerPool
+// =====================================================
+/** Work-stealing thread pool. Each worker thread has its own deque of tasks,
+  * pushing & popping at one end without taking a lock, while idle workers steal
+  * the oldest (and usually largest) tasks from the other end of someone else's.
+  * Threads that are not workers hand tasks over through a locked queue. Threads
+  * waiting on a TaskGroup run queued tasks while they wait, so the calling thread
+  * takes part in the work: a pool of n threads starts n - 1 workers, and a pool
+  * of one thread runs everything inline. */
+class WorkerPool {
+	friend class TaskGroup;
+
+private:
+	class Worker : public Thread {
+		WorkerPool &m_pool;
+		int         m_index;
+	public:
+		Worker(WorkerPool &pool, int index) : m_pool(pool), m_index(index) {}
+		virtual void execute();
+	};
+
+	vector<Worker*>     m_workers;
+	vector<TaskDeque*>  m_deques;		/**< one per worker, indexed as m_workers */
+
+	std::deque<Task*>   m_injected;		/**< tasks queued from threads outside the pool */
+	Mutex               m_injectedMutex;
+	volatile int        m_injectedCount;
+
+	Semaphore           m_wake;			/**< posted when tasks are queued & a worker is asleep */
+	volatile int        m_sleepers;
+	volatile int        m_stealSeed;
+	bool                m_quit;
+
+	void  submit(Task *task);
+	Task* findTask(int self);
+	Task* popInjected();
+	bool  hasWork();
+	void  runTask(Task *task);
+	bool  runOneTask();
+
+public:
+	WorkerPool(int threadCount);
+	~WorkerPool();
+
+	int getThreadCount() const { return m_workers.size() + 1; }
+
+	/** @return true if the calling thread is a worker thread of any pool */
+	static bool isWorkerThread();
+
+	/** Call task.execute() over [0, count) in chunks of (up to) grain indices,
+	  * returns when every index has been processed. Ranges are split in halves
+	  * so idle workers steal big pieces, chunk boundaries depend only on count
+	  * and grain. */
+	void parallelFor(int count, int grain, RangeTask &task);
+};
+
+}}//end namespace
+
+#endif
@@ -0,0 +1,122 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _SHARED_UTIL_BYTE_STREAM_H_
+#define _SHARED_UTIL_BYTE_STREAM_H_
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "types.h"
+
+namespace Shared { namespace Util {
+
+using Platform::uint8;
+using Platform::int32;
+using Platform::uint32;
+
+// =====================================================
+//	class ByteWriter
+// =====================================================
+/** Appends values to a byte buffer for sending over the network. Integers go as
+  * varints, seven bits a byte low bits first with the top bit set on all but the
+  * last byte, so anything under 128 takes one byte. Signed values are zig-zag
+  * mapped first (0, -1, 1, -2 ... to 0, 1, 2, 3 ...) so small negatives stay small. */
+class ByteWriter {
+private:
+	std::vector<uint8> &m_bytes;
+
+public:
+	ByteWriter(std::vector<uint8> &bytes) : m_bytes(bytes) {}
+
+	void writeByte(uint8 b) { m_bytes.push_back(b); }
+
+	void writeBytes(const void *data, size_t size) {
+		const uint8 *p = static_cast<const uint8*>(data);
+		m_bytes.insert(m_bytes.end(), p, p + size);
+	}
+
+	void writeVarUint(uint32 v) {
+		while (v >= 0x80) {
+			m_bytes.push_back(uint8(v | 0x80));
+			v >>= 7;
+		}
+		m_bytes.push_back(uint8(v));
+	}
+
+	void writeVarInt(int32 v) {
+		writeVarUint((uint32(v) << 1) ^ uint32(v >> 31));
+	}
+
+	size_t size() const { return m_bytes.size(); }
+};
+
+// =====================================================
+//	class ByteReader
+// =====================================================
+/** Reads back what a ByteWriter wrote. Reading past the end, or a varint longer
+  * than five bytes, doesn't throw, it yields zeros & sets a flag to check with
+  * isGood() once the message has been read, so callers can report a garbled
+  * message in their own terms. */
+class ByteReader {
+private:
+	const uint8  *m_ptr;
+	const uint8  *m_end;
+	bool          m_good;
+
+public:
+	ByteReader(const void *data, size_t size)
+			: m_ptr(static_cast<const uint8*>(data)), m_end(m_ptr + size), m_good(true) {}
+
+	uint8 readByte() {
+		if (m_ptr == m_end) {
+			m_good = false;
+			return 0;
+		}
+		return *m_ptr++;
+	}
+
+	void readBytes(void *data, size_t size) {
+		if (size_t(m_end - m_ptr) < size) {
+			m_good = false;
+			memset(data, 0, size);
+			m_ptr = m_end;
+			return;
+		}
+		memcpy(data, m_ptr, size);
+		m_ptr += size;
+	}
+
+	uint32 readVarUint() {
+		uint32 v = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			const uint8 b = readByte();
+			if (shift == 28 && b > 0x0F) { // would overflow 32 bits, or run on
+				break;
+			}
+			v |= uint32(b & 0x7F) << shift;
+			if (!(b & 0x80)) {
+				return v;
+			}
+		}
+		m_good = false;
+		return 0;
+	}
+
+	int32 readVarInt() {
+		const uint32 v = readVarUint();
+		return int32(v >> 1) ^ -int32(v & 1);
+	}
+
+	/** @return false if anything read so far was past the end or malformed */
+	bool isGood() const			{ return m_good; }
+	size_t remaining() const	{ return size_t(m_end - m_ptr); }
+};
+
+}} // end namespace Shared::Util
+
+#endif
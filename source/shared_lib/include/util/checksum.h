@@ -19,6 +19,7 @@
 using std::string;
 using Shared::Platform::int32;
 using Shared::Platform::int8;
+using Shared::Platform::uint64;
 
 namespace Shared { namespace Util {
 
@@ -60,6 +61,33 @@ template <> inline void Checksum::add<string>(const string &value) {
 	}
 }
 
+// =====================================================
+//	class Hash64
+// =====================================================
+/** Fast 64 bit hash of a sequence of integers, for telling whether two peers hold
+  * the same game state. Each value is scrambled (MurmurHash3's fmix64 finaliser) and folded
+  * in with a multiply, so the result depends on the order values are added in. Not
+  * meant to stand up to anyone crafting a collision. */
+class Hash64 {
+private:
+	uint64	m_hash;
+
+	static uint64 mix(uint64 v) {
+		v ^= v >> 33;
+		v *= 0xFF51AFD7ED558CCDULL;
+		v ^= v >> 33;
+		v *= 0xC4CEB9FE1A85EC53ULL;
+		v ^= v >> 33;
+		return v;
+	}
+
+public:
+	Hash64() : m_hash(0xCBF29CE484222325ULL) {}
+
+	void add(uint64 value)	{ m_hash = (m_hash ^ mix(value)) * 0x100000001B3ULL; }
+	uint64 getHash() const	{ return mix(m_hash); }
+};
+
 }}//end namespace
 
 #endif
@@ -0,0 +1,183 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _SHARED_UTIL_ID_TABLE_H_
+#define _SHARED_UTIL_ID_TABLE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#include "types.h"
+
+namespace Shared { namespace Util {
+
+using Platform::uint32;
+
+// =====================================================
+//	class IdTable
+// =====================================================
+/** Dense lookup of objects by id, for ids handed out by a counter. Each id has an
+  * entry holding the object, its position in the owner's list of live objects and
+  * a generation, bumped whenever the id is cleared, so a handle (id & generation)
+  * kept past the object's deletion resolves to null even if the id is set again.
+  *
+  * Entries are grouped in pages of pageSize ids, a page is allocated when the first
+  * id in it is set and freed once every id in it has been set & cleared, so a long
+  * running counter costs memory only for the pages that still hold live ids. A freed
+  * page leaves behind the generation its entries start from if it's allocated again,
+  * past any its handles hold. A lookup is a bounds check and two loads. */
+template<typename T> class IdTable {
+public:
+	static const int pageBits = 10;
+	static const int pageSize = 1 << pageBits;
+
+	struct Handle {
+		int     id;
+		uint32  generation;
+
+		Handle() : id(-1), generation(0) {}
+		Handle(int id, uint32 generation) : id(id), generation(generation) {}
+	};
+
+private:
+	struct Entry {
+		T      *obj;
+		int     pos;
+		uint32  generation;
+	};
+
+	struct Page {
+		Entry  entries[pageSize];
+		int    liveCount;		/**< ids in the page currently set */
+		int    retiredCount;	/**< ids in the page set & cleared, the page is done when this hits pageSize */
+
+		Page(uint32 generation) : liveCount(0), retiredCount(0) {
+			for (int i = 0; i < pageSize; ++i) {
+				entries[i].obj = 0;
+				entries[i].pos = -1;
+				entries[i].generation = generation;
+			}
+		}
+	};
+
+	std::vector<Page*>   m_pages;
+	std::vector<uint32>  m_pageGenerations;	/**< per page, first generation if it's allocated (again) */
+	int                  m_pageCount;		/**< pages allocated */
+
+	IdTable(const IdTable&);
+	IdTable& operator=(const IdTable&);
+
+	const Entry* find(int id) const {
+		const size_t p = size_t(id) >> pageBits;
+		if (id < 0 || p >= m_pages.size() || !m_pages[p]) {
+			return 0;
+		}
+		return &m_pages[p]->entries[id & (pageSize - 1)];
+	}
+
+	Entry& entry(int id) {
+		assert(find(id));
+		return m_pages[id >> pageBits]->entries[id & (pageSize - 1)];
+	}
+
+	/** free page p, its entries start past every generation in it if it comes back */
+	void freePage(size_t p) {
+		Page *page = m_pages[p];
+		uint32 generation = 0;
+		for (int i = 0; i < pageSize; ++i) {
+			generation = std::max(generation, page->entries[i].generation);
+		}
+		m_pageGenerations[p] = generation + 1;
+		delete page;
+		m_pages[p] = 0;
+		--m_pageCount;
+	}
+
+public:
+	IdTable() : m_pageCount(0) {}
+	~IdTable() { clear(); }
+
+	/** clear every id, invalidating all handles */
+	void clear() {
+		for (size_t i = 0; i < m_pages.size(); ++i) {
+			if (m_pages[i]) {
+				freePage(i);
+			}
+		}
+	}
+
+	/** @return the object with id, or null */
+	T* get(int id) const {
+		const Entry *e = find(id);
+		return e ? e->obj : 0;
+	}
+
+	/** @return the object handle refers to, or null if it has since been cleared */
+	T* get(const Handle &handle) const {
+		const Entry *e = find(handle.id);
+		return e && e->generation == handle.generation ? e->obj : 0;
+	}
+
+	/** @return a handle to the object with id, which must be set */
+	Handle getHandle(int id) const {
+		assert(get(id));
+		return Handle(id, find(id)->generation);
+	}
+
+	/** @return the position set with the object, -1 if id isn't set */
+	int getPos(int id) const {
+		const Entry *e = find(id);
+		return e && e->obj ? e->pos : -1;
+	}
+
+	/** set the object for id, which must not be set */
+	void set(int id, T *obj, int pos) {
+		assert(id >= 0 && obj && !get(id));
+		const size_t p = size_t(id) >> pageBits;
+		if (p >= m_pages.size()) {
+			m_pages.resize(p + 1, 0);
+			m_pageGenerations.resize(p + 1, 0);
+		}
+		if (!m_pages[p]) {
+			m_pages[p] = new Page(m_pageGenerations[p]);
+			++m_pageCount;
+		}
+		Entry &e = entry(id);
+		e.obj = obj;
+		e.pos = pos;
+		++m_pages[p]->liveCount;
+	}
+
+	/** update the position for id, which must be set */
+	void setPos(int id, int pos) {
+		assert(get(id));
+		entry(id).pos = pos;
+	}
+
+	/** clear id, invalidating any handles to it */
+	void clear(int id) {
+		if (!get(id)) {
+			return;
+		}
+		Page *page = m_pages[id >> pageBits];
+		Entry &e = entry(id);
+		e.obj = 0;
+		e.pos = -1;
+		++e.generation;
+		--page->liveCount;
+		if (++page->retiredCount >= pageSize && !page->liveCount) {
+			freePage(id >> pageBits);
+		}
+	}
+
+	int getPageCount() const { return m_pageCount; }
+};
+
+}} // end namespace Shared::Util
+
+#endif
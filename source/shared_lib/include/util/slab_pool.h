@@ -0,0 +1,86 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _SHARED_UTIL_SLAB_POOL_H_
+#define _SHARED_UTIL_SLAB_POOL_H_
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Shared { namespace Util {
+
+// =====================================================
+//	class SlabPool
+// =====================================================
+/** Raw storage for objects of type T, carved out of slabs of slabSize objects.
+  * Released slots go on a free list and are handed out again before a new slab
+  * is allocated, so objects created & destroyed at a high rate don't touch the
+  * heap once the pool has grown to the peak number alive. Construction and
+  * destruction are up to the caller (placement new & an explicit destructor call). */
+template<typename T, int slabSize = 256> class SlabPool {
+private:
+	union Slot {
+		char         bytes[sizeof(T)];
+		Slot        *next;		/**< while on the free list */
+		long double  align1;	// for the alignment of anything T might hold
+		void        *align2;
+		long long    align3;
+	};
+
+	std::vector<Slot*>  m_slabs;
+	Slot               *m_freeList;
+	int                 m_used;		/**< slots handed out & not released */
+
+	SlabPool(const SlabPool&);
+	SlabPool& operator=(const SlabPool&);
+
+	void grow() {
+		Slot *slab = new Slot[slabSize];
+		m_slabs.push_back(slab);
+		for (int i = slabSize - 1; i >= 0; --i) {
+			slab[i].next = m_freeList;
+			m_freeList = &slab[i];
+		}
+	}
+
+public:
+	SlabPool() : m_freeList(0), m_used(0) {}
+
+	/** frees the slabs, any objects still in them must already have been destroyed */
+	~SlabPool() {
+		for (size_t i = 0; i < m_slabs.size(); ++i) {
+			delete [] m_slabs[i];
+		}
+	}
+
+	/** @return storage for one T */
+	void* allocate() {
+		if (!m_freeList) {
+			grow();
+		}
+		Slot *slot = m_freeList;
+		m_freeList = slot->next;
+		++m_used;
+		return slot;
+	}
+
+	/** return storage from allocate() to the pool */
+	void release(void *ptr) {
+		assert(ptr && m_used > 0);
+		Slot *slot = static_cast<Slot*>(ptr);
+		slot->next = m_freeList;
+		m_freeList = slot;
+		--m_used;
+	}
+
+	int getUsedCount() const		{ return m_used; }
+	int getCapacity() const			{ return int(m_slabs.size()) * slabSize; }
+};
+
+}} // end namespace Shared::Util
+
+#endif
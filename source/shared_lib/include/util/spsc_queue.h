@@ -0,0 +1,74 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _SHARED_UTIL_SPSC_QUEUE_H_
+#define _SHARED_UTIL_SPSC_QUEUE_H_
+
+#include <cassert>
+
+#include "types.h"
+#include "thread.h"
+
+namespace Shared { namespace Util {
+
+using Platform::uint32;
+
+// =====================================================
+//	class SpscQueue
+// =====================================================
+/** Bounded FIFO for handing items from exactly one producer thread to exactly one
+  * consumer thread without a lock. Each end only writes its own counter, the
+  * barriers make an item visible before the producer's counter moves past it and
+  * the slot free only after the consumer has copied it out. Neither end ever waits,
+  * push() fails when the queue is full & pop() when it's empty.
+  * @param capacity number of slots, must be a power of two */
+template<typename T, int capacity> class SpscQueue {
+private:
+	T                m_items[capacity];
+	volatile uint32  m_head;	/**< items popped, written only by the consumer */
+	volatile uint32  m_tail;	/**< items pushed, written only by the producer */
+
+	SpscQueue(const SpscQueue&);
+	SpscQueue& operator=(const SpscQueue&);
+
+public:
+	SpscQueue() : m_head(0), m_tail(0) {
+		assert(capacity > 0 && !(capacity & (capacity - 1)));
+	}
+
+	/** producer only, @return false if the queue is full */
+	bool push(const T &item) {
+		const uint32 tail = m_tail;
+		if (tail - m_head == uint32(capacity)) {
+			return false;
+		}
+		m_items[tail & (capacity - 1)] = item;
+		Platform::memoryBarrier();
+		m_tail = tail + 1;
+		return true;
+	}
+
+	/** consumer only, @return false if the queue is empty */
+	bool pop(T &item) {
+		const uint32 head = m_head;
+		if (head == m_tail) {
+			return false;
+		}
+		Platform::memoryBarrier();
+		item = m_items[head & (capacity - 1)];
+		Platform::memoryBarrier();
+		m_head = head + 1;
+		return true;
+	}
+
+	/** items in the queue, exact from either end when the other is idle, a snapshot otherwise */
+	int size() const	{ return int(m_tail - m_head); }
+	bool empty() const	{ return m_tail == m_head; }
+};
+
+}} // end namespace Shared::Util
+
+#endif
@@ -135,11 +135,11 @@ void ParticleRendererGl::renderSystem(ParticleSystem *ps) {
 	//fill vertex buffer with billboards
 	int bufferIndex = 0;
 
+	const ParticleArrays &particles = ps->getParticles();
 	for (int i = 0; i < ps->getAliveParticleCount(); ++i) {
-		const Particle *particle = ps->getParticle(i);
-		float size = particle->getSize() * 0.5f;
-		Vec3f pos = particle->getPos();
-		Vec4f color = particle->getColor();
+		float size = particles.size[i] * 0.5f;
+		Vec3f pos(particles.posX[i], particles.posY[i], particles.posZ[i]);
+		Vec4f color(particles.colorR[i], particles.colorG[i], particles.colorB[i], particles.colorA[i]);
 
 		vertexBuffer[bufferIndex] = pos - (rightVector - upVector) * size;
 		vertexBuffer[bufferIndex+1] = pos - (rightVector + upVector) * size;
@@ -169,7 +169,7 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps) {
 	assert(rendering);
 
 	if (ps->anyParticle()) {
-		const Particle *particle = ps->getParticle(0);
+		const ParticleArrays &particles = ps->getParticles();
 
 		setBlendFunc(ps->getSrcBlendFactor(), ps->getDestBlendFactor());
 		setBlendEquation(ps->getBlendEquationMode());
@@ -183,16 +183,14 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps) {
 
 		//fill vertex buffer with lines
 		int bufferIndex = 0;
-		glLineWidth(particle->getSize());
+		glLineWidth(particles.size[0]);
 
 		for (int i = 0; i < ps->getAliveParticleCount(); ++i) {
-			particle = ps->getParticle(i);
+			vertexBuffer[bufferIndex] = Vec3f(particles.posX[i], particles.posY[i], particles.posZ[i]);
+			vertexBuffer[bufferIndex + 1] = Vec3f(particles.lastPosX[i], particles.lastPosY[i], particles.lastPosZ[i]);
 
-			vertexBuffer[bufferIndex] = particle->getPos();
-			vertexBuffer[bufferIndex + 1] = particle->getLastPos();
-
-			colorBuffer[bufferIndex] = particle->getColor();
-			colorBuffer[bufferIndex + 1] = particle->getColor2();
+			colorBuffer[bufferIndex] = Vec4f(particles.colorR[i], particles.colorG[i], particles.colorB[i], particles.colorA[i]);
+			colorBuffer[bufferIndex + 1] = Vec4f(particles.color2R[i], particles.color2G[i], particles.color2B[i], particles.color2A[i]);
 
 			bufferIndex += 2;
 
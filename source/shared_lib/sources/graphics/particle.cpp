@@ -35,6 +35,170 @@ namespace Shared{ namespace Graphics{
 
 MEMORY_CHECK_IMPLEMENTATION(Particle)
 
+// =====================================================
+//	class ParticleArrays
+// =====================================================
+
+ParticleArrays::ParticleArrays() : block(0), capacity(0) {
+	setPointers();
+}
+
+void ParticleArrays::allocate(int count) {
+	assert(!block);
+	capacity = padded(count);
+	size_t bytes = size_t(capacity) * (floatArrayCount * sizeof(float) + sizeof(int));
+	block = _mm_malloc(bytes, 16);
+	if (!block) {
+		throw std::bad_alloc();
+	}
+	memset(block, 0, bytes);
+	setPointers();
+}
+
+void ParticleArrays::release() {
+	_mm_free(block);
+	block = 0;
+	capacity = 0;
+	setPointers();
+}
+
+void ParticleArrays::setPointers() {
+	float *arrays[floatArrayCount];
+	float *f = static_cast<float*>(block);
+	for (int i = 0; i < floatArrayCount; ++i) {
+		arrays[i] = f ? f + i * capacity : 0;
+	}
+	posX = arrays[0];		posY = arrays[1];		posZ = arrays[2];
+	lastPosX = arrays[3];	lastPosY = arrays[4];	lastPosZ = arrays[5];
+	speedX = arrays[6];		speedY = arrays[7];		speedZ = arrays[8];
+	accelX = arrays[9];		accelY = arrays[10];	accelZ = arrays[11];
+	colorR = arrays[12];	colorG = arrays[13];	colorB = arrays[14];	colorA = arrays[15];
+	color2R = arrays[16];	color2G = arrays[17];	color2B = arrays[18];	color2A = arrays[19];
+	size = arrays[20];
+	scratch = arrays[21];
+	energy = f ? reinterpret_cast<int*>(f + floatArrayCount * capacity) : 0;
+}
+
+Particle ParticleArrays::get(int i) const {
+	assert(i >= 0 && i < capacity);
+	Particle p;
+	p.pos = Vec3f(posX[i], posY[i], posZ[i]);
+	p.lastPos = Vec3f(lastPosX[i], lastPosY[i], lastPosZ[i]);
+	p.speed = Vec3f(speedX[i], speedY[i], speedZ[i]);
+	p.accel = Vec3f(accelX[i], accelY[i], accelZ[i]);
+	p.color = Vec4f(colorR[i], colorG[i], colorB[i], colorA[i]);
+	p.color2 = Vec4f(color2R[i], color2G[i], color2B[i], color2A[i]);
+	p.size = size[i];
+	p.energy = energy[i];
+	return p;
+}
+
+void ParticleArrays::set(int i, const Particle &p) {
+	assert(i >= 0 && i < capacity);
+	posX[i] = p.pos.x;			posY[i] = p.pos.y;			posZ[i] = p.pos.z;
+	lastPosX[i] = p.lastPos.x;	lastPosY[i] = p.lastPos.y;	lastPosZ[i] = p.lastPos.z;
+	speedX[i] = p.speed.x;		speedY[i] = p.speed.y;		speedZ[i] = p.speed.z;
+	accelX[i] = p.accel.x;		accelY[i] = p.accel.y;		accelZ[i] = p.accel.z;
+	colorR[i] = p.color.r;		colorG[i] = p.color.g;		colorB[i] = p.color.b;		colorA[i] = p.color.a;
+	color2R[i] = p.color2.r;	color2G[i] = p.color2.g;	color2B[i] = p.color2.b;	color2A[i] = p.color2.a;
+	size[i] = p.size;
+	energy[i] = p.energy;
+}
+
+void ParticleArrays::move(int from, int to) {
+	float *f = static_cast<float*>(block);
+	for (int i = 0; i < floatArrayCount - 1; ++i) { // not scratch
+		f[i * capacity + to] = f[i * capacity + from];
+	}
+	energy[to] = energy[from];
+}
+
+void ParticleArrays::integrate(int n) {
+	assert((n & 3) == 0);
+	const __m128i one = _mm_set1_epi32(1);
+	for (int i = 0; i < n; i += 4) {
+		__m128 x = _mm_load_ps(posX + i), y = _mm_load_ps(posY + i), z = _mm_load_ps(posZ + i);
+		_mm_store_ps(lastPosX + i, x);
+		_mm_store_ps(lastPosY + i, y);
+		_mm_store_ps(lastPosZ + i, z);
+		__m128 sx = _mm_load_ps(speedX + i), sy = _mm_load_ps(speedY + i), sz = _mm_load_ps(speedZ + i);
+		_mm_store_ps(posX + i, _mm_add_ps(x, sx));
+		_mm_store_ps(posY + i, _mm_add_ps(y, sy));
+		_mm_store_ps(posZ + i, _mm_add_ps(z, sz));
+		_mm_store_ps(speedX + i, _mm_add_ps(sx, _mm_load_ps(accelX + i)));
+		_mm_store_ps(speedY + i, _mm_add_ps(sy, _mm_load_ps(accelY + i)));
+		_mm_store_ps(speedZ + i, _mm_add_ps(sz, _mm_load_ps(accelZ + i)));
+		__m128i *e = reinterpret_cast<__m128i*>(energy + i);
+		_mm_store_si128(e, _mm_sub_epi32(_mm_load_si128(e), one));
+	}
+}
+
+void ParticleArrays::add(float *dst, const float *src, int n) {
+	assert((n & 3) == 0);
+	for (int i = 0; i < n; i += 4) {
+		_mm_store_ps(dst + i, _mm_add_ps(_mm_load_ps(dst + i), _mm_load_ps(src + i)));
+	}
+}
+
+void ParticleArrays::add(float *dst, float v, int n) {
+	assert((n & 3) == 0);
+	const __m128 vv = _mm_set1_ps(v);
+	for (int i = 0; i < n; i += 4) {
+		_mm_store_ps(dst + i, _mm_add_ps(_mm_load_ps(dst + i), vv));
+	}
+}
+
+void ParticleArrays::scale(float *dst, float v, int n) {
+	assert((n & 3) == 0);
+	const __m128 vv = _mm_set1_ps(v);
+	for (int i = 0; i < n; i += 4) {
+		_mm_store_ps(dst + i, _mm_mul_ps(_mm_load_ps(dst + i), vv));
+	}
+}
+
+void ParticleArrays::scalePositive(float *dst, float v, int n) {
+	assert((n & 3) == 0);
+	const __m128 vv = _mm_set1_ps(v);
+	const __m128 zero = _mm_setzero_ps();
+	for (int i = 0; i < n; i += 4) {
+		__m128 x = _mm_load_ps(dst + i);
+		__m128 mask = _mm_cmpgt_ps(x, zero);
+		x = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(x, vv)), _mm_andnot_ps(mask, x));
+		_mm_store_ps(dst + i, x);
+	}
+}
+
+void ParticleArrays::decrement(int *energy, int n) {
+	assert((n & 3) == 0);
+	const __m128i one = _mm_set1_epi32(1);
+	for (int i = 0; i < n; i += 4) {
+		__m128i *e = reinterpret_cast<__m128i*>(energy + i);
+		_mm_store_si128(e, _mm_sub_epi32(_mm_load_si128(e), one));
+	}
+}
+
+void ParticleArrays::energyRatio(float *ratio, const int *energy, float maxEnergy, int n) {
+	assert((n & 3) == 0);
+	const __m128 max = _mm_set1_ps(maxEnergy);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	for (int i = 0; i < n; i += 4) {
+		__m128 e = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(energy + i)));
+		_mm_store_ps(ratio + i, _mm_min_ps(_mm_max_ps(_mm_div_ps(e, max), zero), one));
+	}
+}
+
+void ParticleArrays::lerp(float *dst, const float *ratio, float a, float b, int n) {
+	assert((n & 3) == 0);
+	const __m128 va = _mm_set1_ps(a);
+	const __m128 vb = _mm_set1_ps(b);
+	const __m128 one = _mm_set1_ps(1.f);
+	for (int i = 0; i < n; i += 4) {
+		__m128 r = _mm_load_ps(ratio + i);
+		_mm_store_ps(dst + i, _mm_add_ps(_mm_mul_ps(va, r), _mm_mul_ps(vb, _mm_sub_ps(one, r))));
+	}
+}
+
 // =====================================================
 //	class ParticleSystemBase
 // =====================================================
@@ -118,7 +282,7 @@ ParticleSystem::ParticleSystem(int particleCount)
 		: ParticleSystemBase()
 		//, id(++idCounter)
 		, particleCount(particleCount)
-		, particles(0)
+		, deathTest(dtEnergy)
 		, state(sPlay)
 		, active(true)
 		, visible(true)
@@ -132,7 +296,7 @@ ParticleSystem::ParticleSystem(const ParticleSystemBase &model, int particleCoun
 		: ParticleSystemBase(model)
 		//, id(++idCounter)
 		, particleCount(particleCount)
-		, particles(0)
+		, deathTest(dtEnergy)
 		, state(sPlay)
 		, active(true)
 		, visible(true)
@@ -143,21 +307,19 @@ ParticleSystem::ParticleSystem(const ParticleSystemBase &model, int particleCoun
 }
 
 void ParticleSystem::initArray(ParticleUse use) {
-	assert(!particles);
-	particles = new Particle[particleCount];
+	assert(!particles.isAllocated());
+	particles.allocate(particleCount);
 	addParticleUse(use, particleCount);
 	this->use = use;
 }
 
 void ParticleSystem::freeArray() {
-	delete [] particles;
+	particles.release();
 	remParticleUse(use, particleCount);
-	particles = 0;
 	aliveParticleCount = 0;
 }
 
 ParticleSystem::~ParticleSystem() {
-	delete [] particles;
 	remParticleUse(use, particleCount);
 }
 
@@ -166,26 +328,19 @@ ParticleSystem::~ParticleSystem() {
 // updates all living particles and creates new ones
 void ParticleSystem::update() {
 	if (visible && state != sPause) {
-		for (int i = 0; i < aliveParticleCount; ++i) {
-			updateParticle(&particles[i]);
-			if (deathTest(&particles[i])) {
-				// kill the particle
-				killParticle(&particles[i]);
-
-				// mantain alive particles at front of the array
-				if (aliveParticleCount > 0) {
-					///@todo FIXME: this particle skips an update :(
-					particles[i] = particles[aliveParticleCount];
-				}
-			}
+		if (aliveParticleCount) {
+			updateParticles(ParticleArrays::padded(aliveParticleCount));
+			killDeadParticles();
 		}
 		if (state != sFade) {
 			float fCount = emissionRateRemainder + emissionRate;
 			int count = fCount;
 			emissionRateRemainder = fCount - count;
 			for (int i = 0; i < count; ++i) {
-				Particle *p = createParticle();
-				initParticle(p, i);
+				int ndx = createParticle();
+				Particle p = particles.get(ndx);
+				initParticle(&p, i);
+				particles.set(ndx, p);
 			}
 		}
 	}
@@ -215,26 +370,43 @@ void ParticleSystem::fade() {
 
 // =============== PROTECTED =========================
 
-// if there is one dead particle it returns it else, return the particle with
-// the least energy
-Particle *ParticleSystem::createParticle() {
+// if there is one dead particle it returns its index else, the index of the
+// particle with the least energy
+int ParticleSystem::createParticle() {
 	//if any dead particles
 	if (aliveParticleCount < particleCount) {
 		++aliveParticleCount;
-		return &particles[aliveParticleCount-1];
+		return aliveParticleCount - 1;
 	}
 
 	//if not
-	int minEnergy = particles[0].energy;
+	int minEnergy = particles.energy[0];
 	int minEnergyParticle = 0;
 	for (int i = 0; i < particleCount; ++i) {
-		if (particles[i].energy < minEnergy) {
-			minEnergy = particles[i].energy;
+		if (particles.energy[i] < minEnergy) {
+			minEnergy = particles.energy[i];
 			minEnergyParticle = i;
 		}
 	}
 
-	return &particles[minEnergyParticle];
+	return minEnergyParticle;
+}
+
+/** remove the particles the last update killed, each is replaced by the last live
+  * one, which has been updated already, so only the dead cost a copy */
+void ParticleSystem::killDeadParticles() {
+	int i = 0;
+	while (i < aliveParticleCount) {
+		bool dead = deathTest == dtEnergy ? particles.energy[i] <= 0 : particles.posY[i] < 0.f;
+		if (dead) {
+			--aliveParticleCount;
+			if (i != aliveParticleCount) {
+				particles.move(aliveParticleCount, i);
+			}
+		} else {
+			++i;
+		}
+	}
 }
 
 void ParticleSystem::initParticle(Particle *p, int particleIndex) {
@@ -248,11 +420,8 @@ void ParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->energy = getRandEnergy();
 }
 
-void ParticleSystem::updateParticle(Particle *p) {
-	p->lastPos = p->pos;
-	p->pos = p->pos + p->speed;
-	p->speed = p->speed + p->accel;
-	p->energy--;
+void ParticleSystem::updateParticles(int n) {
+	particles.integrate(n);
 }
 
 // ===========================================================================
@@ -268,6 +437,7 @@ RainParticleSystem::RainParticleSystem(int particleCount)
 	setColor(Vec4f(0.5f, 0.5f, 0.5f, 0.3f));
 	setColor2(Vec4f(0.5f, 0.5f, 0.5f, 0.0f));
 	setSpeed(0.2f);
+	deathTest = dtBelowGround;
 
 	initArray(ParticleUse::WEATHER);
 }
@@ -291,10 +461,6 @@ void RainParticleSystem::render(ParticleRenderer *pr, ModelRenderer *mr) {
 	pr->renderSystemLine(this);
 }
 
-bool RainParticleSystem::deathTest(Particle *p) {
-	return p->pos.y < 0;
-}
-
 // ===========================================================================
 //  SnowParticleSystem
 // ===========================================================================
@@ -305,6 +471,7 @@ SnowParticleSystem::SnowParticleSystem(int particleCount) : ParticleSystem(parti
 	setSize(0.2f);
 	setColor(Vec4f(0.8f, 0.8f, 0.8f, 0.8f));
 	setSpeed(0.025f);
+	deathTest = dtBelowGround;
 	initArray(ParticleUse::WEATHER);
 }
 
@@ -322,10 +489,6 @@ void SnowParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->speed.y += random.randRange(-0.005f, 0.005f);
 }
 
-bool SnowParticleSystem::deathTest(Particle *p) {
-	return p->pos.y < 0;
-}
-
 // ===========================================================================
 //  ParticleManager
 // ===========================================================================
@@ -335,7 +498,7 @@ ParticleManager::~ParticleManager(){
 }
 
 void ParticleManager::render(ParticleRenderer *pr, ModelRenderer *mr) const{
-	list<ParticleSystem*>::const_iterator it;
+	ParticleSystemList::const_iterator it;
 
 	for (it=particleSystems.begin(); it!=particleSystems.end(); ++it){
 		if((*it)->getVisible()){
@@ -345,17 +508,19 @@ void ParticleManager::render(ParticleRenderer *pr, ModelRenderer *mr) const{
 }
 
 void ParticleManager::update(){
-	list<ParticleSystem*>::iterator it;
-
-	for (it = particleSystems.begin(); it != particleSystems.end(); ++it) {
-		(*it)->update();
-		if ((*it)->isFinished()) {
-			delete *it;
-			*it = NULL;
+	// update, deleting finished systems and closing up the gaps as we go. By index,
+	// systems may be added while updating (they get updated this time too)
+	size_t out = 0;
+	for (size_t i = 0; i < particleSystems.size(); ++i) {
+		ParticleSystem *ps = particleSystems[i];
+		ps->update();
+		if (ps->isFinished()) {
+			delete ps;
+		} else {
+			particleSystems[out++] = ps;
 		}
 	}
-
-	particleSystems.remove(NULL);
+	particleSystems.resize(out);
 }
 
 void ParticleManager::manage(ParticleSystem *ps) {
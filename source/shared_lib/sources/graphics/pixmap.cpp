@@ -23,6 +23,7 @@
 #include "util.h"
 #include "math_util.h"
 #include "random.h"
+#include "simd.h"
 
 #include "leak_dumper.h"
 #include "FSFactory.hpp"
@@ -1446,4 +1447,63 @@ void PixmapCube::loadFaceTga(const string &path, int face){
 	faces[face].loadTga(path);
 }
 
+// =====================================================
+//	alpha fades
+// =====================================================
+
+bool fadeAlphaScalar(uint8 *dst, const uint8 *from, const uint8 *to, int n, float t){
+	bool pending= false;
+	for(int i=0; i<n; ++i){
+		if(to[i] != dst[i]){
+			float p0= from[i] / 255.f;
+			float p1= to[i] / 255.f;
+			dst[i]= static_cast<uint8>((p0 + (t * (p1 - p0))) * 255.f);
+			pending= pending || to[i] != dst[i];
+		}
+	}
+	return pending;
+}
+
+/** four of the bytes unpacked by fadeAlpha(), as floats */
+static inline __m128i fadeQuad(__m128i from, __m128i to, __m128 t){
+	const __m128 scale= _mm_set1_ps(255.f);
+	__m128 p0= _mm_div_ps(_mm_cvtepi32_ps(from), scale);
+	__m128 p1= _mm_div_ps(_mm_cvtepi32_ps(to), scale);
+	__m128 p= _mm_add_ps(p0, _mm_mul_ps(t, _mm_sub_ps(p1, p0)));
+	return _mm_cvttps_epi32(_mm_mul_ps(p, scale));
+}
+
+/** 16 pixels at a time, each step is the same IEEE single precision operation
+  * as the scalar code (no reciprocal approximations), so results match exactly */
+bool fadeAlpha(uint8 *dst, const uint8 *from, const uint8 *to, int n, float t){
+	const __m128i zero= _mm_setzero_si128();
+	const __m128 tt= _mm_set1_ps(t);
+	__m128i pending= zero;
+	int i= 0;
+	for(; i + 16 <= n; i+= 16){
+		__m128i d= _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+		__m128i b= _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i));
+		__m128i same= _mm_cmpeq_epi8(d, b);
+		if(_mm_movemask_epi8(same) == 0xFFFF){
+			continue;
+		}
+		__m128i a= _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+		// widen to 4 x 4 int32
+		__m128i aLo= _mm_unpacklo_epi8(a, zero), aHi= _mm_unpackhi_epi8(a, zero);
+		__m128i bLo= _mm_unpacklo_epi8(b, zero), bHi= _mm_unpackhi_epi8(b, zero);
+		__m128i r0= fadeQuad(_mm_unpacklo_epi16(aLo, zero), _mm_unpacklo_epi16(bLo, zero), tt);
+		__m128i r1= fadeQuad(_mm_unpackhi_epi16(aLo, zero), _mm_unpackhi_epi16(bLo, zero), tt);
+		__m128i r2= fadeQuad(_mm_unpacklo_epi16(aHi, zero), _mm_unpacklo_epi16(bHi, zero), tt);
+		__m128i r3= fadeQuad(_mm_unpackhi_epi16(aHi, zero), _mm_unpackhi_epi16(bHi, zero), tt);
+		// narrow back, results are 0..255 so the saturating packs just truncate
+		__m128i r= _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+		// keep the pixels already at their target
+		r= _mm_or_si128(_mm_and_si128(same, d), _mm_andnot_si128(same, r));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+		pending= _mm_or_si128(pending, _mm_andnot_si128(_mm_cmpeq_epi8(r, b), _mm_set1_epi8(-1)));
+	}
+	bool tailPending= fadeAlphaScalar(dst + i, from + i, to + i, n - i, t);
+	return tailPending || _mm_movemask_epi8(pending) != 0;
+}
+
 }}//end namespace
@@ -49,6 +49,10 @@ void Thread::resume() {
 	NOIMPL;
 }
 
+void Thread::yield() {
+	SDL_Delay(0);
+}
+
 bool Thread::join(int maxWaitMillis) {
 	SDL_WaitThread(thread, 0);
 	return true;
@@ -76,5 +80,27 @@ void Mutex::v() {
 	SDL_mutexV(mutex);
 }
 
+// =====================================
+//          Semaphore
+// =====================================
+
+Semaphore::Semaphore(int initialValue) {
+	semaphore = SDL_CreateSemaphore(initialValue);
+	if (semaphore == 0)
+		throw std::runtime_error("Couldn't initialize semaphore");
+}
+
+Semaphore::~Semaphore() {
+	SDL_DestroySemaphore(semaphore);
+}
+
+void Semaphore::p() {
+	SDL_SemWait(semaphore);
+}
+
+void Semaphore::v() {
+	SDL_SemPost(semaphore);
+}
+
 }
 }//end namespace
@@ -12,6 +12,8 @@
 #include "pch.h"
 #include "thread.h"
 
+#include <climits>
+
 #include "leak_dumper.h"
 
 namespace Shared { namespace Platform {
@@ -44,6 +46,10 @@ void Thread::resume() {
 	ResumeThread(thread);
 }
 
+void Thread::yield() {
+	Sleep(0);
+}
+
 bool Thread::join(int maxWaitMillis) {
 	return WaitForSingleObject(thread, maxWaitMillis) == WAIT_OBJECT_0;
 }
@@ -68,4 +74,24 @@ void Mutex::v() {
 	LeaveCriticalSection(&mutex);
 }
 
+// =====================================================
+// class Semaphore
+// =====================================================
+
+Semaphore::Semaphore(int initialValue) {
+	semaphore = CreateSemaphore(NULL, initialValue, LONG_MAX, NULL);
+}
+
+Semaphore::~Semaphore() {
+	CloseHandle(semaphore);
+}
+
+void Semaphore::p() {
+	WaitForSingleObject(semaphore, INFINITE);
+}
+
+void Semaphore::v() {
+	ReleaseSemaphore(semaphore, 1, NULL);
+}
+
 }}//end namespace
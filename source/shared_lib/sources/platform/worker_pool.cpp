@@ -0,0 +1,313 @@
+// ==============================================================
+//	This file is part of The Glest Advanced Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+
+#include "leak_dumper.h"
+
+#if defined(WIN32) || defined(WIN64)
+#	define THREAD_LOCAL __declspec(thread)
+#else
+#	define THREAD_LOCAL __thread
+#endif
+
+namespace Shared { namespace Platform {
+
+/** the pool the calling thread is a worker of (if any) and its index in that pool */
+static THREAD_LOCAL WorkerPool *t_pool = 0;
+static THREAD_LOCAL int         t_index = -1;
+
+// =====================================================
+//	class TaskDeque
+// =====================================================
+/** Fixed size Chase-Lev work-stealing deque. Only the owning worker calls
+  * push() & pop() (at the bottom), any thread may steal() (from the top). */
+class TaskDeque {
+public:
+	static const int capacity = 4096; // must be a power of 2
+
+private:
+	Task           *m_tasks[capacity];
+	volatile int    m_top;
+	volatile int    m_bottom;
+
+public:
+	TaskDeque() : m_top(0), m_bottom(0) {}
+
+	bool isEmpty() const { return m_bottom - m_top <= 0; }
+
+	/** @return false if the deque is full */
+	bool push(Task *task) {
+		int b = m_bottom;
+		if (b - m_top >= capacity) {
+			return false;
+		}
+		m_tasks[b & (capacity - 1)] = task;
+		memoryBarrier();
+		m_bottom = b + 1;
+		return true;
+	}
+
+	Task* pop() {
+		int b = m_bottom - 1;
+		m_bottom = b;
+		memoryBarrier();
+		int t = m_top;
+		if (t > b) { // empty
+			m_bottom = b + 1;
+			return 0;
+		}
+		Task *task = m_tasks[b & (capacity - 1)];
+		if (t == b) { // last task, race any thieves for it
+			if (!atomicCompareExchange(&m_top, t, t + 1)) {
+				task = 0;
+			}
+			m_bottom = b + 1;
+		}
+		return task;
+	}
+
+	Task* steal() {
+		int t = m_top;
+		memoryBarrier();
+		int b = m_bottom;
+		if (t >= b) {
+			return 0;
+		}
+		Task *task = m_tasks[t & (capacity - 1)];
+		if (!atomicCompareExchange(&m_top, t, t + 1)) {
+			return 0; // lost the race, the caller will look again
+		}
+		return task;
+	}
+};
+
+// =====================================================
+//	class TaskGroup
+// =====================================================
+
+void TaskGroup::run(Task *task) {
+	task->m_group = this;
+	task->m_poolOwned = false;
+	atomicAdd(&m_pending, 1);
+	m_pool.submit(task);
+}
+
+void TaskGroup::runOwned(Task *task) {
+	task->m_group = this;
+	task->m_poolOwned = true;
+	atomicAdd(&m_pending, 1);
+	m_pool.submit(task);
+}
+
+void TaskGroup::wait() {
+	while (m_pending > 0) {
+		if (!m_pool.runOneTask()) {
+			Thread::yield();
+		}
+	}
+	memoryBarrier(); // see everything the tasks wrote
+}
+
+// =====================================================
+//	class WorkerPool
+// =====================================================
+
+WorkerPool::WorkerPool(int threadCount)
+		: m_injectedCount(0), m_wake(0), m_sleepers(0), m_stealSeed(0), m_quit(false) {
+	for (int i = 1; i < threadCount; ++i) {
+		m_deques.push_back(new TaskDeque());
+	}
+	for (int i = 1; i < threadCount; ++i) {
+		m_workers.push_back(new Worker(*this, m_workers.size()));
+	}
+	for (int i = 0; i < m_workers.size(); ++i) {
+		m_workers[i]->start();
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	m_quit = true;
+	memoryBarrier();
+	for (int i = 0; i < m_workers.size(); ++i) {
+		m_wake.v();
+	}
+	for (int i = 0; i < m_workers.size(); ++i) {
+		m_workers[i]->join();
+		delete m_workers[i];
+		delete m_deques[i];
+	}
+}
+
+void WorkerPool::Worker::execute() {
+	t_pool = &m_pool;
+	t_index = m_index;
+	int idleSpins = 0;
+	while (!m_pool.m_quit) {
+		if (Task *task = m_pool.findTask(m_index)) {
+			m_pool.runTask(task);
+			idleSpins = 0;
+		} else if (++idleSpins < 64) {
+			Thread::yield();
+		} else {
+			// announce we're going to sleep before the last look, so a submit()
+			// racing with us either sees a sleeper or is seen by hasWork()
+			atomicAdd(&m_pool.m_sleepers, 1);
+			if (!m_pool.hasWork() && !m_pool.m_quit) {
+				m_pool.m_wake.p();
+			}
+			atomicAdd(&m_pool.m_sleepers, -1);
+			idleSpins = 0;
+		}
+	}
+}
+
+void WorkerPool::submit(Task *task) {
+	if (m_workers.empty()) {
+		runTask(task);
+		return;
+	}
+	if (t_pool == this) {
+		if (!m_deques[t_index]->push(task)) {
+			runTask(task); // deque full, just do it now
+			return;
+		}
+	} else {
+		MutexLock lock(m_injectedMutex);
+		m_injected.push_back(task);
+		atomicAdd(&m_injectedCount, 1);
+	}
+	if (m_sleepers > 0) {
+		m_wake.v();
+	}
+}
+
+Task* WorkerPool::popInjected() {
+	if (m_injectedCount <= 0) {
+		return 0;
+	}
+	MutexLock lock(m_injectedMutex);
+	if (m_injected.empty()) {
+		return 0;
+	}
+	Task *task = m_injected.front();
+	m_injected.pop_front();
+	atomicAdd(&m_injectedCount, -1);
+	return task;
+}
+
+/** find a task for thread self (a worker index, or -1 for threads outside the pool):
+  * its own newest task first, then a task from outside, then steal the oldest from
+  * another worker, starting from a different victim each time */
+Task* WorkerPool::findTask(int self) {
+	if (self >= 0) {
+		if (Task *task = m_deques[self]->pop()) {
+			return task;
+		}
+	}
+	if (Task *task = popInjected()) {
+		return task;
+	}
+	const int n = m_deques.size();
+	const int start = (atomicAdd(&m_stealSeed, 1) & 0x7fffffff) % n;
+	for (int i = 0; i < n; ++i) {
+		int victim = (start + i) % n;
+		if (victim != self) {
+			if (Task *task = m_deques[victim]->steal()) {
+				return task;
+			}
+		}
+	}
+	return 0;
+}
+
+bool WorkerPool::isWorkerThread() {
+	return t_pool != 0;
+}
+
+bool WorkerPool::hasWork() {
+	memoryBarrier();
+	if (m_injectedCount > 0) {
+		return true;
+	}
+	for (int i = 0; i < m_deques.size(); ++i) {
+		if (!m_deques[i]->isEmpty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkerPool::runTask(Task *task) {
+	TaskGroup *group = task->m_group;
+	bool owned = task->m_poolOwned;
+	task->execute();
+	if (owned) {
+		delete task;
+	}
+	memoryBarrier(); // publish the task's writes before it is counted done
+	atomicAdd(&group->m_pending, -1);
+}
+
+/** run one queued task on the calling thread, used by TaskGroup::wait()
+  * @return false if there was nothing to run */
+bool WorkerPool::runOneTask() {
+	if (m_workers.empty()) {
+		return false;
+	}
+	Task *task = findTask(t_pool == this ? t_index : -1);
+	if (task) {
+		runTask(task);
+		return true;
+	}
+	return false;
+}
+
+// =====================================================
+//	parallelFor
+// =====================================================
+
+/** Runs body over [begin, end), splitting off the top half as a new task
+  * until the range is no bigger than grain */
+class SplitRangeTask : public Task {
+	RangeTask  &m_body;
+	TaskGroup  &m_group;
+	int         m_begin, m_end, m_grain;
+
+public:
+	SplitRangeTask(RangeTask &body, TaskGroup &group, int begin, int end, int grain)
+			: m_body(body), m_group(group), m_begin(begin), m_end(end), m_grain(grain) {}
+
+	virtual void execute() {
+		int end = m_end;
+		while (end - m_begin > m_grain) {
+			int mid = m_begin + (end - m_begin) / 2;
+			m_group.runOwned(new SplitRangeTask(m_body, m_group, mid, end, m_grain));
+			end = mid;
+		}
+		m_body.execute(m_begin, end);
+	}
+};
+
+void WorkerPool::parallelFor(int count, int grain, RangeTask &task) {
+	if (count <= 0) {
+		return;
+	}
+	grain = std::max(grain, 1);
+	if (m_workers.empty() || count <= grain) {
+		task.execute(0, count);
+		return;
+	}
+	TaskGroup group(*this);
+	SplitRangeTask root(task, group, 0, count, grain);
+	group.run(&root);
+	group.wait();
+}
+
+}}//end namespace
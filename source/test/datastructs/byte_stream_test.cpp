@@ -0,0 +1,104 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "byte_stream_test.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *ByteStreamTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("ByteStreamTest");
+	ADD_TEST(ByteStreamTest, testVarintSizes);
+	ADD_TEST(ByteStreamTest, testRoundTrip);
+	ADD_TEST(ByteStreamTest, testTruncated);
+
+	return suiteOfTests;
+}
+
+static size_t uintSize(uint32 v) {
+	std::vector<uint8> bytes;
+	ByteWriter(bytes).writeVarUint(v);
+	return bytes.size();
+}
+
+static size_t intSize(int32 v) {
+	std::vector<uint8> bytes;
+	ByteWriter(bytes).writeVarInt(v);
+	return bytes.size();
+}
+
+/** seven bits a byte, small negatives as small as small positives */
+void ByteStreamTest::testVarintSizes() {
+	CPPUNIT_ASSERT_EQUAL(size_t(1), uintSize(0));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), uintSize(127));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), uintSize(128));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), uintSize(16383));
+	CPPUNIT_ASSERT_EQUAL(size_t(3), uintSize(16384));
+	CPPUNIT_ASSERT_EQUAL(size_t(5), uintSize(0xFFFFFFFF));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), intSize(-1));
+	CPPUNIT_ASSERT_EQUAL(size_t(1), intSize(-64));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), intSize(64));
+	CPPUNIT_ASSERT_EQUAL(size_t(5), intSize(-2147483647 - 1));
+}
+
+/** everything written reads back the same, in order */
+void ByteStreamTest::testRoundTrip() {
+	const int32 ints[] = { 0, 1, -1, 63, -64, 64, 1000000, -1000000, 2147483647, -2147483647 - 1 };
+	const int n = sizeof(ints) / sizeof(ints[0]);
+	std::vector<uint8> bytes;
+	ByteWriter writer(bytes);
+	for (int i = 0; i < n; ++i) {
+		writer.writeVarInt(ints[i]);
+		writer.writeVarUint(uint32(ints[i]));
+	}
+	writer.writeByte(0xAB);
+	const char raw[] = "raw";
+	writer.writeBytes(raw, 4);
+	CPPUNIT_ASSERT_EQUAL(bytes.size(), writer.size());
+
+	ByteReader reader(&bytes[0], bytes.size());
+	for (int i = 0; i < n; ++i) {
+		CPPUNIT_ASSERT_EQUAL(ints[i], reader.readVarInt());
+		CPPUNIT_ASSERT_EQUAL(uint32(ints[i]), reader.readVarUint());
+	}
+	CPPUNIT_ASSERT_EQUAL(uint8(0xAB), reader.readByte());
+	char back[4];
+	reader.readBytes(back, 4);
+	CPPUNIT_ASSERT(!strcmp(raw, back));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), reader.remaining());
+	CPPUNIT_ASSERT(reader.isGood());
+}
+
+/** reading past the end, or a varint too long or too big, gives zeros & clears isGood() */
+void ByteStreamTest::testTruncated() {
+	std::vector<uint8> bytes;
+	ByteWriter(bytes).writeVarUint(300);
+	ByteReader reader(&bytes[0], 1); // the first of two bytes
+	CPPUNIT_ASSERT_EQUAL(uint32(44), reader.readVarUint()); // 300 & 0x7F, then ran out
+	CPPUNIT_ASSERT(!reader.isGood());
+	CPPUNIT_ASSERT_EQUAL(uint8(0), reader.readByte());
+
+	const uint8 tooLong[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+	ByteReader reader2(tooLong, sizeof(tooLong));
+	reader2.readVarUint();
+	CPPUNIT_ASSERT(!reader2.isGood());
+
+	// a fifth byte can only hold the top four bits
+	const uint8 tooBig[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x1F };
+	ByteReader reader3(tooBig, sizeof(tooBig));
+	CPPUNIT_ASSERT_EQUAL(uint32(0), reader3.readVarUint());
+	CPPUNIT_ASSERT(!reader3.isGood());
+}
+
+}
@@ -0,0 +1,38 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_BYTE_STREAM_H_
+#define _TEST_BYTE_STREAM_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "byte_stream.h"
+
+namespace Test {
+
+// =====================================================
+//	class ByteStreamTest
+// =====================================================
+
+class ByteStreamTest : public CppUnit::TestFixture {
+public:
+	ByteStreamTest()	{}
+	~ByteStreamTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testVarintSizes();
+	void testRoundTrip();
+	void testTruncated();
+};
+
+}
+
+#endif //_TEST_BYTE_STREAM_H_
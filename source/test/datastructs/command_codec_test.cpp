@@ -0,0 +1,168 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "command_codec_test.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Glest::Net;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *CommandCodecTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("CommandCodecTest");
+	ADD_TEST(CommandCodecTest, testRoundTrip);
+	ADD_TEST(CommandCodecTest, testTruncated);
+	ADD_TEST(CommandCodecTest, testGarbled);
+	ADD_TEST(CommandCodecTest, testHashes);
+
+	return suiteOfTests;
+}
+
+static const int maxCommands = 16;
+
+/** a keyframe's worth of commands, two runs (a selection given an order) among
+  * singles, with negative unit ids & positions, out of order ids and every optional
+  * field */
+static int makeCommands(NetworkCommand *commands) {
+	const Vec2i noPos(-1);
+	int n = 0;
+	commands[n++] = NetworkCommand(NetworkCommandType::GIVE_COMMAND, 12, 3, Vec2i(40, 52), -1, -1, 0);
+	for (int id = 20; id < 25; ++id) {
+		commands[n++] = NetworkCommand(NetworkCommandType::GIVE_COMMAND, id, 7, Vec2i(-5, -3), -1, 9, 1 | 8);
+	}
+	commands[n++] = NetworkCommand(NetworkCommandType::GIVE_COMMAND, 2, 3, Vec2i(0, 130), 17, -1, 0);
+	commands[n++] = NetworkCommand(NetworkCommandType::CANCEL_COMMAND, -1, -1, noPos, -1, -1, 0);
+	commands[n++] = NetworkCommand(NetworkCommandType::SET_AUTO_ATTACK, 3000, -4, noPos, -1, -1, 4);
+	commands[n++] = NetworkCommand(NetworkCommandType::SET_AUTO_ATTACK, 2999, -4, noPos, -1, -1, 4);
+	commands[n++] = NetworkCommand(NetworkCommandType::SET_MEETING_POINT, -8000, 0, Vec2i(-200, 0), -1, -1, 0);
+	return n;
+}
+
+static void assertSame(const NetworkCommand &a, const NetworkCommand &b) {
+	CPPUNIT_ASSERT_EQUAL(int(a.getNetworkCommandType()), int(b.getNetworkCommandType()));
+	CPPUNIT_ASSERT_EQUAL(a.getUnitId(), b.getUnitId());
+	CPPUNIT_ASSERT_EQUAL(a.getCommandTypeId(), b.getCommandTypeId());
+	CPPUNIT_ASSERT(a.getPosition() == b.getPosition());
+	CPPUNIT_ASSERT_EQUAL(a.getProdTypeId(), b.getProdTypeId());
+	CPPUNIT_ASSERT_EQUAL(a.getTargetId(), b.getTargetId());
+	CPPUNIT_ASSERT_EQUAL(a.getFlags(), b.getFlags());
+}
+
+static int decode(const std::vector<uint8> &bytes, size_t size, NetworkCommand *commands) {
+	ByteReader reader(size ? &bytes[0] : 0, size);
+	return decodeCommands(reader, commands, maxCommands);
+}
+
+/** every field of every command comes back, and runs are smaller than the singles */
+void CommandCodecTest::testRoundTrip() {
+	NetworkCommand commands[maxCommands];
+	const int n = makeCommands(commands);
+	std::vector<uint8> bytes;
+	ByteWriter writer(bytes);
+	encodeCommands(writer, commands, n);
+	CPPUNIT_ASSERT(bytes.size() < n * sizeof(NetworkCommand) / 2);
+
+	NetworkCommand back[maxCommands];
+	CPPUNIT_ASSERT_EQUAL(n, decode(bytes, bytes.size(), back));
+	for (int i = 0; i < n; ++i) {
+		assertSame(commands[i], back[i]);
+	}
+
+	// an empty list is just the count
+	std::vector<uint8> empty;
+	ByteWriter emptyWriter(empty);
+	encodeCommands(emptyWriter, commands, 0);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), empty.size());
+	CPPUNIT_ASSERT_EQUAL(0, decode(empty, empty.size(), back));
+
+	// more than the reader has room for
+	ByteReader reader(&bytes[0], bytes.size());
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(reader, back, n - 1));
+}
+
+/** any list cut short is rejected, wherever the cut */
+void CommandCodecTest::testTruncated() {
+	NetworkCommand commands[maxCommands];
+	const int n = makeCommands(commands);
+	std::vector<uint8> bytes;
+	ByteWriter writer(bytes);
+	encodeCommands(writer, commands, n);
+
+	NetworkCommand back[maxCommands];
+	for (size_t size = 0; size < bytes.size(); ++size) {
+		CPPUNIT_ASSERT_EQUAL(-1, decode(bytes, size, back));
+	}
+}
+
+/** hand made lists that are the right length but wrong */
+void CommandCodecTest::testGarbled() {
+	NetworkCommand back[maxCommands];
+
+	// one command, dictionary { 5 }, a record of the given tag & dictionary index
+	// for unit 1, the run length follows the index if the tag has the run bit
+	const uint8 good[]		= { 1, 1, 10, 0x00, 0, 2 };
+	const uint8 badType[]	= { 1, 1, 10, 0x07, 0, 2 };		// one past SET_MEETING_POINT
+	const uint8 badIndex[]	= { 1, 1, 10, 0x00, 1, 2 };		// dictionary has one entry
+	const uint8 longRun[]	= { 2, 1, 10, 0x80, 0, 1, 2, 2, 2 }; // a run of three in a list of two
+	const uint8 bigDict[]	= { 1, 2, 10, 12, 0x00, 0, 2 };	// more type ids than commands
+
+	ByteReader goodReader(good, sizeof(good));
+	CPPUNIT_ASSERT_EQUAL(1, decodeCommands(goodReader, back, maxCommands));
+	CPPUNIT_ASSERT_EQUAL(1, back[0].getUnitId());
+	CPPUNIT_ASSERT_EQUAL(5, back[0].getCommandTypeId());
+
+	ByteReader badTypeReader(badType, sizeof(badType));
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(badTypeReader, back, maxCommands));
+	ByteReader badIndexReader(badIndex, sizeof(badIndex));
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(badIndexReader, back, maxCommands));
+	ByteReader longRunReader(longRun, sizeof(longRun));
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(longRunReader, back, maxCommands));
+	ByteReader bigDictReader(bigDict, sizeof(bigDict));
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(bigDictReader, back, maxCommands));
+
+	// a count that overflows a varint
+	const uint8 badCount[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x1F };
+	ByteReader badCountReader(badCount, sizeof(badCount));
+	CPPUNIT_ASSERT_EQUAL(-1, decodeCommands(badCountReader, back, maxCommands));
+}
+
+/** a SyncHashMessage's hashes come back whole, and a list cut short or longer
+  * than asked for is rejected */
+void CommandCodecTest::testHashes() {
+	vector<WorldHash::Entry> hashes;
+	hashes.push_back(WorldHash::Entry(0, 0));
+	hashes.push_back(WorldHash::Entry(-7, 0xFFFFFFFFFFFFFFFFull));
+	hashes.push_back(WorldHash::Entry(123456, 0x0123456789ABCDEFull));
+	std::vector<uint8> bytes;
+	ByteWriter writer(bytes);
+	encodeHashes(writer, hashes);
+
+	vector<WorldHash::Entry> back;
+	ByteReader reader(&bytes[0], bytes.size());
+	CPPUNIT_ASSERT(decodeHashes(reader, back, 3));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), reader.remaining());
+	CPPUNIT_ASSERT_EQUAL(hashes.size(), back.size());
+	for (size_t i = 0; i < hashes.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(hashes[i].id, back[i].id);
+		CPPUNIT_ASSERT(hashes[i].hash == back[i].hash);
+	}
+
+	for (size_t size = 0; size < bytes.size(); ++size) {
+		ByteReader shortReader(size ? &bytes[0] : 0, size);
+		CPPUNIT_ASSERT(!decodeHashes(shortReader, back, 3));
+	}
+	ByteReader longReader(&bytes[0], bytes.size());
+	CPPUNIT_ASSERT(!decodeHashes(longReader, back, 2));
+}
+
+}
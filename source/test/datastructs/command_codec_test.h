@@ -0,0 +1,39 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_COMMAND_CODEC_H_
+#define _TEST_COMMAND_CODEC_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "command_codec.h"
+
+namespace Test {
+
+// =====================================================
+//	class CommandCodecTest
+// =====================================================
+
+class CommandCodecTest : public CppUnit::TestFixture {
+public:
+	CommandCodecTest()	{}
+	~CommandCodecTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testRoundTrip();
+	void testTruncated();
+	void testGarbled();
+	void testHashes();
+};
+
+}
+
+#endif //_TEST_COMMAND_CODEC_H_
@@ -0,0 +1,78 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <algorithm>
+#include <cppunit/extensions/HelperMacros.h>
+#include "hash64_test.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *Hash64Test::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("Hash64Test");
+	ADD_TEST(Hash64Test, testRepeatable);
+	ADD_TEST(Hash64Test, testOrder);
+	ADD_TEST(Hash64Test, testSingleChange);
+	ADD_TEST(Hash64Test, testKnownAnswer);
+
+	return suiteOfTests;
+}
+
+static uint64 hashOf(const int *values, int n) {
+	Hash64 hash;
+	for (int i = 0; i < n; ++i) {
+		hash.add(values[i]);
+	}
+	return hash.getHash();
+}
+
+/** the same values give the same hash, every time */
+void Hash64Test::testRepeatable() {
+	const int values[] = { 17, -3, 0, 1024, 2147483647 };
+	CPPUNIT_ASSERT(hashOf(values, 5) == hashOf(values, 5));
+	CPPUNIT_ASSERT(Hash64().getHash() == Hash64().getHash());
+}
+
+/** swapping two values, or adding a zero, changes the hash */
+void Hash64Test::testOrder() {
+	const int a[] = { 1, 2, 3 };
+	const int b[] = { 2, 1, 3 };
+	const int c[] = { 1, 2, 3, 0 };
+	CPPUNIT_ASSERT(hashOf(a, 3) != hashOf(b, 3));
+	CPPUNIT_ASSERT(hashOf(a, 3) != hashOf(c, 4));
+}
+
+/** a unit's worth of values, each changed by one in turn, all give different hashes */
+void Hash64Test::testSingleChange() {
+	int values[] = { 1200, 7, 64, 80, 350, 120, 3 };
+	const int n = sizeof(values) / sizeof(values[0]);
+	std::vector<uint64> hashes;
+	hashes.push_back(hashOf(values, n));
+	for (int i = 0; i < n; ++i) {
+		++values[i];
+		hashes.push_back(hashOf(values, n));
+		--values[i];
+	}
+	std::sort(hashes.begin(), hashes.end());
+	CPPUNIT_ASSERT(std::unique(hashes.begin(), hashes.end()) == hashes.end());
+}
+
+/** peers built with different compilers, or for different cpus, must agree on
+  * every hash, these were worked out from the algorithm, not by running this code */
+void Hash64Test::testKnownAnswer() {
+	const int values[] = { 17, -3, 0, 1024, 2147483647 };
+	CPPUNIT_ASSERT(Hash64().getHash() == 0xEFD01F60BA992926ull);
+	CPPUNIT_ASSERT(hashOf(values, 5) == 0xBBF2EDE04ADBB6E1ull);
+}
+
+}
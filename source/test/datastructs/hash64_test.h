@@ -0,0 +1,39 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_HASH64_H_
+#define _TEST_HASH64_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "checksum.h"
+
+namespace Test {
+
+// =====================================================
+//	class Hash64Test
+// =====================================================
+
+class Hash64Test : public CppUnit::TestFixture {
+public:
+	Hash64Test()	{}
+	~Hash64Test()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testRepeatable();
+	void testOrder();
+	void testSingleChange();
+	void testKnownAnswer();
+};
+
+}
+
+#endif //_TEST_HASH64_H_
@@ -0,0 +1,113 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "id_table_test.h"
+
+#include "leak_dumper.h"
+
+using Shared::Util::IdTable;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *IdTableTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("IdTableTest");
+	ADD_TEST(IdTableTest, testLookup);
+	ADD_TEST(IdTableTest, testStaleHandles);
+	ADD_TEST(IdTableTest, testPagesFreed);
+	ADD_TEST(IdTableTest, testStaleHandlesAcrossPages);
+
+	return suiteOfTests;
+}
+
+typedef IdTable<int> Table;
+
+void IdTableTest::testLookup() {
+	Table table;
+	int a = 1, b = 2;
+	CPPUNIT_ASSERT(!table.get(0));
+	CPPUNIT_ASSERT(!table.get(-1));
+	CPPUNIT_ASSERT(!table.get(123456));
+	table.set(3, &a, 0);
+	table.set(Table::pageSize * 5 + 7, &b, 1);
+	CPPUNIT_ASSERT(table.get(3) == &a);
+	CPPUNIT_ASSERT(table.get(Table::pageSize * 5 + 7) == &b);
+	CPPUNIT_ASSERT(!table.get(4));
+	CPPUNIT_ASSERT_EQUAL(0, table.getPos(3));
+	CPPUNIT_ASSERT_EQUAL(-1, table.getPos(4));
+	CPPUNIT_ASSERT_EQUAL(2, table.getPageCount());
+	table.setPos(3, 9);
+	CPPUNIT_ASSERT_EQUAL(9, table.getPos(3));
+	table.clear(3);
+	CPPUNIT_ASSERT(!table.get(3));
+	CPPUNIT_ASSERT_EQUAL(-1, table.getPos(3));
+	table.clear(3); // twice is harmless
+	table.clear(99999);
+}
+
+/** a handle outlives its object, even if the id is used again */
+void IdTableTest::testStaleHandles() {
+	Table table;
+	int a = 1, b = 2;
+	table.set(10, &a, 0);
+	Table::Handle handle = table.getHandle(10);
+	CPPUNIT_ASSERT(table.get(handle) == &a);
+	table.clear(10);
+	CPPUNIT_ASSERT(!table.get(handle));
+	table.set(10, &b, 0);
+	CPPUNIT_ASSERT(table.get(10) == &b);
+	CPPUNIT_ASSERT(!table.get(handle));
+	CPPUNIT_ASSERT(table.get(table.getHandle(10)) == &b);
+	CPPUNIT_ASSERT(!table.get(Table::Handle()));
+}
+
+/** a page goes once every id in it has come and gone, not before */
+void IdTableTest::testPagesFreed() {
+	Table table;
+	int x = 0;
+	for (int id = 0; id < Table::pageSize + 1; ++id) {
+		table.set(id, &x, id);
+	}
+	CPPUNIT_ASSERT_EQUAL(2, table.getPageCount());
+	for (int id = 0; id < Table::pageSize - 1; ++id) {
+		table.clear(id);
+	}
+	CPPUNIT_ASSERT_EQUAL(2, table.getPageCount());
+	CPPUNIT_ASSERT_EQUAL(Table::pageSize - 1, table.getPos(Table::pageSize - 1));
+	table.clear(Table::pageSize - 1);
+	CPPUNIT_ASSERT_EQUAL(1, table.getPageCount());
+	CPPUNIT_ASSERT(!table.get(5));
+	CPPUNIT_ASSERT_EQUAL(Table::pageSize, table.getPos(Table::pageSize));
+}
+
+/** a handle stays stale when its page is freed & allocated again, or the table cleared */
+void IdTableTest::testStaleHandlesAcrossPages() {
+	Table table;
+	int a = 1, b = 2;
+	for (int id = 0; id < Table::pageSize; ++id) {
+		table.set(id, &a, id);
+	}
+	Table::Handle handle = table.getHandle(5);
+	for (int id = 0; id < Table::pageSize; ++id) {
+		table.clear(id);
+	}
+	CPPUNIT_ASSERT_EQUAL(0, table.getPageCount());
+	table.set(5, &b, 0);
+	CPPUNIT_ASSERT(table.get(5) == &b);
+	CPPUNIT_ASSERT(!table.get(handle));
+
+	handle = table.getHandle(5);
+	table.clear();
+	table.set(5, &a, 0);
+	CPPUNIT_ASSERT(!table.get(handle));
+	CPPUNIT_ASSERT(table.get(table.getHandle(5)) == &a);
+}
+
+}
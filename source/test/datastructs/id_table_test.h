@@ -0,0 +1,39 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_ID_TABLE_H_
+#define _TEST_ID_TABLE_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "id_table.h"
+
+namespace Test {
+
+// =====================================================
+//	class IdTableTest
+// =====================================================
+
+class IdTableTest : public CppUnit::TestFixture {
+public:
+	IdTableTest()	{}
+	~IdTableTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testLookup();
+	void testStaleHandles();
+	void testPagesFreed();
+	void testStaleHandlesAcrossPages();
+};
+
+}
+
+#endif //_TEST_ID_TABLE_H_
@@ -0,0 +1,73 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "slab_pool_test.h"
+
+#include <set>
+
+#include "leak_dumper.h"
+
+using Shared::Util::SlabPool;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *SlabPoolTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("SlabPoolTest");
+	ADD_TEST(SlabPoolTest, testSlotsReused);
+	ADD_TEST(SlabPoolTest, testGrowsBySlab);
+
+	return suiteOfTests;
+}
+
+struct Chunk {
+	double  d;
+	int     n[5];
+};
+
+/** released storage is handed out again before the pool grows */
+void SlabPoolTest::testSlotsReused() {
+	SlabPool<Chunk, 8> pool;
+	void *a = pool.allocate();
+	void *b = pool.allocate();
+	CPPUNIT_ASSERT(a != b);
+	CPPUNIT_ASSERT_EQUAL(2, pool.getUsedCount());
+	pool.release(a);
+	CPPUNIT_ASSERT_EQUAL(1, pool.getUsedCount());
+	CPPUNIT_ASSERT(pool.allocate() == a);
+	pool.release(a);
+	pool.release(b);
+	CPPUNIT_ASSERT_EQUAL(0, pool.getUsedCount());
+	CPPUNIT_ASSERT_EQUAL(8, pool.getCapacity());
+}
+
+/** a new slab only when every slot is in use, slots never overlap */
+void SlabPoolTest::testGrowsBySlab() {
+	SlabPool<Chunk, 8> pool;
+	std::set<char*> slots;
+	for (int i = 0; i < 20; ++i) {
+		char *p = static_cast<char*>(pool.allocate());
+		CPPUNIT_ASSERT(reinterpret_cast<size_t>(p) % sizeof(double) == 0);
+		slots.insert(p);
+	}
+	CPPUNIT_ASSERT_EQUAL(size_t(20), slots.size());
+	CPPUNIT_ASSERT_EQUAL(24, pool.getCapacity());
+	char *prev = 0;
+	for (std::set<char*>::iterator it = slots.begin(); it != slots.end(); ++it) {
+		CPPUNIT_ASSERT(!prev || *it - prev >= int(sizeof(Chunk)));
+		prev = *it;
+	}
+	for (std::set<char*>::iterator it = slots.begin(); it != slots.end(); ++it) {
+		pool.release(*it);
+	}
+	CPPUNIT_ASSERT_EQUAL(0, pool.getUsedCount());
+}
+
+}
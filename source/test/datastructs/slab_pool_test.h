@@ -0,0 +1,37 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_SLAB_POOL_H_
+#define _TEST_SLAB_POOL_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "slab_pool.h"
+
+namespace Test {
+
+// =====================================================
+//	class SlabPoolTest
+// =====================================================
+
+class SlabPoolTest : public CppUnit::TestFixture {
+public:
+	SlabPoolTest()	{}
+	~SlabPoolTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testSlotsReused();
+	void testGrowsBySlab();
+};
+
+}
+
+#endif //_TEST_SLAB_POOL_H_
@@ -0,0 +1,83 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "spsc_queue_test.h"
+
+#include "leak_dumper.h"
+
+using Shared::Util::SpscQueue;
+using Shared::Platform::Thread;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *SpscQueueTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("SpscQueueTest");
+	ADD_TEST(SpscQueueTest, testFifoAndBounds);
+	ADD_TEST(SpscQueueTest, testProducerThread);
+
+	return suiteOfTests;
+}
+
+/** items come out in the order pushed, push fails when full & pop when empty */
+void SpscQueueTest::testFifoAndBounds() {
+	SpscQueue<int, 4> queue;
+	int item = -1;
+	CPPUNIT_ASSERT(queue.empty());
+	CPPUNIT_ASSERT(!queue.pop(item));
+	for (int round = 0; round < 3; ++round) { // wrap around the slots a few times
+		for (int i = 0; i < 4; ++i) {
+			CPPUNIT_ASSERT(queue.push(round * 10 + i));
+		}
+		CPPUNIT_ASSERT(!queue.push(99));
+		CPPUNIT_ASSERT_EQUAL(4, queue.size());
+		for (int i = 0; i < 4; ++i) {
+			CPPUNIT_ASSERT(queue.pop(item));
+			CPPUNIT_ASSERT_EQUAL(round * 10 + i, item);
+		}
+		CPPUNIT_ASSERT(!queue.pop(item));
+	}
+}
+
+const int producedCount = 100000;
+
+/** pushes 0 .. producedCount-1, spinning while the queue is full */
+class Producer : public Thread {
+	SpscQueue<int, 64> &m_queue;
+public:
+	Producer(SpscQueue<int, 64> &queue) : m_queue(queue) {}
+	virtual void execute() {
+		for (int i = 0; i < producedCount; ++i) {
+			while (!m_queue.push(i)) {
+				Thread::yield();
+			}
+		}
+	}
+};
+
+/** everything a producer thread pushes is popped once, in order */
+void SpscQueueTest::testProducerThread() {
+	SpscQueue<int, 64> queue;
+	Producer producer(queue);
+	producer.start();
+	int expected = 0, item;
+	while (expected < producedCount) {
+		if (queue.pop(item)) {
+			CPPUNIT_ASSERT_EQUAL(expected, item);
+			++expected;
+		} else {
+			Thread::yield();
+		}
+	}
+	producer.join();
+	CPPUNIT_ASSERT(queue.empty());
+}
+
+}
@@ -0,0 +1,37 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_SPSC_QUEUE_H_
+#define _TEST_SPSC_QUEUE_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "spsc_queue.h"
+
+namespace Test {
+
+// =====================================================
+//	class SpscQueueTest
+// =====================================================
+
+class SpscQueueTest : public CppUnit::TestFixture {
+public:
+	SpscQueueTest()		{}
+	~SpscQueueTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testFifoAndBounds();
+	void testProducerThread();
+};
+
+}
+
+#endif //_TEST_SPSC_QUEUE_H_
@@ -0,0 +1,103 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "worker_pool_test.h"
+
+#include <vector>
+
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *WorkerPoolTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("WorkerPoolTest");
+	ADD_TEST(WorkerPoolTest, testParallelFor);
+	ADD_TEST(WorkerPoolTest, testNestedTasks);
+	ADD_TEST(WorkerPoolTest, testSingleThread);
+
+	return suiteOfTests;
+}
+
+/** counts visits to each index */
+class CountVisits : public RangeTask {
+	std::vector<int> &m_visits;
+public:
+	CountVisits(std::vector<int> &visits) : m_visits(visits) {}
+	virtual void execute(int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			++m_visits[i];
+		}
+	}
+};
+
+/** spawns two children until depth reaches zero, counting the leaves */
+class TreeTask : public Task {
+	TaskGroup    &m_group;
+	int           m_depth;
+	volatile int *m_leaves;
+public:
+	TreeTask(TaskGroup &group, int depth, volatile int *leaves)
+			: m_group(group), m_depth(depth), m_leaves(leaves) {}
+	virtual void execute() {
+		if (m_depth == 0) {
+			atomicAdd(m_leaves, 1);
+			return;
+		}
+		m_group.runOwned(new TreeTask(m_group, m_depth - 1, m_leaves));
+		m_group.runOwned(new TreeTask(m_group, m_depth - 1, m_leaves));
+	}
+};
+
+void WorkerPoolTest::testParallelFor() {
+	WorkerPool pool(4);
+	for (int n = 0; n < 2000; n += 97) {
+		for (int grain = 1; grain < 64; grain *= 3) {
+			std::vector<int> visits(n, 0);
+			CountVisits task(visits);
+			pool.parallelFor(n, grain, task);
+			for (int i = 0; i < n; ++i) {
+				CPPUNIT_ASSERT_EQUAL(1, visits[i]);
+			}
+		}
+	}
+}
+
+void WorkerPoolTest::testNestedTasks() {
+	WorkerPool pool(4);
+	volatile int leaves = 0;
+	{
+		TaskGroup group(pool);
+		group.runOwned(new TreeTask(group, 12, &leaves));
+		group.wait();
+		CPPUNIT_ASSERT(group.isDone());
+	}
+	CPPUNIT_ASSERT_EQUAL(1 << 12, int(leaves));
+}
+
+void WorkerPoolTest::testSingleThread() {
+	WorkerPool pool(1);
+	CPPUNIT_ASSERT_EQUAL(1, pool.getThreadCount());
+	std::vector<int> visits(100, 0);
+	CountVisits task(visits);
+	pool.parallelFor(100, 8, task);
+	for (int i = 0; i < 100; ++i) {
+		CPPUNIT_ASSERT_EQUAL(1, visits[i]);
+	}
+	volatile int leaves = 0;
+	TaskGroup group(pool);
+	group.runOwned(new TreeTask(group, 6, &leaves));
+	group.wait();
+	CPPUNIT_ASSERT_EQUAL(1 << 6, int(leaves));
+}
+
+}
@@ -0,0 +1,38 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_WORKER_POOL_H_
+#define _TEST_WORKER_POOL_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "worker_pool.h"
+
+namespace Test {
+
+// =====================================================
+//	class WorkerPoolTest
+// =====================================================
+
+class WorkerPoolTest : public CppUnit::TestFixture {
+public:
+	WorkerPoolTest()	{}
+	~WorkerPoolTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testParallelFor();
+	void testNestedTasks();
+	void testSingleThread();
+};
+
+}
+
+#endif //_TEST_WORKER_POOL_H_
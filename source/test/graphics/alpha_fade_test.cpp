@@ -0,0 +1,124 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "alpha_fade_test.h"
+
+#include <vector>
+
+#include "leak_dumper.h"
+
+using namespace Shared::Graphics;
+using Shared::Platform::uint8;
+using Shared::Platform::uint32;
+using std::vector;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *AlphaFadeTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("AlphaFadeTest");
+	ADD_TEST(AlphaFadeTest, testMatchesScalar);
+	ADD_TEST(AlphaFadeTest, testSettledPixelsUntouched);
+	ADD_TEST(AlphaFadeTest, testFadeCompletes);
+
+	return suiteOfTests;
+}
+
+/** fills buffers with fog texture like values, runs of the few alphas the minimap
+  * uses with the odd arbitrary byte, and about a third of dst already at its target */
+class FadeBuffers {
+	uint32 m_seed;
+
+	uint8 nextByte() {
+		m_seed = m_seed * 1664525u + 1013904223u;
+		return uint8(m_seed >> 24);
+	}
+	uint8 nextAlpha() {
+		static const uint8 alphas[] = { 0, 127, 255 };
+		uint8 r = nextByte();
+		return r < 200 ? alphas[r % 3] : nextByte();
+	}
+
+public:
+	vector<uint8> from, to, dst;
+
+	FadeBuffers(int n, uint32 seed) : m_seed(seed), from(n), to(n), dst(n) {
+		for (int i = 0; i < n; ++i) {
+			from[i] = nextAlpha();
+			to[i] = nextAlpha();
+			dst[i] = nextByte() < 85 ? to[i] : nextAlpha();
+		}
+	}
+};
+
+static uint8* ptr(vector<uint8> &v) {
+	return v.empty() ? 0 : &v[0];
+}
+
+static const float fadeSteps[] = { 0.f, 0.1f, 0.25f, 1.f / 3.f, 0.5f, 0.7f, 0.999f, 1.f };
+static const int numFadeSteps = sizeof(fadeSteps) / sizeof(fadeSteps[0]);
+
+/** every length from 0 to 80 (all the tail cases), and a few map sized rows, for
+  * each step of a fade, bytes & return value the same as the pixel by pixel path */
+void AlphaFadeTest::testMatchesScalar() {
+	vector<int> lengths;
+	for (int n = 0; n <= 80; ++n) {
+		lengths.push_back(n);
+	}
+	lengths.push_back(256);
+	lengths.push_back(1000);
+	for (int li = 0; li < lengths.size(); ++li) {
+		const int n = lengths[li];
+		FadeBuffers buf(n, 12345 + n);
+		vector<uint8> simdDst(buf.dst), scalarDst(buf.dst);
+		for (int s = 0; s < numFadeSteps; ++s) {
+			bool simdPending = fadeAlpha(ptr(simdDst), ptr(buf.from), ptr(buf.to), n, fadeSteps[s]);
+			bool scalarPending = fadeAlphaScalar(ptr(scalarDst), ptr(buf.from), ptr(buf.to), n, fadeSteps[s]);
+			CPPUNIT_ASSERT_EQUAL(scalarPending, simdPending);
+			CPPUNIT_ASSERT(simdDst == scalarDst);
+		}
+	}
+}
+
+/** pixels already at their target keep their value, whatever the source says */
+void AlphaFadeTest::testSettledPixelsUntouched() {
+	const int n = 40;
+	vector<uint8> from(n, 255), to(n), dst(n);
+	for (int i = 0; i < n; ++i) {
+		to[i] = i % 2 ? 0 : 127;
+		dst[i] = i % 3 ? to[i] : 255;
+	}
+	vector<uint8> before(dst);
+	fadeAlpha(&dst[0], &from[0], &to[0], n, 0.5f);
+	for (int i = 0; i < n; ++i) {
+		if (before[i] == to[i]) {
+			CPPUNIT_ASSERT_EQUAL(int(to[i]), int(dst[i]));
+		} else {
+			CPPUNIT_ASSERT(dst[i] > to[i] && dst[i] < from[i]); // half way
+		}
+	}
+}
+
+/** once a row has faded all the way and reports nothing pending, it stays put */
+void AlphaFadeTest::testFadeCompletes() {
+	const int n = 64;
+	FadeBuffers buf(n, 777);
+	bool pending = true;
+	for (int i = 0; i < 4 && pending; ++i) {
+		pending = fadeAlpha(&buf.dst[0], &buf.to[0], &buf.to[0], n, 1.f);
+	}
+	CPPUNIT_ASSERT(!pending);
+	CPPUNIT_ASSERT(buf.dst == buf.to);
+	vector<uint8> settled(buf.dst);
+	CPPUNIT_ASSERT(!fadeAlpha(&buf.dst[0], &buf.from[0], &buf.to[0], n, 0.3f));
+	CPPUNIT_ASSERT(buf.dst == settled);
+}
+
+}
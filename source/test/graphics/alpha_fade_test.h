@@ -0,0 +1,38 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+#ifndef _TEST_ALPHA_FADE_H_
+#define _TEST_ALPHA_FADE_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "pixmap.h"
+
+namespace Test {
+
+// =====================================================
+//	class AlphaFadeTest
+// =====================================================
+
+class AlphaFadeTest : public CppUnit::TestFixture {
+public:
+	AlphaFadeTest()		{}
+	~AlphaFadeTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testMatchesScalar();
+	void testSettledPixelsUntouched();
+	void testFadeCompletes();
+};
+
+}
+
+#endif //_TEST_ALPHA_FADE_H_
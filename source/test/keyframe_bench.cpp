@@ -0,0 +1,166 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+// Bandwidth benchmark for the keyframe wire format, measures bytes per keyframe with
+// the varint/delta command encoding, world hash included, against the old fixed
+// layout (an 11 byte header & 16 bytes a command), over an 8 player game's worth of
+// keyframes. The game is generated, eight players issuing orders at about 120
+// actions a minute, mostly to selections, with the odd production & build order.
+// Each keyframe is encoded and decoded again (a loopback), and the commands compared
+// field by field.
+// Not part of the test suite, run it by hand: keyframe_bench [keyframes] [actions/min]
+
+#include "pch.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "command_codec.h"
+#include "random.h"
+#include "timer.h"
+
+#include "leak_dumper.h"
+
+using namespace Glest::Net;
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using std::cout;
+using std::endl;
+
+const int playerCount = 8;
+const int keyFramesPerSecond = 40 / 5; // world fps / GameConstants::networkFramePeriod
+const int oldHeaderSize = 4 + 11;		// MsgHeader + the old KeyFrameMsgHeader
+const Vec2i noPos(-1);
+
+/** a player's army, unit ids handed out by the one counter all players share */
+struct BenchPlayer {
+	std::vector<int> units;
+};
+
+/** the orders one player gives in one keyframe's worth of frames */
+void giveOrders(Random &random, BenchPlayer &player, int &nextUnitId, std::vector<NetworkCommand> &out) {
+	const int kind = random.randRange(0, 99);
+	const Vec2i pos(random.randRange(0, 255), random.randRange(0, 255));
+	if (kind < 60) { // move / attack a selection
+		const int size = std::min(int(player.units.size()), random.randRange(1, 12));
+		const int first = random.randRange(0, player.units.size() - size);
+		const int cmdType = random.randRange(0, 2) ? 3 : 5;
+		const int target = random.randRange(0, 3) ? -1 : random.randRange(0, nextUnitId);
+		for (int i = 0; i < size; ++i) {
+			out.push_back(NetworkCommand(NetworkCommandType::GIVE_COMMAND, player.units[first + i],
+				cmdType, target == -1 ? pos : noPos, -1, target, size > 1 ? 8 : 0));
+		}
+	} else if (kind < 85) { // produce, the new unit joins the army
+		const int producer = player.units[random.randRange(0, player.units.size() - 1)];
+		out.push_back(NetworkCommand(NetworkCommandType::GIVE_COMMAND, producer,
+			random.randRange(10, 40), noPos, random.randRange(0, 30), -1, 0));
+		player.units.push_back(nextUnitId++);
+	} else if (kind < 95) { // build, facing goes in the target id
+		const int builder = player.units[random.randRange(0, player.units.size() - 1)];
+		out.push_back(NetworkCommand(NetworkCommandType::GIVE_COMMAND, builder,
+			random.randRange(40, 60), pos, random.randRange(0, 30), random.randRange(0, 3), 1));
+	} else { // toggles & cancels
+		const int unit = player.units[random.randRange(0, player.units.size() - 1)];
+		if (random.randRange(0, 1)) {
+			out.push_back(NetworkCommand(NetworkCommandType::CANCEL_COMMAND, unit, -1, pos, -1, -1, 0));
+		} else {
+			out.push_back(NetworkCommand(NetworkCommandType::SET_AUTO_ATTACK, unit, -1, noPos, -1, -1, 4));
+		}
+	}
+}
+
+bool sameCommand(const NetworkCommand &a, const NetworkCommand &b) {
+	return a.getNetworkCommandType() == b.getNetworkCommandType() && a.getUnitId() == b.getUnitId()
+		&& a.getCommandTypeId() == b.getCommandTypeId() && a.getPosition() == b.getPosition()
+		&& a.getProdTypeId() == b.getProdTypeId() && a.getTargetId() == b.getTargetId()
+		&& a.getFlags() == b.getFlags();
+}
+
+int main(int argc, char **argv) {
+	const int keyFrameCount = argc > 1 ? std::max(1, atoi(argv[1])) : 20 * 60 * keyFramesPerSecond;
+	const int apm = argc > 2 ? std::max(1, atoi(argv[2])) : 120;
+
+	Random random(4321);
+	std::vector<BenchPlayer> players(playerCount);
+	int nextUnitId = 0;
+	for (int i = 0; i < playerCount; ++i) { // the starting units
+		for (int j = 0; j < 5; ++j) {
+			players[i].units.push_back(nextUnitId++);
+		}
+	}
+
+	// an order per player about every (keyFramesPerSecond * 60 / apm) keyframes
+	const int orderChance = std::max(1, apm * 1000 / (60 * keyFramesPerSecond));
+	int64 oldBytes = 0, newBytes = 0, commandCount = 0, encodeMicros = 0;
+	int maxOld = 0, maxNew = 0;
+	std::vector<NetworkCommand> commands, decoded(4096);
+	std::vector<uint8> bytes;
+	for (int f = 0; f < keyFrameCount; ++f) {
+		commands.clear();
+		for (int p = 0; p < playerCount; ++p) {
+			if (random.randRange(0, 999) < orderChance) {
+				giveOrders(random, players[p], nextUnitId, commands);
+			}
+		}
+		std::reverse(commands.begin(), commands.end()); // the server adds them last first
+		const int moveUpdates = random.randRange(20, 80), projUpdates = random.randRange(0, 20);
+		const int updateSize = moveUpdates * 2 + projUpdates;
+
+		const int oldSize = oldHeaderSize + updateSize + int(commands.size()) * 16;
+
+		int64 start = Chrono::getCurMicros();
+		bytes.clear();
+		ByteWriter out(bytes);
+		out.writeVarUint(f * 5);
+		const uint64 worldHash = 0;
+		out.writeBytes(&worldHash, sizeof(worldHash));
+		out.writeVarUint(moveUpdates);
+		out.writeVarUint(projUpdates);
+		out.writeVarUint(updateSize);
+		const int updatesAt = bytes.size();
+		bytes.resize(updatesAt + updateSize, 0);
+		encodeCommands(out, commands.empty() ? 0 : &commands[0], commands.size());
+		encodeMicros += Chrono::getCurMicros() - start;
+		const int newSize = 4 + int(bytes.size());
+
+		// loopback
+		ByteReader in(&bytes[0], bytes.size());
+		in.readVarUint();
+		uint64 hashRead;
+		in.readBytes(&hashRead, sizeof(hashRead));
+		in.readVarUint();
+		in.readVarUint();
+		std::vector<uint8> updates(in.readVarUint() + 1);
+		in.readBytes(&updates[0], updates.size() - 1);
+		const int n = decodeCommands(in, &decoded[0], decoded.size());
+		bool ok = n == int(commands.size()) && in.isGood() && !in.remaining();
+		for (int i = 0; ok && i < n; ++i) {
+			ok = sameCommand(commands[i], decoded[i]);
+		}
+		if (!ok) {
+			cout << "keyframe " << f << " did not decode to what was encoded" << endl;
+			return 1;
+		}
+		oldBytes += oldSize;
+		newBytes += newSize;
+		commandCount += commands.size();
+		maxOld = std::max(maxOld, oldSize);
+		maxNew = std::max(maxNew, newSize);
+	}
+
+	cout << "keyframes: " << keyFrameCount << ", commands: " << commandCount
+		<< ", units at the end: " << nextUnitId << endl;
+	cout << "format, mean bytes/keyframe, max bytes/keyframe, kbit/s per client" << endl;
+	cout << "fixed, " << (float(oldBytes) / keyFrameCount) << ", " << maxOld << ", "
+		<< (oldBytes * 8.f * keyFramesPerSecond / keyFrameCount / 1000.f) << endl;
+	cout << "varint/delta, " << (float(newBytes) / keyFrameCount) << ", " << maxNew << ", "
+		<< (newBytes * 8.f * keyFramesPerSecond / keyFrameCount / 1000.f) << endl;
+	cout << "saving: " << (100.f - newBytes * 100.f / oldBytes) << "%, encoding took "
+		<< (encodeMicros / 1000.f) << " ms" << endl;
+	return 0;
+}
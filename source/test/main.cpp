@@ -23,7 +23,15 @@
 #include "circular_buffer_test.h"
 //#include "checksum_test.h"
 #include "heap_test.h"
+#include "slab_pool_test.h"
+#include "id_table_test.h"
+#include "spsc_queue_test.h"
+#include "byte_stream_test.h"
+#include "hash64_test.h"
+#include "command_codec_test.h"
 #include "line_test.h"
+#include "worker_pool_test.h"
+#include "alpha_fade_test.h"
 
 #include "leak_dumper.h"
 
@@ -39,7 +47,15 @@ int main(int argc, char **argv) {
 	tester.addTest(FixedPointTest::suite());
 //	tester.addTest(ChecksumTest::suite());
 	tester.addTest(MinHeapTest::suite());
+	tester.addTest(SlabPoolTest::suite());
+	tester.addTest(IdTableTest::suite());
+	tester.addTest(SpscQueueTest::suite());
+	tester.addTest(ByteStreamTest::suite());
+	tester.addTest(Hash64Test::suite());
+	tester.addTest(CommandCodecTest::suite());
 	tester.addTest(LineAlgorithmTest::suite());
+	tester.addTest(WorkerPoolTest::suite());
+	tester.addTest(AlphaFadeTest::suite());
 
 	bool res = tester.run();
 
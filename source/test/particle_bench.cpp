@@ -0,0 +1,118 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+// Micro-benchmark for Shared::Graphics::ParticleSystem, measures particles updated
+// per millisecond with the struct-of-arrays kernels, against the same update done
+// a particle at a time over an array of Particle records (the old layout).
+// Not part of the test suite, run it by hand: particle_bench [particles] [frames]
+
+#include "pch.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "particle.h"
+#include "timer.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Graphics;
+using namespace Shared::Platform;
+using std::cout;
+using std::endl;
+
+const int particleEnergy = 200;
+
+/** emits enough long lived particles to keep about particleCount alive */
+class BenchParticleSystem : public ParticleSystem {
+public:
+	BenchParticleSystem(int particleCount) : ParticleSystem(particleCount) {
+		setEnergy(particleEnergy);
+		setEnergyVar(particleEnergy / 4);
+		setEmissionRate(float(particleCount) / (particleEnergy * 5 / 4));
+		initArray(ParticleUse::UNIT);
+	}
+
+	virtual void initParticle(Particle *p, int particleIndex) {
+		ParticleSystem::initParticle(p, particleIndex);
+		p->speed = Vec3f(random.randRange(-0.1f, 0.1f), random.randRange(0.f, 0.2f),
+			random.randRange(-0.1f, 0.1f));
+		p->accel = Vec3f(0.f, -0.001f, 0.f);
+	}
+};
+
+/** the reference, the same particles as Particle records updated one by one */
+class AosReference {
+	std::vector<Particle> m_particles;
+	int m_alive;
+
+public:
+	AosReference(const ParticleSystem &ps) : m_particles(ps.getAliveParticleCount()) {
+		m_alive = ps.getAliveParticleCount();
+		for (int i = 0; i < m_alive; ++i) {
+			m_particles[i] = ps.getParticle(i);
+		}
+	}
+
+	int getAliveCount() const { return m_alive; }
+
+	void update() {
+		for (int i = 0; i < m_alive; ) {
+			Particle &p = m_particles[i];
+			p.lastPos = p.pos;
+			p.pos += p.speed;
+			p.speed += p.accel;
+			--p.energy;
+			if (p.energy <= 0) {
+				m_particles[i] = m_particles[--m_alive];
+			} else {
+				++i;
+			}
+		}
+	}
+};
+
+int main(int argc, char **argv) {
+	const int particleCount = argc > 1 ? std::max(1, atoi(argv[1])) : 100000;
+	const int frameCount = argc > 2 ? std::max(1, atoi(argv[2])) : 200;
+
+	BenchParticleSystem ps(particleCount);
+	for (int i = 0; i < particleEnergy * 2; ++i) { // warm up to a steady state
+		ps.update();
+	}
+	AosReference reference(ps);
+	ps.setEmissionRate(0.f); // no emission while timing, the reference doesn't emit either
+
+	int64 updated = 0;
+	int64 start = Chrono::getCurMicros();
+	for (int i = 0; i < frameCount; ++i) {
+		updated += ps.getAliveParticleCount();
+		ps.update();
+	}
+	int64 soaTime = std::max(int64(1), Chrono::getCurMicros() - start);
+
+	int64 refUpdated = 0;
+	start = Chrono::getCurMicros();
+	for (int i = 0; i < frameCount; ++i) {
+		refUpdated += reference.getAliveCount();
+		reference.update();
+	}
+	int64 aosTime = std::max(int64(1), Chrono::getCurMicros() - start);
+
+	cout << "layout, particles updated, time (ms), particles/ms" << endl;
+	cout << "struct-of-arrays, " << updated << ", " << (soaTime / 1000.f) << ", "
+		<< (updated * 1000 / soaTime) << endl;
+	cout << "array-of-structs, " << refUpdated << ", " << (aosTime / 1000.f) << ", "
+		<< (refUpdated * 1000 / aosTime) << endl;
+	if (ps.getAliveParticleCount() != reference.getAliveCount()) {
+		cout << "alive counts differ: " << ps.getAliveParticleCount() << " vs "
+			<< reference.getAliveCount() << endl;
+		return 1;
+	}
+	return 0;
+}
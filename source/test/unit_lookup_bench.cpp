@@ -0,0 +1,108 @@
+// ==============================================================
+//	This file is part of The Mandate Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+// Micro-benchmark for entity lookup by id, measures lookups per millisecond with
+// the IdTable the EntityFactory now uses, against the std::map<int, Entity*> it
+// replaced, with 10k live entities whose ids have churned like a long game's.
+// Not part of the test suite, run it by hand: unit_lookup_bench [live] [lookups]
+
+#include "pch.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "id_table.h"
+#include "random.h"
+#include "timer.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using std::cout;
+using std::endl;
+
+/** stands in for a Unit, about the same size so the objects spread over memory alike */
+struct BenchUnit {
+	int   id;
+	char  payload[1020];
+};
+
+int main(int argc, char **argv) {
+	const int liveCount = argc > 1 ? std::max(1, atoi(argv[1])) : 10000;
+	const int lookupCount = argc > 2 ? std::max(1, atoi(argv[2])) : 10000000;
+
+	// create 4x liveCount units, kill three quarters of them at random, so the
+	// live ids are scattered over the id range as they are mid-game
+	Random random(1234);
+	std::vector<BenchUnit*> units;
+	for (int i = 0; i < liveCount * 4; ++i) {
+		BenchUnit *unit = new BenchUnit();
+		unit->id = i;
+		units.push_back(unit);
+	}
+	std::vector<BenchUnit*> dead;
+	while (int(units.size()) > liveCount) {
+		const int ndx = random.randRange(0, units.size() - 1);
+		dead.push_back(units[ndx]);
+		units[ndx] = units.back();
+		units.pop_back();
+	}
+
+	std::map<int, BenchUnit*> unitMap;
+	IdTable<BenchUnit> unitTable;
+	for (int i = 0; i < units.size(); ++i) {
+		unitMap[units[i]->id] = units[i];
+		unitTable.set(units[i]->id, units[i], i);
+	}
+
+	// the ids to look up, mostly live units, the odd dead one
+	std::vector<int> ids(lookupCount);
+	for (int i = 0; i < lookupCount; ++i) {
+		ids[i] = random.randRange(0, 15) ? units[random.randRange(0, units.size() - 1)]->id
+			: dead[random.randRange(0, dead.size() - 1)]->id;
+	}
+
+	int64 mapFound = 0;
+	int64 start = Chrono::getCurMicros();
+	for (int i = 0; i < lookupCount; ++i) {
+		std::map<int, BenchUnit*>::const_iterator it = unitMap.find(ids[i]);
+		if (it != unitMap.end()) {
+			mapFound += it->second->id;
+		}
+	}
+	int64 mapTime = std::max(int64(1), Chrono::getCurMicros() - start);
+
+	int64 tableFound = 0;
+	start = Chrono::getCurMicros();
+	for (int i = 0; i < lookupCount; ++i) {
+		if (BenchUnit *unit = unitTable.get(ids[i])) {
+			tableFound += unit->id;
+		}
+	}
+	int64 tableTime = std::max(int64(1), Chrono::getCurMicros() - start);
+
+	cout << "lookup, live units, lookups, time (ms), lookups/ms" << endl;
+	cout << "std::map, " << liveCount << ", " << lookupCount << ", " << (mapTime / 1000.f)
+		<< ", " << (int64(lookupCount) * 1000 / mapTime) << endl;
+	cout << "IdTable, " << liveCount << ", " << lookupCount << ", " << (tableTime / 1000.f)
+		<< ", " << (int64(lookupCount) * 1000 / tableTime) << endl;
+
+	for (int i = 0; i < units.size(); ++i) {
+		delete units[i];
+	}
+	for (int i = 0; i < dead.size(); ++i) {
+		delete dead[i];
+	}
+	if (mapFound != tableFound) {
+		cout << "results differ: " << mapFound << " vs " << tableFound << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//  GPL V3, see source/licence.txt
+// ==============================================================
+
+// Micro-benchmark for Shared::Platform::WorkerPool, measures the cost of
+// spawning tasks and how parallelFor scales with the number of threads.
+// Not part of the test suite, run it by hand: worker_pool_bench [maxThreads]
+
+#include "pch.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <cmath>
+
+#include "worker_pool.h"
+#include "timer.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+using std::cout;
+using std::endl;
+
+/** does nothing, measures pure spawn & run overhead */
+class EmptyTask : public Task {
+public:
+	virtual void execute() {}
+};
+
+/** some floating point busy work per index */
+class BusyRange : public RangeTask {
+	std::vector<float> &m_out;
+public:
+	BusyRange(std::vector<float> &out) : m_out(out) {}
+	virtual void execute(int begin, int end) {
+		for (int i = begin; i < end; ++i) {
+			float f = float(i);
+			for (int j = 0; j < 200; ++j) {
+				f = std::sqrt(f * f + 1.f);
+			}
+			m_out[i] = f;
+		}
+	}
+};
+
+/** spawns children from inside the pool, so pushes go to the workers' own deques */
+class SpawnTask : public Task {
+	TaskGroup &m_group;
+	int        m_count;
+public:
+	SpawnTask(TaskGroup &group, int count) : m_group(group), m_count(count) {}
+	virtual void execute() {
+		for (int i = 0; i < m_count; ++i) {
+			m_group.runOwned(new EmptyTask());
+		}
+	}
+};
+
+int main(int argc, char **argv) {
+	const int maxThreads = argc > 1 ? std::max(1, atoi(argv[1])) : 16;
+	const int spawnCount = 100000;
+	const int rangeSize = 200000;
+
+	cout << "threads, external spawn (ns/task), internal spawn (ns/task), parallelFor (ms), speed-up" << endl;
+	int64 baseTime = 0;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		WorkerPool pool(threads);
+
+		// tasks queued from outside the pool
+		std::vector<EmptyTask> tasks(spawnCount);
+		int64 start = Chrono::getCurMicros();
+		{
+			TaskGroup group(pool);
+			for (int i = 0; i < spawnCount; ++i) {
+				group.run(&tasks[i]);
+			}
+			group.wait();
+		}
+		int64 externalTime = Chrono::getCurMicros() - start;
+
+		// tasks queued by a task
+		start = Chrono::getCurMicros();
+		{
+			TaskGroup group(pool);
+			group.runOwned(new SpawnTask(group, spawnCount));
+			group.wait();
+		}
+		int64 internalTime = Chrono::getCurMicros() - start;
+
+		// scaling
+		std::vector<float> out(rangeSize);
+		BusyRange body(out);
+		start = Chrono::getCurMicros();
+		pool.parallelFor(rangeSize, 256, body);
+		int64 forTime = Chrono::getCurMicros() - start;
+		if (threads == 1) {
+			baseTime = forTime;
+		}
+
+		cout << threads << ", "
+			<< (externalTime * 1000 / spawnCount) << ", "
+			<< (internalTime * 1000 / spawnCount) << ", "
+			<< (forTime / 1000.f) << ", "
+			<< (forTime ? float(baseTime) / forTime : 0.f) << endl;
+	}
+	return 0;
+}